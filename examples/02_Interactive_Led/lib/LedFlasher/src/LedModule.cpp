@@ -8,9 +8,17 @@ LedModule::LedModule(const char* instanceName, const JsonObject& config)
     _pin = resourceObj["pin"];
     _interval = config["blink_interval_ms"] | 500;
     _taskHandle = 0;
+    _shortPressSubscription = 0;
+    _longPressSubscription = 0;
     _currentState = LedState::OFF; // Initial state
 }
 
+LedModule::~LedModule() {
+    // The event handlers capture `this`; remove them before it dangles.
+    NextinoEvent().off(_shortPressSubscription);
+    NextinoEvent().off(_longPressSubscription);
+}
+
 const char* LedModule::getName() const { return "LedModule"; }
 
 void LedModule::init() {
@@ -26,8 +34,8 @@ void LedModule::init() {
 }
 
 void LedModule::start() {
-    NextinoEvent().on("button_short_press", [this](void* p) { this->handleShortPress(p); });
-    NextinoEvent().on("button_long_press", [this](void* p) { this->handleLongPress(p); });
+    _shortPressSubscription = NextinoEvent().on("button_short_press", [this](void* p) { this->handleShortPress(p); });
+    _longPressSubscription = NextinoEvent().on("button_long_press", [this](void* p) { this->handleLongPress(p); });
     NEXTINO_LOGI(getName(), "Subscribed to button events.");
 }
 
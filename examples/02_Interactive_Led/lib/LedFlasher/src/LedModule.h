@@ -14,6 +14,8 @@ private:
     int _pin;
     unsigned long _interval;
     uint32_t _taskHandle;
+    EventBus::Subscription _shortPressSubscription;
+    EventBus::Subscription _longPressSubscription;
     LedState _currentState; // Use a single state variable
 
     // Event handlers
@@ -26,6 +28,7 @@ private:
 public:
     // Updated constructor to accept the instance name
     LedModule(const char* instanceName, const JsonObject& config);
+    ~LedModule() override;
 
     // Updated static create function to match the ModuleCreationFunction signature
     static BaseModule* create(const char* instanceName, const JsonObject& config) {
@@ -9,6 +9,91 @@ import json
 # The name of the header file to be generated.
 GENERATED_HEADER_NAME = "generated_config.h"
 
+def _command_hash(seed, instance_name, command):
+    """
+    Hashes "<instance> <command>" with 32-bit FNV-1a, starting from the basis
+    XOR `seed`. Must match `CommandTable::hash()` in CommandRouter.h.
+    """
+    result = (2166136261 ^ seed) & 0xFFFFFFFF
+    for byte in f"{instance_name} {command}".encode("utf-8"):
+        result = ((result ^ byte) * 16777619) & 0xFFFFFFFF
+    return result
+
+def build_command_table(commands):
+    """
+    Builds a minimal perfect hash of the declared commands ("hash and displace").
+
+    The first hash puts each command in one of about N/4 buckets. Buckets are
+    then placed largest first: each gets the first displacement that, used as
+    the seed of the second hash, sends all its commands to free slots.
+
+    Args:
+        commands (list): Unique (instance_name, command) pairs.
+
+    Returns:
+        tuple: The pair in each slot, and the displacement of each bucket.
+    """
+    size = len(commands)
+    bucket_count = max(1, (size + 3) // 4)
+    buckets = [[] for _ in range(bucket_count)]
+    for key in commands:
+        buckets[_command_hash(0, *key) % bucket_count].append(key)
+
+    slots = [None] * size
+    displacements = [0] * bucket_count
+    for index in sorted(range(bucket_count), key=lambda b: -len(buckets[b])):
+        bucket = buckets[index]
+        if not bucket:
+            continue
+        for displacement in range(1, 0x10000):
+            chosen = [_command_hash(displacement, *key) % size for key in bucket]
+            if len(set(chosen)) == len(chosen) and all(slots[slot] is None for slot in chosen):
+                break
+        else:
+            raise ValueError(f"Could not build the command table for {bucket}; rename one of these commands.")
+        displacements[index] = displacement
+        for key, slot in zip(bucket, chosen):
+            slots[slot] = key
+    return slots, displacements
+
+def generate_command_table(commands):
+    """
+    Generates the C++ definition of `nextinoCommandTable` for the declared commands.
+
+    Args:
+        commands (list): Unique (instance_name, command) pairs.
+
+    Returns:
+        str: The C++ source, or an empty string if no commands are declared.
+    """
+    if not commands:
+        return ""
+    if len(commands) > 0x8000:
+        raise ValueError("At most 32768 commands can be declared.")
+
+    slots, displacements = build_command_table(commands)
+    # A command's slot is also its ID in binary command frames.
+    entries_string = "\n".join(
+        f"    {{{json.dumps(instance_name)}, {json.dumps(command)}}}, // ID {slot}"
+        for slot, (instance_name, command) in enumerate(slots)
+    )
+    displacement_lines = [
+        "    " + ", ".join(str(d) for d in displacements[i:i + 16]) + ","
+        for i in range(0, len(displacements), 16)
+    ]
+    displacements_string = "\n".join(displacement_lines)
+
+    return f"""// Perfect-hash table of the commands declared in config.json (see CommandTable)
+static const CommandTable::Entry nextinoCommandEntries[] = {{
+{entries_string}
+}};
+static const uint16_t nextinoCommandDisplacements[] = {{
+{displacements_string}
+}};
+static const CommandTable nextinoCommandTable = {{nextinoCommandEntries, nextinoCommandDisplacements, {len(slots)}, {len(displacements)}}};
+
+"""
+
 def generate_header_file(module_data):
     """
     Generates the full content for the `generated_config.h` file.
@@ -25,6 +110,7 @@ def generate_header_file(module_data):
     module_configs = module_data.get("configs", [])
     module_headers = module_data.get("headers", [])
     module_class_names = module_data.get("class_names", [])
+    module_commands = module_data.get("commands", [])
 
     # Create the final JSON object to be embedded in the header
     final_config_dict = {"modules": module_configs}
@@ -38,6 +124,10 @@ def generate_header_file(module_data):
         f'    NextinoFactory().registerModule("{name}", {name}::create);'
         for name in module_class_names
     ]
+    command_table_string = generate_command_table(module_commands)
+    if command_table_string:
+        # Installed before SystemManager::begin() runs the modules' registerCommands().
+        registration_lines.append("    NextinoCommands().useCommandTable(nextinoCommandTable);")
     registrations_string = "\n".join(registration_lines)
 
     # Assemble the final header content using an f-string
@@ -56,7 +146,7 @@ const char* projectConfigJson = R"json(
 {final_json_string}
 )json";
 
-// Function to register all module types with the ModuleFactory
+{command_table_string}// Function to register all module types with the ModuleFactory
 void registerAllModuleTypes() {{
 {registrations_string}
 }}
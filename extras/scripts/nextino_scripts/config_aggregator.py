@@ -33,19 +33,22 @@ def _is_nextino_module(lib_path):
 def find_and_process_modules(project_lib_dir):
     """
     Scans libs, finds Nextino modules, and returns aggregated configs and metadata.
-    It now also extracts `mqtt_interface` data for each module instance.
+    It now also extracts `mqtt_interface` data and declared `commands` for
+    each module instance.
     """
     all_module_configs = []
     unique_module_headers = set()
     unique_module_class_names = set()
     mqtt_interfaces = [] # New list to store MQTT data
+    commands = [] # (instance_name, command) pairs for the command table
 
     if not os.path.exists(project_lib_dir):
         return {
             "configs": [],
             "headers": [],
             "class_names": [],
-            "mqtt_interfaces": []
+            "mqtt_interfaces": [],
+            "commands": []
         }
 
     for lib_name in os.listdir(project_lib_dir):
@@ -79,6 +82,11 @@ def find_and_process_modules(project_lib_dir):
                                 "module_type": module_type,
                                 "interface": mqtt_interface
                             })
+
+                        # Declared commands: a list of names, or an object of name -> description.
+                        for command in instance_config.get("commands") or []:
+                            if instance_name:
+                                commands.append((instance_name, command))
             except Exception as e:
                 print(f"Warning: Could not parse {config_path}: {e}", file=sys.stderr)
         
@@ -95,5 +103,6 @@ def find_and_process_modules(project_lib_dir):
         "configs": all_module_configs,
         "headers": sorted(list(unique_module_headers)),
         "class_names": sorted(list(unique_module_class_names)),
-        "mqtt_interfaces": mqtt_interfaces
+        "mqtt_interfaces": mqtt_interfaces,
+        "commands": sorted(set(commands))
     }
\ No newline at end of file
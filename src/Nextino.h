@@ -21,13 +21,20 @@
 // --- Core Singletons (Internal Headers) ---
 #include "core/SystemManager.h"
 #include "core/Scheduler.h"
+#include "core/Executor.h"
+#include "core/DeferredQueue.h"
+#include "core/Coroutine.h"
 #include "core/Logger.h"
 #include "core/ModuleFactory.h"
 #include "core/ResourceManager.h"
 #include "core/EventBus.h"
+#include "core/EventChannel.h"
+#include "core/EventPayload.h"
+#include "core/EventRecorder.h"
 #include "core/ServiceLocator.h"
 #include "core/DeviceIdentity.h"
 #include "core/CommandRouter.h"
+#include "core/CommandFrame.h"
 
 /**
  * @brief Provides access to the global SystemManager instance.
@@ -41,6 +48,18 @@ inline SystemManager& NextinoSystem() { return SystemManager::getInstance(); }
  */
 inline Scheduler& NextinoScheduler() { return Scheduler::getInstance(); }
 
+/**
+ * @brief Provides access to the global Executor instance.
+ * @return A reference to the Executor singleton.
+ */
+inline Executor& NextinoExecutor() { return Executor::getInstance(); }
+
+/**
+ * @brief Provides access to the global DeferredQueue instance.
+ * @return A reference to the DeferredQueue singleton.
+ */
+inline DeferredQueue& NextinoDeferred() { return DeferredQueue::getInstance(); }
+
 /**
  * @brief Provides access to the global ModuleFactory instance.
  * @return A reference to the ModuleFactory singleton.
@@ -59,6 +78,12 @@ inline ResourceManager &NextinoResource() { return ResourceManager::getInstance(
  */
 inline EventBus &NextinoEvent() { return EventBus::getInstance(); }
 
+/**
+ * @brief Provides access to the global EventPayloadPool instance.
+ * @return A reference to the EventPayloadPool singleton.
+ */
+inline EventPayloadPool &NextinoPayloads() { return EventPayloadPool::getInstance(); }
+
 /**
  * @brief Provides access to the global ServiceLocator instance.
  * @return A reference to the ServiceLocator singleton.
@@ -0,0 +1,165 @@
+/**
+ * @file        CommandFrame.cpp
+ * @title       Binary Command Frames Implementation
+ * @description Implements the CRC, the request writer, the stream reader and
+ *              the response decoder of the binary command framing.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-06
+ * @version     0.1.0
+ *
+ * @copyright   (c) 2025 Nextino. All rights reserved.
+ * @license     MIT License
+ */
+
+#include "CommandFrame.h"
+#include <string.h> // For memcpy, memmove
+
+namespace {
+// CRC-8 of every byte value, computed at compile time; 256 bytes of flash.
+struct Crc8Table {
+    uint8_t values[256];
+
+    constexpr Crc8Table() : values() {
+        for (int byte = 0; byte < 256; ++byte) {
+            uint8_t crc = (uint8_t)byte;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+            }
+            values[byte] = crc;
+        }
+    }
+};
+
+constexpr Crc8Table CRC8_TABLE;
+} // namespace
+
+uint8_t CommandFrame::crc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; ++i) {
+        crc = CRC8_TABLE.values[crc ^ data[i]];
+    }
+    return crc;
+}
+
+bool CommandFrame::decodeResponse(const uint8_t* frame, size_t size, CommandResponse& response) {
+    if (size < OVERHEAD + 2 || frame[0] != RESPONSE || frame[1] + OVERHEAD != size ||
+        crc8(frame + 1, size - 2) != frame[size - 1]) {
+        return false;
+    }
+    response.sequence = frame[2];
+    response.status = (CommandStatus)frame[3];
+    response.output = std::string_view((const char*)frame + 4, size - OVERHEAD - 2);
+    return true;
+}
+
+// --- CommandFrameWriter ---
+
+CommandFrameWriter::CommandFrameWriter(uint8_t* buffer, size_t capacity)
+    : _buffer(buffer), _capacity(capacity), _size(0), _argc(0), _overflow(false) {}
+
+CommandFrameWriter& CommandFrameWriter::begin(uint8_t sequence, uint16_t id) {
+    _size = 0;
+    _argc = 0;
+    _overflow = false;
+    uint8_t header[6] = {CommandFrame::REQUEST, 0, sequence, (uint8_t)(id & 0xFF), (uint8_t)(id >> 8), 0};
+    put(header, sizeof(header));
+    return *this;
+}
+
+CommandFrameWriter& CommandFrameWriter::addInt(int32_t value) {
+    uint8_t bytes[5] = {(uint8_t)CommandArgType::Int, (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16),
+                        (uint8_t)((uint32_t)value >> 24)};
+    put(bytes, sizeof(bytes));
+    _argc++;
+    return *this;
+}
+
+CommandFrameWriter& CommandFrameWriter::addFloat(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint8_t bytes[5] = {(uint8_t)CommandArgType::Float, (uint8_t)bits, (uint8_t)(bits >> 8), (uint8_t)(bits >> 16),
+                        (uint8_t)(bits >> 24)};
+    put(bytes, sizeof(bytes));
+    _argc++;
+    return *this;
+}
+
+CommandFrameWriter& CommandFrameWriter::addBool(bool value) {
+    uint8_t bytes[2] = {(uint8_t)CommandArgType::Bool, (uint8_t)(value ? 1 : 0)};
+    put(bytes, sizeof(bytes));
+    _argc++;
+    return *this;
+}
+
+CommandFrameWriter& CommandFrameWriter::addText(std::string_view text) {
+    if (text.size() > 255) {
+        _overflow = true;
+        return *this;
+    }
+    uint8_t header[2] = {(uint8_t)CommandArgType::Text, (uint8_t)text.size()};
+    put(header, sizeof(header));
+    put(text.data(), text.size());
+    _argc++;
+    return *this;
+}
+
+void CommandFrameWriter::put(const void* data, size_t length) {
+    if (_overflow || _size + length > _capacity) {
+        _overflow = true;
+        return;
+    }
+    memcpy(_buffer + _size, data, length);
+    _size += length;
+}
+
+size_t CommandFrameWriter::finish() {
+    // The body runs from the sequence byte to here; the CRC follows.
+    if (_overflow || _size < 6 || _size - 2 > 255 || _size + 1 > _capacity) {
+        return 0;
+    }
+    _buffer[1] = (uint8_t)(_size - 2);
+    _buffer[5] = _argc;
+    _buffer[_size] = CommandFrame::crc8(_buffer + 1, _size - 1);
+    return _size + 1;
+}
+
+// --- CommandFrameReader ---
+
+CommandFrameReader::CommandFrameReader(uint8_t start) : _start(start), _size(0), _expected(0), _complete(false), _dropped(0) {}
+
+bool CommandFrameReader::feedSlow(uint8_t byte) {
+    if (_complete) {
+        _complete = false;
+        _size = 0;
+    }
+    if (_size == 0 && byte != _start) {
+        return false; // Between frames, or lost in one
+    }
+    _buffer[_size++] = byte;
+
+    while (_size >= 2) {
+        _expected = _buffer[1] + CommandFrame::OVERHEAD;
+        if (_size < _expected) {
+            return false;
+        }
+        if (CommandFrame::crc8(_buffer + 1, _expected - 2) == _buffer[_expected - 1]) {
+            _size = _expected;
+            _complete = true;
+            return true;
+        }
+        _dropped++;
+        resync();
+    }
+    return false;
+}
+
+void CommandFrameReader::resync() {
+    // The start byte may have been noise: look for a frame starting later in the buffer.
+    size_t next = 1;
+    while (next < _size && _buffer[next] != _start) {
+        next++;
+    }
+    memmove(_buffer, _buffer + next, _size - next);
+    _size -= next;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file        CommandFrame.h
+ * @title       Binary Command Frames
+ * @description Defines the compact binary framing that `CommandRouter` accepts
+ *              alongside text commands, for high-rate machine-to-machine
+ *              control. A request names its command by a numeric ID and
+ *              carries typed arguments; a response carries a status code and
+ *              the handler's output. The same registered handlers serve both.
+ *
+ *              Wire format, little-endian:
+ *
+ *                  request:  0xC5 | length | sequence | id (2) | argc | args... | crc
+ *                  response: 0xC6 | length | sequence | status | output... | crc
+ *
+ *              `length` counts the bytes between itself and the CRC, at most
+ *              255. `crc` is a CRC-8 (polynomial 0x07) of `length` and those
+ *              bytes. Each argument is a `CommandArgType` byte followed by an
+ *              int32, a float32, one byte (0 or 1), or a length byte and text.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-06
+ * @version     0.1.0
+ *
+ * @copyright   (c) 2025 Nextino. All rights reserved.
+ * @license     MIT License
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "CommandRouter.h"
+
+/**
+ * @enum CommandArgType
+ * @brief The type tag of an argument in a binary request.
+ * @details Handlers receive every argument as text: an Int as decimal, a
+ *          Float with enough digits to read back the same value, a Bool as
+ *          "1" or "0", and Text as is.
+ */
+enum class CommandArgType : uint8_t {
+    Int = 1,   /**< int32 */
+    Float = 2, /**< IEEE 754 float32 */
+    Bool = 3,  /**< One byte, 0 or 1 */
+    Text = 4   /**< A length byte and up to 255 bytes */
+};
+
+namespace CommandFrame {
+constexpr uint8_t REQUEST = 0xC5;
+constexpr uint8_t RESPONSE = 0xC6;
+constexpr size_t OVERHEAD = 3;                  // Start byte, length and CRC
+constexpr size_t MAX_SIZE = OVERHEAD + 255;     // The longest frame
+constexpr size_t MAX_OUTPUT = 255 - 2;          // The most output a response carries
+
+/**
+ * @brief CRC-8 with polynomial 0x07 and initial value 0.
+ */
+uint8_t crc8(const uint8_t* data, size_t length);
+} // namespace CommandFrame
+
+/**
+ * @class CommandFrameWriter
+ * @brief Builds a request frame into a caller-supplied buffer.
+ * @code
+ * uint8_t frame[CommandFrame::MAX_SIZE];
+ * size_t size = CommandFrameWriter(frame, sizeof(frame)).begin(1, setLevelId).addInt(75).addText("fast").finish();
+ * @endcode
+ */
+class CommandFrameWriter {
+public:
+    CommandFrameWriter(uint8_t* buffer, size_t capacity);
+
+    /**
+     * @brief Starts a request for the command with the given ID.
+     * @param sequence Echoed in the response, to match it to its request.
+     */
+    CommandFrameWriter& begin(uint8_t sequence, uint16_t id);
+
+    CommandFrameWriter& addInt(int32_t value);
+    CommandFrameWriter& addFloat(float value);
+    CommandFrameWriter& addBool(bool value);
+    CommandFrameWriter& addText(std::string_view text);
+
+    /**
+     * @brief Completes the frame.
+     * @return The size of the frame, or 0 if it did not fit.
+     */
+    size_t finish();
+
+private:
+    void put(const void* data, size_t length);
+
+    uint8_t* _buffer;
+    size_t _capacity;
+    size_t _size;
+    uint8_t _argc;
+    bool _overflow;
+};
+
+/**
+ * @class CommandFrameReader
+ * @brief Reassembles frames from a byte stream, such as a serial port.
+ * @details Bytes before a start byte are skipped, and a frame whose CRC does
+ *          not match is dropped; reading then resumes after its start byte, so
+ *          the reader finds its way back into a stream that lost bytes.
+ * @code
+ * while (Serial.available()) {
+ *     if (reader.feed(Serial.read())) {
+ *         size_t size = NextinoCommands().executeFrame(reader.data(), reader.size(), response, sizeof(response));
+ *         Serial.write(response, size);
+ *     }
+ * }
+ * @endcode
+ */
+class CommandFrameReader {
+public:
+    /**
+     * @param start The start byte of the frames to read: CommandFrame::REQUEST,
+     *              or CommandFrame::RESPONSE in a tool reading responses.
+     */
+    explicit CommandFrameReader(uint8_t start = CommandFrame::REQUEST);
+
+    /**
+     * @brief Adds one byte.
+     * @return True if it completed a frame, which data() then holds until the next call.
+     */
+    bool feed(uint8_t byte) {
+        if (_size >= 2 && _size + 1 < _expected) {
+            _buffer[_size++] = byte; // Inside a frame, not its last byte
+            return false;
+        }
+        return feedSlow(byte);
+    }
+
+    const uint8_t* data() const { return _buffer; }
+    size_t size() const { return _complete ? _size : 0; }
+
+    /**
+     * @brief The number of frames dropped for a bad CRC.
+     */
+    uint32_t dropped() const { return _dropped; }
+
+private:
+    bool feedSlow(uint8_t byte);
+    void resync();
+
+    uint8_t _buffer[CommandFrame::MAX_SIZE];
+    uint8_t _start;
+    size_t _size;
+    size_t _expected; // The size of the frame being read, once its length byte is in
+    bool _complete;
+    uint32_t _dropped;
+};
+
+/**
+ * @struct CommandResponse
+ * @brief A decoded response frame.
+ */
+struct CommandResponse {
+    uint8_t sequence;
+    CommandStatus status;
+    std::string_view output; // A view into the frame
+};
+
+namespace CommandFrame {
+/**
+ * @brief Decodes a response frame.
+ * @return False if the frame is malformed or its CRC does not match.
+ */
+bool decodeResponse(const uint8_t* frame, size_t size, CommandResponse& response);
+} // namespace CommandFrame
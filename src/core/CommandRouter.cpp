@@ -4,8 +4,238 @@
  * @description Implements the logic for registering, parsing, and executing commands.
  */
 #include "CommandRouter.h"
+#include "CommandFrame.h"
 #include "Logger.h" // For logging
-#include <sstream>   // For splitting the command string
+#include <ctype.h>  // For isspace
+#include <stdarg.h> // For va_list
+#include <stdio.h>  // For vsnprintf
+#include <stdlib.h> // For strtod
+#include <string.h> // For memcpy
+
+static const char INVALID_FORMAT[] = "ERROR: Invalid command format. Expected '<instance_name> <command> [args...]'.";
+static const char NOT_FOUND[] = "ERROR: Command not found.";
+
+static uint32_t readU32(const uint8_t* bytes) {
+    return (uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+}
+
+// Turns the typed arguments of a request into views for the handler.
+static CommandStatus decodeArguments(const uint8_t* data, const uint8_t* end, size_t argc, std::string_view* args,
+                                     char (*numbers)[16]) {
+    if (argc > NEXTINO_COMMAND_MAX_ARGS) {
+        return CommandStatus::BadArguments;
+    }
+    for (size_t i = 0; i < argc; ++i) {
+        if (data == end) {
+            return CommandStatus::InvalidFormat;
+        }
+        CommandArgType type = (CommandArgType)*data++;
+        size_t need = type == CommandArgType::Bool ? 1 : type == CommandArgType::Text ? 1 : 4;
+        if ((size_t)(end - data) < need) {
+            return CommandStatus::InvalidFormat;
+        }
+        switch (type) {
+        case CommandArgType::Int:
+            args[i] = CommandOutput(numbers[i], sizeof(numbers[i])).print((int32_t)readU32(data)).view();
+            break;
+        case CommandArgType::Float: {
+            uint32_t bits = readU32(data);
+            float value;
+            memcpy(&value, &bits, sizeof(value));
+            args[i] = std::string_view(numbers[i], (size_t)snprintf(numbers[i], sizeof(numbers[i]), "%.9g", (double)value));
+            break;
+        }
+        case CommandArgType::Bool:
+            args[i] = *data ? "1" : "0";
+            break;
+        case CommandArgType::Text:
+            need += *data;
+            if ((size_t)(end - data) < need) {
+                return CommandStatus::InvalidFormat;
+            }
+            args[i] = std::string_view((const char*)data + 1, *data);
+            break;
+        default:
+            return CommandStatus::InvalidFormat;
+        }
+        data += need;
+    }
+    return data == end ? CommandStatus::Ok : CommandStatus::InvalidFormat;
+}
+
+CommandOutput::CommandOutput(char* buffer, size_t capacity)
+    : _buffer(buffer), _capacity(buffer ? capacity : 0), _length(0), _truncated(false) {
+    if (_capacity > 0) {
+        _buffer[0] = '\0';
+    }
+}
+
+CommandOutput& CommandOutput::print(std::string_view text) {
+    size_t room = _capacity > _length ? _capacity - _length - 1 : 0;
+    size_t count = text.size() < room ? text.size() : room;
+    if (count < text.size()) {
+        _truncated = true;
+    }
+    if (count > 0) {
+        memcpy(_buffer + _length, text.data(), count);
+        _length += count;
+        _buffer[_length] = '\0';
+    }
+    return *this;
+}
+
+CommandOutput& CommandOutput::printSigned(long long value) {
+    if (value < 0) {
+        print("-");
+        return printUnsigned(0ull - (unsigned long long)value);
+    }
+    return printUnsigned((unsigned long long)value);
+}
+
+CommandOutput& CommandOutput::printUnsigned(unsigned long long value) {
+    // Digits come out last first.
+    char digits[20];
+    size_t count = sizeof(digits);
+    do {
+        digits[--count] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    return print(std::string_view(digits + count, sizeof(digits) - count));
+}
+
+CommandOutput& CommandOutput::print(double value, uint8_t decimals) {
+    static const uint32_t SCALES[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+    if (decimals > 9) {
+        decimals = 9;
+    }
+    if (!(value > -1e9 && value < 1e9)) {
+        return printf("%.*f", decimals, value); // Large, infinite or NaN
+    }
+
+    // In fixed point, rounded: below 1e9 * 1e9, which fits 64 bits.
+    bool negative = value < 0;
+    unsigned long long scaled = (unsigned long long)((negative ? -value : value) * SCALES[decimals] + 0.5);
+    if (negative && scaled > 0) {
+        print("-");
+    }
+    printUnsigned(scaled / SCALES[decimals]);
+    if (decimals > 0) {
+        char fraction[10];
+        fraction[0] = '.';
+        unsigned long long rest = scaled % SCALES[decimals];
+        for (size_t i = decimals; i > 0; --i) {
+            fraction[i] = (char)('0' + rest % 10);
+            rest /= 10;
+        }
+        print(std::string_view(fraction, decimals + 1u));
+    }
+    return *this;
+}
+
+CommandOutput& CommandOutput::printf(const char* format, ...) {
+    if (_capacity == 0) {
+        _truncated = true;
+        return *this;
+    }
+    size_t room = _capacity - _length;
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(_buffer + _length, room, format, args);
+    va_end(args);
+    if (written < 0) {
+        _buffer[_length] = '\0';
+        return *this;
+    }
+    if ((size_t)written >= room) {
+        _truncated = true;
+        written = (int)(room - 1);
+    }
+    _length += (size_t)written;
+    return *this;
+}
+
+void CommandOutput::clear() {
+    _length = 0;
+    _truncated = false;
+    if (_capacity > 0) {
+        _buffer[0] = '\0';
+    }
+}
+
+bool nextino::parseCommandArg(std::string_view text, unsigned long long& value) {
+    if (text.empty() || text.size() > 20) {
+        return false;
+    }
+    unsigned long long result = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        unsigned digit = (unsigned)(c - '0');
+        if (result > (~0ull - digit) / 10) {
+            return false; // Overflow
+        }
+        result = result * 10 + digit;
+    }
+    value = result;
+    return true;
+}
+
+bool nextino::parseCommandArg(std::string_view text, long long& value) {
+    bool negative = !text.empty() && text[0] == '-';
+    if (!text.empty() && (text[0] == '-' || text[0] == '+')) {
+        text.remove_prefix(1);
+    }
+    unsigned long long magnitude;
+    unsigned long long limit = negative ? 1ull << 63 : (1ull << 63) - 1;
+    if (!parseCommandArg(text, magnitude) || magnitude > limit) {
+        return false;
+    }
+    value = negative ? (long long)(0ull - magnitude) : (long long)magnitude;
+    return true;
+}
+
+bool nextino::parseCommandArg(std::string_view text, double& value) {
+    // strtod() needs a terminated string; numbers are short.
+    char copy[32];
+    if (text.empty() || text.size() >= sizeof(copy) || isspace((unsigned char)text[0])) {
+        return false;
+    }
+    memcpy(copy, text.data(), text.size());
+    copy[text.size()] = '\0';
+    char* end;
+    double result = strtod(copy, &end);
+    if (end != copy + text.size()) {
+        return false;
+    }
+    value = result;
+    return true;
+}
+
+bool nextino::parseCommandArg(std::string_view text, bool& value) {
+    if (text == "1" || text == "true" || text == "on") {
+        value = true;
+        return true;
+    }
+    if (text == "0" || text == "false" || text == "off") {
+        value = false;
+        return true;
+    }
+    return false;
+}
+
+int CommandTable::find(std::string_view instanceName, std::string_view command) const {
+    if (size == 0) {
+        return -1;
+    }
+    uint16_t displacement = displacements[hash(0, instanceName, command) % buckets];
+    uint16_t slot = (uint16_t)(hash(displacement, instanceName, command) % size);
+    // Every name hashes to some slot: check that it is this one's.
+    if (instanceName != entries[slot].instanceName || command != entries[slot].command) {
+        return -1;
+    }
+    return slot;
+}
 
 CommandRouter& CommandRouter::getInstance() {
     static CommandRouter instance;
@@ -13,40 +243,481 @@ CommandRouter& CommandRouter::getInstance() {
 }
 
 bool CommandRouter::registerCommand(const std::string& instanceName, const std::string& command, CommandHandler handler) {
-    RegisteredCommand cmd = {instanceName, command};
-    if (_commandRegistry.count(cmd)) {
+    CommandEntry entry;
+    entry.legacy = std::move(handler);
+    return store(instanceName, command, std::move(entry));
+}
+
+bool CommandRouter::registerCommand(const std::string& instanceName, const std::string& command, CommandFunction handler) {
+    CommandEntry entry;
+    entry.handler = std::move(handler);
+    return store(instanceName, command, std::move(entry));
+}
+
+bool CommandRouter::registerCommand(const std::string& instanceName, const std::string& command, AsyncCommandFunction handler) {
+    CommandEntry entry;
+    entry.async = std::move(handler);
+    return store(instanceName, command, std::move(entry));
+}
+
+bool CommandRouter::useCommandTable(const CommandTable& table) {
+    if (_table) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "CmdRouter", "A command table is already installed.");
+        return false;
+    }
+    _table = &table;
+    _slots.reset(new CommandEntry[table.size]);
+    for (uint16_t slot = 0; slot < table.size; ++slot) {
+        _slots[slot].id = slot;
+    }
+    NEXTINO_CORE_LOG(LogLevel::Debug, "CmdRouter", "Installed a table of %u declared commands.", (unsigned)table.size);
+    return true;
+}
+
+bool CommandRouter::store(const std::string& instanceName, const std::string& command, CommandEntry&& entry) {
+    int slot = _table ? _table->find(instanceName, command) : -1;
+    if (slot >= 0) {
+        // A declared command: its slot is waiting, no key to build.
+        if (_slots[slot].isSet()) {
+            NEXTINO_CORE_LOG(LogLevel::Warn, "CmdRouter", "Command '%s' is already registered for instance '%s'. Overwriting.", command.c_str(), instanceName.c_str());
+        }
+        _slots[slot] = std::move(entry);
+        _slots[slot].id = (uint16_t)slot;
+        return true;
+    }
+
+    auto inserted = _commandRegistry.emplace(RegisteredCommand{instanceName, command}, CommandEntry());
+    CommandEntry& stored = inserted.first->second;
+    if (!inserted.second) {
         NEXTINO_CORE_LOG(LogLevel::Warn, "CmdRouter", "Command '%s' is already registered for instance '%s'. Overwriting.", command.c_str(), instanceName.c_str());
+        entry.id = stored.id; // Keeps its ID
+    } else if (_registered.size() < (size_t)(NO_ID - FIRST_REGISTERED_ID)) {
+        entry.id = (uint16_t)(FIRST_REGISTERED_ID + _registered.size());
+        _registered.push_back(&stored); // Map nodes do not move
+    } else {
+        NEXTINO_CORE_LOG(LogLevel::Warn, "CmdRouter", "Out of command IDs: '%s %s' is text-only.", instanceName.c_str(), command.c_str());
     }
-    _commandRegistry[cmd] = handler;
+    stored = std::move(entry);
     NEXTINO_CORE_LOG(LogLevel::Debug, "CmdRouter", "Registered command '%s' for instance '%s'.", command.c_str(), instanceName.c_str());
     return true;
 }
 
+size_t CommandRouter::tokenize(std::string_view text, size_t& position, std::string_view* tokens, size_t max, bool batch) {
+    // In a batch, ';' and line breaks end a command; otherwise line breaks are spaces.
+    auto isSpace = [batch](char c) { return c == ' ' || c == '\t' || c == '\r' || (c == '\n' && !batch); };
+    auto endsCommand = [batch](char c) { return batch && (c == ';' || c == '\n'); };
+    size_t count = 0;
+    while (true) {
+        // Skip spaces, then take everything up to the next one.
+        while (position < text.size() && isSpace(text[position])) {
+            position++;
+        }
+        if (position == text.size() || endsCommand(text[position])) {
+            return count;
+        }
+        size_t start = position;
+        while (position < text.size() && !isSpace(text[position]) && !endsCommand(text[position])) {
+            position++;
+        }
+        if (count < max) {
+            tokens[count] = text.substr(start, position - start);
+        }
+        if (count <= max) {
+            count++;
+        }
+    }
+}
+
+const CommandRouter::CommandEntry* CommandRouter::resolve(const std::string_view* tokens, size_t count, CommandOutput& output,
+                                                          CommandStatus& status) {
+    if (count > 2 + NEXTINO_COMMAND_MAX_ARGS) {
+        output.printf("ERROR: Too many arguments (at most %u).", (unsigned)NEXTINO_COMMAND_MAX_ARGS);
+        status = CommandStatus::BadArguments;
+        return nullptr;
+    }
+    if (count < 2) {
+        output.print(INVALID_FORMAT);
+        status = CommandStatus::InvalidFormat;
+        return nullptr;
+    }
+
+    const CommandEntry* entry = find(tokens[0], tokens[1]);
+    if (!entry) {
+        NEXTINO_CORE_LOG(LogLevel::Warn, "CmdRouter", "Command '%.*s' not found for instance '%.*s'", (int)tokens[1].size(),
+                         tokens[1].data(), (int)tokens[0].size(), tokens[0].data());
+        output.print(NOT_FOUND);
+        status = CommandStatus::NotFound;
+        return nullptr;
+    }
+    NEXTINO_CORE_LOG(LogLevel::Debug, "CmdRouter", "Executing command '%.*s' for instance '%.*s'", (int)tokens[1].size(),
+                     tokens[1].data(), (int)tokens[0].size(), tokens[0].data());
+    return entry;
+}
+
+const CommandRouter::CommandEntry* CommandRouter::find(std::string_view instanceName, std::string_view command) const {
+    int slot = _table ? _table->find(instanceName, command) : -1;
+    if (slot >= 0 && _slots[slot].isSet()) {
+        return &_slots[slot];
+    }
+    // Undeclared, or registered before the table was installed.
+    auto it = _commandRegistry.find(CommandKey{instanceName, command});
+    return it != _commandRegistry.end() ? &it->second : nullptr;
+}
+
+const CommandRouter::CommandEntry* CommandRouter::find(uint16_t id) const {
+    if (id >= FIRST_REGISTERED_ID) {
+        size_t index = id - FIRST_REGISTERED_ID;
+        return index < _registered.size() ? _registered[index] : nullptr;
+    }
+    if (_table && id < _table->size && _slots[id].isSet()) {
+        return &_slots[id];
+    }
+    return nullptr;
+}
+
+int CommandRouter::commandId(std::string_view instanceName, std::string_view command) const {
+    const CommandEntry* entry = find(instanceName, command);
+    return entry && entry->id != NO_ID ? entry->id : -1;
+}
+
+CommandStatus CommandRouter::invoke(const CommandEntry& entry, const CommandArgs& args, CommandOutput& output) {
+    if (entry.handler) {
+        return entry.handler(args, output);
+    }
+
+    // A CommandHandler takes strings; its result counts as an error if it says so.
+    std::vector<std::string> strings(args.begin(), args.end());
+    std::string result = entry.legacy(strings);
+    output.print(result);
+    return result.compare(0, 5, "ERROR") == 0 ? CommandStatus::Failed : CommandStatus::Ok;
+}
+
+CommandStatus CommandRouter::dispatch(const std::string_view* tokens, size_t count, CommandOutput& output) {
+    CommandStatus status;
+    const CommandEntry* entry = resolve(tokens, count, output, status);
+    if (!entry) {
+        return status;
+    }
+    return run(*entry, CommandArgs(tokens + 2, count - 2), output);
+}
+
+CommandStatus CommandRouter::execute(std::string_view commandLine, CommandOutput& output) {
+    std::string_view tokens[2 + NEXTINO_COMMAND_MAX_ARGS];
+    size_t position = 0;
+    size_t count = tokenize(commandLine, position, tokens, 2 + NEXTINO_COMMAND_MAX_ARGS, false);
+    return dispatch(tokens, count, output);
+}
+
+BatchResult CommandRouter::executeBatch(std::string_view commands, CommandOutput& output, BatchMode mode) {
+    BatchResult result = {0, 0, 0, 0, CommandStatus::Ok};
+    std::string_view tokens[2 + NEXTINO_COMMAND_MAX_ARGS];
+    size_t position = 0;
+    while (position < commands.size()) {
+        // Tokenizing stops at the end of each command, so the text is read once.
+        size_t count = tokenize(commands, position, tokens, 2 + NEXTINO_COMMAND_MAX_ARGS, true);
+        position++; // Past the separator
+        if (count == 0) {
+            continue; // Blank, e.g. after a trailing separator
+        }
+        if (result.failed > 0 && mode == BatchMode::StopOnError) {
+            result.skipped++;
+            continue;
+        }
+
+        if (result.executed > 0) {
+            output.print("\n");
+        }
+        CommandStatus status = dispatch(tokens, count, output);
+        result.executed++;
+        if (status == CommandStatus::Pending) {
+            result.pending++; // Still running, not failed
+        } else if (status != CommandStatus::Ok && result.failed++ == 0) {
+            result.firstError = status;
+        }
+    }
+    NEXTINO_CORE_LOG(LogLevel::Debug, "CmdRouter", "Batch: %u run, %u failed, %u skipped, %u pending.", (unsigned)result.executed,
+                     (unsigned)result.failed, (unsigned)result.skipped, (unsigned)result.pending);
+    return result;
+}
+
+CommandStatus CommandRouter::execute(uint16_t id, const CommandArgs& args, CommandOutput& output) {
+    const CommandEntry* entry = find(id);
+    if (!entry) {
+        NEXTINO_CORE_LOG(LogLevel::Warn, "CmdRouter", "Command ID %u not found.", (unsigned)id);
+        return CommandStatus::NotFound;
+    }
+    return run(*entry, args, output);
+}
+
+size_t CommandRouter::executeFrame(const uint8_t* frame, size_t size, uint8_t* response, size_t capacity) {
+    // Header: start, length, sequence, id (2), argc. Then the arguments and the CRC.
+    if (size < CommandFrame::OVERHEAD + 4 || frame[0] != CommandFrame::REQUEST || frame[1] + CommandFrame::OVERHEAD != size ||
+        CommandFrame::crc8(frame + 1, size - 2) != frame[size - 1] || capacity < CommandFrame::OVERHEAD + 2) {
+        return 0;
+    }
+
+    std::string_view args[NEXTINO_COMMAND_MAX_ARGS];
+    char numbers[NEXTINO_COMMAND_MAX_ARGS][16];
+    size_t argc = frame[5];
+    // The handler writes after the response header; its NUL lands where the CRC goes.
+    size_t room = capacity - 4 < CommandFrame::MAX_OUTPUT + 1 ? capacity - 4 : CommandFrame::MAX_OUTPUT + 1;
+    CommandOutput output((char*)response + 4, room);
+    CommandStatus status = decodeArguments(frame + 6, frame + size - 1, argc, args, numbers);
+    if (status == CommandStatus::Ok) {
+        status = execute((uint16_t)(frame[3] | frame[4] << 8), CommandArgs(args, argc), output);
+    }
+
+    response[0] = CommandFrame::RESPONSE;
+    response[1] = (uint8_t)(2 + output.length());
+    response[2] = frame[2];
+    response[3] = (uint8_t)status;
+    response[4 + output.length()] = CommandFrame::crc8(response + 1, 3 + output.length());
+    return CommandFrame::OVERHEAD + 2 + output.length();
+}
+
 std::string CommandRouter::execute(const std::string& commandString) {
-    std::stringstream ss(commandString);
-    std::string segment;
-    std::vector<std::string> segments;
-    while(std::getline(ss, segment, ' ')) {
-       segments.push_back(segment);
+    char buffer[NEXTINO_COMMAND_OUTPUT_SIZE];
+    CommandOutput output(buffer, sizeof(buffer));
+    std::string_view tokens[2 + NEXTINO_COMMAND_MAX_ARGS];
+    size_t position = 0;
+    size_t count = tokenize(commandString, position, tokens, 2 + NEXTINO_COMMAND_MAX_ARGS, false);
+    if (count > 2 + NEXTINO_COMMAND_MAX_ARGS) {
+        // A CommandHandler takes any number of arguments, as it always has.
+        const CommandEntry* entry = find(tokens[0], tokens[1]);
+        if (entry && entry->legacy) {
+            std::vector<std::string_view> all(commandString.size() / 2 + 1); // Enough for one-letter tokens
+            position = 0;
+            count = tokenize(commandString, position, all.data(), all.size(), false);
+            return entry->legacy(std::vector<std::string>(all.begin() + 2, all.begin() + count));
+        }
+    }
+    CommandStatus status;
+    const CommandEntry* entry = resolve(tokens, count, output, status);
+    if (entry && entry->legacy) {
+        // Keeps a CommandHandler's result whole, however long.
+        return entry->legacy(std::vector<std::string>(tokens + 2, tokens + count));
+    }
+    if (entry) {
+        run(*entry, CommandArgs(tokens + 2, count - 2), output);
+    }
+    return std::string(output.view());
+}
+
+// --- Asynchronous commands ---
+
+bool PendingCommand::isActive() const {
+    const CommandRouter& router = CommandRouter::getInstance();
+    const CommandRouter::PendingSlot* slot = router.resolvePending(_token);
+    return slot && slot->state == CommandRouter::PendingState::Running;
+}
+
+bool PendingCommand::complete(CommandStatus status, std::string_view text) {
+    CommandRouter& router = CommandRouter::getInstance();
+    CommandOutput* output = router.pendingOutput(_token);
+    if (!output) {
+        return false;
+    }
+    output->print(text);
+    return router.finishPending(_token, status);
+}
+
+CommandStatus CommandRouter::run(const CommandEntry& entry, const CommandArgs& args, CommandOutput& output) {
+    if (!entry.async) {
+        return invoke(entry, args, output);
+    }
+
+    CommandToken token;
+    PendingSlot* slot = startPending(CommandCompletion(), false, token);
+    if (!slot) {
+        output.print("ERROR: Too many commands pending.");
+        return CommandStatus::Failed;
+    }
+    entry.async(args, PendingCommand(token));
+    slot = resolvePending(token);
+    if (!slot) {
+        output.print("ERROR: Command cancelled.");
+        return CommandStatus::Cancelled;
+    }
+    if (slot->state == PendingState::Done) {
+        // Completed before returning: answer like a synchronous handler.
+        output.print(slot->output.view());
+        CommandStatus status = slot->status;
+        freePending(*slot);
+        return status;
     }
+    afterStart(token, NEXTINO_COMMAND_TIMEOUT_MS);
+    output.printf("PENDING: Command %lu is running.", (unsigned long)token);
+    return CommandStatus::Pending;
+}
+
+CommandToken CommandRouter::executeAsync(std::string_view commandLine, CommandCompletion completion, unsigned long timeoutMs) {
+    CommandToken token;
+    PendingSlot* slot = startPending(std::move(completion), true, token);
+    if (!slot) {
+        return 0;
+    }
+
+    std::string_view tokens[2 + NEXTINO_COMMAND_MAX_ARGS];
+    size_t position = 0;
+    size_t count = tokenize(commandLine, position, tokens, 2 + NEXTINO_COMMAND_MAX_ARGS, false);
+    CommandStatus status;
+    const CommandEntry* entry = resolve(tokens, count, slot->output, status);
+    if (!entry) {
+        finishPending(token, status);
+    } else if (entry->async) {
+        entry->async(CommandArgs(tokens + 2, count - 2), PendingCommand(token));
+    } else {
+        finishPending(token, invoke(*entry, CommandArgs(tokens + 2, count - 2), slot->output));
+    }
+    afterStart(token, timeoutMs);
+    return token;
+}
+
+bool CommandRouter::cancel(CommandToken token) {
+    PendingSlot* slot = resolvePending(token);
+    if (!slot) {
+        return false;
+    }
+    if (slot->task) {
+        Scheduler::getInstance().cancel(slot->task);
+    }
+    freePending(*slot);
+    NEXTINO_CORE_LOG(LogLevel::Debug, "CmdRouter", "Command %lu cancelled.", (unsigned long)token);
+    return true;
+}
+
+size_t CommandRouter::getPendingCount() const {
+    size_t count = 0;
+    for (const PendingSlot& slot : _pending) {
+        if (slot.state != PendingState::Free) {
+            count++;
+        }
+    }
+    return count;
+}
+
+CommandRouter::PendingSlot* CommandRouter::startPending(CommandCompletion&& completion, bool hasCaller, CommandToken& token) {
+    for (uint16_t index = 0; index < NEXTINO_COMMAND_MAX_PENDING; ++index) {
+        PendingSlot& slot = _pending[index];
+        if (slot.state != PendingState::Free) {
+            continue;
+        }
+        slot.completion = std::move(completion);
+        slot.task = 0;
+        slot.state = PendingState::Running;
+        slot.starting = true;
+        slot.hasCaller = hasCaller;
+        slot.status = CommandStatus::Ok;
+        slot.output = CommandOutput(slot.buffer, sizeof(slot.buffer));
+        token = ((CommandToken)slot.generation << 16) | index;
+        return &slot;
+    }
+    NEXTINO_CORE_LOG(LogLevel::Warn, "CmdRouter", "Too many commands pending (%u).", (unsigned)NEXTINO_COMMAND_MAX_PENDING);
+    return nullptr;
+}
+
+const CommandRouter::PendingSlot* CommandRouter::resolvePending(CommandToken token) const {
+    uint16_t index = (uint16_t)(token & 0xFFFF);
+    if (index >= NEXTINO_COMMAND_MAX_PENDING) {
+        return nullptr;
+    }
+    const PendingSlot& slot = _pending[index];
+    if (slot.generation != (uint16_t)(token >> 16) || slot.state == PendingState::Free) {
+        return nullptr;
+    }
+    return &slot;
+}
+
+CommandRouter::PendingSlot* CommandRouter::resolvePending(CommandToken token) {
+    return const_cast<PendingSlot*>(static_cast<const CommandRouter*>(this)->resolvePending(token));
+}
 
-    if (segments.size() < 2) {
-        return "ERROR: Invalid command format. Expected '<instance_name> <command> [args...]'.";
+CommandOutput* CommandRouter::pendingOutput(CommandToken token) {
+    PendingSlot* slot = resolvePending(token);
+    return slot && slot->state == PendingState::Running ? &slot->output : nullptr;
+}
+
+bool CommandRouter::finishPending(CommandToken token, CommandStatus status) {
+    PendingSlot* slot = resolvePending(token);
+    if (!slot || slot->state != PendingState::Running) {
+        return false;
+    }
+    slot->state = PendingState::Done;
+    slot->status = status;
+    if (slot->task) {
+        Scheduler::getInstance().cancel(slot->task); // The timeout
+        slot->task = 0;
     }
+    if (!slot->starting) {
+        scheduleDelivery(token);
+    }
+    return true;
+}
 
-    std::string instanceName = segments[0];
-    std::string command = segments[1];
-    std::vector<std::string> args(segments.begin() + 2, segments.end());
+void CommandRouter::afterStart(CommandToken token, unsigned long timeoutMs) {
+    PendingSlot* slot = resolvePending(token);
+    if (!slot) {
+        return; // Cancelled by its own handler
+    }
+    slot->starting = false;
+    if (slot->state == PendingState::Done) {
+        scheduleDelivery(token);
+        return;
+    }
+    if (timeoutMs == 0) {
+        return;
+    }
+    slot->task = Scheduler::getInstance().scheduleOnce(timeoutMs, [this, token]() {
+        PendingSlot* timedOut = resolvePending(token);
+        if (!timedOut || timedOut->state != PendingState::Running) {
+            return;
+        }
+        timedOut->task = 0; // This task, which is finishing
+        timedOut->output.clear();
+        timedOut->output.print("ERROR: Command timed out.");
+        NEXTINO_CORE_LOG(LogLevel::Warn, "CmdRouter", "Command %lu timed out.", (unsigned long)token);
+        finishPending(token, CommandStatus::TimedOut);
+    });
+}
 
-    RegisteredCommand cmdToFind = {instanceName, command};
+void CommandRouter::scheduleDelivery(CommandToken token) {
+    // The caller hears back from the Scheduler, never from inside its own call.
+    PendingSlot* slot = resolvePending(token);
+    slot->task = Scheduler::getInstance().scheduleOnce(0, [this, token]() { deliver(token); });
+    if (!slot->task) {
+        deliver(token); // The Scheduler is full
+    }
+}
 
-    auto it = _commandRegistry.find(cmdToFind);
-    if (it != _commandRegistry.end()) {
-        // Command found, execute the handler
-        NEXTINO_CORE_LOG(LogLevel::Info, "CmdRouter", "Executing command '%s' for instance '%s'", command.c_str(), instanceName.c_str());
-        return it->second(args); // Call the stored lambda/function
+void CommandRouter::deliver(CommandToken token) {
+    PendingSlot* slot = resolvePending(token);
+    if (!slot || slot->state != PendingState::Done) {
+        return;
+    }
+    slot->task = 0;
+    if (slot->hasCaller) {
+        // Moved out, so a completion that cancels its own command does not destroy itself.
+        CommandCompletion completion = std::move(slot->completion);
+        completion(slot->status, slot->output.view());
     } else {
-        NEXTINO_CORE_LOG(LogLevel::Warn, "CmdRouter", "Command '%s' not found for instance '%s'", command.c_str(), instanceName.c_str());
-        return "ERROR: Command not found.";
+        NEXTINO_CORE_LOG(LogLevel::Info, "CmdRouter", "Command %lu finished: %.*s", (unsigned long)token,
+                         (int)slot->output.length(), slot->output.c_str());
     }
-}
\ No newline at end of file
+    // The completion may have cancelled it already.
+    slot = resolvePending(token);
+    if (slot) {
+        freePending(*slot);
+    }
+}
+
+void CommandRouter::freePending(PendingSlot& slot) {
+    slot.completion = nullptr;
+    slot.task = 0;
+    slot.state = PendingState::Free;
+    slot.starting = false;
+    slot.hasCaller = false;
+    slot.generation++;
+    if (slot.generation == 0) {
+        slot.generation = 1;
+    }
+}
@@ -3,22 +3,392 @@
  * @title       Command Router Service
  * @description Defines the `CommandRouter` singleton, a core service for
  *              registering and executing text-based commands from any source
- *              (Serial, MQTT, etc.).
+ *              (Serial, MQTT, etc.). Command lines are tokenized in place
+ *              into `std::string_view`s, and handlers receive the arguments as
+ *              a span and write their result into a caller-supplied buffer, so
+ *              executing a command needs no heap allocation. Typed handlers get
+ *              their arguments decoded and checked centrally. The same handlers
+ *              also serve binary frames (see CommandFrame.h).
  *
  * @author      Giorgi Magradze
  * @date        2025-08-25
- * @version     0.3.0
+ * @version     0.4.0
  */
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <limits>
+#include <memory>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <map>
+#include "InlineFunction.h"
+#include "Scheduler.h"
+
+/**
+ * @def NEXTINO_COMMAND_MAX_ARGS
+ * @brief The most arguments a command line may carry after `<instance> <command>`.
+ * @details The `std::string` form of execute() still passes any number to a
+ *          `CommandHandler`, tokenizing longer lines on the heap.
+ */
+#ifndef NEXTINO_COMMAND_MAX_ARGS
+#define NEXTINO_COMMAND_MAX_ARGS 8
+#endif
+
+/**
+ * @def NEXTINO_COMMAND_OUTPUT_SIZE
+ * @brief The result buffer used by the `std::string` form of execute().
+ */
+#ifndef NEXTINO_COMMAND_OUTPUT_SIZE
+#define NEXTINO_COMMAND_OUTPUT_SIZE 256
+#endif
+
+/**
+ * @def NEXTINO_COMMAND_MAX_PENDING
+ * @brief The most commands that may run asynchronously at once.
+ */
+#ifndef NEXTINO_COMMAND_MAX_PENDING
+#define NEXTINO_COMMAND_MAX_PENDING 4
+#endif
+
+/**
+ * @def NEXTINO_COMMAND_PENDING_OUTPUT_SIZE
+ * @brief The result buffer of each asynchronous command.
+ */
+#ifndef NEXTINO_COMMAND_PENDING_OUTPUT_SIZE
+#define NEXTINO_COMMAND_PENDING_OUTPUT_SIZE 128
+#endif
+
+/**
+ * @def NEXTINO_COMMAND_TIMEOUT_MS
+ * @brief How long an asynchronous command may run by default before it times out.
+ */
+#ifndef NEXTINO_COMMAND_TIMEOUT_MS
+#define NEXTINO_COMMAND_TIMEOUT_MS 5000
+#endif
+
+/**
+ * @def NEXTINO_COMMAND_COMPLETION_SIZE
+ * @brief The inline storage, in bytes, of a CommandCompletion callback.
+ */
+#ifndef NEXTINO_COMMAND_COMPLETION_SIZE
+#define NEXTINO_COMMAND_COMPLETION_SIZE (4 * sizeof(void*))
+#endif
 
 // Define a type for the command handler function.
 // It accepts a vector of string arguments and returns a result string.
 using CommandHandler = std::function<std::string(const std::vector<std::string>& args)>;
 
+/**
+ * @enum CommandStatus
+ * @brief The outcome of executing a command.
+ */
+enum class CommandStatus : uint8_t {
+    Ok,            /**< The handler ran and succeeded. */
+    InvalidFormat, /**< The line is not `<instance> <command> [args...]`. */
+    NotFound,      /**< No handler is registered for the instance and command. */
+    BadArguments,  /**< Too many arguments, or the handler rejected them. */
+    Failed,        /**< The handler ran and reported an error. */
+    Pending,       /**< An asynchronous handler is still running. */
+    TimedOut,      /**< An asynchronous handler did not finish in time. */
+    Cancelled      /**< The command was cancelled. */
+};
+
+/**
+ * @enum BatchMode
+ * @brief What CommandRouter::executeBatch() does after a command fails.
+ */
+enum class BatchMode : uint8_t {
+    ContinueOnError, /**< Run every command. */
+    StopOnError      /**< Skip the commands after the first failure. */
+};
+
+/**
+ * @struct BatchResult
+ * @brief The outcome of a batch of commands.
+ */
+struct BatchResult {
+    uint16_t executed;        /**< Commands run, including failed ones. */
+    uint16_t failed;          /**< Commands whose status was neither Ok nor Pending. */
+    uint16_t skipped;         /**< Commands not run after a failure (StopOnError). */
+    uint16_t pending;         /**< Asynchronous commands still running; their results are logged. */
+    CommandStatus firstError; /**< The status of the first failure, or Ok. */
+};
+
+/**
+ * @class CommandArgs
+ * @brief A read-only span of the arguments of a command, as views into the command line.
+ * @details The views are valid only while the handler runs; copy what must outlive it.
+ */
+class CommandArgs {
+public:
+    constexpr CommandArgs() : _args(nullptr), _count(0) {}
+    constexpr CommandArgs(const std::string_view* args, size_t count) : _args(args), _count(count) {}
+
+    constexpr size_t size() const { return _count; }
+    constexpr bool empty() const { return _count == 0; }
+    constexpr std::string_view operator[](size_t index) const { return _args[index]; }
+    constexpr const std::string_view* begin() const { return _args; }
+    constexpr const std::string_view* end() const { return _args + _count; }
+
+private:
+    const std::string_view* _args;
+    size_t _count;
+};
+
+/**
+ * @class CommandOutput
+ * @brief Writes a command's result into a caller-supplied buffer.
+ * @details The text is always NUL-terminated. What does not fit is cut off
+ *          and truncated() becomes true; writing never allocates.
+ * @code
+ * char buffer[128];
+ * CommandOutput output(buffer, sizeof(buffer));
+ * NextinoCommands().execute("sensor get_value", output);
+ * Serial.println(output.c_str());
+ * @endcode
+ */
+class CommandOutput {
+public:
+    CommandOutput(char* buffer, size_t capacity);
+
+    /**
+     * @brief Appends text.
+     */
+    CommandOutput& print(std::string_view text);
+
+    /**
+     * @brief Appends an integer in decimal, a bool as "true" or "false", or a char.
+     */
+    template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+    CommandOutput& print(T value) {
+        if constexpr (std::is_same<T, bool>::value) {
+            return print(value ? std::string_view("true") : std::string_view("false"));
+        } else if constexpr (std::is_same<T, char>::value) {
+            return print(std::string_view(&value, 1));
+        } else if constexpr (std::is_signed<T>::value) {
+            return printSigned(value);
+        } else {
+            return printUnsigned(value);
+        }
+    }
+
+    /**
+     * @brief Appends a number with a fixed count of decimals (at most 9), rounded.
+     */
+    CommandOutput& print(double value, uint8_t decimals = 2);
+
+    /**
+     * @brief Appends formatted text, as `snprintf()` would.
+     */
+    CommandOutput& printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+    /**
+     * @brief Empties the output.
+     */
+    void clear();
+
+    const char* c_str() const { return _capacity ? _buffer : ""; }
+    std::string_view view() const { return std::string_view(c_str(), _length); }
+    size_t length() const { return _length; }
+    bool truncated() const { return _truncated; }
+
+private:
+    CommandOutput& printSigned(long long value);
+    CommandOutput& printUnsigned(unsigned long long value);
+
+    char* _buffer;
+    size_t _capacity;
+    size_t _length;
+    bool _truncated;
+};
+
+/**
+ * @typedef CommandFunction
+ * @brief A handler that reads its arguments in place and writes its result into a buffer.
+ * @code
+ * NextinoCommands().registerCommand(getInstanceName(), "status", [this](const CommandArgs& args, CommandOutput& out) {
+ *     if (!args.empty()) {
+ *         out.print("ERROR: No arguments expected.");
+ *         return CommandStatus::BadArguments;
+ *     }
+ *     out.printf("OK: %s at %d%%.", isOn() ? "on" : "off", getLevel());
+ *     return CommandStatus::Ok;
+ * });
+ * @endcode
+ */
+using CommandFunction = std::function<CommandStatus(const CommandArgs& args, CommandOutput& output)>;
+
+/**
+ * @typedef CommandToken
+ * @brief Identifies a running asynchronous command; 0 is never a valid token.
+ */
+using CommandToken = uint32_t;
+
+/**
+ * @class PendingCommand
+ * @brief The handle an asynchronous handler keeps to finish its command later.
+ * @details Small and copyable, so it fits in a Scheduler callback. Once the
+ *          command has completed, timed out or been cancelled, the handle goes
+ *          stale: complete() then returns false and isActive() false.
+ */
+class PendingCommand {
+public:
+    PendingCommand() : _token(0) {}
+    explicit PendingCommand(CommandToken token) : _token(token) {}
+
+    CommandToken token() const { return _token; }
+
+    /**
+     * @brief Whether the command still waits for its result.
+     * @details A handler can check it to stop early after a timeout or cancel.
+     */
+    bool isActive() const;
+
+    /**
+     * @brief Finishes the command with a status and a result text.
+     * @return False if the command is no longer active.
+     */
+    bool complete(CommandStatus status, std::string_view text = std::string_view());
+
+    /**
+     * @brief Finishes the command, writing its result through `write(CommandOutput&)`.
+     * @return False if the command is no longer active; `write` is then not called.
+     */
+    template <typename Write, typename std::enable_if<std::is_invocable<Write&, CommandOutput&>::value, int>::type = 0>
+    bool complete(CommandStatus status, Write write);
+
+private:
+    CommandToken _token;
+};
+
+/**
+ * @typedef AsyncCommandFunction
+ * @brief A handler that may finish its command after it returns, through a PendingCommand.
+ * @code
+ * NextinoCommands().registerCommand(getInstanceName(), "read", [this](const CommandArgs&, PendingCommand pending) {
+ *     startConversion();
+ *     NextinoScheduler().scheduleOnce(750, [this, pending]() {
+ *         pending.complete(CommandStatus::Ok, [this](CommandOutput& out) { out.print("OK: ").print(readCelsius(), 1); });
+ *     });
+ * });
+ * @endcode
+ */
+using AsyncCommandFunction = std::function<void(const CommandArgs& args, PendingCommand pending)>;
+
+/**
+ * @typedef CommandCompletion
+ * @brief Receives the result of a command started with CommandRouter::executeAsync().
+ * @details `output` is valid only during the call.
+ */
+using CommandCompletion = InlineFunction<void(CommandStatus status, std::string_view output), NEXTINO_COMMAND_COMPLETION_SIZE>;
+
+namespace nextino {
+
+/**
+ * @brief Decodes one command argument; false if it does not parse or is out of range.
+ * @details The whole argument must parse. Integers are decimal with an optional
+ *          sign; bools are "1"/"0", "true"/"false" or "on"/"off"; a
+ *          std::string_view receives the argument as is.
+ */
+bool parseCommandArg(std::string_view text, long long& value);
+bool parseCommandArg(std::string_view text, unsigned long long& value);
+bool parseCommandArg(std::string_view text, double& value);
+bool parseCommandArg(std::string_view text, bool& value);
+
+inline bool parseCommandArg(std::string_view text, std::string_view& value) {
+    value = text;
+    return true;
+}
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, bool>::type
+parseCommandArg(std::string_view text, T& value) {
+    using Wide = typename std::conditional<std::is_signed<T>::value, long long, unsigned long long>::type;
+    Wide wide;
+    if (!parseCommandArg(text, wide) || wide < (Wide)std::numeric_limits<T>::min() || wide > (Wide)std::numeric_limits<T>::max()) {
+        return false;
+    }
+    value = (T)wide;
+    return true;
+}
+
+inline bool parseCommandArg(std::string_view text, float& value) {
+    double wide;
+    if (!parseCommandArg(text, wide)) {
+        return false;
+    }
+    value = (float)wide;
+    return true;
+}
+
+/**
+ * @brief Describes what an argument of type T must look like, for error messages.
+ */
+template <typename T>
+constexpr const char* commandArgKind() {
+    if constexpr (std::is_same<T, bool>::value) {
+        return "true or false";
+    } else if constexpr (std::is_integral<T>::value) {
+        return std::is_signed<T>::value ? "an integer" : "a non-negative integer";
+    } else if constexpr (std::is_floating_point<T>::value) {
+        return "a number";
+    } else {
+        return "text";
+    }
+}
+
+} // namespace nextino
+
+/**
+ * @struct CommandTable
+ * @brief A minimal perfect-hash table of commands, generated at build time.
+ * @details The build script generates one from the `commands` lists in the
+ *          modules' `config.json` files and installs it in
+ *          `registerAllModuleTypes()`. The entries and displacements are
+ *          constant, so they stay in flash. A command is found with two hashes
+ *          of `<instance> <command>`: the first picks a bucket, whose
+ *          displacement seeds the second, which gives the command's slot.
+ */
+struct CommandTable {
+    struct Entry {
+        const char* instanceName;
+        const char* command;
+    };
+
+    const Entry* entries;          // By slot
+    const uint16_t* displacements; // By bucket
+    uint16_t size;                 // Slots, one per command
+    uint16_t buckets;
+
+    /**
+     * @brief Hashes `<instance> <command>` with 32-bit FNV-1a, starting from the basis XOR `seed`.
+     * @details Must match `_command_hash()` in the build script's code generator.
+     */
+    static constexpr uint32_t hash(uint32_t seed, std::string_view instanceName, std::string_view command) {
+        uint32_t result = 2166136261u ^ seed;
+        for (char c : instanceName) {
+            result = (result ^ (uint8_t)c) * 16777619u;
+        }
+        result = (result ^ (uint8_t)' ') * 16777619u;
+        for (char c : command) {
+            result = (result ^ (uint8_t)c) * 16777619u;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Finds the slot of a command.
+     * @return The slot, or -1 if the table does not declare the command.
+     */
+    int find(std::string_view instanceName, std::string_view command) const;
+};
+
 /**
  * @class CommandRouter
  * @brief A central service for routing text-based commands to modules.
@@ -41,32 +411,329 @@ public:
      */
     bool registerCommand(const std::string& instanceName, const std::string& command, CommandHandler handler);
 
+    /**
+     * @brief Registers a handler that takes its arguments as views and writes into a buffer.
+     * @details Preferred for commands run often: no strings are built on the way in or out.
+     * @see registerCommand(const std::string&, const std::string&, CommandHandler)
+     */
+    bool registerCommand(const std::string& instanceName, const std::string& command, CommandFunction handler);
+
+    /**
+     * @brief Registers a handler that may finish its command later.
+     * @details The handler receives a PendingCommand and returns at once; it
+     *          calls PendingCommand::complete() when the result is ready, for
+     *          example from a Scheduler task, so waiting for a sensor or a bus
+     *          transaction does not stall the loop. Callers that need the
+     *          result use executeAsync(). execute(), executeBatch() and
+     *          executeFrame() return the result if the handler completes before
+     *          returning, and CommandStatus::Pending otherwise; the result is
+     *          then logged.
+     */
+    bool registerCommand(const std::string& instanceName, const std::string& command, AsyncCommandFunction handler);
+
+    /**
+     * @brief Registers a handler that takes typed arguments.
+     * @details The router checks the count of arguments and decodes each into
+     *          its type before calling the handler, straight from the command
+     *          line with no intermediate strings. A wrong count, or an argument
+     *          that does not parse or is out of range for its type, is
+     *          answered with BadArguments and an error message, and the handler
+     *          is not called. Arguments may be integer types, float, double,
+     *          bool and std::string_view. The handler writes its result through
+     *          the typed print() overloads of CommandOutput.
+     * @code
+     * NextinoCommands().registerCommand<int, bool>(getInstanceName(), "set", [this](int level, bool fade, CommandOutput& out) {
+     *     setLevel(level, fade);
+     *     out.print("OK: Level ").print(level);
+     *     return CommandStatus::Ok;
+     * });
+     * @endcode
+     */
+    template <typename... Args, typename Handler,
+              typename std::enable_if<std::is_invocable_r<CommandStatus, Handler&, Args..., CommandOutput&>::value, int>::type = 0>
+    bool registerCommand(const std::string& instanceName, const std::string& command, Handler handler) {
+        static_assert(((std::is_arithmetic<typename std::decay<Args>::type>::value ||
+                        std::is_same<typename std::decay<Args>::type, std::string_view>::value) && ...),
+                      "Command arguments must be integers, floating-point numbers, bools or std::string_view.");
+        return registerCommand(instanceName, command, CommandFunction([handler](const CommandArgs& args, CommandOutput& output) mutable {
+            return invokeTyped<Args...>(handler, args, output, std::index_sequence_for<Args...>());
+        }));
+    }
+
+    /**
+     * @brief Executes a command line without allocating.
+     * @details Splits the line in place at spaces, tabs and line breaks, finds
+     *          the handler and calls it with views of the arguments. The result,
+     *          or an error message, is appended to `output`. A handler
+     *          registered with a CommandHandler still works, through a copy of
+     *          its arguments and result.
+     * @param commandLine The full command line, e.g. "my_led on" or "sensor set_rate 10".
+     * @param output Receives the result or an error message.
+     * @return The status of the command.
+     */
+    CommandStatus execute(std::string_view commandLine, CommandOutput& output);
+
+    /**
+     * @brief Executes many commands in one call, separated by newlines or semicolons.
+     * @details Splits and runs the commands in order in a single pass over the
+     *          text, skipping blank ones. The result of each command run goes to
+     *          `output` on its own line, so line N answers the Nth command run;
+     *          handlers should therefore not write line breaks themselves.
+     * @code
+     * char response[512];
+     * CommandOutput output(response, sizeof(response));
+     * BatchResult result = NextinoCommands().executeBatch("relay_1 on; relay_2 on\nsensor get_value", output,
+     *                                                      BatchMode::StopOnError);
+     * @endcode
+     *          An asynchronous command that has not completed by the time its
+     *          handler returns answers "PENDING: ..." on its line and counts in
+     *          `pending`, not as a failure; its result is logged. Use
+     *          executeAsync() for commands whose results the caller needs.
+     * @param commands The commands, e.g. "relay_1 on; relay_2 off\nsensor get_value".
+     * @param output Receives one line per command run.
+     * @param mode Whether to keep going after a command fails.
+     * @return The counts of commands run, failed and skipped.
+     */
+    BatchResult executeBatch(std::string_view commands, CommandOutput& output, BatchMode mode = BatchMode::ContinueOnError);
+
+    /**
+     * @brief Executes a command and reports its result through a callback.
+     * @details Works with handlers of every form. The completion always runs
+     *          from a later Scheduler pass, never from inside this call, with
+     *          the status and result of the command. An asynchronous handler that
+     *          has not completed within `timeoutMs` finishes with
+     *          CommandStatus::TimedOut.
+     * @code
+     * NextinoCommands().executeAsync("sensor read", [](CommandStatus status, std::string_view output) {
+     *     Serial.write(output.data(), output.size());
+     * });
+     * @endcode
+     * @param commandLine The full command line.
+     * @param completion Called once with the result, unless the command is cancelled.
+     * @param timeoutMs How long the command may run; 0 for no limit.
+     * @return A token for cancel(), or 0 if NEXTINO_COMMAND_MAX_PENDING commands are already running.
+     */
+    CommandToken executeAsync(std::string_view commandLine, CommandCompletion completion,
+                              unsigned long timeoutMs = NEXTINO_COMMAND_TIMEOUT_MS);
+
+    /**
+     * @brief Cancels a command started with executeAsync(), or still pending after execute().
+     * @details Its completion is not called, and its PendingCommand goes stale.
+     * @return False if the token is not of a running or undelivered command.
+     */
+    bool cancel(CommandToken token);
+
+    /**
+     * @brief The number of commands running or waiting to deliver their result.
+     */
+    size_t getPendingCount() const;
+
     /**
      * @brief Executes a command string.
      * @details This is the main entry point. It parses the string, finds the
-     *          correct handler, and executes it.
+     *          correct handler, and executes it. A `CommandHandler` receives
+     *          every argument, even past `NEXTINO_COMMAND_MAX_ARGS`.
      * @param commandString The full command string (e.g., "my_led on", "sensor get_value").
      * @return A string containing the result or an error message from the command.
      */
     std::string execute(const std::string& commandString);
 
+    /**
+     * @brief Installs a generated table of the commands declared in `config.json`.
+     * @details Call before the modules register their commands; the generated
+     *          `registerAllModuleTypes()` does. Declared commands then register
+     *          into the table's slots and are found by perfect hashing, without
+     *          strings or map nodes. Other commands still use the registry map.
+     * @return False if a table is already installed.
+     */
+    bool useCommandTable(const CommandTable& table);
+
+    /**
+     * @brief The first ID of the commands that are not in the generated table.
+     * @details A declared command's ID is its slot in the CommandTable, below
+     *          this value. Other commands get IDs from here up, in the order
+     *          they are first registered.
+     */
+    static constexpr uint16_t FIRST_REGISTERED_ID = 0x8000;
+
+    /**
+     * @brief Gets the numeric ID of a registered command, for binary frames.
+     * @return The ID, or -1 if the command is not registered.
+     */
+    int commandId(std::string_view instanceName, std::string_view command) const;
+
+    /**
+     * @brief Executes a command by its numeric ID with arguments already split.
+     * @details Unlike the text forms, writes no error message: the status says it.
+     * @return The status of the handler, or NotFound.
+     */
+    CommandStatus execute(uint16_t id, const CommandArgs& args, CommandOutput& output);
+
+    /**
+     * @brief Executes a binary request frame and writes the response frame.
+     * @details See CommandFrame.h for the format. The arguments are decoded
+     *          in place: text arguments are views into the request, numbers are
+     *          formatted on the stack, and the handler writes straight into
+     *          the response. An asynchronous command that has not completed
+     *          by the time its handler returns answers CommandStatus::Pending;
+     *          its result is logged, not sent. Use executeAsync() for commands
+     *          whose results the caller needs.
+     * @param frame A complete request, e.g. from a CommandFrameReader.
+     * @param size The size of the request.
+     * @param response Receives the response frame; CommandFrame::MAX_SIZE bytes always suffice.
+     * @param capacity The size of `response`, at least 5.
+     * @return The size of the response, or 0 if the request is not a valid frame.
+     */
+    size_t executeFrame(const uint8_t* frame, size_t size, uint8_t* response, size_t capacity);
+
 private:
-    CommandRouter() {} // Singleton
-    
+    friend class PendingCommand;
+
+    CommandRouter() : _table(nullptr) {} // Singleton
+
+    /**
+     * @brief Splits one command into views, starting at `position`.
+     * @details Stops at the end of `text`, or in a batch at the ';' or line
+     *          break ending the command, and leaves `position` there.
+     * @return The number of tokens, or `max + 1` if there are more than `max`.
+     */
+    static size_t tokenize(std::string_view text, size_t& position, std::string_view* tokens, size_t max, bool batch);
+
     // Internal structure to hold the registered command
     struct RegisteredCommand {
         std::string instanceName;
         std::string command;
+    };
+
+    // The same key as views into a command line, for lookups without copies.
+    struct CommandKey {
+        std::string_view instanceName;
+        std::string_view command;
+    };
+
+    // Orders commands by instance, then command; also compares against a CommandKey.
+    struct CommandLess {
+        using is_transparent = void;
 
-        // Custom comparator for map key
-        bool operator<(const RegisteredCommand& other) const {
-            if (instanceName < other.instanceName) return true;
-            if (instanceName > other.instanceName) return false;
-            return command < other.command;
+        template <typename A, typename B>
+        bool operator()(const A& a, const B& b) const {
+            int order = std::string_view(a.instanceName).compare(std::string_view(b.instanceName));
+            return order != 0 ? order < 0 : std::string_view(a.command) < std::string_view(b.command);
         }
     };
-    
+
+    static constexpr uint16_t NO_ID = 0xFFFF; // A command past the last registered ID
+
+    // A handler in any form; exactly one is set.
+    struct CommandEntry {
+        CommandFunction handler;
+        CommandHandler legacy;
+        AsyncCommandFunction async;
+        uint16_t id = NO_ID;
+
+        bool isSet() const { return handler || legacy || async; }
+    };
+
+    enum class PendingState : uint8_t { Free, Running, Done };
+
+    // An asynchronous command, from its start until its result is delivered.
+    struct PendingSlot {
+        CommandCompletion completion;
+        Scheduler::TaskHandle task = 0; // The timeout while running, then the delivery
+        uint16_t generation = 1;
+        PendingState state = PendingState::Free;
+        bool starting = false;          // Its handler has not returned yet
+        bool hasCaller = false;         // Started by executeAsync(), not execute()
+        CommandStatus status = CommandStatus::Ok;
+        char buffer[NEXTINO_COMMAND_PENDING_OUTPUT_SIZE];
+        CommandOutput output{nullptr, 0};
+    };
+
+    /**
+     * @brief Finds the handler of a command, in the generated table or the registry map.
+     */
+    const CommandEntry* find(std::string_view instanceName, std::string_view command) const;
+
+    /**
+     * @brief Finds the handler of a command by its ID.
+     */
+    const CommandEntry* find(uint16_t id) const;
+
+    /**
+     * @brief Finds the handler of a tokenized command, or writes the error message.
+     * @return The handler, or nullptr with `status` and `output` set.
+     */
+    const CommandEntry* resolve(const std::string_view* tokens, size_t count, CommandOutput& output, CommandStatus& status);
+
+    /**
+     * @brief Resolves a tokenized command and calls its handler.
+     */
+    CommandStatus dispatch(const std::string_view* tokens, size_t count, CommandOutput& output);
+
+    /**
+     * @brief Decodes the arguments of a typed handler, then calls it.
+     */
+    template <typename... Args, typename Handler, size_t... I>
+    static CommandStatus invokeTyped(Handler& handler, const CommandArgs& args, CommandOutput& output, std::index_sequence<I...>) {
+        if (args.size() != sizeof...(Args)) {
+            output.printf("ERROR: Expected %u argument(s), got %u.", (unsigned)sizeof...(Args), (unsigned)args.size());
+            return CommandStatus::BadArguments;
+        }
+        std::tuple<typename std::decay<Args>::type...> values;
+        size_t bad = 0;
+        // Decodes in order, stopping at the first argument that does not parse.
+        bool decoded = (true && ... && (nextino::parseCommandArg(args[I], std::get<I>(values)) || (bad = I, false)));
+        if (!decoded) {
+            static const char* const kinds[] = {nextino::commandArgKind<typename std::decay<Args>::type>()..., ""};
+            output.printf("ERROR: Argument %u must be %s.", (unsigned)(bad + 1), kinds[bad]);
+            return CommandStatus::BadArguments;
+        }
+        return handler(std::get<I>(values)..., output);
+    }
+
+    /**
+     * @brief Calls a synchronous handler of either form.
+     */
+    static CommandStatus invoke(const CommandEntry& entry, const CommandArgs& args, CommandOutput& output);
+
+    /**
+     * @brief Calls a handler of any form for a synchronous caller.
+     */
+    CommandStatus run(const CommandEntry& entry, const CommandArgs& args, CommandOutput& output);
+
+    PendingSlot* startPending(CommandCompletion&& completion, bool hasCaller, CommandToken& token);
+    PendingSlot* resolvePending(CommandToken token);
+    const PendingSlot* resolvePending(CommandToken token) const;
+    CommandOutput* pendingOutput(CommandToken token);
+    bool finishPending(CommandToken token, CommandStatus status);
+    void afterStart(CommandToken token, unsigned long timeoutMs);
+    void scheduleDelivery(CommandToken token);
+    void deliver(CommandToken token);
+    void freePending(PendingSlot& slot);
+
+    bool store(const std::string& instanceName, const std::string& command, CommandEntry&& entry);
+
     // A map where the key is a combination of instance name and command,
     // and the value is the handler function.
-    std::map<RegisteredCommand, CommandHandler> _commandRegistry;
-};
\ No newline at end of file
+    std::map<RegisteredCommand, CommandEntry, CommandLess> _commandRegistry;
+
+    // The generated table of declared commands, and their handlers by slot.
+    const CommandTable* _table;
+    std::unique_ptr<CommandEntry[]> _slots;
+
+    // The commands in the registry map, by ID - FIRST_REGISTERED_ID.
+    std::vector<const CommandEntry*> _registered;
+
+    PendingSlot _pending[NEXTINO_COMMAND_MAX_PENDING];
+};
+
+template <typename Write, typename std::enable_if<std::is_invocable<Write&, CommandOutput&>::value, int>::type>
+bool PendingCommand::complete(CommandStatus status, Write write) {
+    CommandRouter& router = CommandRouter::getInstance();
+    CommandOutput* output = router.pendingOutput(_token);
+    if (!output) {
+        return false;
+    }
+    write(*output);
+    return router.finishPending(_token, status);
+}
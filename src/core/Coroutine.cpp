@@ -0,0 +1,189 @@
+/**
+ * @file        Coroutine.cpp
+ * @title       Coroutine Runtime Implementation
+ * @description Implements the coroutine frame pool and the awaiters that hook
+ *              suspended coroutines into the Scheduler and the EventBus.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-08-31
+ * @version     0.1.0
+ *
+ * @copyright   (c) 2025 Nextino. All rights reserved.
+ * @license     MIT License
+ */
+
+#include "Coroutine.h"
+
+#if NEXTINO_HAS_COROUTINES
+#include <map>
+#include "Logger.h"
+
+/**
+ * @brief Gets the singleton instance of the CoroutinePool.
+ * @details Uses the Meyers' Singleton pattern for thread-safe, guaranteed initialization.
+ * @return A reference to the CoroutinePool.
+ */
+CoroutinePool& CoroutinePool::getInstance() {
+    static CoroutinePool instance;
+    return instance;
+}
+
+CoroutinePool::CoroutinePool()
+    : _freeHead(0), _activeFrames(0), _peakFrames(0), _largestFrame(0), _allocationFailures(0) {
+    static_assert(NEXTINO_COROUTINE_MAX_TASKS > 0 && NEXTINO_COROUTINE_MAX_TASKS < NO_FRAME,
+                  "NEXTINO_COROUTINE_MAX_TASKS must be between 1 and 65534.");
+
+    for (uint16_t i = 0; i < NEXTINO_COROUTINE_MAX_TASKS; ++i) {
+        _nextFree[i] = (i + 1 < NEXTINO_COROUTINE_MAX_TASKS) ? i + 1 : NO_FRAME;
+    }
+}
+
+void* CoroutinePool::allocate(size_t size) noexcept {
+    if (size > _largestFrame) {
+        _largestFrame = size;
+    }
+    if (size > NEXTINO_COROUTINE_FRAME_SIZE || _freeHead == NO_FRAME) {
+        _allocationFailures++;
+        NEXTINO_CORE_LOG(LogLevel::Error, "Coroutine", "Cannot start coroutine: %s (frame %u bytes, slot %u bytes).",
+                         _freeHead == NO_FRAME ? "pool exhausted" : "frame too large",
+                         (unsigned)size, (unsigned)NEXTINO_COROUTINE_FRAME_SIZE);
+        return nullptr;
+    }
+
+    uint16_t index = _freeHead;
+    _freeHead = _nextFree[index];
+    _activeFrames++;
+    if (_activeFrames > _peakFrames) {
+        _peakFrames = _activeFrames;
+    }
+    return _frames[index];
+}
+
+void CoroutinePool::release(void* frame) noexcept {
+    if (!frame) {
+        return;
+    }
+    uint16_t index = (uint16_t)(((unsigned char(*)[NEXTINO_COROUTINE_FRAME_SIZE])frame) - _frames);
+    _nextFree[index] = _freeHead;
+    _freeHead = index;
+    _activeFrames--;
+}
+
+CoroutineStats CoroutinePool::getStats() const {
+    return {NEXTINO_COROUTINE_MAX_TASKS, NEXTINO_COROUTINE_FRAME_SIZE, _activeFrames, _peakFrames, _largestFrame, _allocationFailures};
+}
+
+namespace nextino {
+
+/**
+ * @class EventWaitList
+ * @brief Routes EventBus events to the coroutines waiting for them.
+ * @details One EventBus listener is registered per event, on the first
+ *          wait for it, and removed again once a post leaves nothing waiting.
+ */
+class EventWaitList {
+public:
+    static void add(EventAwaiter* awaiter) {
+        std::map<uint32_t, WaitList>& lists = waitLists();
+        uint32_t id = awaiter->_event.value;
+        auto it = lists.find(id);
+        if (it == lists.end()) {
+            it = lists.emplace(id, WaitList{nullptr, 0}).first;
+            it->second.subscription = EventBus::getInstance().on(awaiter->_event, [id](void* payload) { dispatch(id, payload); });
+        }
+        awaiter->_next = it->second.waiting;
+        it->second.waiting = awaiter;
+    }
+
+private:
+    struct WaitList {
+        EventAwaiter* waiting; // Newest first
+        EventBus::Subscription subscription;
+    };
+
+    static std::map<uint32_t, WaitList>& waitLists() {
+        static std::map<uint32_t, WaitList> lists;
+        return lists;
+    }
+
+    static void dispatch(uint32_t id, void* payload) {
+        std::map<uint32_t, WaitList>& lists = waitLists();
+        auto it = lists.find(id);
+        if (it == lists.end() || it->second.waiting == nullptr) {
+            return;
+        }
+
+        // Detach the whole list first: coroutines that wait for this event
+        // again while being resumed belong to the next post, not this one.
+        EventAwaiter* waiting = it->second.waiting;
+        it->second.waiting = nullptr;
+
+        // The list is newest-first; reverse it so waiters resume in FIFO order.
+        EventAwaiter* ordered = nullptr;
+        while (waiting) {
+            EventAwaiter* next = waiting->_next;
+            waiting->_next = ordered;
+            ordered = waiting;
+            waiting = next;
+        }
+
+        while (ordered) {
+            // Resuming may finish the coroutine and free the awaiter's frame.
+            EventAwaiter* next = ordered->_next;
+            ordered->_payload = payload;
+            ordered->_handle.resume();
+            ordered = next;
+        }
+
+        // Nobody waits again: unsubscribe (safe from within this very listener).
+        it = lists.find(id);
+        if (it != lists.end() && it->second.waiting == nullptr) {
+            EventBus::getInstance().off(it->second.subscription);
+            lists.erase(it);
+        }
+    }
+};
+
+bool SleepAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    Scheduler::TaskHandle task = Scheduler::getInstance().scheduleOnce(_delayMs, [handle]() { handle.resume(); });
+    if (task == 0) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "Coroutine", "sleep(%lu) could not be scheduled; continuing immediately.", _delayMs);
+        return false;
+    }
+    return true;
+}
+
+void EventAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    _handle = handle;
+    EventWaitList::add(this);
+}
+
+bool ConditionAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    Scheduler& scheduler = Scheduler::getInstance();
+    _handle = handle;
+    _deadline = scheduler.nowMicros() + (Scheduler::Timestamp)_timeoutMs * 1000ULL;
+    _poller = scheduler.scheduleRecurring(_pollMs, [this]() { poll(); });
+    if (_poller == 0) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "Coroutine", "until() could not be scheduled; continuing immediately.");
+        return false;
+    }
+    return true;
+}
+
+void ConditionAwaiter::poll() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    if (_condition()) {
+        _met = true;
+    } else if (scheduler.nowMicros() < _deadline) {
+        return;
+    }
+
+    // The awaiter lives in the coroutine frame; do not touch it after resuming.
+    std::coroutine_handle<> handle = _handle;
+    scheduler.cancel(_poller);
+    handle.resume();
+}
+
+} // namespace nextino
+
+#endif // NEXTINO_HAS_COROUTINES
@@ -0,0 +1,255 @@
+/**
+ * @file        Coroutine.h
+ * @title       Scheduler-Driven Coroutine Tasks
+ * @description Defines `NextinoTask`, a C++20 coroutine type that lets a module
+ *              write sequential code (`co_await nextino::sleep(500)`) instead of
+ *              a hand-written state machine. Suspended coroutines are resumed by
+ *              the Scheduler or the EventBus from the main loop. Coroutine frames
+ *              come from a fixed pool (`CoroutinePool`), never the general heap.
+ *              Only available when the compiler supports coroutines
+ *              (`NEXTINO_HAS_COROUTINES`), e.g. with `-std=gnu++20`.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-08-31
+ * @version     0.1.0
+ *
+ * @copyright   (c) 2025 Nextino. All rights reserved.
+ * @license     MIT License
+ */
+
+#pragma once
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define NEXTINO_HAS_COROUTINES 1
+#else
+#define NEXTINO_HAS_COROUTINES 0
+#endif
+
+#if NEXTINO_HAS_COROUTINES
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include "EventBus.h"
+#include "InlineFunction.h"
+#include "Scheduler.h"
+
+/**
+ * @def NEXTINO_COROUTINE_MAX_TASKS
+ * @brief The number of coroutine frames reserved at compile time.
+ */
+#ifndef NEXTINO_COROUTINE_MAX_TASKS
+#define NEXTINO_COROUTINE_MAX_TASKS 16
+#endif
+
+/**
+ * @def NEXTINO_COROUTINE_FRAME_SIZE
+ * @brief The size, in bytes, of each coroutine frame slot.
+ * @details A frame holds the coroutine's parameters, the locals that live
+ *          across a `co_await`, and the awaiter being waited on. Coroutines
+ *          whose frame does not fit fail to start; see CoroutineStats::largestFrame.
+ */
+#ifndef NEXTINO_COROUTINE_FRAME_SIZE
+#define NEXTINO_COROUTINE_FRAME_SIZE 256
+#endif
+
+/**
+ * @struct CoroutineStats
+ * @brief A snapshot of the coroutine frame pool usage.
+ */
+struct CoroutineStats {
+    size_t capacity;             /**< Total number of frames (NEXTINO_COROUTINE_MAX_TASKS). */
+    size_t frameSize;            /**< Bytes per frame (NEXTINO_COROUTINE_FRAME_SIZE). */
+    size_t activeFrames;         /**< Coroutines currently alive. */
+    size_t peakFrames;           /**< Highest number of coroutines ever alive at once. */
+    size_t largestFrame;         /**< Largest frame the compiler requested so far. */
+    uint32_t allocationFailures; /**< Coroutines that could not start (pool full or frame too large). */
+};
+
+/**
+ * @class CoroutinePool
+ * @brief A singleton fixed-block allocator for coroutine frames.
+ * @details Not thread-safe: start coroutines from the main loop only.
+ */
+class CoroutinePool {
+public:
+    static CoroutinePool& getInstance();
+
+    /**
+     * @brief Takes a frame from the pool.
+     * @param size The frame size requested by the compiler.
+     * @return A frame, or nullptr if the pool is full or `size` is too large.
+     */
+    void* allocate(size_t size) noexcept;
+
+    /**
+     * @brief Returns a frame to the pool.
+     */
+    void release(void* frame) noexcept;
+
+    /**
+     * @brief Gets a snapshot of the pool usage counters.
+     */
+    CoroutineStats getStats() const;
+
+private:
+    CoroutinePool();
+
+    // Delete copy constructor and assignment operator to prevent copies
+    CoroutinePool(const CoroutinePool&) = delete;
+    void operator=(const CoroutinePool&) = delete;
+
+    static const uint16_t NO_FRAME = 0xFFFF;
+
+    alignas(std::max_align_t) unsigned char _frames[NEXTINO_COROUTINE_MAX_TASKS][NEXTINO_COROUTINE_FRAME_SIZE];
+    uint16_t _nextFree[NEXTINO_COROUTINE_MAX_TASKS];
+    uint16_t _freeHead;
+    size_t _activeFrames;
+    size_t _peakFrames;
+    size_t _largestFrame;
+    uint32_t _allocationFailures;
+};
+
+/**
+ * @class NextinoTask
+ * @brief The return type of a Nextino coroutine.
+ * @details A coroutine starts running immediately and runs until its first
+ *          `co_await`; from then on the main loop resumes it. Tasks are
+ *          detached: the frame is returned to the pool when the coroutine
+ *          finishes, whether or not the NextinoTask object is kept.
+ *
+ * @code
+ * NextinoTask LedModule::blink() {
+ *     while (true) {
+ *         digitalWrite(_pin, HIGH);
+ *         co_await nextino::sleep(500);
+ *         digitalWrite(_pin, LOW);
+ *         co_await nextino::sleep(500);
+ *     }
+ * }
+ * @endcode
+ */
+class NextinoTask {
+public:
+    struct promise_type {
+        NextinoTask get_return_object() noexcept { return NextinoTask(true); }
+        static NextinoTask get_return_object_on_allocation_failure() noexcept { return NextinoTask(false); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+
+        static void* operator new(size_t size) noexcept { return CoroutinePool::getInstance().allocate(size); }
+        static void operator delete(void* frame) noexcept { CoroutinePool::getInstance().release(frame); }
+    };
+
+    /**
+     * @brief Checks whether the coroutine started.
+     * @return False if no frame was available; the coroutine body never ran.
+     */
+    bool isValid() const { return _valid; }
+
+private:
+    explicit NextinoTask(bool valid) : _valid(valid) {}
+
+    bool _valid;
+};
+
+namespace nextino {
+
+/**
+ * @class SleepAwaiter
+ * @brief Suspends a coroutine for a number of milliseconds. See nextino::sleep().
+ */
+class SleepAwaiter {
+public:
+    explicit SleepAwaiter(unsigned long delayMs) : _delayMs(delayMs) {}
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> handle);
+    void await_resume() const noexcept {}
+
+private:
+    unsigned long _delayMs;
+};
+
+/**
+ * @class EventAwaiter
+ * @brief Suspends a coroutine until an EventBus event is posted. See nextino::event().
+ * @details Waiters form an intrusive list (the nodes live in the suspended
+ *          frames), so waiting allocates nothing beyond the first wait on a
+ *          given event.
+ */
+class EventAwaiter {
+public:
+    explicit EventAwaiter(EventId event) : _event(event), _payload(nullptr), _next(nullptr) {}
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle);
+    void* await_resume() const noexcept { return _payload; }
+
+private:
+    friend class EventWaitList;
+
+    EventId _event;
+    std::coroutine_handle<> _handle;
+    void* _payload;
+    EventAwaiter* _next;
+};
+
+/**
+ * @class ConditionAwaiter
+ * @brief Suspends a coroutine until a condition holds or a timeout expires. See nextino::until().
+ */
+class ConditionAwaiter {
+public:
+    using Condition = InlineFunction<bool(), NEXTINO_SCHEDULER_CALLBACK_SIZE>;
+
+    ConditionAwaiter(Condition condition, unsigned long timeoutMs, unsigned long pollMs)
+        : _condition(condition), _timeoutMs(timeoutMs), _pollMs(pollMs), _deadline(0), _poller(0), _met(false) {}
+
+    bool await_ready() { return _met = _condition(); }
+    bool await_suspend(std::coroutine_handle<> handle);
+    bool await_resume() const noexcept { return _met; }
+
+private:
+    void poll();
+
+    Condition _condition;
+    unsigned long _timeoutMs;
+    unsigned long _pollMs;
+    Scheduler::Timestamp _deadline;
+    Scheduler::TaskHandle _poller;
+    std::coroutine_handle<> _handle;
+    bool _met;
+};
+
+/**
+ * @brief Suspends the calling coroutine for `delayMs` milliseconds.
+ * @details Backed by a one-shot Scheduler task. `sleep(0)` yields until the
+ *          next loop pass. If the Scheduler pool is full the coroutine
+ *          continues immediately and an error is logged.
+ */
+inline SleepAwaiter sleep(unsigned long delayMs) { return SleepAwaiter(delayMs); }
+
+/**
+ * @brief Suspends the calling coroutine until `event` is posted on the EventBus.
+ * @details The coroutine resumes inside `EventBus::post()`, so the payload is
+ *          still valid: `void* payload = co_await nextino::event("button_pressed");`
+ */
+inline EventAwaiter event(EventId event) { return EventAwaiter(event); }
+
+/**
+ * @brief Suspends the calling coroutine until `condition` returns true, for at most `timeoutMs`.
+ * @details The condition is polled every `pollMs` milliseconds from the main
+ *          loop, e.g. to wait for a UART reply or a sensor's data-ready pin.
+ * @return True if the condition was met, false on timeout:
+ *         `bool ready = co_await nextino::until([]() { return Serial.available() > 0; }, 100);`
+ */
+inline ConditionAwaiter until(ConditionAwaiter::Condition condition, unsigned long timeoutMs, unsigned long pollMs = 1) {
+    return ConditionAwaiter(condition, timeoutMs, pollMs);
+}
+
+} // namespace nextino
+
+#endif // NEXTINO_HAS_COROUTINES
@@ -0,0 +1,169 @@
+/**
+ * @file        DeferredQueue.cpp
+ * @title       Deferred Work Queue Implementation
+ * @description Implements the lock-free ring behind the `DeferredQueue` class.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-01
+ * @version     0.1.0
+ *
+ * @copyright   (c) 2025 Nextino. All rights reserved.
+ * @license     MIT License
+ */
+
+#include "DeferredQueue.h"
+#include "WakeSignal.h"
+
+/**
+ * @brief Gets the singleton instance of the DeferredQueue.
+ * @details Uses the Meyers' Singleton pattern. The SystemManager touches it on
+ *          construction, so it exists before any interrupt can post to it.
+ * @return A reference to the DeferredQueue.
+ */
+DeferredQueue& DeferredQueue::getInstance() {
+    static DeferredQueue instance;
+    return instance;
+}
+
+DeferredQueue::DeferredQueue()
+    : _enqueuePosition(0), _dequeuePosition(0), _posted(0), _executed(0), _dropped(0), _overflows(0), _peakDepth(0),
+      _overflowing(false), _wakeSignal(nullptr) {
+    static_assert(NEXTINO_DEFERRED_QUEUE_SIZE >= 2 && (NEXTINO_DEFERRED_QUEUE_SIZE & (NEXTINO_DEFERRED_QUEUE_SIZE - 1)) == 0,
+                  "NEXTINO_DEFERRED_QUEUE_SIZE must be a power of two.");
+    static_assert(NEXTINO_DEFERRED_PAYLOAD_SIZE <= 255, "NEXTINO_DEFERRED_PAYLOAD_SIZE must fit in a byte.");
+
+    // Cell i is free for the producer that claims position i.
+    for (uint32_t i = 0; i < NEXTINO_DEFERRED_QUEUE_SIZE; ++i) {
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+        _cells[i].invoke = nullptr;
+        _cells[i].target = nullptr;
+        _cells[i].size = 0;
+    }
+}
+
+bool NEXTINO_ISR_ATTR DeferredQueue::post(Handler handler, const void* data, size_t size) {
+    return enqueue(&DeferredQueue::invokeRaw, reinterpret_cast<void (*)()>(handler), data, size);
+}
+
+bool NEXTINO_ISR_ATTR DeferredQueue::enqueue(Thunk invoke, void (*target)(), const void* data, size_t size) {
+    if (size > NEXTINO_DEFERRED_PAYLOAD_SIZE) {
+        recordDrop(false);
+        return false;
+    }
+
+    uint32_t position = _enqueuePosition.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+        cell = &_cells[position & MASK];
+        uint32_t sequence = cell->sequence.load(std::memory_order_acquire);
+        int32_t difference = (int32_t)(sequence - position);
+        if (difference == 0) {
+            // The cell is free for this position: try to claim it.
+            if (_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // The consumer has not freed this cell yet: the ring is full.
+            recordDrop(true);
+            return false;
+        } else {
+            // Another producer claimed it first; retry with the new position.
+            position = _enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->invoke = invoke;
+    cell->target = target;
+    cell->size = (uint8_t)size;
+    if (size > 0) {
+        memcpy(cell->data, data, size);
+    }
+    // Publish the entry to the consumer.
+    cell->sequence.store(position + 1, std::memory_order_release);
+
+    _posted.fetch_add(1, std::memory_order_relaxed);
+    uint32_t depth = position + 1 - _dequeuePosition.load(std::memory_order_relaxed);
+    uint32_t peak = _peakDepth.load(std::memory_order_relaxed);
+    while (depth > peak && !_peakDepth.compare_exchange_weak(peak, depth, std::memory_order_relaxed)) {
+    }
+
+    WakeSignal* signal = _wakeSignal.load(std::memory_order_acquire);
+    if (signal) {
+        signal->notify();
+    }
+    return true;
+}
+
+void DeferredQueue::setWakeSignal(WakeSignal* signal) {
+    _wakeSignal.store(signal, std::memory_order_release);
+}
+
+size_t DeferredQueue::drain(size_t maxEntries) {
+    size_t count = 0;
+    uint32_t position = _dequeuePosition.load(std::memory_order_relaxed);
+    while (count < maxEntries) {
+        Cell& cell = _cells[position & MASK];
+        uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (sequence != position + 1) {
+            // Empty, or the next producer has claimed the cell but not yet
+            // published it. Later entries wait for it, preserving order.
+            break;
+        }
+
+        // Copy the entry out and free the cell before running the handler, so
+        // producers (including the handler itself) can reuse it right away.
+        Thunk invoke = cell.invoke;
+        void (*target)() = cell.target;
+        size_t size = cell.size;
+        alignas(std::max_align_t) unsigned char data[NEXTINO_DEFERRED_PAYLOAD_SIZE];
+        memcpy(data, cell.data, size);
+        cell.sequence.store(position + NEXTINO_DEFERRED_QUEUE_SIZE, std::memory_order_release);
+        position++;
+        _dequeuePosition.store(position, std::memory_order_relaxed);
+
+        invoke(target, data, size);
+        count++;
+    }
+
+    if (count > 0) {
+        _executed.fetch_add((uint32_t)count, std::memory_order_relaxed);
+        _overflowing.store(false, std::memory_order_relaxed);
+    }
+    return count;
+}
+
+bool DeferredQueue::isEmpty() const {
+    uint32_t position = _dequeuePosition.load(std::memory_order_relaxed);
+    return _cells[position & MASK].sequence.load(std::memory_order_acquire) != position + 1;
+}
+
+DeferredQueueStats DeferredQueue::getStats() const {
+    DeferredQueueStats stats;
+    stats.capacity = NEXTINO_DEFERRED_QUEUE_SIZE;
+    stats.pending = _enqueuePosition.load(std::memory_order_relaxed) - _dequeuePosition.load(std::memory_order_relaxed);
+    stats.peakDepth = _peakDepth.load(std::memory_order_relaxed);
+    stats.posted = _posted.load(std::memory_order_relaxed);
+    stats.executed = _executed.load(std::memory_order_relaxed);
+    stats.dropped = _dropped.load(std::memory_order_relaxed);
+    stats.overflows = _overflows.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void DeferredQueue::resetStats() {
+    _posted.store(0);
+    _executed.store(0);
+    _dropped.store(0);
+    _overflows.store(0);
+    _peakDepth.store(0);
+}
+
+void NEXTINO_ISR_ATTR DeferredQueue::recordDrop(bool full) {
+    _dropped.fetch_add(1, std::memory_order_relaxed);
+    if (full && !_overflowing.exchange(true, std::memory_order_relaxed)) {
+        _overflows.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void DeferredQueue::invokeRaw(void (*target)(), const void* data, size_t size) {
+    reinterpret_cast<Handler>(target)(data, size);
+}
@@ -0,0 +1,190 @@
+/**
+ * @file        DeferredQueue.h
+ * @title       Lock-Free Deferred Work Queue
+ * @description Defines the `DeferredQueue` singleton, a fixed-size, lock-free
+ *              multi-producer/single-consumer ring that hands work from ISRs,
+ *              FreeRTOS tasks or host threads to the main loop. Producers post a
+ *              function pointer plus a small copied payload; the SystemManager
+ *              drains the ring in batches at the start of every loop pass.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-01
+ * @version     0.1.0
+ *
+ * @copyright   (c) 2025 Nextino. All rights reserved.
+ * @license     MIT License
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "Platform.h"
+
+class WakeSignal;
+
+/**
+ * @def NEXTINO_DEFERRED_QUEUE_SIZE
+ * @brief The number of entries in the ring. Must be a power of two.
+ */
+#ifndef NEXTINO_DEFERRED_QUEUE_SIZE
+#define NEXTINO_DEFERRED_QUEUE_SIZE 32
+#endif
+
+/**
+ * @def NEXTINO_DEFERRED_PAYLOAD_SIZE
+ * @brief The payload bytes copied with each entry, e.g. a pin number and a timestamp.
+ */
+#ifndef NEXTINO_DEFERRED_PAYLOAD_SIZE
+#define NEXTINO_DEFERRED_PAYLOAD_SIZE 8
+#endif
+
+/**
+ * @def NEXTINO_DEFERRED_BATCH_SIZE
+ * @brief The most entries run per main-loop pass, so an interrupt storm cannot starve the modules.
+ */
+#ifndef NEXTINO_DEFERRED_BATCH_SIZE
+#define NEXTINO_DEFERRED_BATCH_SIZE 16
+#endif
+
+/**
+ * @struct DeferredQueueStats
+ * @brief A snapshot of the deferred queue counters.
+ */
+struct DeferredQueueStats {
+    size_t capacity;    /**< Ring size (NEXTINO_DEFERRED_QUEUE_SIZE). */
+    size_t pending;     /**< Entries waiting to run. */
+    size_t peakDepth;   /**< Highest number of entries ever waiting at once. */
+    uint32_t posted;    /**< Entries accepted by post(). */
+    uint32_t executed;  /**< Entries run by drain(). */
+    uint32_t dropped;   /**< Entries rejected: ring full or payload too large. */
+    uint32_t overflows; /**< Times the ring filled up (a burst of drops counts once). */
+};
+
+/**
+ * @class DeferredQueue
+ * @brief A singleton lock-free MPSC ring for work deferred to the main loop.
+ * @details Based on Dmitry Vyukov's bounded queue: each cell carries a sequence
+ *          number, producers claim a cell with a single compare-and-swap, and
+ *          nothing ever blocks or allocates. `post()` is safe from ISRs (it is
+ *          placed in IRAM on ESP32), other tasks and threads; `drain()` must
+ *          only be called from the main loop.
+ *
+ * @code
+ * void IRAM_ATTR onButtonEdge() {
+ *     uint32_t at = micros();
+ *     DeferredQueue::getInstance().post(&ButtonModule::onEdge, at);
+ * }
+ * @endcode
+ */
+class DeferredQueue {
+public:
+    /**
+     * @typedef Handler
+     * @brief Runs on the main loop with a copy of the posted payload.
+     */
+    using Handler = void (*)(const void* data, size_t size);
+
+    static DeferredQueue& getInstance();
+
+    /**
+     * @brief Queues a handler and a copy of `size` bytes of `data`.
+     * @details Lock-free and wait-free unless producers race for the same cell.
+     *          Wakes the main loop if it is sleeping in an idle mode.
+     * @param handler The function to run on the main loop.
+     * @param data (Optional) The payload to copy.
+     * @param size The payload size, at most NEXTINO_DEFERRED_PAYLOAD_SIZE.
+     * @return True if queued, false if dropped (ring full or payload too large).
+     */
+    bool post(Handler handler, const void* data = nullptr, size_t size = 0);
+
+    /**
+     * @brief Queues a typed handler and a copy of `value`.
+     * @tparam T A trivially copyable type of at most NEXTINO_DEFERRED_PAYLOAD_SIZE bytes.
+     * @return True if queued, false if the ring was full.
+     */
+    template <typename T>
+    bool NEXTINO_ISR_ATTR post(void (*handler)(const T& value), const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Deferred payloads are copied byte-wise.");
+        static_assert(sizeof(T) <= NEXTINO_DEFERRED_PAYLOAD_SIZE, "Payload too large; raise NEXTINO_DEFERRED_PAYLOAD_SIZE.");
+        return enqueue(&invokeTyped<T>, reinterpret_cast<void (*)()>(handler), &value, sizeof(T));
+    }
+
+    /**
+     * @brief Sets the signal post() notifies, so the main loop wakes for new work.
+     * @details The SystemManager passes its own on construction. The pointer is
+     *          cached because an ISR running from IRAM must not call into the
+     *          SystemManager singleton, whose accessor lives in flash.
+     */
+    void setWakeSignal(WakeSignal* signal);
+
+    /**
+     * @brief Runs queued entries in FIFO order (per producer). Main loop only.
+     * @param maxEntries The most entries to run in this call.
+     * @return The number of entries run.
+     */
+    size_t drain(size_t maxEntries = NEXTINO_DEFERRED_BATCH_SIZE);
+
+    /**
+     * @brief Checks whether any entry is waiting.
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Gets a snapshot of the queue counters.
+     */
+    DeferredQueueStats getStats() const;
+
+    /**
+     * @brief Clears the counters (not the queued entries).
+     */
+    void resetStats();
+
+private:
+    DeferredQueue();
+
+    // Delete copy constructor and assignment operator to prevent copies
+    DeferredQueue(const DeferredQueue&) = delete;
+    void operator=(const DeferredQueue&) = delete;
+
+    using Thunk = void (*)(void (*target)(), const void* data, size_t size);
+
+    /**
+     * @struct Cell
+     * @brief One ring entry. `sequence` tells producers and the consumer whose turn it is.
+     */
+    struct Cell {
+        std::atomic<uint32_t> sequence;
+        Thunk invoke;
+        void (*target)();
+        uint8_t size;
+        alignas(std::max_align_t) unsigned char data[NEXTINO_DEFERRED_PAYLOAD_SIZE];
+    };
+
+    static const uint32_t MASK = NEXTINO_DEFERRED_QUEUE_SIZE - 1;
+
+    bool enqueue(Thunk invoke, void (*target)(), const void* data, size_t size);
+    void recordDrop(bool full);
+
+    static void invokeRaw(void (*target)(), const void* data, size_t size);
+
+    template <typename T>
+    static void invokeTyped(void (*target)(), const void* data, size_t) {
+        T value;
+        memcpy(&value, data, sizeof(T));
+        reinterpret_cast<void (*)(const T&)>(target)(value);
+    }
+
+    Cell _cells[NEXTINO_DEFERRED_QUEUE_SIZE];
+    std::atomic<uint32_t> _enqueuePosition;
+    std::atomic<uint32_t> _dequeuePosition; // Written by the consumer only
+    std::atomic<uint32_t> _posted;
+    std::atomic<uint32_t> _executed;
+    std::atomic<uint32_t> _dropped;
+    std::atomic<uint32_t> _overflows;
+    std::atomic<uint32_t> _peakDepth;
+    std::atomic<bool> _overflowing;
+    std::atomic<WakeSignal*> _wakeSignal;
+};
@@ -16,6 +16,9 @@
 #elif defined(ARDUINO_ARCH_AVR)
     #include <EEPROM.h>
     #include <Arduino.h> // For randomSeed() and analogRead()
+#elif !defined(ARDUINO)
+    #include <stdint.h>
+    #include <random> // Host builds have no Arduino random() helpers
 #endif
 
 // Define a "magic number" and EEPROM address for AVR-based persistent ID.
@@ -77,6 +80,15 @@ void DeviceIdentity::generateId() {
         }
     }
 
+#elif !defined(ARDUINO)
+    platform = "host";
+    // Host (native) builds are used for tests and benchmarks only, so a
+    // non-persistent random ID is sufficient.
+    std::random_device rd;
+    for (int i = 0; i < UNIQUE_ID_LENGTH; ++i) {
+        idBytes[i] = (uint8_t)(rd() & 0xFF);
+    }
+
 #else
     // Fallback for any other unsupported platform
     // This part will use a non-persistent random ID for now.
@@ -5,14 +5,21 @@
  *
  * @author      Giorgi Magradze
  * @date        2025-08-21
- * @version     0.1.0
+ * @version     0.2.0
  *
  * @copyright   (c) 2025 Nextino. All rights reserved.
  * @license     MIT License
  */
 
 #include "EventBus.h"
+#include "EventRecorder.h"
 #include "Logger.h" // For internal logging
+#include "Platform.h"
+#include "Scheduler.h" // For the rate-control clock and coalesced deliveries
+#include "WakeSignal.h" // To wake the main loop when another task posts
+#include <string.h> // For memcpy, strlen, strcmp
+#include <algorithm> // For std::lower_bound
+#include <utility>  // For std::move
 
 /**
 * @brief Gets the singleton instance of the EventBus.
@@ -24,20 +31,1059 @@ EventBus &EventBus::getInstance() {
     return instance;
 }
 
-void EventBus::on(const std::string& eventName, EventCallback callback) {
-    // Add the callback to the vector for the given event name.
-    _listeners[eventName].push_back(callback);
-    NEXTINO_CORE_LOG(LogLevel::Debug, "EventBus", "New listener subscribed to event '%s'.", eventName.c_str());
+EventBus::EventBus()
+    : _freeTopicSubscription(NO_SLOT), _activeTopicSubscriptions(0), _queueFullPolicy(QueueFullPolicy::DropOldest), _queuedEvents(0), _peakQueuedEvents(0), _postedAsync(0),
+      _dispatchedAsync(0), _droppedAsync(0), _blockedAsync(0), _multiProducer(false), _owner(nullptr), _inboxEnqueue(0), _inboxDequeue(0),
+      _forwarded(0), _inboxDropped(0), _unreportedRawPayloads(0), _unreportedOversized(0), _unreportedLongNames(0), _unreportedUnnamed(0), _wakeSignal(nullptr), _recorder(nullptr),
+      _dispatchDepth(0) {
+    static_assert(NEXTINO_EVENTBUS_MAX_EVENTS >= 2 && (NEXTINO_EVENTBUS_MAX_EVENTS & (NEXTINO_EVENTBUS_MAX_EVENTS - 1)) == 0,
+                  "NEXTINO_EVENTBUS_MAX_EVENTS must be a power of two.");
+    static_assert(NEXTINO_EVENTBUS_MAX_EVENTS <= TOPIC_INDEX, "Subscription handles hold at most 128 event slots.");
+    static_assert(NEXTINO_EVENTBUS_INBOX_SIZE >= 2 && (NEXTINO_EVENTBUS_INBOX_SIZE & (NEXTINO_EVENTBUS_INBOX_SIZE - 1)) == 0,
+                  "NEXTINO_EVENTBUS_INBOX_SIZE must be a power of two.");
+    for (auto& entry : _events) {
+        entry.id = 0;
+        entry.type = nullptr;
+        entry.name = nullptr;
+        entry.rate = NO_RATE;
+    }
+    for (auto& rate : _rates) {
+        rate.mode = EventRateMode::Unlimited;
+        rate.pending = false;
+        rate.pooled = false;
+        rate.flushTask = 0;
+    }
+    for (auto& queue : _queues) {
+        queue.head = 0;
+        queue.count = 0;
+    }
+    // Inbox cell i is free for the producer that claims position i.
+    for (uint32_t i = 0; i < NEXTINO_EVENTBUS_INBOX_SIZE; ++i) {
+        _inbox[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+EventBus::EventEntry* EventBus::findSlot(uint32_t id) {
+    uint32_t index = id & MASK;
+    for (uint32_t probes = 0; probes < NEXTINO_EVENTBUS_MAX_EVENTS; ++probes) {
+        EventEntry& entry = _events[index];
+        if (entry.id == id || entry.id == 0) {
+            return &entry;
+        }
+        index = (index + 1) & MASK;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Hashes one level of a topic, `[begin, end)`, like EventId::hash().
+ */
+static uint32_t hashLevel(const char* begin, const char* end) {
+    uint32_t result = 2166136261u;
+    while (begin != end) {
+        result = (result ^ (uint8_t)*begin++) * 16777619u;
+    }
+    return result;
+}
+
+EventBus::Subscription EventBus::on(EventId event, EventCallback callback) {
+    if (rejectForeign("on")) {
+        return 0;
+    }
+    if (event.name && isTopicFilter(event.name)) {
+        return onTopic(event.name, std::move(callback));
+    }
+
+    EventEntry* entry = findSlot(event.value);
+    if (!entry) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "EventBus", "Event table full (%u events). Raise NEXTINO_EVENTBUS_MAX_EVENTS.",
+                         (unsigned)NEXTINO_EVENTBUS_MAX_EVENTS);
+        return 0;
+    }
+    if (!checkName(entry, event, true)) {
+        return 0;
+    }
+
+    uint16_t slot = entry->listeners.add(std::move(callback));
+    if (slot == NO_SLOT) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "EventBus", "Event 0x%08lx already has %u listeners.", (unsigned long)event.value,
+                         (unsigned)MAX_SUBSCRIPTIONS);
+        return 0;
+    }
+
+    // Claim the table slot on the first subscription.
+    entry->id = event.value;
+    NEXTINO_CORE_LOG(LogLevel::Debug, "EventBus", "New listener subscribed to event 0x%08lx.", (unsigned long)event.value);
+    return (uint32_t)(entry - _events) | ((uint32_t)slot << EVENT_BITS) |
+           ((uint32_t)entry->listeners.slots[slot].generation << (EVENT_BITS + SLOT_BITS));
+}
+
+bool EventBus::off(Subscription subscription) {
+    uint32_t index = subscription & ((1u << EVENT_BITS) - 1);
+    uint16_t slot = (subscription >> EVENT_BITS) & (MAX_SUBSCRIPTIONS - 1);
+    uint16_t generation = (uint16_t)(subscription >> (EVENT_BITS + SLOT_BITS));
+    if (subscription == 0 || rejectForeign("off")) {
+        return false;
+    }
+    if (index == TOPIC_INDEX) {
+        return offTopic(slot, generation);
+    }
+    if (index >= NEXTINO_EVENTBUS_MAX_EVENTS || !_events[index].listeners.remove(slot, generation)) {
+        return false;
+    }
+    NEXTINO_CORE_LOG(LogLevel::Debug, "EventBus", "Listener unsubscribed from event 0x%08lx.", (unsigned long)_events[index].id);
+    return true;
+}
+
+void NEXTINO_ISR_ATTR EventBus::post(EventId event, void* payload) {
+    postSized(event, payload, EventRecorder::SIZE_UNKNOWN, nullptr);
+}
+
+bool NEXTINO_ISR_ATTR EventBus::postSized(EventId event, void* payload, size_t size, const void* type) {
+    if (isForeignThread()) {
+        // Listeners run on the owner task; a raw payload would not outlive this call.
+        // The caller may be an ISR, so the drop is logged later, by the owner.
+        if (payload) {
+            _inboxDropped.fetch_add(1, std::memory_order_relaxed);
+            _unreportedRawPayloads.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return forward(event, nullptr, 0, EventPriority::Normal, false);
+    }
+
+    EventEntry* entry = findSlot(event.value);
+    if (entry && entry->id != event.value) {
+        entry = nullptr;
+    }
+    if (entry && !checkName(entry, event, false)) {
+        return false;
+    }
+    // Typed listeners cast the payload: only their own type may reach them.
+    if (payload && entry && entry->type && entry->type != type) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "EventBus", "Event 0x%08lx posted with the wrong payload type.", (unsigned long)event.value);
+        return false;
+    }
+    NEXTINO_CORE_LOG(LogLevel::Debug, "EventBus", "Posting event 0x%08lx.", (unsigned long)event.value);
+    if (_recorder) {
+        _recorder->record(EventRecorder::Sync, EventPriority::Normal, event, payload, size);
+    }
+
+    if (entry && entry->rate != NO_RATE && !admit(_rates[entry->rate], Scheduler::getInstance().nowMicros())) {
+        return true;
+    }
+    deliver(entry, event, payload);
+    return true;
+}
+
+void EventBus::deliver(EventEntry* entry, EventId event, void* payload) {
+    _dispatchDepth++;
+    // Call the listeners registered for this event, if any.
+    if (entry) {
+        entry->listeners.dispatch(payload);
+    }
+
+    // Then the listeners of matching topic filters, if there are any.
+    if (_activeTopicSubscriptions > 0 && event.name) {
+        matchTopic(0, event.name, payload);
+    }
+    _dispatchDepth--;
+}
+
+uint16_t EventBus::ListenerList::add(EventCallback&& callback) {
+    if (dirty && dispatching == 0) {
+        settle();
+    }
+
+    // Take a free subscription slot, or a new one.
+    uint16_t slot = freeSlot;
+    if (slot != NO_SLOT) {
+        freeSlot = slots[slot].position;
+    } else if (slots.size() < MAX_SUBSCRIPTIONS) {
+        slot = (uint16_t)slots.size();
+        slots.push_back({0, 1});
+    } else {
+        return NO_SLOT;
+    }
+
+    // During a dispatch the listener waits in `pending`, so the array being
+    // iterated never moves.
+    if (dispatching > 0) {
+        slots[slot].position = (uint16_t)(listeners.size() + pending.size());
+        pending.push_back({std::move(callback), slot});
+        dirty = true;
+    } else {
+        slots[slot].position = (uint16_t)listeners.size();
+        listeners.push_back({std::move(callback), slot});
+    }
+    return slot;
+}
+
+bool EventBus::ListenerList::remove(uint16_t slot, uint16_t generation) {
+    if (slot >= slots.size() || slots[slot].generation != generation) {
+        return false;
+    }
+    size_t position = slots[slot].position;
+    Listener* listener = position < listeners.size()                     ? &listeners[position]
+                         : position - listeners.size() < pending.size() ? &pending[position - listeners.size()]
+                                                                         : nullptr;
+    if (!listener || listener->slot != slot) {
+        return false; // A free slot
+    }
+
+    // Only mark the listener: it may be running right now. Outside a
+    // dispatch, its captured state can be released at once.
+    listener->slot = NO_SLOT;
+    if (dispatching == 0) {
+        listener->callback = nullptr;
+    }
+    dirty = true;
+
+    uint16_t next = (slots[slot].generation + 1) & GENERATION_MASK;
+    slots[slot].generation = next != 0 ? next : 1;
+    slots[slot].position = freeSlot;
+    freeSlot = slot;
+    return true;
+}
+
+void EventBus::ListenerList::dispatch(void* payload) {
+    // Index rather than iterate: listeners may subscribe and unsubscribe
+    // meanwhile, which only marks this array.
+    dispatching++;
+    for (size_t i = 0, count = listeners.size(); i < count; ++i) {
+        const Listener& listener = listeners[i];
+        if (listener.slot != NO_SLOT) {
+            listener.callback(payload);
+        }
+    }
+    if (--dispatching == 0 && dirty) {
+        settle();
+    }
+}
+
+void EventBus::ListenerList::settle() {
+    for (auto& listener : pending) {
+        listeners.push_back(std::move(listener));
+    }
+    pending.clear();
+
+    size_t kept = 0;
+    for (size_t i = 0; i < listeners.size(); ++i) {
+        if (listeners[i].slot == NO_SLOT) {
+            continue;
+        }
+        if (kept != i) {
+            listeners[kept] = std::move(listeners[i]);
+        }
+        slots[listeners[kept].slot].position = (uint16_t)kept;
+        kept++;
+    }
+    listeners.erase(listeners.begin() + kept, listeners.end());
+    dirty = false;
+}
+
+bool EventBus::isTopicFilter(const char* name) {
+    const char* level = name;
+    for (const char* c = name;; ++c) {
+        if (*c == '/' || *c == '\0') {
+            if (c - level == 1 && (*level == '+' || *level == '#')) {
+                return true;
+            }
+            if (*c == '\0') {
+                return false;
+            }
+            level = c + 1;
+        }
+    }
+}
+
+EventBus::Subscription EventBus::onTopic(const char* filter, EventCallback&& callback) {
+    if (_topicNodes.empty()) {
+        _topicNodes.emplace_back(); // The root
+    }
+
+    // Walk the filter level by level, creating the missing nodes.
+    uint32_t node = 0;
+    bool rest = false;
+    const char* level = filter;
+    while (true) {
+        const char* end = level;
+        while (*end && *end != '/') {
+            end++;
+        }
+        if (end - level == 1 && *level == '#') {
+            if (*end != '\0') {
+                NEXTINO_CORE_LOG(LogLevel::Error, "EventBus", "Topic filter '%s': '#' must be the last level.", filter);
+                return 0;
+            }
+            rest = true;
+            break;
+        }
+        if (end - level == 1 && *level == '+') {
+            if (_topicNodes[node].plus == NO_NODE) {
+                _topicNodes.emplace_back();
+                _topicNodes[node].plus = (uint32_t)(_topicNodes.size() - 1);
+            }
+            node = _topicNodes[node].plus;
+        } else {
+            node = topicChild(node, hashLevel(level, end), true);
+        }
+        if (*end == '\0') {
+            break;
+        }
+        level = end + 1;
+    }
+
+    // Take a free topic subscription, or a new one.
+    uint16_t index = _freeTopicSubscription;
+    if (index == NO_SLOT && _topicSubscriptions.size() >= MAX_SUBSCRIPTIONS) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "EventBus", "Too many topic filter subscriptions (%u).", (unsigned)MAX_SUBSCRIPTIONS);
+        return 0;
+    }
+    TopicNode& target = _topicNodes[node];
+    ListenerList& list = rest ? target.rest : target.exact;
+    uint16_t slot = list.add(std::move(callback));
+    if (slot == NO_SLOT) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "EventBus", "Topic filter '%s' already has %u listeners.", filter, (unsigned)MAX_SUBSCRIPTIONS);
+        return 0;
+    }
+    if (index != NO_SLOT) {
+        _freeTopicSubscription = (uint16_t)_topicSubscriptions[index].node;
+    } else {
+        index = (uint16_t)_topicSubscriptions.size();
+        _topicSubscriptions.push_back({NO_NODE, NO_SLOT, 0, 1, false});
+    }
+
+    TopicSubscription& subscription = _topicSubscriptions[index];
+    subscription.node = node;
+    subscription.slot = slot;
+    subscription.listGeneration = list.slots[slot].generation;
+    subscription.rest = rest;
+    _activeTopicSubscriptions++;
+    NEXTINO_CORE_LOG(LogLevel::Debug, "EventBus", "New listener subscribed to topic filter '%s'.", filter);
+    return TOPIC_INDEX | ((uint32_t)index << EVENT_BITS) | ((uint32_t)subscription.generation << (EVENT_BITS + SLOT_BITS));
+}
+
+bool EventBus::offTopic(uint16_t index, uint16_t generation) {
+    if (index >= _topicSubscriptions.size()) {
+        return false;
+    }
+    TopicSubscription& subscription = _topicSubscriptions[index];
+    if (subscription.slot == NO_SLOT || subscription.generation != generation) {
+        return false;
+    }
+
+    TopicNode& node = _topicNodes[subscription.node];
+    (subscription.rest ? node.rest : node.exact).remove(subscription.slot, subscription.listGeneration);
+
+    // Trie nodes are kept: an emptied path costs nothing but its memory.
+    uint16_t next = (subscription.generation + 1) & GENERATION_MASK;
+    subscription.generation = next != 0 ? next : 1;
+    subscription.slot = NO_SLOT;
+    subscription.node = _freeTopicSubscription;
+    _freeTopicSubscription = index;
+    _activeTopicSubscriptions--;
+    NEXTINO_CORE_LOG(LogLevel::Debug, "EventBus", "Listener unsubscribed from a topic filter.");
+    return true;
+}
+
+uint32_t EventBus::topicChild(uint32_t node, uint32_t level, bool create) {
+    std::vector<TopicChild>& children = _topicNodes[node].children;
+    auto it = std::lower_bound(children.begin(), children.end(), level,
+                               [](const TopicChild& child, uint32_t value) { return child.level < value; });
+    if (it != children.end() && it->level == level) {
+        return it->node;
+    }
+    if (!create) {
+        return NO_NODE;
+    }
+
+    uint32_t child = (uint32_t)_topicNodes.size();
+    children.insert(it, {level, child});
+    _topicNodes.emplace_back(); // After the insert: `children` is not referenced again
+    return child;
+}
+
+void EventBus::matchTopic(uint32_t node, const char* levels, void* payload) {
+    // A `#` here matches whatever is left, even nothing.
+    _topicNodes[node].rest.dispatch(payload);
+    if (!levels) {
+        _topicNodes[node].exact.dispatch(payload);
+        return;
+    }
+
+    const char* end = levels;
+    while (*end && *end != '/') {
+        end++;
+    }
+    const char* next = *end ? end + 1 : nullptr;
+
+    uint32_t child = topicChild(node, hashLevel(levels, end), false);
+    if (child != NO_NODE) {
+        matchTopic(child, next, payload);
+    }
+    uint32_t plus = _topicNodes[node].plus;
+    if (plus != NO_NODE) {
+        matchTopic(plus, next, payload);
+    }
+}
+
+bool EventBus::topicMatches(uint32_t node, const char* levels) {
+    const TopicNode& current = _topicNodes[node];
+    if (!current.rest.listeners.empty() || !current.rest.pending.empty()) {
+        return true;
+    }
+    if (!levels) {
+        return !current.exact.listeners.empty() || !current.exact.pending.empty();
+    }
+
+    const char* end = levels;
+    while (*end && *end != '/') {
+        end++;
+    }
+    const char* next = *end ? end + 1 : nullptr;
+
+    uint32_t child = topicChild(node, hashLevel(levels, end), false);
+    if (child != NO_NODE && topicMatches(child, next)) {
+        return true;
+    }
+    uint32_t plus = _topicNodes[node].plus;
+    return plus != NO_NODE && topicMatches(plus, next);
+}
+
+EventBus::Subscription EventBus::onTyped(EventId event, EventCallback callback, const void* type) {
+    if (event.name && isTopicFilter(event.name)) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "EventBus", "Typed channels need an exact event name, not the filter '%s'.", event.name);
+        return 0;
+    }
+    EventEntry* entry = findSlot(event.value);
+    if (entry && entry->id == event.value && entry->type && entry->type != type) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "EventBus", "Event 0x%08lx already carries another payload type.", (unsigned long)event.value);
+        return 0;
+    }
+    if (!entry) {
+        return on(event, callback); // Logs the full table
+    }
+
+    entry->type = type;
+    return on(event, callback);
+}
+
+bool EventBus::acceptsType(EventId event, const void* type) {
+    if (isForeignThread()) {
+        return true; // The table belongs to the owner task; its posts are checked
+    }
+    EventEntry* entry = findSlot(event.value);
+    if (entry && entry->id == event.value && entry->type && entry->type != type) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "EventBus", "Event 0x%08lx posted with the wrong payload type.", (unsigned long)event.value);
+        return false;
+    }
+    return true;
+}
+
+const void* EventBus::typeOf(EventId event) {
+    EventEntry* entry = findSlot(event.value);
+    return entry && entry->id == event.value ? entry->type : nullptr;
+}
+
+bool EventBus::postTyped(EventId event, const void* payload, size_t size, const void* type) {
+    // Plain listeners see the same object; the channel only ever hands it out as const.
+    return postSized(event, const_cast<void*>(payload), size, type);
+}
+
+bool NEXTINO_ISR_ATTR EventBus::postAsync(EventId event, const void* data, size_t size, EventPriority priority) {
+    return postQueued(event, data, size, priority, nullptr);
+}
+
+bool NEXTINO_ISR_ATTR EventBus::postQueued(EventId event, const void* data, size_t size, EventPriority priority, const void* type) {
+    bool foreign = isForeignThread();
+    if (size > NEXTINO_EVENTBUS_PAYLOAD_SIZE) {
+        if (foreign) {
+            // Possibly an ISR: no logging here; the owner reports it.
+            _inboxDropped.fetch_add(1, std::memory_order_relaxed);
+            _unreportedOversized.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _droppedAsync++;
+        NEXTINO_CORE_LOG(LogLevel::Error, "EventBus", "Payload of %u bytes too large to queue (max %u).", (unsigned)size,
+                         (unsigned)NEXTINO_EVENTBUS_PAYLOAD_SIZE);
+        return false;
+    }
+    if (foreign) {
+        return forward(event, data, size, priority, false);
+    }
+    if (size > 0 && !acceptsType(event, type)) {
+        _droppedAsync++;
+        return false;
+    }
+    return enqueue(event, data, size, priority, false, nextinoMicros64());
 }
 
-void EventBus::post(const std::string& eventName, void* payload) {
-    NEXTINO_CORE_LOG(LogLevel::Debug, "EventBus", "Posting event '%s'.", eventName.c_str());
+bool EventBus::postPooled(EventId event, void* payload, EventPriority priority, const void* type) {
+    static_assert(sizeof(void*) <= NEXTINO_EVENTBUS_PAYLOAD_SIZE, "A queued payload must hold a pointer.");
+    bool foreign = isForeignThread();
+    if (!payload) {
+        if (foreign) {
+            _inboxDropped.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            _droppedAsync++;
+        }
+        return false;
+    }
+    if (!foreign && !acceptsType(event, type)) {
+        _droppedAsync++;
+        return false;
+    }
+
+    EventPayloadPool& pool = EventPayloadPool::getInstance();
+    pool.retain(payload);
+    bool queued = foreign ? forward(event, &payload, sizeof(payload), priority, true)
+                          : enqueue(event, &payload, sizeof(payload), priority, true, nextinoMicros64());
+    if (!queued) {
+        pool.release(payload);
+    }
+    return queued;
+}
+
+void EventBus::postShared(EventId event, void* payload) {
+    if (isForeignThread()) {
+        postPooled(event, payload, EventPriority::Normal, nullptr);
+    } else {
+        postSized(event, payload, payload ? EventPayloadPool::getInstance().sizeOf(payload) : 0, nullptr);
+    }
+}
+
+void EventBus::releasePooled(const unsigned char* data) {
+    void* payload;
+    memcpy(&payload, data, sizeof(payload));
+    EventPayloadPool::getInstance().release(payload);
+}
+
+bool EventBus::enqueue(EventId event, const void* data, size_t size, EventPriority priority, bool pooled, uint64_t postedAt) {
+    if (_recorder) {
+        if (pooled) {
+            void* payload;
+            memcpy(&payload, data, sizeof(payload));
+            _recorder->record(EventRecorder::Pooled, priority, event, payload, EventPayloadPool::getInstance().sizeOf(payload));
+        } else {
+            _recorder->record(EventRecorder::Async, priority, event, size > 0 ? data : nullptr, size);
+        }
+    }
+
+    // A rate control decides before the event takes queue space.
+    EventEntry* entry = findSlot(event.value);
+    if (entry && entry->id == event.value && !checkName(entry, event, false)) {
+        _droppedAsync++;
+        return false;
+    }
+    if (event.name && _activeTopicSubscriptions > 0 && topicMatches(0, event.name)) {
+        entry = internName(entry, event);
+    }
+    if (entry && entry->id == event.value && entry->rate != NO_RATE) {
+        RateControl& rate = _rates[entry->rate];
+        uint64_t now = Scheduler::getInstance().nowMicros();
+        if (rate.mode == EventRateMode::Coalesce && (rate.pending || (rate.delivered && now - rate.lastDelivery < rate.interval))) {
+            rate.stats.posted++;
+            coalesce(rate, now, data, size, pooled);
+            return true;
+        }
+        if (!admit(rate, now)) {
+            return false;
+        }
+    }
+
+    EventQueue& queue = _queues[(uint8_t)priority < PRIORITY_COUNT ? (uint8_t)priority : PRIORITY_COUNT - 1];
+    if (queue.count == NEXTINO_EVENTBUS_QUEUE_SIZE) {
+        switch (_queueFullPolicy) {
+        case QueueFullPolicy::DropNewest:
+            _droppedAsync++;
+            return false;
+        case QueueFullPolicy::Block:
+            // There is no other thread to wait for: deliver the oldest event now.
+            _blockedAsync++;
+            dispatchOldest(queue);
+            if (queue.count == NEXTINO_EVENTBUS_QUEUE_SIZE) {
+                // Its listener posted to this queue again and took the slot.
+                _droppedAsync++;
+                return false;
+            }
+            break;
+        case QueueFullPolicy::DropOldest:
+        default:
+            if (queue.entries[queue.head].pooled) {
+                releasePooled(queue.entries[queue.head].data);
+            }
+            queue.head = (queue.head + 1) % NEXTINO_EVENTBUS_QUEUE_SIZE;
+            queue.count--;
+            _queuedEvents--;
+            _droppedAsync++;
+            break;
+        }
+    }
+
+    QueuedEvent& slot = queue.entries[(queue.head + queue.count) % NEXTINO_EVENTBUS_QUEUE_SIZE];
+    slot.id = event.value;
+    slot.size = (uint8_t)size;
+    slot.pooled = pooled;
+    slot.postedAt = postedAt;
+    if (size > 0) {
+        memcpy(slot.data, data, size);
+    }
+    queue.count++;
+    _queuedEvents++;
+    if (_queuedEvents > _peakQueuedEvents) {
+        _peakQueuedEvents = _queuedEvents;
+    }
+    _postedAsync++;
+    return true;
+}
+
+size_t EventBus::dispatchQueued(size_t maxEvents) {
+    if (rejectForeign("dispatchQueued")) {
+        return 0;
+    }
+    reportForeignDrops();
+    size_t dispatched = 0;
+    while (dispatched < maxEvents) {
+        // Events from other tasks join the queues as room frees up.
+        drainInbox();
+        if (_queuedEvents == 0) {
+            break;
+        }
+        // Re-check from the top each time: a listener may queue a higher-priority event.
+        for (auto& queue : _queues) {
+            if (queue.count > 0) {
+                dispatchOldest(queue);
+                dispatched++;
+                break;
+            }
+        }
+    }
+    return dispatched;
+}
+
+void EventBus::dispatchOldest(EventQueue& queue) {
+    // Copy the event out first, so listeners can queue new events (even into
+    // this very slot) without corrupting the payload they are reading.
+    QueuedEvent event = queue.entries[queue.head];
+    queue.head = (queue.head + 1) % NEXTINO_EVENTBUS_QUEUE_SIZE;
+    queue.count--;
+    _queuedEvents--;
+
+    uint64_t latency = nextinoMicros64() - event.postedAt;
+    _queueLatency.record(latency > UINT32_MAX ? UINT32_MAX : (uint32_t)latency);
+    _dispatchedAsync++;
 
-    // Check if any listeners are registered for this event.
-    if (_listeners.find(eventName) != _listeners.end()) {
-        // If so, iterate through all of them and call the callbacks.
-        for (auto const& callback : _listeners[eventName]) {
-            callback(payload);
+    // Already admitted by any rate control when it was queued.
+    EventEntry* entry = findSlot(event.id);
+    if (entry && entry->id != event.id) {
+        entry = nullptr;
+    }
+    void* payload = event.size > 0 ? event.data : nullptr;
+    if (event.pooled) {
+        memcpy(&payload, event.data, sizeof(payload));
+    }
+    deliver(entry, EventId::fromValue(event.id, entry ? entry->name : nullptr), payload);
+    if (event.pooled) {
+        releasePooled(event.data);
+    }
+}
+
+bool EventBus::setEventRate(EventId event, EventRateMode mode, unsigned long intervalMs, uint16_t burst) {
+    if (rejectForeign("setEventRate")) {
+        return false;
+    }
+    if (event.name && isTopicFilter(event.name)) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "EventBus", "Rate controls need an exact event name, not the filter '%s'.", event.name);
+        return false;
+    }
+    EventEntry* entry = findSlot(event.value);
+    if (!entry) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "EventBus", "Event table full (%u events). Raise NEXTINO_EVENTBUS_MAX_EVENTS.",
+                         (unsigned)NEXTINO_EVENTBUS_MAX_EVENTS);
+        return false;
+    }
+    uint8_t index = entry->id == event.value ? entry->rate : NO_RATE;
+    if (index != NO_RATE) {
+        if (_rates[index].flushTask != 0) {
+            Scheduler::getInstance().cancel(_rates[index].flushTask);
+            _rates[index].flushTask = 0;
+        }
+        discardPending(_rates[index]);
+    }
+
+    if (mode == EventRateMode::Unlimited) {
+        if (index != NO_RATE) {
+            _rates[index].mode = EventRateMode::Unlimited;
+            entry->rate = NO_RATE;
         }
+        return true;
+    }
+    if (intervalMs == 0 || (mode == EventRateMode::RateLimit && burst == 0)) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "EventBus", "Invalid rate for event 0x%08lx.", (unsigned long)event.value);
+        return false;
     }
+
+    // Take a free rate control if the event has none yet.
+    for (uint8_t i = 0; index == NO_RATE && i < NEXTINO_EVENTBUS_MAX_RATE_CONTROLS; ++i) {
+        if (_rates[i].mode == EventRateMode::Unlimited) {
+            index = i;
+        }
+    }
+    if (index == NO_RATE) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "EventBus", "All %u rate controls in use. Raise NEXTINO_EVENTBUS_MAX_RATE_CONTROLS.",
+                         (unsigned)NEXTINO_EVENTBUS_MAX_RATE_CONTROLS);
+        return false;
+    }
+
+    // Claim the table slot, as a subscription would.
+    entry->id = event.value;
+    entry->rate = index;
+    uint64_t intervalUs = (uint64_t)intervalMs * 1000ULL;
+    RateControl& rate = _rates[index];
+    rate.mode = mode;
+    rate.event = (uint8_t)(entry - _events);
+    rate.burst = mode == EventRateMode::RateLimit ? burst : 1;
+    rate.tokens = rate.burst;
+    rate.delivered = false;
+    rate.size = 0;
+    rate.interval = intervalUs > UINT32_MAX ? UINT32_MAX : (uint32_t)intervalUs;
+    rate.lastDelivery = 0;
+    rate.lastRefill = Scheduler::getInstance().nowMicros();
+    rate.stats = {0, 0, 0, 0};
+    return true;
+}
+
+bool EventBus::getEventRateStats(EventId event, EventRateStats& stats) {
+    if (rejectForeign("getEventRateStats")) {
+        return false;
+    }
+    EventEntry* entry = findSlot(event.value);
+    if (!entry || entry->id != event.value || entry->rate == NO_RATE) {
+        return false;
+    }
+    stats = _rates[entry->rate].stats;
+    return true;
+}
+
+bool EventBus::admit(RateControl& rate, uint64_t now) {
+    rate.stats.posted++;
+    if (rate.mode == EventRateMode::RateLimit) {
+        // Refill one token per interval, up to the burst.
+        uint64_t refills = (now - rate.lastRefill) / rate.interval;
+        if (refills > 0) {
+            rate.tokens = refills >= (uint64_t)(rate.burst - rate.tokens) ? rate.burst : (uint16_t)(rate.tokens + refills);
+            rate.lastRefill += refills * rate.interval;
+        }
+        if (rate.tokens == 0) {
+            rate.stats.dropped++;
+            return false;
+        }
+        if (rate.tokens == rate.burst) {
+            rate.lastRefill = now; // A full bucket does not bank refill time
+        }
+        rate.tokens--;
+    } else if (rate.delivered && now - rate.lastDelivery < rate.interval) {
+        rate.stats.dropped++;
+        return false;
+    }
+
+    if (rate.pending) {
+        discardPending(rate); // A post() superseded the coalesced payload
+        rate.stats.coalesced++;
+    }
+    rate.delivered = true;
+    rate.lastDelivery = now;
+    rate.stats.delivered++;
+    return true;
+}
+
+void EventBus::coalesce(RateControl& rate, uint64_t now, const void* data, size_t size, bool pooled) {
+    if (rate.pending) {
+        discardPending(rate);
+        rate.stats.coalesced++; // The older payload is never delivered
+    }
+    rate.pending = true;
+    rate.pooled = pooled;
+    rate.size = (uint8_t)size;
+    if (size > 0) {
+        memcpy(rate.data, data, size);
+    }
+
+    if (rate.flushTask == 0) {
+        uint64_t due = rate.lastDelivery + rate.interval;
+        uint8_t index = (uint8_t)(&rate - _rates);
+        rate.flushTask = Scheduler::getInstance().scheduleOnceMicros(due > now ? due - now : 0, [this, index]() { flushCoalesced(index); });
+        if (rate.flushTask == 0) {
+            // Retried on the next post of the event.
+            NEXTINO_CORE_LOG(LogLevel::Warn, "EventBus", "Could not schedule a coalesced delivery; the Scheduler is full.");
+        }
+    }
+}
+
+void EventBus::flushCoalesced(uint8_t index) {
+    RateControl& rate = _rates[index];
+    rate.flushTask = 0;
+    if (!rate.pending) {
+        return;
+    }
+
+    // Copy the payload out: a listener may post the event again.
+    alignas(std::max_align_t) unsigned char data[NEXTINO_EVENTBUS_PAYLOAD_SIZE];
+    size_t size = rate.size;
+    bool pooled = rate.pooled;
+    memcpy(data, rate.data, size);
+    rate.pending = false;
+    rate.pooled = false;
+    rate.delivered = true;
+    rate.lastDelivery = Scheduler::getInstance().nowMicros();
+    rate.stats.delivered++;
+
+    EventEntry& entry = _events[rate.event];
+    void* payload = size > 0 ? data : nullptr;
+    if (pooled) {
+        memcpy(&payload, data, sizeof(payload));
+    }
+    deliver(&entry, EventId::fromValue(entry.id, entry.name), payload);
+    if (pooled) {
+        releasePooled(data);
+    }
+}
+
+void EventBus::discardPending(RateControl& rate) {
+    if (rate.pending && rate.pooled) {
+        releasePooled(rate.data);
+    }
+    rate.pending = false;
+    rate.pooled = false;
+}
+
+void EventBus::restartRateWindows() {
+    uint64_t now = Scheduler::getInstance().nowMicros();
+    for (RateControl& rate : _rates) {
+        if (rate.mode == EventRateMode::Unlimited) {
+            continue;
+        }
+        if (rate.flushTask != 0) {
+            Scheduler::getInstance().cancel(rate.flushTask);
+            rate.flushTask = 0;
+        }
+        discardPending(rate);
+        rate.tokens = rate.burst;
+        rate.delivered = false;
+        rate.lastDelivery = 0;
+        rate.lastRefill = now;
+    }
+}
+
+bool EventBus::hasQueuedEvents() const {
+    return _queuedEvents > 0 || _inbox[_inboxDequeue & INBOX_MASK].sequence.load(std::memory_order_acquire) == _inboxDequeue + 1;
+}
+
+void EventBus::setQueueFullPolicy(QueueFullPolicy policy) {
+    if (!rejectForeign("setQueueFullPolicy")) {
+        _queueFullPolicy = policy;
+    }
+}
+
+void EventBus::setWakeSignal(WakeSignal* signal) {
+    _wakeSignal.store(signal, std::memory_order_release);
+}
+
+void EventBus::setMultiProducer(bool enabled) {
+    if (rejectForeign("setMultiProducer")) {
+        return;
+    }
+    _owner.store(nextinoCurrentThread(), std::memory_order_relaxed);
+    _multiProducer.store(enabled, std::memory_order_release);
+    NEXTINO_CORE_LOG(LogLevel::Info, "EventBus", "Multi-producer mode %s.", enabled ? "enabled; listeners run on this task" : "disabled");
+}
+
+bool EventBus::rejectForeign(const char* method) const {
+    if (!isForeignThread()) {
+        return false;
+    }
+    NEXTINO_CORE_LOG(LogLevel::Error, "EventBus", "%s() is only allowed on the task that owns the bus.", method);
+    return true;
+}
+
+bool NEXTINO_ISR_ATTR EventBus::forward(EventId event, const void* data, size_t size, EventPriority priority, bool pooled) {
+    // A bounded multi-producer ring, as in DeferredQueue: claim a cell with
+    // one compare-and-swap, fill it, then publish it with its sequence number.
+    uint32_t position = _inboxEnqueue.load(std::memory_order_relaxed);
+    InboxCell* cell;
+    while (true) {
+        cell = &_inbox[position & INBOX_MASK];
+        int32_t difference = (int32_t)(cell->sequence.load(std::memory_order_acquire) - position);
+        if (difference == 0) {
+            if (_inboxEnqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // The owner task has not taken this cell yet: the inbox is full.
+            _inboxDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            position = _inboxEnqueue.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->id = event.value;
+    cell->size = (uint8_t)size;
+    cell->priority = (uint8_t)priority < PRIORITY_COUNT ? (uint8_t)priority : PRIORITY_COUNT - 1;
+    cell->pooled = pooled;
+    cell->postedAt = nextinoMicros64();
+    if (size > 0) {
+        memcpy(cell->data, data, size);
+    }
+#if NEXTINO_EVENTBUS_INBOX_NAME_SIZE > 0
+    // The name is copied, not referenced: the poster's string may be gone by dispatch.
+    size_t length = 0;
+    if (event.name) {
+        while (length < NEXTINO_EVENTBUS_INBOX_NAME_SIZE && event.name[length]) {
+            cell->name[length] = event.name[length];
+            length++;
+        }
+        if (length == NEXTINO_EVENTBUS_INBOX_NAME_SIZE) {
+            length = 0; // Too long: delivered to exact-name listeners only
+            _unreportedLongNames.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    cell->name[length] = '\0';
+#endif
+    cell->sequence.store(position + 1, std::memory_order_release);
+
+    _forwarded.fetch_add(1, std::memory_order_relaxed);
+    WakeSignal* signal = _wakeSignal.load(std::memory_order_acquire);
+    if (signal) {
+        signal->notify();
+    }
+    return true;
+}
+
+EventBus::EventEntry* EventBus::internName(EventEntry* entry, EventId event) {
+    if (!entry) {
+        _unreportedUnnamed++; // Logged by reportForeignDrops()
+        return nullptr;
+    }
+    if (entry->id == 0) {
+        entry->id = event.value; // Claimed for its name; listeners may follow
+    }
+    if (!entry->name) {
+        // Copied once per event and kept, like the table slot itself.
+        size_t length = strlen(event.name);
+        char* name = new char[length + 1];
+        memcpy(name, event.name, length + 1);
+        entry->name = name;
+    }
+    return entry;
+}
+
+bool EventBus::checkName(EventEntry* entry, EventId event, bool keep) {
+#if NEXTINO_EVENTBUS_CHECK_NAMES
+    if (!event.name) {
+        return true; // Only the hash is known
+    }
+    if (!entry->name) {
+        if (keep) {
+            internName(entry, event);
+        }
+        return true;
+    }
+    if (strcmp(entry->name, event.name) == 0) {
+        return true;
+    }
+    NEXTINO_CORE_LOG(LogLevel::Error, "EventBus", "Events '%s' and '%s' share the ID 0x%08lx; rename one.", entry->name, event.name,
+                     (unsigned long)event.value);
+    return false;
+#else
+    (void)entry;
+    (void)event;
+    (void)keep;
+    return true;
+#endif
+}
+
+void EventBus::reportForeignDrops() {
+    uint32_t rawPayloads = _unreportedRawPayloads.exchange(0, std::memory_order_relaxed);
+    if (rawPayloads > 0) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "EventBus", "Dropped %lu event(s) posted from another task with a raw payload; use an EventPayload.",
+                         (unsigned long)rawPayloads);
+    }
+    uint32_t oversized = _unreportedOversized.exchange(0, std::memory_order_relaxed);
+    if (oversized > 0) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "EventBus", "Dropped %lu event(s) from another task with a payload too large to queue (max %u).",
+                         (unsigned long)oversized, (unsigned)NEXTINO_EVENTBUS_PAYLOAD_SIZE);
+    }
+    uint32_t longNames = _unreportedLongNames.exchange(0, std::memory_order_relaxed);
+    if (longNames > 0) {
+        NEXTINO_CORE_LOG(LogLevel::Warn, "EventBus", "%lu event(s) from another task had a name too long for topic filters (max %u).",
+                         (unsigned long)longNames, (unsigned)(NEXTINO_EVENTBUS_INBOX_NAME_SIZE > 0 ? NEXTINO_EVENTBUS_INBOX_NAME_SIZE - 1 : 0));
+    }
+    if (_unreportedUnnamed > 0) {
+        NEXTINO_CORE_LOG(LogLevel::Warn, "EventBus", "Event table full; topic filters missed %lu queued event(s). Raise NEXTINO_EVENTBUS_MAX_EVENTS.",
+                         (unsigned long)_unreportedUnnamed);
+        _unreportedUnnamed = 0;
+    }
+}
+
+void EventBus::drainInbox() {
+    while (true) {
+        InboxCell& cell = _inbox[_inboxDequeue & INBOX_MASK];
+        if (cell.sequence.load(std::memory_order_acquire) != _inboxDequeue + 1) {
+            return; // Empty, or the next producer has not published its cell yet
+        }
+        // An event whose queue is full waits here, in order, rather than
+        // pushing out events the owner has not had a chance to dispatch.
+        if (_queues[cell.priority].count == NEXTINO_EVENTBUS_QUEUE_SIZE) {
+            return;
+        }
+
+        // Copy the event out and free the cell before queueing it.
+        alignas(std::max_align_t) unsigned char data[NEXTINO_EVENTBUS_PAYLOAD_SIZE];
+        uint32_t id = cell.id;
+        size_t size = cell.size;
+        EventPriority priority = (EventPriority)cell.priority;
+        bool pooled = cell.pooled;
+        uint64_t postedAt = cell.postedAt;
+        memcpy(data, cell.data, size);
+#if NEXTINO_EVENTBUS_INBOX_NAME_SIZE > 0
+        char name[NEXTINO_EVENTBUS_INBOX_NAME_SIZE];
+        memcpy(name, cell.name, sizeof(name));
+        EventId event = EventId::fromValue(id, name[0] ? name : nullptr);
+#else
+        EventId event = EventId::fromValue(id);
+#endif
+        cell.sequence.store(_inboxDequeue + NEXTINO_EVENTBUS_INBOX_SIZE, std::memory_order_release);
+        _inboxDequeue++;
+
+        // Rate controls apply here, on the owner task, which also interns the name.
+        if (!enqueue(event, data, size, priority, pooled, postedAt) && pooled) {
+            releasePooled(data);
+        }
+    }
+}
+
+EventQueueStats EventBus::getQueueStats() const {
+    EventQueueStats stats;
+    stats.capacity = NEXTINO_EVENTBUS_QUEUE_SIZE;
+    stats.depth = _queuedEvents;
+    stats.peakDepth = _peakQueuedEvents;
+    stats.posted = _postedAsync;
+    stats.forwarded = _forwarded.load(std::memory_order_relaxed);
+    stats.dispatched = _dispatchedAsync;
+    stats.dropped = _droppedAsync + _inboxDropped.load(std::memory_order_relaxed);
+    stats.blocked = _blockedAsync;
+    stats.latency = _queueLatency.summary();
+    return stats;
+}
+
+void EventBus::resetQueueStats() {
+    _peakQueuedEvents = _queuedEvents;
+    _postedAsync = 0;
+    _dispatchedAsync = 0;
+    _droppedAsync = 0;
+    _blockedAsync = 0;
+    _forwarded.store(0, std::memory_order_relaxed);
+    _inboxDropped.store(0, std::memory_order_relaxed);
+    _queueLatency.reset();
 }
\ No newline at end of file
@@ -3,29 +3,238 @@
  * @title       Asynchronous Event Bus
  * @description Defines the `EventBus` singleton class, which provides a centralized
  *              publish-subscribe mechanism for decoupled, asynchronous communication
- *              between modules.
+ *              between modules. Events are identified by `EventId`, a 32-bit FNV-1a
+ *              hash of the event name that can be computed at compile time, and
+ *              listeners are found through a fixed, flat table indexed by that ID.
+ *              Typed channels (`EventChannel<T>`, see EventChannel.h) share the
+ *              same table. Events can also be queued with a copied payload and
+ *              dispatched later by the SystemManager, in priority order.
+ *              Every subscription returns a handle that unsubscribes it in O(1).
+ *              Subscriptions to MQTT-style topic filters (`sensor/+/temperature`,
+ *              `sensor/#`) are indexed in a topic trie. Per-event rate controls
+ *              coalesce, space out or rate-limit high-rate producers. Payloads
+ *              that must outlive a post can come from the EventPayloadPool.
+ *              In multi-producer mode, other tasks, threads and ISRs post
+ *              through a lock-free inbox, and every listener runs on the
+ *              task that owns the bus. An attached EventRecorder captures
+ *              every post for later replay.
  *
  * @author      Giorgi Magradze
  * @date        2025-08-21
- * @version     0.1.0
+ * @version     0.2.0
  *
  * @copyright   (c) 2025 Nextino. All rights reserved.
  * @license     MIT License
  */
 
 #pragma once
-#include <map>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <vector>
 #include <functional>
 #include <string>
+#include <type_traits>
+#include "EventPayload.h"
+#include "Platform.h"
+#include "TimingStats.h"
+
+/**
+ * @def NEXTINO_EVENTBUS_MAX_EVENTS
+ * @brief The number of distinct event IDs that can have listeners. Must be a power of two.
+ * @details Keep it at least twice the number of events in use, so lookups rarely probe.
+ */
+#ifndef NEXTINO_EVENTBUS_MAX_EVENTS
+#define NEXTINO_EVENTBUS_MAX_EVENTS 64
+#endif
+
+/**
+ * @def NEXTINO_EVENTBUS_QUEUE_SIZE
+ * @brief The number of queued events each priority class can hold.
+ */
+#ifndef NEXTINO_EVENTBUS_QUEUE_SIZE
+#define NEXTINO_EVENTBUS_QUEUE_SIZE 16
+#endif
+
+/**
+ * @def NEXTINO_EVENTBUS_PAYLOAD_SIZE
+ * @brief The largest payload, in bytes, that postAsync() can copy.
+ */
+#ifndef NEXTINO_EVENTBUS_PAYLOAD_SIZE
+#define NEXTINO_EVENTBUS_PAYLOAD_SIZE 16
+#endif
+
+/**
+ * @def NEXTINO_EVENTBUS_BATCH_SIZE
+ * @brief The most queued events dispatched per main-loop pass.
+ */
+#ifndef NEXTINO_EVENTBUS_BATCH_SIZE
+#define NEXTINO_EVENTBUS_BATCH_SIZE 8
+#endif
+
+/**
+ * @def NEXTINO_EVENTBUS_INBOX_SIZE
+ * @brief The number of events other tasks can have in flight to the owner task. Must be a power of two.
+ */
+#ifndef NEXTINO_EVENTBUS_INBOX_SIZE
+#define NEXTINO_EVENTBUS_INBOX_SIZE 32
+#endif
+
+/**
+ * @def NEXTINO_EVENTBUS_INBOX_NAME_SIZE
+ * @brief The longest event name, with its terminator, an inbox cell carries for topic filters. 0 carries none.
+ */
+#ifndef NEXTINO_EVENTBUS_INBOX_NAME_SIZE
+#define NEXTINO_EVENTBUS_INBOX_NAME_SIZE 32
+#endif
+
+/**
+ * @def NEXTINO_EVENTBUS_CHECK_NAMES
+ * @brief 1 to catch two event names with the same hash; on unless NDEBUG is defined.
+ * @details on() keeps a copy of each subscribed event's name, and on() and the
+ *          post functions compare it with the name they are given. A mismatch
+ *          is logged as an error and the call is rejected, instead of the two
+ *          events silently sharing listeners, rate controls and types.
+ */
+#ifndef NEXTINO_EVENTBUS_CHECK_NAMES
+#ifdef NDEBUG
+#define NEXTINO_EVENTBUS_CHECK_NAMES 0
+#else
+#define NEXTINO_EVENTBUS_CHECK_NAMES 1
+#endif
+#endif
+
+/**
+ * @def NEXTINO_EVENTBUS_MAX_RATE_CONTROLS
+ * @brief The number of events that can have a rate control at the same time.
+ */
+#ifndef NEXTINO_EVENTBUS_MAX_RATE_CONTROLS
+#define NEXTINO_EVENTBUS_MAX_RATE_CONTROLS 8
+#endif
+
+/**
+ * @enum EventPriority
+ * @brief The priority class of a queued event. Higher classes are dispatched first.
+ */
+enum class EventPriority : uint8_t {
+    High,
+    Normal, /**< The default. */
+    Low
+};
+
+/**
+ * @enum QueueFullPolicy
+ * @brief What postAsync() does when the event's priority queue is full.
+ */
+enum class QueueFullPolicy : uint8_t {
+    DropOldest, /**< Discard the oldest queued event of that priority to make room (default). */
+    DropNewest, /**< Discard the event being posted. */
+    Block       /**< Dispatch the oldest queued event of that priority right away, on the caller's stack; drop the new one if its listener refilled the queue. */
+};
+
+/**
+ * @enum EventRateMode
+ * @brief How often an event may reach its listeners (see EventBus::setEventRate()).
+ */
+enum class EventRateMode : uint8_t {
+    Unlimited,   /**< Every post is delivered (default). */
+    Coalesce,    /**< At most one delivery per interval. postAsync() keeps the newest payload posted meanwhile and delivers it when the interval ends; post() drops it. */
+    MinInterval, /**< At most one delivery per interval; posts in between are dropped. */
+    RateLimit    /**< A token bucket: up to `burst` posts at once, refilled at one per interval; posts without a token are dropped. */
+};
+
+/**
+ * @struct EventRateStats
+ * @brief The counters of one rate-controlled event.
+ */
+struct EventRateStats {
+    uint32_t posted;    /**< Posts of the event, by post() or postAsync(). */
+    uint32_t delivered; /**< Posts let through to the listeners (or to the queue). */
+    uint32_t coalesced; /**< Payloads replaced by a newer one before delivery (Coalesce). */
+    uint32_t dropped;   /**< Posts rejected by the interval or the token bucket. */
+};
+
+/**
+ * @struct EventQueueStats
+ * @brief A snapshot of the queued-dispatch counters.
+ */
+struct EventQueueStats {
+    size_t capacity;       /**< Queue slots per priority class (NEXTINO_EVENTBUS_QUEUE_SIZE). */
+    size_t depth;          /**< Events currently queued, all classes. */
+    size_t peakDepth;      /**< Highest number of events queued at once. */
+    uint32_t posted;       /**< Events accepted by postAsync(). */
+    uint32_t forwarded;    /**< Events posted from other tasks or threads through the inbox. */
+    uint32_t dispatched;   /**< Queued events delivered to their listeners. */
+    uint32_t dropped;      /**< Events discarded: queue or inbox full, or payload too large. */
+    uint32_t blocked;      /**< Posts that had to dispatch an event first (QueueFullPolicy::Block). */
+    TimingSummary latency; /**< Time from postAsync() to dispatch, in microseconds. */
+};
+
+/**
+ * @struct EventId
+ * @brief The identifier of an event: the 32-bit FNV-1a hash of its name.
+ * @details Converts implicitly from a name, so `post("button_pressed")` keeps
+ *          working; the hash is then computed at runtime without allocating.
+ *          To guarantee it is computed at compile time, use a `constexpr`
+ *          constant or the NEXTINO_EVENT() macro. The name itself is kept
+ *          alongside, so posts can also be matched against topic filters:
+ * @code
+ * constexpr EventId BUTTON_PRESSED("button_pressed");
+ * NextinoEvent().post(BUTTON_PRESSED);
+ * NextinoEvent().post(NEXTINO_EVENT("button_pressed"));
+ * @endcode
+ */
+struct EventId {
+    uint32_t value;
+    const char* name; // The hashed name, or nullptr if only the hash is known
+
+    constexpr EventId(const char* name) : value(hash(name)), name(name) {}
+    EventId(const std::string& name) : value(hash(name.c_str())), name(name.c_str()) {}
+
+    /**
+     * @brief Wraps a precomputed hash, e.g. one generated by the build scripts.
+     * @details Without a name, the event only reaches exact-name listeners.
+     */
+    static constexpr EventId fromValue(uint32_t value, const char* name = nullptr) { return EventId(value, name); }
+
+    constexpr bool operator==(const EventId& other) const { return value == other.value; }
+    constexpr bool operator!=(const EventId& other) const { return value != other.value; }
+
+    /**
+     * @brief Hashes an event name with 32-bit FNV-1a. Never returns 0 (reserved for empty table slots).
+     */
+    static constexpr uint32_t hash(const char* name) {
+        uint32_t result = 2166136261u;
+        while (*name) {
+            result = (result ^ (uint8_t)*name++) * 16777619u;
+        }
+        return result != 0 ? result : 1;
+    }
+
+private:
+    constexpr EventId(uint32_t value, const char* name) : value(value), name(name) {}
+};
+
+/**
+ * @def NEXTINO_EVENT
+ * @brief Yields the EventId of a string literal, always computed at compile time.
+ */
+#define NEXTINO_EVENT(name) (EventId::fromValue(std::integral_constant<uint32_t, EventId(name).value>::value, name))
+
+class EventRecorder;
+class WakeSignal;
 
 /**
  * @class EventBus
  * @brief A singleton class for managing and dispatching events.
  * @details Modules can subscribe to named events and publish events to notify
- *          other parts of the system without direct dependencies. This class
- *          is not thread-safe and is intended for single-threaded environments
- *          or to be called from the main `loop()`.
+ *          other parts of the system without direct dependencies. By default
+ *          the bus is not thread-safe and must only be used from the main
+ *          `loop()`'s task. After setMultiProducer(true), any task, thread or
+ *          (on ESP32) ISR may post: posts from other tasks go through a
+ *          lock-free inbox and are dispatched on the owner task, so listeners
+ *          always run there and the listener tables are never shared.
  */
 class EventBus {
 public:
@@ -43,34 +252,612 @@ public:
      */
     using EventCallback = std::function<void(void*)>;
 
+    /**
+     * @typedef Subscription
+     * @brief A handle to one subscription, returned by on() and accepted by off().
+     * @details Encodes the event's table slot (low 8 bits; 255 for topic
+     *          filters), the subscription slot within that event (next 12 bits)
+     *          and the slot's generation (high 12 bits). A handle is never 0, so 0 can be used as "not
+     *          subscribed". Once unsubscribed, a handle becomes stale and is
+     *          safely rejected, even if its slot is reused.
+     */
+    using Subscription = uint32_t;
+
     /**
      * @brief Subscribes a callback function to a specific event.
-     * @param eventName The name of the event to listen for (e.g., "button_pressed").
+     * @details Listeners run in subscription order. A listener subscribed while
+     *          the event is being posted first runs on the next post. Fails (and
+     *          logs an error) if NEXTINO_EVENTBUS_MAX_EVENTS distinct events
+     *          already have listeners.
+     *
+     *          Names are split into `/`-separated levels. A name in which a whole
+     *          level is `+` (any one level) or a final `#` (any number of levels,
+     *          including none) is an MQTT-style topic filter: the listener then
+     *          receives every event posted with a matching name.
+     * @code
+     * NextinoEvent().on("sensor/+/temperature", onAnyTemperature);
+     * NextinoEvent().on("sensor/#", onAnySensorEvent);
+     * NextinoEvent().post("sensor/kitchen/temperature", &reading); // Reaches both
+     * @endcode
+     * @param event The event or topic filter to listen for, e.g. "button_pressed" or a constexpr EventId.
      * @param callback The function to be executed when the event is posted.
+     * @return A handle for off(), or 0 on failure.
      */
-    void on(const std::string& eventName, EventCallback callback);
+    Subscription on(EventId event, EventCallback callback);
+
+    /**
+     * @brief Removes a subscription in O(1).
+     * @details Safe at any time, including from a listener of the same event
+     *          while it is being posted (even the listener being removed): the
+     *          listener is only marked, and the array is compacted once the
+     *          outermost post of that event returns. A listener removed during
+     *          a post that has not run yet is skipped.
+     * @param subscription The handle returned by on().
+     * @return False if the handle is 0, stale, or was never issued.
+     */
+    bool off(Subscription subscription);
 
     /**
      * @brief Publishes (posts) an event to all subscribed listeners.
-     * @details This method immediately calls all registered callbacks for the given event.
-     * @param eventName The name of the event to publish.
+     * @details This method immediately calls all registered callbacks for the
+     *          given event. Finding them is one hash-table probe, and the callbacks
+     *          are stored contiguously; no strings are compared and nothing is
+     *          allocated. Listeners of matching topic filters run next; finding
+     *          them walks the topic trie once per level of the event name (plus
+     *          once per matching `+` branch). Events posted without a name (see
+     *          EventId::fromValue()) skip the trie.
+     * @param event The event to publish, e.g. "button_pressed" or a constexpr EventId.
      * @param payload (Optional) A void pointer to data to be passed to the listeners.
      *                Defaults to nullptr if no data is needed.
+     * @note In multi-producer mode, a post from another task is queued like
+     *       postAsync() with normal priority. It cannot carry a raw payload,
+     *       which would be gone before the owner task dispatches it, so one
+     *       with a payload is dropped; post an EventPayload<T> instead. Such a
+     *       drop is counted at once and logged later from the owner task, so
+     *       post() stays safe to call from an ISR.
+     */
+    void post(EventId event, void* payload = nullptr);
+
+    /**
+     * @brief Publishes a pooled payload to all subscribed listeners.
+     * @details Listeners receive `payload.get()` and may keep it past the post
+     *          with EventPayload<T>::retain().
+     */
+    template <typename T>
+    void post(EventId event, const EventPayload<T>& payload) {
+        postShared(event, payload.get());
+    }
+
+    /**
+     * @brief Limits how often an event reaches its listeners.
+     * @details Applies to every post of the event, so consumers such as a
+     *          display or an MQTT publisher need no throttling of their own.
+     *          With EventRateMode::Coalesce, postAsync() keeps the newest
+     *          payload of each interval in the rate control and a one-shot
+     *          Scheduler task delivers it when the interval ends, so a burst
+     *          costs one delivery and no queue space. Reconfiguring an event
+     *          resets its counters; EventRateMode::Unlimited removes the control
+     *          and discards a payload still waiting.
+     * @code
+     * // The display needs at most 4 temperature updates per second, the latest ones.
+     * NextinoEvent().setEventRate("sensor/kitchen/temperature", EventRateMode::Coalesce, 250);
+     * @endcode
+     * @param event The event to control. Topic filters are not supported.
+     * @param mode The rate mode.
+     * @param intervalMs The interval, or the token refill period for RateLimit. Must be above 0.
+     * @param burst The token bucket size for RateLimit; ignored by the other modes.
+     * @return False if NEXTINO_EVENTBUS_MAX_RATE_CONTROLS events already have a
+     *         control, the event table is full, or the arguments are invalid.
+     */
+    bool setEventRate(EventId event, EventRateMode mode, unsigned long intervalMs, uint16_t burst = 1);
+
+    /**
+     * @brief Gets the counters of a rate-controlled event.
+     * @return False if the event has no rate control.
+     */
+    bool getEventRateStats(EventId event, EventRateStats& stats);
+
+    /**
+     * @brief Queues an event for later dispatch and returns at once.
+     * @details The payload is copied into a pre-allocated ring, one per
+     *          priority class. Listeners receive a pointer to that copy when
+     *          the SystemManager dispatches the event, at the start of a later
+     *          loop pass. A listener that posts asynchronously never recurses.
+     *          While topic filters are subscribed, the bus keeps one copy of
+     *          each queued event's name in its event table, so filters match
+     *          queued, coalesced and replayed events too. From another task in
+     *          multi-producer mode, the event passes through the inbox first,
+     *          with its name if it fits NEXTINO_EVENTBUS_INBOX_NAME_SIZE, and
+     *          is dropped if the inbox is full.
+     * @param event The event to publish.
+     * @param data (Optional) The payload to copy.
+     * @param size The payload size, at most NEXTINO_EVENTBUS_PAYLOAD_SIZE.
+     * @param priority The priority class of this event.
+     * @return True if queued, false if dropped (see setQueueFullPolicy()).
+     */
+    bool postAsync(EventId event, const void* data = nullptr, size_t size = 0, EventPriority priority = EventPriority::Normal);
+
+    /**
+     * @brief Queues an event with a pooled payload, holding a reference to it until it is dispatched or dropped.
+     * @details Only the pointer is queued, so the payload is not limited to
+     *          NEXTINO_EVENTBUS_PAYLOAD_SIZE and is not copied. Every listener
+     *          receives the same object as `void*`; one that keeps it past the
+     *          dispatch takes a reference with EventPayload<T>::retain().
+     * @param payload A payload from EventPayload<T>::make(); an empty one is rejected.
+     * @return True if queued, false if dropped (the queue's reference is then released at once).
+     */
+    template <typename T>
+    bool postAsync(EventId event, const EventPayload<T>& payload, EventPriority priority = EventPriority::Normal) {
+        return postPooled(event, payload.get(), priority, nullptr);
+    }
+
+    /**
+     * @brief Lets other tasks, threads and ISRs post events.
+     * @details Call it from the task that runs the main loop, typically in
+     *          setup(); that task becomes the owner of the bus. Afterwards,
+     *          post() and postAsync() from any other task only copy the event
+     *          into a lock-free inbox (a bounded multi-producer ring, safe from
+     *          ISRs on ESP32) and wake the main loop; dispatchQueued() moves the
+     *          inbox into the priority queues on the owner task. Listeners and
+     *          rate controls therefore always run on the owner task, so
+     *          dispatch needs no lock and listener tables are never shared.
+     *          Subscribing, unsubscribing and the other settings stay owner-only
+     *          and are rejected, with an error, from any other task.
+     * @param enabled True to enable, false to return to single-task mode.
+     */
+    void setMultiProducer(bool enabled);
+
+    /**
+     * @brief Sets the signal a post from another task notifies, so the main loop wakes for it.
+     * @details The SystemManager passes its own on construction. The pointer is
+     *          cached because an ISR running from IRAM must not call into the
+     *          SystemManager singleton, whose accessor lives in flash.
+     */
+    void setWakeSignal(WakeSignal* signal);
+
+    /**
+     * @brief Checks whether other tasks may post (see setMultiProducer()).
+     */
+    bool isMultiProducer() const { return _multiProducer.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Dispatches queued events, highest priority class first, FIFO within a class.
+     * @details Called by SystemManager::loop() every pass.
+     * @param maxEvents The most events to dispatch in this call.
+     * @return The number of events dispatched.
+     */
+    size_t dispatchQueued(size_t maxEvents = NEXTINO_EVENTBUS_BATCH_SIZE);
+
+    /**
+     * @brief Checks whether any event is waiting in the queue.
+     */
+    bool hasQueuedEvents() const;
+
+    /**
+     * @brief Chooses what postAsync() does when a priority queue is full.
      */
-    void post(const std::string& eventName, void* payload = nullptr);
+    void setQueueFullPolicy(QueueFullPolicy policy);
+
+    /**
+     * @brief Gets a snapshot of the queued-dispatch counters.
+     */
+    EventQueueStats getQueueStats() const;
+
+    /**
+     * @brief Clears the queued-dispatch counters (not the queued events).
+     */
+    void resetQueueStats();
 
 private:
+    template <typename T>
+    friend class EventChannel;
+    friend class EventRecorder;
+    friend class EventReplay;
+
     /**
      * @brief Private constructor to enforce the singleton pattern.
      */
-    EventBus() {}
-    
+    EventBus();
+
     // Delete copy constructor and assignment operator to prevent copies
     EventBus(const EventBus&) = delete;
     void operator=(const EventBus&) = delete;
 
+    static const uint32_t MASK = NEXTINO_EVENTBUS_MAX_EVENTS - 1;
+
+    // Subscription handle layout, see Subscription.
+    static const uint32_t EVENT_BITS = 8;
+    static const uint32_t SLOT_BITS = 12;
+    static const uint32_t TOPIC_INDEX = (1u << EVENT_BITS) - 1; // Event slot of topic-filter handles
+    static const uint16_t MAX_SUBSCRIPTIONS = 1u << SLOT_BITS;  // Per event, and topic filters in total
+    static const uint16_t GENERATION_MASK = (1u << (32 - EVENT_BITS - SLOT_BITS)) - 1;
+    static const uint16_t NO_SLOT = 0xFFFF;
+    static const uint32_t NO_NODE = 0xFFFFFFFF;
+
+    /**
+     * @struct Listener
+     * @brief One subscriber, stored by value in its event's contiguous array.
+     */
+    struct Listener {
+        EventCallback callback;
+        uint16_t slot; // Subscription slot that owns it, or NO_SLOT once unsubscribed
+    };
+
+    /**
+     * @struct SubscriptionSlot
+     * @brief Maps a subscription handle to its listener's current position.
+     */
+    struct SubscriptionSlot {
+        uint16_t position;   // Index in `listeners` (or in `pending`, past its end); next free slot while free
+        uint16_t generation; // Bumped on every free; part of the handle
+    };
+
+    /**
+     * @struct ListenerList
+     * @brief The listeners of one event or topic filter, with O(1) removal.
+     * @details Safe to modify from its own listeners: while it is being
+     *          dispatched, removal only marks a listener and new listeners wait
+     *          in `pending`, so `listeners` never moves under the loop.
+     */
+    struct ListenerList {
+        std::vector<Listener> listeners;     // Delivery order; never reallocated during a dispatch
+        std::vector<Listener> pending;       // Added during a dispatch; appended when it returns
+        std::vector<SubscriptionSlot> slots;
+        uint16_t freeSlot = NO_SLOT;         // Head of the free slot list
+        uint16_t dispatching = 0;            // Nesting depth of dispatch()
+        bool dirty = false;                  // Holds removed or pending listeners
+
+        /**
+         * @brief Adds a listener.
+         * @return Its subscription slot, or NO_SLOT if MAX_SUBSCRIPTIONS are in use.
+         */
+        uint16_t add(EventCallback&& callback);
+
+        /**
+         * @brief Removes the listener of a subscription slot, if `generation` is current.
+         */
+        bool remove(uint16_t slot, uint16_t generation);
+
+        /**
+         * @brief Calls every live listener, then settles the list if this was the outermost call.
+         */
+        void dispatch(void* payload);
+
+        /**
+         * @brief Appends pending listeners and compacts out removed ones, keeping order.
+         */
+        void settle();
+    };
+
+    /**
+     * @struct EventEntry
+     * @brief One slot of the event table. `id` is 0 while the slot is empty.
+     */
+    struct EventEntry {
+        uint32_t id;
+        const void* type; // Payload type of a typed channel, or nullptr
+        const char* name; // Interned name, for topic filters and name checks, or nullptr
+        uint8_t rate;     // Index in _rates, or NO_RATE
+        ListenerList listeners;
+    };
+
+    static const uint8_t NO_RATE = 0xFF;
+
+    /**
+     * @struct RateControl
+     * @brief The state of one rate-controlled event.
+     */
+    struct RateControl {
+        EventRateMode mode;  // Unlimited while the control is free
+        uint8_t event;       // Index in _events
+        uint16_t burst;
+        uint16_t tokens;
+        bool delivered;      // Whether `lastDelivery` is set
+        bool pending;        // A coalesced payload waits in `data`
+        bool pooled;         // `data` holds a pointer to a pooled payload, with a reference
+        uint8_t size;
+        uint32_t interval;   // Microseconds
+        uint64_t lastDelivery;
+        uint64_t lastRefill;
+        uint32_t flushTask;  // Scheduler task delivering `data`, or 0
+        EventRateStats stats;
+        alignas(std::max_align_t) unsigned char data[NEXTINO_EVENTBUS_PAYLOAD_SIZE];
+    };
+
+    /**
+     * @struct TopicChild
+     * @brief An edge of the topic trie, keyed by the hash of one level.
+     */
+    struct TopicChild {
+        uint32_t level;
+        uint32_t node;
+    };
+
+    /**
+     * @struct TopicNode
+     * @brief A node of the topic trie: the filters that reach it level by level.
+     */
+    struct TopicNode {
+        std::vector<TopicChild> children; // Literal levels, sorted by hash
+        uint32_t plus = NO_NODE;          // The `+` child
+        ListenerList exact;               // Filters ending at this level
+        ListenerList rest;                // Filters ending in `#` after this level
+    };
+
+    /**
+     * @struct TopicSubscription
+     * @brief Maps a topic-filter handle to its listener in the trie.
+     */
+    struct TopicSubscription {
+        uint32_t node;       // Trie node; next free subscription while free
+        uint16_t slot;       // Slot in the node's list, or NO_SLOT while free
+        uint16_t listGeneration;
+        uint16_t generation; // Bumped on every free; part of the handle
+        bool rest;           // In the node's `rest` list rather than `exact`
+    };
+
+    /**
+     * @brief Finds the slot of an event, or the empty slot where it would go.
+     * @return The slot, or nullptr if the event is absent and the table is full.
+     */
+    EventEntry* findSlot(uint32_t id);
+
+    /**
+     * @brief Calls the exact listeners of an event, then those of matching topic filters.
+     */
+    void deliver(EventEntry* entry, EventId event, void* payload);
+
+    /**
+     * @brief Decides whether a post of a rate-controlled event goes through now.
+     */
+    bool admit(RateControl& rate, uint64_t now);
+
+    /**
+     * @brief Keeps the newest payload of a coalesced event and schedules its delivery.
+     */
+    void coalesce(RateControl& rate, uint64_t now, const void* data, size_t size, bool pooled);
+
+    /**
+     * @brief Discards the coalesced payload of a rate control, if any.
+     */
+    void discardPending(RateControl& rate);
+
+    /**
+     * @brief Restarts every rate window as if just configured, dropping pending payloads.
+     * @details Lets each EventReplay start from the same state; the counters are kept.
+     */
+    void restartRateWindows();
+
+    /**
+     * @brief Delivers the coalesced payload of a rate control. Runs as a Scheduler task.
+     */
+    void flushCoalesced(uint8_t index);
+
+    /**
+     * @brief Checks whether a name is a topic filter: some level is exactly `+` or `#`.
+     */
+    static bool isTopicFilter(const char* name);
+
+    /**
+     * @brief Subscribes a listener to a topic filter, creating its trie path.
+     */
+    Subscription onTopic(const char* filter, EventCallback&& callback);
+
+    /**
+     * @brief Removes a topic-filter subscription.
+     */
+    bool offTopic(uint16_t index, uint16_t generation);
+
+    /**
+     * @brief Finds or creates the child of a trie node for one level.
+     */
+    uint32_t topicChild(uint32_t node, uint32_t level, bool create);
+
+    /**
+     * @brief Dispatches to the filters under `node` that match the remaining levels of a topic.
+     * @param levels The unmatched part of the topic, or nullptr once every level matched.
+     */
+    void matchTopic(uint32_t node, const char* levels, void* payload);
+
+    /**
+     * @brief Whether any filter under `node` matches the remaining levels of a topic.
+     * @details Walks the same paths as matchTopic(), without calling anyone.
+     */
+    bool topicMatches(uint32_t node, const char* levels);
+
+    /**
+     * @brief Subscribes a typed-channel listener, checking the payload type.
+     * @param type A unique tag of the payload type (see EventChannel).
+     * @return A handle for off(), or 0 if the event carries another type or the table is full.
+     */
+    Subscription onTyped(EventId event, EventCallback callback, const void* type);
+
+    /**
+     * @brief Posts a typed-channel payload, checking the payload type.
+     * @param size The payload size, for an attached EventRecorder.
+     * @return False if the event carries another type.
+     */
+    bool postTyped(EventId event, const void* payload, size_t size, const void* type);
+
+    /**
+     * @brief Does the work of post(), with the payload size if known (for an attached EventRecorder).
+     * @param type The payload type tag, or nullptr for an untyped post. A payload
+     *             of another type than a typed event's is rejected.
+     * @return False if the post was rejected or dropped.
+     */
+    bool postSized(EventId event, void* payload, size_t size, const void* type);
+
     /**
-     * @brief A map that stores a vector of callbacks for each event name.
+     * @brief Does the work of postAsync(), checking a copied payload's type like postSized().
      */
-    std::map<std::string, std::vector<EventCallback>> _listeners;
+    bool postQueued(EventId event, const void* data, size_t size, EventPriority priority, const void* type);
+
+    /**
+     * @brief Checks that a typed event may carry `type`.
+     */
+    bool acceptsType(EventId event, const void* type);
+
+    /**
+     * @brief Gets the payload type tag of a typed event, or nullptr if it is untyped.
+     * @details Lets EventReplay post recorded payloads, which were checked when recorded.
+     */
+    const void* typeOf(EventId event);
+
+    static const size_t PRIORITY_COUNT = 3;
+
+    /**
+     * @struct QueuedEvent
+     * @brief One queued event with its copied payload.
+     */
+    struct QueuedEvent {
+        uint32_t id;
+        uint8_t size;
+        bool pooled; // `data` holds a pointer to a pooled payload, with a reference
+        uint64_t postedAt;
+        alignas(std::max_align_t) unsigned char data[NEXTINO_EVENTBUS_PAYLOAD_SIZE];
+    };
+
+    /**
+     * @struct EventQueue
+     * @brief A fixed ring of queued events of one priority class.
+     */
+    struct EventQueue {
+        QueuedEvent entries[NEXTINO_EVENTBUS_QUEUE_SIZE];
+        uint16_t head;
+        uint16_t count;
+    };
+
+    /**
+     * @brief Removes the oldest event of a queue and delivers it.
+     */
+    void dispatchOldest(EventQueue& queue);
+
+    /**
+     * @brief Applies any rate control, then queues a copy of `data`.
+     * @param pooled Whether `data` is a pointer to a pooled payload whose reference the queue takes over.
+     * @return False if dropped; a pooled reference then stays with the caller.
+     */
+    bool enqueue(EventId event, const void* data, size_t size, EventPriority priority, bool pooled, uint64_t postedAt);
+
+    /**
+     * @brief Queues a pooled payload by pointer, taking a reference to it.
+     * @param type The payload type tag, or nullptr for an untyped post.
+     */
+    bool postPooled(EventId event, void* payload, EventPriority priority, const void* type);
+
+    /**
+     * @brief Posts a pooled payload: synchronously on the owner task, queued from any other.
+     */
+    void postShared(EventId event, void* payload);
+
+    /**
+     * @brief Drops the reference held by a queued or coalesced pointer to a pooled payload.
+     */
+    static void releasePooled(const unsigned char* data);
+
+    /**
+     * @brief Checks whether the caller must go through the inbox: multi-producer mode, and not the owner task.
+     */
+    bool isForeignThread() const {
+        return _multiProducer.load(std::memory_order_acquire) && nextinoCurrentThread() != _owner.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Logs and returns true if an owner-only method was called from another task.
+     */
+    bool rejectForeign(const char* method) const;
+
+    /**
+     * @brief Copies an event into the inbox. Lock-free; safe from any task or ISR.
+     * @return False if the inbox is full.
+     */
+    bool forward(EventId event, const void* data, size_t size, EventPriority priority, bool pooled);
+
+    /**
+     * @brief Moves inbox events into the priority queues, while they have room. Owner task only.
+     */
+    void drainInbox();
+
+    /**
+     * @brief Keeps a copy of an event's name in its table slot, claiming the slot if needed.
+     * @details Queued events carry only their ID; the interned name lets topic
+     *          filters match them at dispatch. Called only for names a filter
+     *          matches, so events nobody listens to take no slot. Owner task only.
+     * @param entry The slot findSlot() returned for the event.
+     * @return The slot, or nullptr if the table is full.
+     */
+    EventEntry* internName(EventEntry* entry, EventId event);
+
+    /**
+     * @brief Checks that an event's name matches the one its slot holds, if both are known.
+     * @details Only with NEXTINO_EVENTBUS_CHECK_NAMES; otherwise always true.
+     * @param entry The event's slot, as findSlot() returned it.
+     * @param keep Whether to keep the name if the slot has none yet.
+     * @return False, with an error logged, if another name has the same hash.
+     */
+    bool checkName(EventEntry* entry, EventId event, bool keep);
+
+    /**
+     * @brief Logs the posts from other tasks dropped since the last call. Owner task only.
+     * @details Those tasks may be ISRs, which must not take the Logger's lock.
+     *          Also logs the queued events whose names found the event table
+     *          full, so a full table is reported once per batch, not per post.
+     */
+    void reportForeignDrops();
+
+    static const uint32_t INBOX_MASK = NEXTINO_EVENTBUS_INBOX_SIZE - 1;
+
+    /**
+     * @struct InboxCell
+     * @brief One inbox entry. `sequence` tells producers and the owner whose turn it is.
+     */
+    struct InboxCell {
+        std::atomic<uint32_t> sequence;
+        uint32_t id;
+        uint8_t size;
+        uint8_t priority;
+        bool pooled; // `data` holds a pointer to a pooled payload, with a reference
+        uint64_t postedAt;
+        alignas(std::max_align_t) unsigned char data[NEXTINO_EVENTBUS_PAYLOAD_SIZE];
+#if NEXTINO_EVENTBUS_INBOX_NAME_SIZE > 0
+        char name[NEXTINO_EVENTBUS_INBOX_NAME_SIZE]; // Empty if the post had no name, or a longer one
+#endif
+    };
+
+    /**
+     * @brief An open-addressing table of events, indexed by event ID (linear probing).
+     */
+    EventEntry _events[NEXTINO_EVENTBUS_MAX_EVENTS];
+    RateControl _rates[NEXTINO_EVENTBUS_MAX_RATE_CONTROLS];
+
+    std::deque<TopicNode> _topicNodes; // Node 0 is the root; a deque keeps nodes in place as it grows
+    std::vector<TopicSubscription> _topicSubscriptions;
+    uint16_t _freeTopicSubscription;
+    uint16_t _activeTopicSubscriptions;
+
+    EventQueue _queues[PRIORITY_COUNT]; // Indexed by EventPriority
+    QueueFullPolicy _queueFullPolicy;
+    size_t _queuedEvents;
+    size_t _peakQueuedEvents;
+    uint32_t _postedAsync;
+    uint32_t _dispatchedAsync;
+    uint32_t _droppedAsync;
+    uint32_t _blockedAsync;
+    TimingHistogram _queueLatency;
+
+    std::atomic<bool> _multiProducer;
+    std::atomic<const void*> _owner; // nextinoCurrentThread() of the owner task
+    InboxCell _inbox[NEXTINO_EVENTBUS_INBOX_SIZE];
+    std::atomic<uint32_t> _inboxEnqueue;
+    uint32_t _inboxDequeue; // Owner task only
+    std::atomic<uint32_t> _forwarded;
+    std::atomic<uint32_t> _inboxDropped;
+    std::atomic<uint32_t> _unreportedRawPayloads; // Raw-payload posts from other tasks, not logged yet
+    std::atomic<uint32_t> _unreportedOversized;   // Oversized posts from other tasks, not logged yet
+    std::atomic<uint32_t> _unreportedLongNames;   // Names from other tasks too long for the inbox, not logged yet
+    uint32_t _unreportedUnnamed;                  // Queued events whose name found the table full, not logged yet
+    std::atomic<WakeSignal*> _wakeSignal;
+
+    EventRecorder* _recorder; // Captures every post while attached, or nullptr
+    uint16_t _dispatchDepth;  // Listener calls in progress; posts made inside them are derived
 };
\ No newline at end of file
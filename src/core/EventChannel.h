@@ -0,0 +1,121 @@
+/**
+ * @file        EventChannel.h
+ * @title       Typed Event Channels
+ * @description Defines `EventChannel<T>`, a typed view of an EventBus event.
+ *              Subscribers receive `const T&` instead of a `void*` they must
+ *              cast, and synchronous delivery passes the publisher's object by
+ *              reference: no copy and no heap allocation per post. Queued
+ *              delivery copies the payload once into the EventBus ring, or
+ *              queues a reference to a pooled EventPayload<T>.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-02
+ * @version     0.1.0
+ *
+ * @copyright   (c) 2025 Nextino. All rights reserved.
+ * @license     MIT License
+ */
+
+#pragma once
+#include <type_traits>
+#include <utility>
+#include "EventBus.h"
+
+/**
+ * @class EventChannel
+ * @brief A compile-time typed handle to an EventBus event.
+ * @details A channel is just an EventId and a payload type, so it is usually a
+ *          `constexpr` constant in a header shared by publisher and subscribers.
+ *          The payload type is checked when subscribing and posting: an event
+ *          used with two different types is rejected with an error, and once
+ *          a channel has subscribed, posts of the event through the untyped
+ *          EventBus API are rejected if they carry a payload. One without a
+ *          payload, such as a plain `EventBus::post(id)`, reaches only the
+ *          plain listeners. Plain `EventBus::on()` listeners of the same event
+ *          still receive the payload as a `void*` to the same object.
+ *
+ * @code
+ * struct TempReading { float celsius; uint32_t at; };
+ * constexpr EventChannel<TempReading> TEMPERATURE("sensor_temperature");
+ *
+ * TEMPERATURE.on([this](const TempReading& reading) { show(reading.celsius); });
+ * TEMPERATURE.post({21.5f, millis()});
+ * @endcode
+ *
+ * @tparam T The payload type.
+ */
+template <typename T>
+class EventChannel {
+public:
+    using Payload = typename std::remove_cv<typename std::remove_reference<T>::type>::type;
+
+    constexpr explicit EventChannel(EventId event) : _event(event) {}
+
+    /**
+     * @brief Gets the underlying event ID.
+     */
+    constexpr EventId id() const { return _event; }
+
+    /**
+     * @brief Subscribes a listener taking `const T&`.
+     * @details The listener is called directly with the publisher's object; the
+     *          only type erasure is the EventBus callback it is stored in.
+     * @param listener Any callable accepting `const T&`.
+     * @return A handle for EventBus::off(), or 0 if the event already carries
+     *         another payload type or the table is full.
+     */
+    template <typename Listener>
+    EventBus::Subscription on(Listener listener) const {
+        return EventBus::getInstance().onTyped(
+            _event,
+            [listener](void* payload) {
+                // An untyped post without a payload carries nothing for this listener.
+                if (payload) {
+                    listener(*static_cast<const Payload*>(payload));
+                }
+            },
+            typeTag());
+    }
+
+    /**
+     * @brief Delivers `value` to every listener, synchronously and by reference.
+     * @param value The payload. Only needs to live until post() returns.
+     * @return False if the event carries another payload type.
+     */
+    bool post(const Payload& value) const {
+        return EventBus::getInstance().postTyped(_event, &value, sizeof(Payload), typeTag());
+    }
+
+    /**
+     * @brief Queues a copy of `value` for dispatch on a later loop pass.
+     * @see EventBus::postAsync()
+     * @param value The payload; must be trivially copyable and fit NEXTINO_EVENTBUS_PAYLOAD_SIZE.
+     * @param priority The priority class of this event.
+     * @return False if the payload type is wrong or the event was dropped.
+     */
+    bool postAsync(const Payload& value, EventPriority priority = EventPriority::Normal) const {
+        static_assert(std::is_trivially_copyable<Payload>::value, "Queued payloads are copied byte-wise.");
+        static_assert(sizeof(Payload) <= NEXTINO_EVENTBUS_PAYLOAD_SIZE, "Payload too large; raise NEXTINO_EVENTBUS_PAYLOAD_SIZE.");
+        return EventBus::getInstance().postQueued(_event, &value, sizeof(Payload), priority, typeTag());
+    }
+
+    /**
+     * @brief Queues a pooled payload; listeners get a reference to the pooled object itself.
+     * @see EventBus::postAsync(EventId, const EventPayload<T>&, EventPriority)
+     * @return False if the payload type is wrong, the handle is empty or the event was dropped.
+     */
+    bool postAsync(const EventPayload<Payload>& payload, EventPriority priority = EventPriority::Normal) const {
+        return EventBus::getInstance().postPooled(_event, payload.get(), priority, typeTag());
+    }
+
+private:
+    /**
+     * @brief A unique address per payload type; works without RTTI.
+     */
+    static const void* typeTag() {
+        static const char tag = 0;
+        return &tag;
+    }
+
+    EventId _event;
+};
@@ -0,0 +1,179 @@
+/**
+ * @file        EventPayload.cpp
+ * @title       Event Payload Pool Implementation
+ * @description Implements the size classes and lock-free free lists behind
+ *              the `EventPayloadPool` class.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-03
+ * @version     0.1.0
+ *
+ * @copyright   (c) 2025 Nextino. All rights reserved.
+ * @license     MIT License
+ */
+
+#include "EventPayload.h"
+#include "Logger.h"
+
+/**
+ * @brief Gets the singleton instance of the EventPayloadPool.
+ * @details Uses the Meyers' Singleton pattern for thread-safe, guaranteed initialization.
+ * @return A reference to the EventPayloadPool.
+ */
+EventPayloadPool& EventPayloadPool::getInstance() {
+    static EventPayloadPool instance;
+    return instance;
+}
+
+EventPayloadPool::EventPayloadPool() {
+    static const uint16_t sizes[CLASS_COUNT] = {16, 32, 64, 128};
+    static const uint16_t capacities[CLASS_COUNT] = {NEXTINO_PAYLOAD_POOL_BLOCKS_16, NEXTINO_PAYLOAD_POOL_BLOCKS_32,
+                                                     NEXTINO_PAYLOAD_POOL_BLOCKS_64, NEXTINO_PAYLOAD_POOL_BLOCKS_128};
+    static_assert(NEXTINO_PAYLOAD_POOL_BLOCKS_16 < NO_BLOCK && NEXTINO_PAYLOAD_POOL_BLOCKS_32 < NO_BLOCK &&
+                      NEXTINO_PAYLOAD_POOL_BLOCKS_64 < NO_BLOCK && NEXTINO_PAYLOAD_POOL_BLOCKS_128 < NO_BLOCK,
+                  "Each payload size class holds at most 65534 blocks.");
+
+    unsigned char* next = _storage;
+    for (size_t c = 0; c < CLASS_COUNT; ++c) {
+        SizeClass& sizeClass = _classes[c];
+        sizeClass.blocks = next;
+        sizeClass.blockSize = sizes[c];
+        sizeClass.capacity = capacities[c];
+        next += (size_t)capacities[c] * (HEADER_SIZE + sizes[c]);
+
+        // Chain every block into the free list, lowest address first.
+        for (uint16_t i = 0; i < sizeClass.capacity; ++i) {
+            Block* block = new (blockAt(sizeClass, i)) Block();
+            block->refs.store(0, std::memory_order_relaxed);
+            block->next.store(i + 1 < sizeClass.capacity ? i + 1 : NO_BLOCK, std::memory_order_relaxed);
+            block->sizeClass = (uint8_t)c;
+            block->requested = 0;
+            block->destroy = nullptr;
+        }
+        sizeClass.freeHead.store(sizeClass.capacity > 0 ? 0 : NO_BLOCK);
+        sizeClass.inUse.store(0);
+    }
+    resetStats();
+}
+
+void* EventPayloadPool::allocate(size_t size, void (*destroy)(void* payload)) {
+    // The smallest class that fits, then larger ones if it is exhausted.
+    size_t first = 0;
+    while (first < CLASS_COUNT && _classes[first].blockSize < size) {
+        first++;
+    }
+    for (size_t c = first; c < CLASS_COUNT; ++c) {
+        SizeClass& sizeClass = _classes[c];
+        Block* block = pop(sizeClass);
+        if (!block) {
+            continue;
+        }
+
+        block->refs.store(1, std::memory_order_relaxed);
+        block->requested = (uint16_t)size;
+        block->destroy = destroy;
+        sizeClass.allocations.fetch_add(1, std::memory_order_relaxed);
+        sizeClass.requestedBytes.fetch_add((uint32_t)size, std::memory_order_relaxed);
+        if (c != first) {
+            sizeClass.fallbacks.fetch_add(1, std::memory_order_relaxed);
+        }
+        uint32_t inUse = sizeClass.inUse.fetch_add(1, std::memory_order_relaxed) + 1;
+        uint32_t peak = sizeClass.peakInUse.load(std::memory_order_relaxed);
+        while (inUse > peak && !sizeClass.peakInUse.compare_exchange_weak(peak, inUse, std::memory_order_relaxed)) {
+        }
+        return reinterpret_cast<unsigned char*>(block) + HEADER_SIZE;
+    }
+
+    _classes[first < CLASS_COUNT ? first : CLASS_COUNT - 1].failures.fetch_add(1, std::memory_order_relaxed);
+    NEXTINO_CORE_LOG(LogLevel::Error, "EventPayload", "Cannot allocate a %u-byte payload: %s.", (unsigned)size,
+                     first < CLASS_COUNT ? "pool exhausted" : "too large");
+    return nullptr;
+}
+
+void EventPayloadPool::retain(void* payload) {
+    blockOf(payload)->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EventPayloadPool::release(void* payload) {
+    Block* block = blockOf(payload);
+    // acq_rel: the last holder must see every write made through the other references.
+    if (block->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    if (block->destroy) {
+        block->destroy(payload);
+    }
+    SizeClass& sizeClass = _classes[block->sizeClass];
+    sizeClass.requestedBytes.fetch_sub(block->requested, std::memory_order_relaxed);
+    sizeClass.inUse.fetch_sub(1, std::memory_order_relaxed);
+    sizeClass.releases.fetch_add(1, std::memory_order_relaxed);
+    push(sizeClass, block);
+}
+
+uint16_t EventPayloadPool::useCount(const void* payload) const {
+    return blockOf(payload)->refs.load(std::memory_order_relaxed);
+}
+
+bool EventPayloadPool::owns(const void* payload) const {
+    const unsigned char* address = static_cast<const unsigned char*>(payload);
+    for (const SizeClass& sizeClass : _classes) {
+        size_t stride = HEADER_SIZE + sizeClass.blockSize;
+        const unsigned char* end = sizeClass.blocks + (size_t)sizeClass.capacity * stride;
+        if (address >= sizeClass.blocks && address < end) {
+            return (size_t)(address - sizeClass.blocks) % stride == HEADER_SIZE;
+        }
+    }
+    return false;
+}
+
+PayloadPoolStats EventPayloadPool::getStats(size_t sizeClass) const {
+    const SizeClass& source = _classes[sizeClass < CLASS_COUNT ? sizeClass : CLASS_COUNT - 1];
+    PayloadPoolStats stats;
+    stats.blockSize = source.blockSize;
+    stats.capacity = source.capacity;
+    stats.inUse = source.inUse.load(std::memory_order_relaxed);
+    stats.peakInUse = source.peakInUse.load(std::memory_order_relaxed);
+    stats.requestedBytes = source.requestedBytes.load(std::memory_order_relaxed);
+    stats.allocations = source.allocations.load(std::memory_order_relaxed);
+    stats.releases = source.releases.load(std::memory_order_relaxed);
+    stats.fallbacks = source.fallbacks.load(std::memory_order_relaxed);
+    stats.failures = source.failures.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void EventPayloadPool::resetStats() {
+    for (SizeClass& sizeClass : _classes) {
+        sizeClass.peakInUse.store(sizeClass.inUse.load());
+        sizeClass.allocations.store(0);
+        sizeClass.releases.store(0);
+        sizeClass.fallbacks.store(0);
+        sizeClass.failures.store(0);
+    }
+}
+
+EventPayloadPool::Block* EventPayloadPool::pop(SizeClass& sizeClass) {
+    uint32_t head = sizeClass.freeHead.load(std::memory_order_acquire);
+    while (true) {
+        uint16_t index = (uint16_t)head;
+        if (index == NO_BLOCK) {
+            return nullptr;
+        }
+        Block* block = blockAt(sizeClass, index);
+        // The tag changes on every pop, so a block popped and pushed back by
+        // another thread meanwhile (ABA) makes this exchange fail.
+        uint32_t next = ((head + 0x10000u) & 0xFFFF0000u) | block->next.load(std::memory_order_relaxed);
+        if (sizeClass.freeHead.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire)) {
+            return block;
+        }
+    }
+}
+
+void EventPayloadPool::push(SizeClass& sizeClass, Block* block) {
+    uint16_t index = (uint16_t)(((unsigned char*)block - sizeClass.blocks) / (HEADER_SIZE + sizeClass.blockSize));
+    uint32_t head = sizeClass.freeHead.load(std::memory_order_relaxed);
+    do {
+        block->next.store((uint16_t)head, std::memory_order_relaxed);
+    } while (!sizeClass.freeHead.compare_exchange_weak(head, (head & 0xFFFF0000u) | index, std::memory_order_release,
+                                                        std::memory_order_relaxed));
+}
@@ -0,0 +1,274 @@
+/**
+ * @file        EventPayload.h
+ * @title       Pooled, Reference-Counted Event Payloads
+ * @description Defines `EventPayloadPool`, a singleton fixed-block allocator
+ *              with four size classes, and `EventPayload<T>`, a handle that
+ *              keeps a pooled object alive with an intrusive reference count.
+ *              A payload can be queued, fanned out to many listeners and kept
+ *              by any of them; it returns to the pool when the last reference
+ *              is released, never too early and without touching the heap.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-03
+ * @version     0.1.0
+ *
+ * @copyright   (c) 2025 Nextino. All rights reserved.
+ * @license     MIT License
+ */
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @def NEXTINO_PAYLOAD_POOL_BLOCKS_16
+ * @brief The number of 16-byte payload blocks. The other size classes are 32, 64 and 128 bytes.
+ */
+#ifndef NEXTINO_PAYLOAD_POOL_BLOCKS_16
+#define NEXTINO_PAYLOAD_POOL_BLOCKS_16 32
+#endif
+
+#ifndef NEXTINO_PAYLOAD_POOL_BLOCKS_32
+#define NEXTINO_PAYLOAD_POOL_BLOCKS_32 16
+#endif
+
+#ifndef NEXTINO_PAYLOAD_POOL_BLOCKS_64
+#define NEXTINO_PAYLOAD_POOL_BLOCKS_64 8
+#endif
+
+#ifndef NEXTINO_PAYLOAD_POOL_BLOCKS_128
+#define NEXTINO_PAYLOAD_POOL_BLOCKS_128 4
+#endif
+
+/**
+ * @struct PayloadPoolStats
+ * @brief A snapshot of the counters of one size class.
+ */
+struct PayloadPoolStats {
+    size_t blockSize;      /**< Payload bytes per block. */
+    size_t capacity;       /**< Blocks in this class. */
+    size_t inUse;          /**< Blocks currently allocated. */
+    size_t peakInUse;      /**< Highest number of blocks allocated at once. */
+    size_t requestedBytes; /**< Bytes asked for by the blocks in use; the rest of them is internal fragmentation. */
+    uint32_t allocations;  /**< Blocks handed out. */
+    uint32_t releases;     /**< Blocks returned. */
+    uint32_t fallbacks;    /**< Allocations served here because the smaller, fitting class was exhausted. */
+    uint32_t failures;     /**< Requests for this class that found no free block here or above. */
+};
+
+/**
+ * @class EventPayloadPool
+ * @brief A singleton fixed-block allocator for event payloads.
+ * @details Each size class is a contiguous array of blocks, each a small header
+ *          (reference count, size class, destructor) followed by the payload.
+ *          Free blocks form a lock-free stack per class, so allocating and
+ *          releasing are O(1), never fragment the heap, and are safe from
+ *          any task or thread. A request goes to the smallest class that fits
+ *          and falls back to larger classes when that one is exhausted.
+ */
+class EventPayloadPool {
+public:
+    static const size_t CLASS_COUNT = 4;
+
+    static EventPayloadPool& getInstance();
+
+    /**
+     * @brief Takes a block of at least `size` bytes, with a reference count of 1.
+     * @param size The payload size in bytes.
+     * @param destroy (Optional) Called on the payload when the last reference is released.
+     * @return The payload, aligned for any type, or nullptr if no class can hold it.
+     */
+    void* allocate(size_t size, void (*destroy)(void* payload) = nullptr);
+
+    /**
+     * @brief Adds a reference to a pooled payload.
+     */
+    void retain(void* payload);
+
+    /**
+     * @brief Drops a reference; the last one destroys the payload and frees its block.
+     */
+    void release(void* payload);
+
+    /**
+     * @brief Gets the current reference count of a pooled payload.
+     */
+    uint16_t useCount(const void* payload) const;
+
+    /**
+     * @brief Gets the size a pooled payload was allocated with.
+     */
+    size_t sizeOf(const void* payload) const { return blockOf(payload)->requested; }
+
+    /**
+     * @brief Checks whether a pointer is a payload allocated from this pool.
+     */
+    bool owns(const void* payload) const;
+
+    /**
+     * @brief Gets a snapshot of the counters of one size class (0 = 16 bytes ... 3 = 128 bytes).
+     */
+    PayloadPoolStats getStats(size_t sizeClass) const;
+
+    /**
+     * @brief Clears the counters of every class (not the allocated blocks).
+     */
+    void resetStats();
+
+private:
+    EventPayloadPool();
+
+    // Delete copy constructor and assignment operator to prevent copies
+    EventPayloadPool(const EventPayloadPool&) = delete;
+    void operator=(const EventPayloadPool&) = delete;
+
+    /**
+     * @struct Block
+     * @brief The header in front of every payload.
+     */
+    struct Block {
+        std::atomic<uint16_t> refs;
+        std::atomic<uint16_t> next; // Free-list link while free
+        uint8_t sizeClass;
+        uint16_t requested;
+        void (*destroy)(void* payload);
+    };
+
+    /**
+     * @struct SizeClass
+     * @brief One array of equal blocks and its free list.
+     */
+    struct SizeClass {
+        unsigned char* blocks;
+        uint16_t blockSize;
+        uint16_t capacity;
+        std::atomic<uint32_t> freeHead; // ABA tag (high 16 bits) and block index (low 16 bits)
+        std::atomic<uint32_t> inUse;
+        std::atomic<uint32_t> peakInUse;
+        std::atomic<uint32_t> requestedBytes;
+        std::atomic<uint32_t> allocations;
+        std::atomic<uint32_t> releases;
+        std::atomic<uint32_t> fallbacks;
+        std::atomic<uint32_t> failures;
+    };
+
+    static const uint16_t NO_BLOCK = 0xFFFF;
+    static const size_t HEADER_SIZE = (sizeof(Block) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+    static const size_t STORAGE_SIZE = NEXTINO_PAYLOAD_POOL_BLOCKS_16 * (HEADER_SIZE + 16) + NEXTINO_PAYLOAD_POOL_BLOCKS_32 * (HEADER_SIZE + 32) +
+                                       NEXTINO_PAYLOAD_POOL_BLOCKS_64 * (HEADER_SIZE + 64) + NEXTINO_PAYLOAD_POOL_BLOCKS_128 * (HEADER_SIZE + 128);
+
+    static Block* blockOf(const void* payload) {
+        return reinterpret_cast<Block*>(const_cast<unsigned char*>(static_cast<const unsigned char*>(payload)) - HEADER_SIZE);
+    }
+
+    Block* blockAt(const SizeClass& sizeClass, uint16_t index) const {
+        return reinterpret_cast<Block*>(sizeClass.blocks + (size_t)index * (HEADER_SIZE + sizeClass.blockSize));
+    }
+
+    Block* pop(SizeClass& sizeClass);
+    void push(SizeClass& sizeClass, Block* block);
+
+    alignas(std::max_align_t) unsigned char _storage[STORAGE_SIZE];
+    SizeClass _classes[CLASS_COUNT];
+};
+
+/**
+ * @class EventPayload
+ * @brief A reference-counted handle to a `T` in the EventPayloadPool.
+ * @details Copying a handle adds a reference and destroying one drops it, like
+ *          `std::shared_ptr`, but the count lives in the pooled block and
+ *          nothing is allocated on the heap. `EventBus::postAsync()` keeps a
+ *          reference until the event is dispatched; a listener that needs the
+ *          payload afterwards takes its own with `retain()`.
+ *
+ * @code
+ * auto frame = EventPayload<CanFrame>::make(id, data);
+ * if (frame) NextinoEvent().postAsync("can_frame", frame);
+ *
+ * NextinoEvent().on("can_frame", [this](void* payload) {
+ *     _backlog.push_back(EventPayload<CanFrame>::retain(payload)); // Kept past the dispatch
+ * });
+ * @endcode
+ *
+ * @tparam T The payload type; at most 128 bytes.
+ */
+template <typename T>
+class EventPayload {
+public:
+    static_assert(sizeof(T) <= 128, "Payload too large for the largest EventPayloadPool class.");
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Payload is over-aligned for the EventPayloadPool.");
+
+    EventPayload() : _object(nullptr) {}
+
+    /**
+     * @brief Constructs a `T` in a pooled block.
+     * @return The handle, or an empty one if the pool is exhausted.
+     */
+    template <typename... Args>
+    static EventPayload make(Args &&...args) {
+        void* block = EventPayloadPool::getInstance().allocate(sizeof(T), std::is_trivially_destructible<T>::value ? nullptr : &destroy);
+        EventPayload payload;
+        if (block) {
+            payload._object = new (block) T(std::forward<Args>(args)...);
+        }
+        return payload;
+    }
+
+    /**
+     * @brief Takes a new reference to a pooled payload, e.g. the `void*` a listener received.
+     */
+    static EventPayload retain(const void* payload) {
+        EventPayload handle;
+        if (payload) {
+            EventPayloadPool::getInstance().retain(const_cast<void*>(payload));
+            handle._object = static_cast<T*>(const_cast<void*>(payload));
+        }
+        return handle;
+    }
+
+    EventPayload(const EventPayload& other) : _object(other._object) {
+        if (_object) {
+            EventPayloadPool::getInstance().retain(_object);
+        }
+    }
+
+    EventPayload(EventPayload&& other) : _object(other._object) {
+        other._object = nullptr;
+    }
+
+    ~EventPayload() { reset(); }
+
+    EventPayload& operator=(EventPayload other) {
+        std::swap(_object, other._object);
+        return *this;
+    }
+
+    T* get() const { return _object; }
+    T& operator*() const { return *_object; }
+    T* operator->() const { return _object; }
+    explicit operator bool() const { return _object != nullptr; }
+
+    /**
+     * @brief Gets the number of references to the payload, or 0 if empty.
+     */
+    uint16_t useCount() const { return _object ? EventPayloadPool::getInstance().useCount(_object) : 0; }
+
+    /**
+     * @brief Drops this reference, leaving the handle empty.
+     */
+    void reset() {
+        if (_object) {
+            EventPayloadPool::getInstance().release(_object);
+            _object = nullptr;
+        }
+    }
+
+private:
+    static void destroy(void* payload) { static_cast<T*>(payload)->~T(); }
+
+    T* _object;
+};
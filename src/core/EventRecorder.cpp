@@ -0,0 +1,469 @@
+/**
+ * @file        EventRecorder.cpp
+ * @title       Event Recording and Replay Implementation
+ * @description Implements the binary record format, the RAM ring of the
+ *              `EventRecorder` class and the virtual-clock driver of the
+ *              `EventReplay` class.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-04
+ * @version     0.1.0
+ *
+ * @copyright   (c) 2025 Nextino. All rights reserved.
+ * @license     MIT License
+ */
+
+#include "EventRecorder.h"
+#include "Logger.h"
+#include "Platform.h"
+#include "Scheduler.h"
+#include <string.h> // For memcpy
+#include <vector>
+
+static const uint8_t MAGIC[4] = {'N', 'X', 'E', 'R'};
+
+/**
+ * @brief Appends a LEB128 varint (7 bits per byte, low bits first).
+ * @return The number of bytes written, at most 10.
+ */
+static size_t writeVarint(uint8_t* out, uint64_t value) {
+    size_t count = 0;
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        out[count++] = byte | (value ? 0x80 : 0);
+    } while (value);
+    return count;
+}
+
+EventRecorder::EventRecorder(uint8_t* buffer, size_t capacity)
+    : _buffer(buffer), _capacity(buffer ? capacity : 0), _head(0), _used(0), _baseTime(0), _lastTime(0),
+      _recording(false), _sizeCount(0), _stats{0, 0, 0, 0} {
+}
+
+EventRecorder::EventRecorder(Sink sink)
+    : _buffer(nullptr), _capacity(0), _sink(std::move(sink)), _head(0), _used(0), _baseTime(0), _lastTime(0),
+      _recording(false), _sizeCount(0), _stats{0, 0, 0, 0} {
+}
+
+EventRecorder::~EventRecorder() {
+    stop();
+}
+
+void EventRecorder::start() {
+    EventBus& bus = EventBus::getInstance();
+    if (bus._recorder && bus._recorder != this) {
+        bus._recorder->_recording = false;
+    }
+
+    _head = 0;
+    _used = 0;
+    _stats = {0, 0, 0, 0};
+    _baseTime = Scheduler::getInstance().nowMicros();
+    _lastTime = _baseTime;
+    if (_sink) {
+        uint8_t header[HEADER_SIZE];
+        writeHeader(header, _baseTime);
+        _sink(header, sizeof(header));
+        _stats.bytes = sizeof(header);
+    }
+    _recording = true;
+    bus._recorder = this;
+}
+
+void EventRecorder::stop() {
+    EventBus& bus = EventBus::getInstance();
+    if (bus._recorder == this) {
+        bus._recorder = nullptr;
+    }
+    if (_recording) {
+        // The end record keeps the quiet time after the last post, e.g. for pending timers.
+        uint8_t record[1 + 10];
+        store(record, beginRecord(record, End));
+    }
+    _recording = false;
+}
+
+bool EventRecorder::isRecording() const {
+    return _recording;
+}
+
+bool EventRecorder::setPayloadSize(EventId event, size_t size) {
+    for (size_t i = 0; i < _sizeCount; ++i) {
+        if (_sizes[i].id == event.value) {
+            _sizes[i].size = (uint16_t)size;
+            return true;
+        }
+    }
+    if (_sizeCount == NEXTINO_RECORDER_MAX_SIZED_EVENTS) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "Recorder", "Payload sizes already declared for %u events.",
+                         (unsigned)NEXTINO_RECORDER_MAX_SIZED_EVENTS);
+        return false;
+    }
+    _sizes[_sizeCount++] = {event.value, (uint16_t)size};
+    return true;
+}
+
+void EventRecorder::record(Kind kind, EventPriority priority, EventId event, const void* payload, size_t size) {
+    uint8_t record[MAX_RECORD_SIZE];
+    // Queued events use their name only for topic filters, so it is kept only while there are any.
+    const EventBus& bus = EventBus::getInstance();
+    const char* name = kind == Sync || bus._activeTopicSubscriptions > 0 ? event.name : nullptr;
+    uint8_t flags = (uint8_t)kind | (uint8_t)((uint8_t)priority << PRIORITY_SHIFT) | (payload ? HAS_PAYLOAD : 0) |
+                    (name ? HAS_NAME : 0) | (bus._dispatchDepth > 0 ? DERIVED : 0);
+    size_t length = beginRecord(record, flags);
+    for (int shift = 0; shift < 32; shift += 8) {
+        record[length++] = (uint8_t)(event.value >> shift);
+    }
+
+    if (payload) {
+        if (size == SIZE_UNKNOWN) {
+            size = 0; // Present but empty, unless declared with setPayloadSize()
+            for (size_t i = 0; i < _sizeCount; ++i) {
+                if (_sizes[i].id == event.value) {
+                    size = _sizes[i].size;
+                }
+            }
+        }
+        size_t captured = size < NEXTINO_RECORDER_MAX_PAYLOAD ? size : NEXTINO_RECORDER_MAX_PAYLOAD;
+        if (captured < size) {
+            _stats.truncated++;
+        }
+        length += writeVarint(record + length, size);
+        length += writeVarint(record + length, captured);
+        memcpy(record + length, payload, captured);
+        length += captured;
+    }
+    if (name) {
+        size_t nameLength = strnlen(name, 255);
+        record[length++] = (uint8_t)nameLength;
+        memcpy(record + length, name, nameLength);
+        length += nameLength;
+    }
+
+    _stats.recorded++;
+    store(record, length);
+}
+
+size_t EventRecorder::beginRecord(uint8_t* record, uint8_t flags) {
+    uint64_t now = Scheduler::getInstance().nowMicros();
+    uint64_t delta = now > _lastTime ? now - _lastTime : 0;
+    _lastTime += delta;
+    record[0] = flags;
+    return 1 + writeVarint(record + 1, delta);
+}
+
+void EventRecorder::store(const uint8_t* record, size_t length) {
+    if (_sink) {
+        _sink(record, length);
+        _stats.bytes += length;
+        return;
+    }
+    if (length > _capacity) {
+        return; // Cannot fit even in an empty ring
+    }
+    while (_capacity - _used < length) {
+        dropOldest();
+    }
+    append(record, length);
+}
+
+void EventRecorder::append(const uint8_t* data, size_t size) {
+    size_t tail = (_head + _used) % _capacity;
+    size_t first = size < _capacity - tail ? size : _capacity - tail;
+    memcpy(_buffer + tail, data, first);
+    memcpy(_buffer, data + first, size - first);
+    _used += size;
+}
+
+void EventRecorder::dropOldest() {
+    // Walk the oldest record to find its length; its delta moves into the base time.
+    size_t offset = _head;
+    uint8_t flags = byteAt(offset++);
+    uint64_t delta = 0;
+    for (int shift = 0;; shift += 7) {
+        uint8_t byte = byteAt(offset++);
+        delta |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            break;
+        }
+    }
+    if ((flags & KIND_MASK) != End) {
+        offset += 4; // Event ID
+    }
+    if (flags & HAS_PAYLOAD) {
+        for (int varint = 0; varint < 2; ++varint) {
+            uint64_t value = 0;
+            for (int shift = 0;; shift += 7) {
+                uint8_t byte = byteAt(offset++);
+                value |= (uint64_t)(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) {
+                    break;
+                }
+            }
+            if (varint == 1) {
+                offset += (size_t)value; // The captured bytes
+            }
+        }
+    }
+    if (flags & HAS_NAME) {
+        offset += 1 + byteAt(offset);
+    }
+
+    size_t length = offset - _head;
+    _baseTime += delta;
+    _head = (_head + length) % _capacity;
+    _used -= length;
+    _stats.overwritten++;
+}
+
+void EventRecorder::writeHeader(uint8_t* header, uint64_t startTime) const {
+    memcpy(header, MAGIC, sizeof(MAGIC));
+    header[4] = FORMAT_VERSION;
+    for (int i = 0; i < 8; ++i) {
+        header[5 + i] = (uint8_t)(startTime >> (8 * i));
+    }
+}
+
+size_t EventRecorder::writeTo(const Sink& sink) const {
+    if (_sink || !_buffer) {
+        return 0;
+    }
+    uint8_t header[HEADER_SIZE];
+    writeHeader(header, _baseTime);
+    sink(header, sizeof(header));
+
+    // The records, oldest first, in at most two pieces.
+    size_t first = _used < _capacity - _head ? _used : _capacity - _head;
+    if (first > 0) {
+        sink(_buffer + _head, first);
+    }
+    if (_used > first) {
+        sink(_buffer, _used - first);
+    }
+    return sizeof(header) + _used;
+}
+
+RecorderStats EventRecorder::getStats() const {
+    RecorderStats stats = _stats;
+    if (!_sink) {
+        stats.bytes = _used;
+    }
+    return stats;
+}
+
+// --- EventReplay ---
+
+uint64_t EventReplay::s_now = 0;
+
+uint64_t EventReplay::virtualClock() {
+    return s_now;
+}
+
+EventReplay::EventReplay(const uint8_t* stream, size_t size)
+    : _stream(stream), _size(stream ? size : 0), _position(0), _replayDerived(false), _speed(0.0f), _realStart(0), _recordStart(0) {
+}
+
+bool EventReplay::isValid() const {
+    return _size >= EventRecorder::HEADER_SIZE && memcmp(_stream, MAGIC, sizeof(MAGIC)) == 0 &&
+           _stream[4] == EventRecorder::FORMAT_VERSION;
+}
+
+void EventReplay::setLoopHook(LoopHook hook) {
+    _loop = std::move(hook);
+}
+
+void EventReplay::setReplayDerived(bool enabled) {
+    _replayDerived = enabled;
+}
+
+ReplayStats EventReplay::run(float speed) {
+    ReplayStats stats = {0, 0, 0, false, 0, 0};
+    if (!isValid()) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "Replay", "Not a recording (bad header or version).");
+        return stats;
+    }
+
+    uint64_t start = 0;
+    for (int i = 0; i < 8; ++i) {
+        start |= (uint64_t)_stream[5 + i] << (8 * i);
+    }
+    Scheduler& scheduler = Scheduler::getInstance();
+    Scheduler::TimeSource previousClock = scheduler.getTimeSource();
+    s_now = start;
+    scheduler.setTimeSource(&EventReplay::virtualClock);
+    EventBus::getInstance().restartRateWindows();
+
+    _speed = speed;
+    _realStart = nextinoMicros64();
+    _recordStart = start;
+    _position = EventRecorder::HEADER_SIZE;
+    uint64_t time = start;
+    while (_position < _size && replayRecord(time, stats)) {
+    }
+    stats.complete = _position == _size;
+    advanceTo(time); // Deliver what the last records queued
+
+    scheduler.setTimeSource(previousClock);
+    stats.recordedUs = time - start;
+    stats.elapsedUs = nextinoMicros64() - _realStart;
+    if (!stats.complete) {
+        NEXTINO_CORE_LOG(LogLevel::Error, "Replay", "Malformed record at byte %u; replay stopped.", (unsigned)_position);
+    }
+    return stats;
+}
+
+void EventReplay::runPass() {
+    if (_loop) {
+        _loop();
+        return;
+    }
+    EventBus& bus = EventBus::getInstance();
+    // Drain the queue as the main loop would over several passes at this instant.
+    for (size_t passes = 0; passes < 1000; ++passes) {
+        bus.dispatchQueued();
+        Scheduler::getInstance().loop();
+        if (!bus.hasQueuedEvents()) {
+            break;
+        }
+    }
+}
+
+void EventReplay::waitForRealTime(uint64_t virtualTime) {
+    if (_speed <= 0.0f) {
+        return;
+    }
+    uint64_t due = _realStart + (uint64_t)((double)(virtualTime - _recordStart) / _speed);
+    while (true) {
+        uint64_t now = nextinoMicros64();
+        if (now >= due) {
+            return;
+        }
+        if (due - now > 2000) {
+            delay((unsigned long)((due - now) / 1000 - 1));
+        } else {
+            yield();
+        }
+    }
+}
+
+void EventReplay::advanceTo(uint64_t until) {
+    Scheduler& scheduler = Scheduler::getInstance();
+    runPass();
+    // Jump from deadline to deadline, so every task runs at its exact due time.
+    while (true) {
+        Scheduler::Timestamp wait = scheduler.getTimeUntilNextDeadlineMicros();
+        if (wait == Scheduler::NO_DEADLINE_MICROS || s_now + wait > until) {
+            break;
+        }
+        s_now += wait > 0 ? wait : 1; // A due task held back by its slack still moves time on
+        waitForRealTime(s_now);
+        runPass();
+    }
+    s_now = until;
+    waitForRealTime(s_now);
+}
+
+bool EventReplay::readVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (_position >= _size) {
+            return false;
+        }
+        uint8_t byte = _stream[_position++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool EventReplay::replayRecord(uint64_t& time, ReplayStats& stats) {
+    size_t recordStart = _position;
+    uint8_t flags = _stream[_position++];
+    uint64_t delta, size = 0, captured = 0;
+    if (!readVarint(delta)) {
+        _position = recordStart;
+        return false;
+    }
+    uint8_t kind = flags & EventRecorder::KIND_MASK;
+    if (kind == EventRecorder::End) {
+        time += delta;
+        advanceTo(time);
+        return true;
+    }
+    if (_position + 4 > _size) {
+        _position = recordStart;
+        return false;
+    }
+    uint32_t id = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        id |= (uint32_t)_stream[_position++] << shift;
+    }
+
+    const uint8_t* payload = nullptr;
+    if (flags & EventRecorder::HAS_PAYLOAD) {
+        if (!readVarint(size) || !readVarint(captured) || captured > size || captured > _size - _position || size > 0xFFFF) {
+            _position = recordStart;
+            return false;
+        }
+        payload = _stream + _position;
+        _position += (size_t)captured;
+    }
+    char name[256];
+    if (flags & EventRecorder::HAS_NAME) {
+        if (_position >= _size || (size_t)_stream[_position] + 1 > _size - _position) {
+            _position = recordStart;
+            return false;
+        }
+        size_t length = _stream[_position++];
+        memcpy(name, _stream + _position, length);
+        name[length] = '\0';
+        _position += length;
+    }
+
+    if (kind == EventRecorder::Pooled && !payload) {
+        _position = recordStart;
+        return false;
+    }
+
+    time += delta;
+    advanceTo(time);
+    if ((flags & EventRecorder::DERIVED) && !_replayDerived) {
+        stats.skipped++;
+        return true;
+    }
+
+    EventBus& bus = EventBus::getInstance();
+    // The payload was type-checked when it was recorded: post it as the event's own type.
+    const void* type = bus.typeOf(EventId::fromValue(id));
+    EventPriority priority = (EventPriority)((flags >> EventRecorder::PRIORITY_SHIFT) & 0x03);
+    EventId event = EventId::fromValue(id, (flags & EventRecorder::HAS_NAME) ? name : nullptr);
+    if (kind == EventRecorder::Pooled) {
+        EventPayloadPool& pool = EventPayloadPool::getInstance();
+        void* block = pool.allocate((size_t)size);
+        if (!block) {
+            stats.failed++;
+            return true;
+        }
+        memset(block, 0, (size_t)size);
+        memcpy(block, payload, (size_t)captured);
+        bus.postPooled(event, block, priority, type);
+        pool.release(block);
+    } else {
+        // A zero-padded, aligned copy: truncated payloads keep their original size.
+        std::vector<std::max_align_t> copy(payload ? ((size_t)size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t) + 1 : 0);
+        if (payload) {
+            memset(copy.data(), 0, copy.size() * sizeof(std::max_align_t));
+            memcpy(copy.data(), payload, (size_t)captured);
+        }
+        if (kind == EventRecorder::Sync) {
+            bus.postSized(event, payload ? copy.data() : nullptr, EventRecorder::SIZE_UNKNOWN, type);
+        } else {
+            bus.postQueued(event, payload ? copy.data() : nullptr, (size_t)size, priority, type);
+        }
+    }
+    stats.posted++;
+    return true;
+}
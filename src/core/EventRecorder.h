@@ -0,0 +1,332 @@
+/**
+ * @file        EventRecorder.h
+ * @title       Event Recording and Deterministic Replay
+ * @description Defines `EventRecorder`, which captures every EventBus post (its
+ *              time, event ID, name, priority and a snapshot of its payload) as
+ *              a compact binary stream, kept in a RAM ring or streamed to a
+ *              file, and `EventReplay`, which re-injects such a stream into the
+ *              EventBus under a virtual Scheduler clock, as fast as possible or
+ *              at the recorded speed. A trace captured on a device can then be
+ *              replayed on the bench or in a host test, with the same timing
+ *              seen by rate controls, scheduled tasks and listeners.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-04
+ * @version     0.1.0
+ *
+ * @copyright   (c) 2025 Nextino. All rights reserved.
+ * @license     MIT License
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "EventBus.h"
+
+/**
+ * @def NEXTINO_RECORDER_MAX_PAYLOAD
+ * @brief The most payload bytes captured per post; larger payloads are truncated.
+ */
+#ifndef NEXTINO_RECORDER_MAX_PAYLOAD
+#define NEXTINO_RECORDER_MAX_PAYLOAD 64
+#endif
+
+/**
+ * @def NEXTINO_RECORDER_MAX_SIZED_EVENTS
+ * @brief The number of events whose raw `post()` payload size can be declared with setPayloadSize().
+ */
+#ifndef NEXTINO_RECORDER_MAX_SIZED_EVENTS
+#define NEXTINO_RECORDER_MAX_SIZED_EVENTS 8
+#endif
+
+/**
+ * @struct RecorderStats
+ * @brief The counters of an EventRecorder.
+ */
+struct RecorderStats {
+    uint32_t recorded;    /**< Posts captured. */
+    uint32_t overwritten; /**< Oldest records dropped from a full ring. */
+    uint32_t truncated;   /**< Payloads larger than NEXTINO_RECORDER_MAX_PAYLOAD, captured in part. */
+    size_t bytes;         /**< Bytes of records currently held (ring) or written so far (stream). */
+};
+
+/**
+ * @class EventRecorder
+ * @brief Captures EventBus posts as a compact binary stream.
+ * @details The stream starts with a 13-byte header ("NXER", a version and the
+ *          64-bit start time), followed by one record per post:
+ *
+ *          | Field | Size |
+ *          | :--- | :--- |
+ *          | Flags: kind (post, postAsync, pooled, end), priority, payload, name, derived | 1 byte |
+ *          | Time since the previous record, in microseconds | varint |
+ *          | Event ID (except in the end record written by stop()) | 4 bytes |
+ *          | Payload size, captured size and bytes (if any) | 2 varints + bytes |
+ *          | Name length and characters (if any) | 1 byte + bytes |
+ *
+ *          A post with a small payload and no name takes about 9 bytes plus
+ *          the payload. Sizes are known for postAsync(), typed channels and
+ *          pooled payloads; for a raw `post(event, pointer)` declare the size
+ *          with setPayloadSize(), or the payload is recorded as present but empty.
+ *
+ *          In ring mode, the records live in a caller-supplied buffer and the
+ *          oldest are overwritten when it fills, so it always holds the latest
+ *          stretch of activity, like a flight recorder; writeTo() exports it as
+ *          a complete stream. In stream mode, every record goes straight to a
+ *          sink, e.g. a file. Only one recorder can be attached at a time.
+ *          Posts are captured on the task that owns the bus; those from other
+ *          tasks in multi-producer mode are captured when they leave the inbox.
+ *          Posts made by a listener are flagged as derived, so a replay can
+ *          leave them to the listener instead of delivering them twice.
+ *
+ * @code
+ * static uint8_t traceBuffer[4096];
+ * static EventRecorder recorder(traceBuffer, sizeof(traceBuffer));
+ * recorder.start();
+ * // ... later, e.g. from a "dump_trace" command:
+ * recorder.writeTo([](const uint8_t* data, size_t size) { Serial.write(data, size); });
+ * @endcode
+ */
+class EventRecorder {
+public:
+    /**
+     * @typedef Sink
+     * @brief Receives a chunk of the binary stream.
+     */
+    using Sink = std::function<void(const uint8_t* data, size_t size)>;
+
+    static const uint8_t FORMAT_VERSION = 1;
+    static const size_t HEADER_SIZE = 13;
+
+    /**
+     * @brief Creates a recorder that keeps the latest records in a RAM ring.
+     * @param buffer The ring storage; must outlive the recorder.
+     * @param capacity The size of `buffer`, in bytes.
+     */
+    EventRecorder(uint8_t* buffer, size_t capacity);
+
+    /**
+     * @brief Creates a recorder that streams every record to a sink.
+     * @details The header is written on start().
+     * @code
+     * FILE* file = fopen("trace.nxer", "wb");
+     * EventRecorder recorder([file](const uint8_t* data, size_t size) { fwrite(data, 1, size, file); });
+     * @endcode
+     */
+    explicit EventRecorder(Sink sink);
+
+    ~EventRecorder();
+
+    // A recorder is attached to the bus by address; never copy it.
+    EventRecorder(const EventRecorder&) = delete;
+    void operator=(const EventRecorder&) = delete;
+
+    /**
+     * @brief Attaches the recorder to the EventBus and starts capturing.
+     * @details Replaces any other attached recorder. Clears the ring.
+     */
+    void start();
+
+    /**
+     * @brief Detaches the recorder and records the stop time. The ring keeps its records.
+     */
+    void stop();
+
+    /**
+     * @brief Checks whether the recorder is attached.
+     */
+    bool isRecording() const;
+
+    /**
+     * @brief Declares the payload size of raw `post(event, pointer)` calls of an event.
+     * @return False if NEXTINO_RECORDER_MAX_SIZED_EVENTS events already have a size.
+     */
+    bool setPayloadSize(EventId event, size_t size);
+
+    /**
+     * @brief Exports the ring as a complete stream: header, then the records, oldest first.
+     * @return The number of bytes written, or 0 in stream mode.
+     */
+    size_t writeTo(const Sink& sink) const;
+
+    /**
+     * @brief Gets the recorder's counters.
+     */
+    RecorderStats getStats() const;
+
+private:
+    friend class EventBus;
+    friend class EventReplay;
+
+    static const uint8_t KIND_MASK = 0x03;
+    static const uint8_t PRIORITY_SHIFT = 2;
+    static const uint8_t HAS_PAYLOAD = 0x10;
+    static const uint8_t HAS_NAME = 0x20;
+    static const uint8_t DERIVED = 0x40; // Posted by a listener
+    static const size_t MAX_RECORD_SIZE = 1 + 10 + 4 + 10 + 10 + NEXTINO_RECORDER_MAX_PAYLOAD + 1 + 255;
+
+    /**
+     * @brief How a post reached the bus.
+     */
+    enum Kind : uint8_t {
+        Sync = 0,  /**< post() */
+        Async = 1, /**< postAsync() with a copied payload */
+        Pooled = 2, /**< postAsync() with an EventPayload */
+        End = 3     /**< stop(): only the flags and the time */
+    };
+
+    /**
+     * @brief Captures one post. Called by the EventBus.
+     * @param size The payload size, or SIZE_UNKNOWN for a raw post() payload.
+     */
+    void record(Kind kind, EventPriority priority, EventId event, const void* payload, size_t size);
+
+    static const size_t SIZE_UNKNOWN = (size_t)-1;
+
+    /**
+     * @brief Starts a record: the flags and the time since the previous record.
+     * @return The bytes written.
+     */
+    size_t beginRecord(uint8_t* record, uint8_t flags);
+
+    /**
+     * @brief Sends a complete record to the sink, or into the ring.
+     */
+    void store(const uint8_t* record, size_t length);
+
+    void writeHeader(uint8_t* header, uint64_t startTime) const;
+    void append(const uint8_t* data, size_t size);
+    void dropOldest();
+    uint8_t byteAt(size_t offset) const { return _buffer[offset % _capacity]; }
+
+    struct SizedEvent {
+        uint32_t id;
+        uint16_t size;
+    };
+
+    uint8_t* _buffer;
+    size_t _capacity;
+    Sink _sink;
+    size_t _head; // Offset of the oldest record
+    size_t _used; // Bytes of records in the ring
+    uint64_t _baseTime; // Time the oldest record's delta counts from
+    uint64_t _lastTime; // Time of the newest record
+    bool _recording;
+    SizedEvent _sizes[NEXTINO_RECORDER_MAX_SIZED_EVENTS];
+    size_t _sizeCount;
+    RecorderStats _stats;
+};
+
+/**
+ * @struct ReplayStats
+ * @brief The outcome of an EventReplay run.
+ */
+struct ReplayStats {
+    uint32_t posted;       /**< Records re-injected into the EventBus. */
+    uint32_t skipped;      /**< Derived records left to the listeners that post them. */
+    uint32_t failed;       /**< Pooled records that found the pool exhausted. */
+    bool complete;         /**< The whole stream was valid and replayed. */
+    uint64_t recordedUs;   /**< Time span of the recording, up to stop() if it was called. */
+    uint64_t elapsedUs;    /**< Real time the replay took. */
+};
+
+/**
+ * @class EventReplay
+ * @brief Re-injects a recorded stream into the EventBus under a virtual clock.
+ * @details While it runs, the Scheduler's time source is a virtual clock that
+ *          starts at the recording's start time and jumps from deadline to
+ *          deadline: before each record, every Scheduler task due until the
+ *          record's time runs at its exact due time and queued events are
+ *          dispatched; then the record is posted the way it was originally
+ *          (post(), postAsync() with its priority, or a pooled payload). Rate
+ *          controls, timers and listeners therefore see the recorded timing.
+ *          Each run restarts the windows of rate-controlled events, so two
+ *          replays of a stream behave identically.
+ *
+ *          With `speed` 0 the replay runs as fast as possible, which measures
+ *          handler throughput against a real trace. Any other speed also waits
+ *          in real time between records: 1.0 is the recorded pace, 10.0 is ten
+ *          times faster. The stream must stay valid while the replay runs.
+ *
+ * @code
+ * std::vector<uint8_t> trace = readFile("field-trace.nxer");
+ * EventReplay replay(trace.data(), trace.size());
+ * ReplayStats stats = replay.run(0); // As fast as possible
+ * printf("%u events in %llu us\n", stats.posted, stats.elapsedUs);
+ * @endcode
+ */
+class EventReplay {
+public:
+    /**
+     * @typedef LoopHook
+     * @brief Runs one pass of the system under the virtual clock.
+     * @details Defaults to EventBus::dispatchQueued() and Scheduler::loop(). A
+     *          full application can run `NextinoSystem().loop()` instead, with
+     *          its idle mode off.
+     */
+    using LoopHook = std::function<void()>;
+
+    EventReplay(const uint8_t* stream, size_t size);
+
+    /**
+     * @brief Checks the stream header.
+     */
+    bool isValid() const;
+
+    /**
+     * @brief Replaces the pass run between records.
+     */
+    void setLoopHook(LoopHook hook);
+
+    /**
+     * @brief Also re-posts derived records, those posted by a listener.
+     * @details Off by default: the replayed listeners post them again, and
+     *          posting the recorded copies too would deliver them twice. Turn
+     *          it on when the listeners that posted them are not present.
+     */
+    void setReplayDerived(bool enabled);
+
+    /**
+     * @brief Replays the whole stream, up to the time the recording stopped.
+     * @details Restores the Scheduler's previous clock when done.
+     * @param speed 0 for as fast as possible, else a multiple of the recorded pace.
+     */
+    ReplayStats run(float speed = 0.0f);
+
+private:
+    /**
+     * @brief Runs every Scheduler deadline up to `until`, each at its exact time.
+     */
+    void advanceTo(uint64_t until);
+
+    /**
+     * @brief Runs the loop hook, or dispatches until the queue is empty and runs the Scheduler.
+     */
+    void runPass();
+
+    /**
+     * @brief When paced, waits until the real time that corresponds to `virtualTime`.
+     */
+    void waitForRealTime(uint64_t virtualTime);
+
+    /**
+     * @brief Decodes the record at `_position`, advances the clock to it and posts it.
+     * @return False if the record is malformed.
+     */
+    bool replayRecord(uint64_t& time, ReplayStats& stats);
+
+    bool readVarint(uint64_t& value);
+
+    static uint64_t virtualClock();
+    static uint64_t s_now; // The virtual time; one replay runs at a time
+
+    const uint8_t* _stream;
+    size_t _size;
+    size_t _position;
+    LoopHook _loop;
+    bool _replayDerived;
+    float _speed;
+    uint64_t _realStart;   // Real time the replay started
+    uint64_t _recordStart; // Recorded time it started from
+};
@@ -0,0 +1,319 @@
+/**
+ * @file        Executor.cpp
+ * @title       Work-Stealing Executor Implementation
+ * @description Implements the worker pool, the per-worker deques and the
+ *              platform-specific thread and sleep logic of the `Executor`.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-08-30
+ * @version     0.1.0
+ *
+ * @copyright   (c) 2025 Nextino. All rights reserved.
+ * @license     MIT License
+ */
+
+#include "Executor.h"
+#include "Logger.h"
+#include "Platform.h"
+
+/**
+ * @brief Gets the singleton instance of the Executor.
+ * @details Uses the Meyers' Singleton pattern for thread-safe, guaranteed initialization.
+ * @return A reference to the Executor.
+ */
+Executor& Executor::getInstance() {
+    static Executor instance;
+    return instance;
+}
+
+Executor::Executor()
+    : _workerCount(0), _nextWorker(0), _running(false), _queued(0), _outstanding(0),
+      _submitted(0), _executed(0), _stolen(0), _rejected(0) {
+    for (uint8_t i = 0; i < NEXTINO_EXECUTOR_MAX_WORKERS; ++i) {
+        _workers[i].head = 0;
+        _workers[i].count = 0;
+        _workers[i].freeCount = NEXTINO_EXECUTOR_QUEUE_SIZE;
+        for (uint16_t slot = 0; slot < NEXTINO_EXECUTOR_QUEUE_SIZE; ++slot) {
+            _workers[i].freeSlots[slot] = slot;
+        }
+#if defined(ESP32)
+        portMUX_INITIALIZE(&_workers[i].lock);
+        _workers[i].task = NULL;
+#endif
+    }
+#if defined(ESP32)
+    _workAvailable = xSemaphoreCreateCounting(0xFFFF, 0);
+    _liveWorkers.store(0);
+#endif
+}
+
+bool Executor::start(uint8_t workerCount) {
+#if NEXTINO_EXECUTOR_SUPPORTED
+    if (_running.load()) {
+        return true;
+    }
+
+    if (workerCount == 0) {
+#if defined(ESP32)
+        workerCount = portNUM_PROCESSORS;
+#else
+        unsigned cores = std::thread::hardware_concurrency();
+        workerCount = (uint8_t)(cores > 0 && cores < 255 ? cores : 1);
+#endif
+    }
+    if (workerCount > NEXTINO_EXECUTOR_MAX_WORKERS) {
+        workerCount = NEXTINO_EXECUTOR_MAX_WORKERS;
+    }
+
+    _workerCount = workerCount;
+    _running.store(true);
+
+    for (uint8_t i = 0; i < _workerCount; ++i) {
+#if defined(ESP32)
+        if (_workAvailable == NULL ||
+            xTaskCreatePinnedToCore(&Executor::workerEntry, "nextino_worker", NEXTINO_EXECUTOR_STACK_SIZE, &_workers[i],
+                                    NEXTINO_EXECUTOR_TASK_PRIORITY, &_workers[i].task, i % portNUM_PROCESSORS) != pdPASS) {
+            NEXTINO_CORE_LOG(LogLevel::Error, "Executor", "Failed to create worker task %u.", (unsigned)i);
+            _workerCount = i;
+            stop();
+            return false;
+        }
+        _liveWorkers++;
+#else
+        _workers[i].thread = std::thread(&Executor::runWorker, this, i);
+#endif
+    }
+
+    NEXTINO_CORE_LOG(LogLevel::Info, "Executor", "Started %u worker(s).", (unsigned)_workerCount);
+    return true;
+#else
+    (void)workerCount;
+    NEXTINO_CORE_LOG(LogLevel::Warn, "Executor", "No executor on this target; tasks stay on the main loop.");
+    return false;
+#endif
+}
+
+void Executor::stop() {
+    if (!_running.load()) {
+        return;
+    }
+
+    waitIdle();
+    _running.store(false);
+    signalWork(true);
+
+#if defined(ESP32)
+    while (_liveWorkers.load() > 0) {
+        delay(1);
+    }
+#elif !defined(ARDUINO)
+    for (uint8_t i = 0; i < _workerCount; ++i) {
+        if (_workers[i].thread.joinable()) {
+            _workers[i].thread.join();
+        }
+    }
+#endif
+
+    NEXTINO_CORE_LOG(LogLevel::Info, "Executor", "Stopped %u worker(s).", (unsigned)_workerCount);
+    _workerCount = 0;
+}
+
+bool Executor::isRunning() const {
+    return _running.load();
+}
+
+bool Executor::submit(const Job& job, std::atomic<uint16_t>* pending) {
+    if (!_running.load() || _workerCount == 0) {
+        _rejected++;
+        return false;
+    }
+
+    // Round-robin placement; if that deque is full, try the others in turn.
+    uint8_t first = (uint8_t)(_nextWorker.fetch_add(1) % _workerCount);
+    for (uint8_t i = 0; i < _workerCount; ++i) {
+        Worker& worker = _workers[(first + i) % _workerCount];
+        // Count the job before it becomes visible, so a fast worker never
+        // drives the counters below zero.
+        _outstanding++;
+        _queued++;
+        if (pushBack(worker, job, pending)) {
+            _submitted++;
+            signalWork(false);
+            return true;
+        }
+        _queued--;
+        _outstanding--;
+    }
+
+    _rejected++;
+    return false;
+}
+
+void Executor::waitIdle() const {
+    while (_outstanding.load() != 0) {
+        yield();
+    }
+}
+
+ExecutorStats Executor::getStats() const {
+    return {(uint8_t)(_running.load() ? _workerCount : 0), _submitted.load(), _executed.load(), _stolen.load(), _rejected.load()};
+}
+
+void Executor::lockWorker(Worker& worker) {
+#if defined(ESP32)
+    portENTER_CRITICAL(&worker.lock);
+#elif !defined(ARDUINO)
+    worker.lock.lock();
+#else
+    (void)worker;
+#endif
+}
+
+void Executor::unlockWorker(Worker& worker) {
+#if defined(ESP32)
+    portEXIT_CRITICAL(&worker.lock);
+#elif !defined(ARDUINO)
+    worker.lock.unlock();
+#else
+    (void)worker;
+#endif
+}
+
+bool Executor::pushBack(Worker& worker, const Job& job, std::atomic<uint16_t>* pending) {
+    lockWorker(worker);
+    if (worker.freeCount == 0) {
+        unlockWorker(worker);
+        return false;
+    }
+    uint16_t slot = worker.freeSlots[--worker.freeCount];
+    unlockWorker(worker);
+
+    // The slot is ours until it is queued: copy the job without the lock.
+    worker.jobs[slot].job = job;
+    worker.jobs[slot].pending = pending;
+
+    lockWorker(worker);
+    worker.ring[(worker.head + worker.count) % NEXTINO_EXECUTOR_QUEUE_SIZE] = slot;
+    worker.count++;
+    unlockWorker(worker);
+    return true;
+}
+
+bool Executor::popBack(Worker& worker, uint16_t& slot) {
+    lockWorker(worker);
+    if (worker.count == 0) {
+        unlockWorker(worker);
+        return false;
+    }
+    worker.count--;
+    slot = worker.ring[(worker.head + worker.count) % NEXTINO_EXECUTOR_QUEUE_SIZE];
+    unlockWorker(worker);
+    return true;
+}
+
+bool Executor::popFront(Worker& worker, uint16_t& slot) {
+    lockWorker(worker);
+    if (worker.count == 0) {
+        unlockWorker(worker);
+        return false;
+    }
+    slot = worker.ring[worker.head];
+    worker.head = (uint16_t)((worker.head + 1) % NEXTINO_EXECUTOR_QUEUE_SIZE);
+    worker.count--;
+    unlockWorker(worker);
+    return true;
+}
+
+void Executor::releaseSlot(Worker& worker, uint16_t slot) {
+    lockWorker(worker);
+    worker.freeSlots[worker.freeCount++] = slot;
+    unlockWorker(worker);
+}
+
+bool Executor::findJob(uint8_t self, Worker*& owner, uint16_t& slot) {
+    if (_queued.load() == 0) {
+        return false;
+    }
+
+    // Own deque first, newest job first; then steal the oldest job of a peer.
+    if (popBack(_workers[self], slot)) {
+        owner = &_workers[self];
+        _queued--;
+        return true;
+    }
+    for (uint8_t i = 1; i < _workerCount; ++i) {
+        Worker& peer = _workers[(self + i) % _workerCount];
+        if (popFront(peer, slot)) {
+            owner = &peer;
+            _queued--;
+            _stolen++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Executor::runWorker(uint8_t self) {
+    Worker* owner;
+    uint16_t slot;
+    while (true) {
+        if (findJob(self, owner, slot)) {
+            // Run the job in place; the slot returns to its worker afterwards.
+            QueuedJob& entry = owner->jobs[slot];
+            std::atomic<uint16_t>* pending = entry.pending;
+            entry.job();
+            entry.job.reset();
+            releaseSlot(*owner, slot);
+            if (pending) {
+                pending->fetch_sub(1);
+            }
+            _executed++;
+            _outstanding--;
+            continue;
+        }
+        if (!_running.load()) {
+            break;
+        }
+        waitForWork();
+    }
+}
+
+void Executor::waitForWork() {
+#if defined(ESP32)
+    // The timeout only guards against a missed stop(); jobs give a token each.
+    xSemaphoreTake(_workAvailable, pdMS_TO_TICKS(100));
+#elif !defined(ARDUINO)
+    std::unique_lock<std::mutex> lock(_sleepMutex);
+    _workAvailable.wait(lock, [this]() { return _queued.load() > 0 || !_running.load(); });
+#endif
+}
+
+void Executor::signalWork(bool all) {
+#if defined(ESP32)
+    uint8_t tokens = all ? _workerCount : 1;
+    for (uint8_t i = 0; i < tokens; ++i) {
+        xSemaphoreGive(_workAvailable);
+    }
+#elif !defined(ARDUINO)
+    // Taking the mutex orders this notify after a sleeper's predicate check.
+    std::lock_guard<std::mutex> lock(_sleepMutex);
+    if (all) {
+        _workAvailable.notify_all();
+    } else {
+        _workAvailable.notify_one();
+    }
+#else
+    (void)all;
+#endif
+}
+
+#if defined(ESP32)
+void Executor::workerEntry(void* parameter) {
+    Executor& executor = Executor::getInstance();
+    uint8_t self = (uint8_t)((Worker*)parameter - executor._workers);
+    executor.runWorker(self);
+    executor._workers[self].task = NULL;
+    executor._liveWorkers--;
+    vTaskDelete(NULL);
+}
+#endif
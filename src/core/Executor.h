@@ -0,0 +1,217 @@
+/**
+ * @file        Executor.h
+ * @title       Multi-Core Work-Stealing Executor
+ * @description Defines the `Executor` singleton, an optional pool of worker
+ *              threads that runs parallel-safe jobs off the main loop. Each worker
+ *              owns a fixed-capacity deque; idle workers steal from the others.
+ *              Workers are FreeRTOS tasks pinned per core on ESP32 and
+ *              `std::thread`s on host builds. Other targets have no executor and
+ *              keep running everything on the main loop.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-08-30
+ * @version     0.1.0
+ *
+ * @copyright   (c) 2025 Nextino. All rights reserved.
+ * @license     MIT License
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include "Scheduler.h"
+
+#if defined(ESP32)
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#define NEXTINO_EXECUTOR_SUPPORTED 1
+#elif !defined(ARDUINO)
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#define NEXTINO_EXECUTOR_SUPPORTED 1
+#else
+#define NEXTINO_EXECUTOR_SUPPORTED 0
+#endif
+
+/**
+ * @def NEXTINO_EXECUTOR_MAX_WORKERS
+ * @brief The maximum number of worker threads (one per core on ESP32).
+ */
+#ifndef NEXTINO_EXECUTOR_MAX_WORKERS
+#if defined(ESP32)
+#define NEXTINO_EXECUTOR_MAX_WORKERS 2
+#else
+#define NEXTINO_EXECUTOR_MAX_WORKERS 16
+#endif
+#endif
+
+/**
+ * @def NEXTINO_EXECUTOR_QUEUE_SIZE
+ * @brief The number of jobs each worker's deque can hold.
+ */
+#ifndef NEXTINO_EXECUTOR_QUEUE_SIZE
+#define NEXTINO_EXECUTOR_QUEUE_SIZE 32
+#endif
+
+/**
+ * @def NEXTINO_EXECUTOR_STACK_SIZE
+ * @brief The stack size, in bytes, of each worker task on ESP32.
+ */
+#ifndef NEXTINO_EXECUTOR_STACK_SIZE
+#define NEXTINO_EXECUTOR_STACK_SIZE 4096
+#endif
+
+/**
+ * @def NEXTINO_EXECUTOR_TASK_PRIORITY
+ * @brief The FreeRTOS priority of each worker task on ESP32 (same as the Arduino loop).
+ */
+#ifndef NEXTINO_EXECUTOR_TASK_PRIORITY
+#define NEXTINO_EXECUTOR_TASK_PRIORITY 1
+#endif
+
+/**
+ * @struct ExecutorStats
+ * @brief A snapshot of the Executor's counters.
+ */
+struct ExecutorStats {
+    uint8_t workers;    /**< Number of running workers (0 when stopped). */
+    uint32_t submitted; /**< Jobs accepted by submit(). */
+    uint32_t executed;  /**< Jobs that finished running. */
+    uint32_t stolen;    /**< Jobs run by a worker other than the one they were queued on. */
+    uint32_t rejected;  /**< Jobs refused because the executor was stopped or every deque was full. */
+};
+
+/**
+ * @class Executor
+ * @brief A singleton pool of workers for parallel-safe jobs.
+ * @details The main loop submits jobs; workers pop their own deque from the
+ *          back (most recent first, cache-warm) and steal from the front of
+ *          other workers' deques (oldest first) when their own runs dry.
+ *          Jobs must not touch the Scheduler, EventBus or modules without their
+ *          own synchronisation: those services belong to the main loop.
+ */
+class Executor {
+public:
+    /**
+     * @typedef Job
+     * @brief A job is any Scheduler task callback.
+     */
+    using Job = Scheduler::TaskCallback;
+
+    static Executor& getInstance();
+
+    /**
+     * @brief Starts the worker pool.
+     * @param workerCount The number of workers, or 0 for one per CPU core.
+     *                    Capped at NEXTINO_EXECUTOR_MAX_WORKERS.
+     * @return True if the workers are running, false if the target has no
+     *         executor support or the workers could not be created.
+     */
+    bool start(uint8_t workerCount = 0);
+
+    /**
+     * @brief Stops the worker pool after the queued jobs have run.
+     * @details Blocks until every worker has exited.
+     */
+    void stop();
+
+    /**
+     * @brief Checks whether the worker pool is running.
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Queues a job on one of the workers.
+     * @details Jobs are spread round-robin over the workers. Never blocks.
+     * @param job The job to run. It is copied into the worker's deque.
+     * @param pending (Optional) Decremented once the job has finished running.
+     * @return True if the job was queued, false if it was rejected. The caller
+     *         decides whether to drop it or run it inline.
+     */
+    bool submit(const Job& job, std::atomic<uint16_t>* pending = nullptr);
+
+    /**
+     * @brief Blocks until every submitted job has finished running.
+     */
+    void waitIdle() const;
+
+    /**
+     * @brief Gets a snapshot of the executor counters.
+     */
+    ExecutorStats getStats() const;
+
+private:
+    Executor();
+
+    // Delete copy constructor and assignment operator to prevent copies
+    Executor(const Executor&) = delete;
+    void operator=(const Executor&) = delete;
+
+    /**
+     * @struct QueuedJob
+     * @brief A job plus its completion counter.
+     */
+    struct QueuedJob {
+        Job job;
+        std::atomic<uint16_t>* pending;
+    };
+
+    /**
+     * @struct Worker
+     * @brief A worker's jobs and its deque of their indices, guarded by a short lock.
+     * @details Only indices move under the lock. Jobs are copied into and run
+     *          from their slot outside it, so no user constructor or destructor
+     *          runs inside a critical section.
+     */
+    struct Worker {
+        QueuedJob jobs[NEXTINO_EXECUTOR_QUEUE_SIZE];
+        uint16_t ring[NEXTINO_EXECUTOR_QUEUE_SIZE];     // Deque of queued slots
+        uint16_t freeSlots[NEXTINO_EXECUTOR_QUEUE_SIZE]; // Stack of unused slots
+        uint16_t head;      // Position of the oldest queued slot in `ring`
+        uint16_t count;     // Number of queued slots
+        uint16_t freeCount; // Number of unused slots
+#if defined(ESP32)
+        portMUX_TYPE lock;
+        TaskHandle_t task;
+#elif !defined(ARDUINO)
+        std::mutex lock;
+        std::thread thread;
+#endif
+    };
+
+    void lockWorker(Worker& worker);
+    void unlockWorker(Worker& worker);
+    bool pushBack(Worker& worker, const Job& job, std::atomic<uint16_t>* pending);
+    bool popBack(Worker& worker, uint16_t& slot);
+    bool popFront(Worker& worker, uint16_t& slot);
+    void releaseSlot(Worker& worker, uint16_t slot);
+    bool findJob(uint8_t self, Worker*& owner, uint16_t& slot);
+    void runWorker(uint8_t self);
+    void waitForWork();
+    void signalWork(bool all);
+
+#if defined(ESP32)
+    static void workerEntry(void* parameter);
+#endif
+
+    Worker _workers[NEXTINO_EXECUTOR_MAX_WORKERS];
+    uint8_t _workerCount;
+    std::atomic<uint8_t> _nextWorker;
+    std::atomic<bool> _running;
+    std::atomic<uint32_t> _queued;      // Jobs waiting in a deque
+    std::atomic<uint32_t> _outstanding; // Queued plus running jobs
+    std::atomic<uint32_t> _submitted;
+    std::atomic<uint32_t> _executed;
+    std::atomic<uint32_t> _stolen;
+    std::atomic<uint32_t> _rejected;
+
+#if defined(ESP32)
+    SemaphoreHandle_t _workAvailable; // Counting: one token per submitted job
+    std::atomic<uint8_t> _liveWorkers;
+#elif !defined(ARDUINO)
+    std::mutex _sleepMutex;
+    std::condition_variable _workAvailable;
+#endif
+};
@@ -0,0 +1,151 @@
+/**
+ * @file        InlineFunction.h
+ * @title       Fixed-Capacity Callable Wrapper
+ * @description Defines `InlineFunction`, a `std::function`-like wrapper that stores
+ *              the callable inside a fixed-size buffer and never touches the heap.
+ *              Callables that do not fit are rejected at compile time.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-08-27
+ * @version     0.1.0
+ *
+ * @copyright   (c) 2025 Nextino. All rights reserved.
+ * @license     MIT License
+ */
+
+#pragma once
+#include <cstddef>     // For size_t, std::nullptr_t
+#include <new>         // For placement new
+#include <type_traits> // For std::decay, std::enable_if
+#include <utility>     // For std::forward, std::move
+
+template <typename Signature, size_t Capacity>
+class InlineFunction;
+
+/**
+ * @class InlineFunction
+ * @brief A heap-free, type-erased callable with inline storage.
+ * @tparam R The return type of the callable.
+ * @tparam Args The argument types of the callable.
+ * @tparam Capacity The size in bytes of the inline buffer. Lambdas capturing
+ *                  `this` plus a few references fit comfortably in
+ *                  `4 * sizeof(void*)`.
+ */
+template <typename R, typename... Args, size_t Capacity>
+class InlineFunction<R(Args...), Capacity> {
+public:
+    InlineFunction() : _ops(nullptr) {}
+
+    InlineFunction(std::nullptr_t) : _ops(nullptr) {}
+
+    /**
+     * @brief Wraps any callable (lambda, functor or function pointer).
+     * @details Fails to compile if the callable is larger than `Capacity`.
+     */
+    template <typename F,
+              typename Fn = typename std::decay<F>::type,
+              typename = typename std::enable_if<!std::is_same<Fn, InlineFunction>::value>::type>
+    InlineFunction(F&& f) : _ops(nullptr) {
+        static_assert(sizeof(Fn) <= Capacity, "Callable is too large for this InlineFunction; capture less state or raise the capacity.");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "Callable is over-aligned for InlineFunction storage.");
+        new (_storage) Fn(std::forward<F>(f));
+        _ops = &OpsFor<Fn>::table;
+    }
+
+    InlineFunction(const InlineFunction& other) : _ops(other._ops) {
+        if (_ops) {
+            _ops->copy(_storage, other._storage);
+        }
+    }
+
+    InlineFunction(InlineFunction&& other) : _ops(other._ops) {
+        if (_ops) {
+            _ops->move(_storage, other._storage);
+            other.reset();
+        }
+    }
+
+    ~InlineFunction() { reset(); }
+
+    InlineFunction& operator=(const InlineFunction& other) {
+        if (this != &other) {
+            reset();
+            _ops = other._ops;
+            if (_ops) {
+                _ops->copy(_storage, other._storage);
+            }
+        }
+        return *this;
+    }
+
+    InlineFunction& operator=(InlineFunction&& other) {
+        if (this != &other) {
+            reset();
+            _ops = other._ops;
+            if (_ops) {
+                _ops->move(_storage, other._storage);
+                other.reset();
+            }
+        }
+        return *this;
+    }
+
+    InlineFunction& operator=(std::nullptr_t) {
+        reset();
+        return *this;
+    }
+
+    /**
+     * @brief Invokes the stored callable. Must not be called when empty.
+     */
+    R operator()(Args... args) const {
+        return _ops->invoke(const_cast<unsigned char*>(_storage), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Checks whether a callable is stored.
+     */
+    explicit operator bool() const { return _ops != nullptr; }
+
+    /**
+     * @brief Destroys the stored callable, leaving the wrapper empty.
+     */
+    void reset() {
+        if (_ops) {
+            _ops->destroy(_storage);
+            _ops = nullptr;
+        }
+    }
+
+private:
+    // Per-type operation table; one static instance per stored callable type.
+    struct Ops {
+        R (*invoke)(void* storage, Args&&... args);
+        void (*copy)(void* dst, const void* src);
+        void (*move)(void* dst, void* src);
+        void (*destroy)(void* storage);
+    };
+
+    template <typename Fn>
+    struct OpsFor {
+        static R invoke(void* storage, Args&&... args) {
+            return (*static_cast<Fn*>(storage))(std::forward<Args>(args)...);
+        }
+        static void copy(void* dst, const void* src) { new (dst) Fn(*static_cast<const Fn*>(src)); }
+        static void move(void* dst, void* src) { new (dst) Fn(std::move(*static_cast<Fn*>(src))); }
+        static void destroy(void* storage) { static_cast<Fn*>(storage)->~Fn(); }
+        static const Ops table;
+    };
+
+    alignas(std::max_align_t) unsigned char _storage[Capacity];
+    const Ops* _ops;
+};
+
+template <typename R, typename... Args, size_t Capacity>
+template <typename Fn>
+const typename InlineFunction<R(Args...), Capacity>::Ops InlineFunction<R(Args...), Capacity>::OpsFor<Fn>::table = {
+    &InlineFunction<R(Args...), Capacity>::OpsFor<Fn>::invoke,
+    &InlineFunction<R(Args...), Capacity>::OpsFor<Fn>::copy,
+    &InlineFunction<R(Args...), Capacity>::OpsFor<Fn>::move,
+    &InlineFunction<R(Args...), Capacity>::OpsFor<Fn>::destroy,
+};
@@ -47,6 +47,7 @@ void Logger::begin(LogLevel level, LogOutputType outputType)
     this->currentLevel = level;
     this->outputType = outputType;
 
+#if defined(ARDUINO)
     if (this->outputType == LogOutputType::Serial)
     {
         // Start Serial if it's not already running.
@@ -61,6 +62,7 @@ void Logger::begin(LogLevel level, LogOutputType outputType)
         }
         delay(100); // Small delay to ensure the monitor is ready.
     }
+#endif
 
 #if defined(ESP32)
     xSemaphoreGive(_logMutex);
@@ -140,6 +142,7 @@ void Logger::log(LogLevel level, bool isCore, const char *tag, const char *messa
             return;
         }
 
+#if defined(ARDUINO)
         // Print Level: [E], [W], etc.
         Serial.print(levelColor);
         Serial.print("[");
@@ -161,5 +164,14 @@ void Logger::log(LogLevel level, bool isCore, const char *tag, const char *messa
         {
             Serial.flush();
         }
+#else
+        // On a host build the "serial port" is the process's standard output.
+        const char *tagColor = isCore ? LOG_COLOR_NEON_PURPLE : LOG_COLOR_CYAN;
+        printf("%s[%s] %s[%s]: %s%s\n", levelColor, levelChar, tagColor, tag, LOG_COLOR_RESET, message);
+        if (level == LogLevel::Error)
+        {
+            fflush(stdout);
+        }
+#endif
     }
 }
\ No newline at end of file
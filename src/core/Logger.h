@@ -11,7 +11,7 @@
  */
 
 #pragma once
-#include <Arduino.h>
+#include "Platform.h"
 #include <stdarg.h>
 #include "LogColors.h"
 
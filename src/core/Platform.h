@@ -0,0 +1,137 @@
+/**
+ * @file        Platform.h
+ * @title       Platform Abstraction Layer
+ * @description Provides the small set of Arduino primitives used by the core
+ *              (`millis()`, `micros()`, `delay()`, `yield()`) on every target,
+ *              plus `nextinoMicros64()`, the framework's 64-bit monotonic clock.
+ *              On Arduino boards this simply includes `<Arduino.h>`. On a host
+ *              (native/Linux) build it supplies `std::chrono` based equivalents,
+ *              so the core services, unit tests and benchmarks can run off-target.
+ *              `nextinoCurrentThread()` identifies the calling task or thread.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-08-26
+ * @version     0.1.0
+ *
+ * @copyright   (c) 2025 Nextino. All rights reserved.
+ * @license     MIT License
+ */
+
+#pragma once
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#include <stdint.h>
+#if defined(ESP32)
+#include <esp_timer.h>
+#endif
+#else
+#include <chrono>
+#include <thread>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Returns the reference point that the host timing functions count from.
+ * @details Captured on first use, mirroring how `millis()` starts at zero on boot.
+ */
+inline std::chrono::steady_clock::time_point nextinoHostStartTime() {
+    static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    return startTime;
+}
+
+/**
+ * @brief Host equivalent of Arduino's `millis()`.
+ * @return Milliseconds elapsed since the first call into the timing functions.
+ */
+inline unsigned long millis() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - nextinoHostStartTime())
+        .count();
+}
+
+/**
+ * @brief Host equivalent of Arduino's `micros()`.
+ * @return Microseconds elapsed since the first call into the timing functions.
+ */
+inline unsigned long micros() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - nextinoHostStartTime())
+        .count();
+}
+
+/**
+ * @brief Host equivalent of Arduino's `delay()`. Blocks the calling thread.
+ * @param ms The number of milliseconds to sleep.
+ */
+inline void delay(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+/**
+ * @brief Host equivalent of Arduino's `yield()`.
+ */
+inline void yield() {
+    std::this_thread::yield();
+}
+#endif
+
+/**
+ * @def NEXTINO_ISR_ATTR
+ * @brief Marks a function that may run in interrupt context.
+ * @details Places it in IRAM on ESP32, so it still works while the flash cache
+ *          is disabled. Expands to nothing elsewhere.
+ */
+#if defined(ESP32)
+#define NEXTINO_ISR_ATTR IRAM_ATTR
+#else
+#define NEXTINO_ISR_ATTR
+#endif
+
+/**
+ * @brief Identifies the calling task or thread, e.g. to check that a service is
+ *        used from the task that owns it.
+ * @details The FreeRTOS task handle on ESP32, where every ISR reports the same
+ *          value, distinct from any task. A per-thread address on host builds.
+ *          Always nullptr on other Arduino targets, which have a single thread.
+ * @return A value unique to the calling thread while it runs.
+ */
+inline const void* nextinoCurrentThread() {
+#if defined(ESP32)
+    static const char isrContext = 0;
+    return xPortInIsrContext() ? (const void*)&isrContext : (const void*)xTaskGetCurrentTaskHandle();
+#elif defined(ARDUINO)
+    return nullptr;
+#else
+    static thread_local const char marker = 0;
+    return &marker;
+#endif
+}
+
+/**
+ * @brief The framework's monotonic 64-bit clock, in microseconds since boot.
+ * @details Uses `esp_timer_get_time()` on ESP32 and `std::chrono::steady_clock`
+ *          on host builds. Other Arduino targets extend the 32-bit `micros()`
+ *          counter, which requires a call at least once per ~71 minutes; the
+ *          Scheduler's `loop()` takes care of that.
+ * @return Microseconds elapsed since boot (or since first use on the host).
+ */
+inline uint64_t nextinoMicros64() {
+#if defined(ESP32)
+    return (uint64_t)esp_timer_get_time();
+#elif defined(ARDUINO)
+    static uint32_t lastMicros = 0;
+    static uint32_t rollovers = 0;
+    uint32_t nowMicros = micros();
+    if (nowMicros < lastMicros) {
+        rollovers++;
+    }
+    lastMicros = nowMicros;
+    return ((uint64_t)rollovers << 32) | nowMicros;
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - nextinoHostStartTime())
+        .count();
+#endif
+}
@@ -12,9 +12,9 @@
  */
 
 #include "Scheduler.h"
+#include "Executor.h"
 #include "Logger.h"
-#include <Arduino.h>
-#include <algorithm> // For std::remove_if
+#include "Platform.h"
 
 /**
  * @brief Gets the singleton instance of the Scheduler.
@@ -27,62 +27,739 @@ Scheduler &Scheduler::getInstance()
     return instance;
 }
 
-Scheduler::TaskHandle Scheduler::scheduleOnce(unsigned long delayMs, TaskCallback callback)
+const unsigned long Scheduler::NO_DEADLINE;
+const Scheduler::Timestamp Scheduler::NO_DEADLINE_MICROS;
+
+Scheduler::Scheduler()
+    : _freeHead(0), _activeTasks(0), _peakTasks(0), _scheduleFailures(0), _budgetOverruns(0), _nextSequence(0), _maxSlack(0), _passStartedAt(0), _timeSource(&nextinoMicros64)
+{
+    static_assert(NEXTINO_SCHEDULER_MAX_TASKS > 0 && NEXTINO_SCHEDULER_MAX_TASKS < NO_INDEX,
+                  "NEXTINO_SCHEDULER_MAX_TASKS must be between 1 and 65534.");
+
+    _timers.size = 0;
+    _ready.size = 0;
+
+    // Thread every slot onto the free list. Generations start at 1 so that a
+    // valid handle is never 0.
+    for (uint16_t i = 0; i < NEXTINO_SCHEDULER_MAX_TASKS; ++i)
+    {
+        _slots[i].owner = nullptr;
+        _slots[i].generation = 1;
+        _slots[i].heapIndex = (i + 1 < NEXTINO_SCHEDULER_MAX_TASKS) ? i + 1 : NO_INDEX;
+        _slots[i].state = TaskState::Free;
+        _slots[i].recurring = false;
+        _slots[i].missedRunPolicy = MissedRunPolicy::Skip;
+        _slots[i].priority = TaskPriority::Normal;
+        _slots[i].overrunPolicy = OverrunPolicy::Report;
+        _slots[i].budget = 0;
+        _slots[i].slack = 0;
+        _slots[i].affinity = TaskAffinity::MainLoop;
+        _slots[i].inFlight.store(0);
+    }
+}
+
+Scheduler::TaskHandle Scheduler::scheduleOnce(unsigned long delayMs, TaskCallback callback, const BaseModule *owner)
+{
+    return scheduleOnceMicros((Timestamp)delayMs * 1000ULL, std::move(callback), owner);
+}
+
+Scheduler::TaskHandle Scheduler::scheduleRecurring(unsigned long intervalMs, TaskCallback callback, const BaseModule *owner)
+{
+    return scheduleRecurringMicros((Timestamp)intervalMs * 1000ULL, std::move(callback), owner);
+}
+
+Scheduler::TaskHandle Scheduler::scheduleOnceMicros(Timestamp delayUs, TaskCallback callback, const BaseModule *owner)
 {
-    TaskHandle handle = _nextTaskHandle++;
-    _tasks.push_back({handle, delayMs, millis(), callback, false});
-    NEXTINO_CORE_LOG(LogLevel::Debug, "Scheduler", "Scheduled one-shot task with handle %u.", handle);
+    TaskHandle handle = allocateTask(delayUs, callback, owner, false);
+    if (handle != 0)
+    {
+        NEXTINO_CORE_LOG(LogLevel::Debug, "Scheduler", "Scheduled one-shot task with handle %u.", handle);
+    }
     return handle;
 }
 
-Scheduler::TaskHandle Scheduler::scheduleRecurring(unsigned long intervalMs, TaskCallback callback)
+Scheduler::TaskHandle Scheduler::scheduleRecurringMicros(Timestamp intervalUs, TaskCallback callback, const BaseModule *owner)
 {
-    TaskHandle handle = _nextTaskHandle++;
-    _tasks.push_back({handle, intervalMs, millis(), callback, true});
-    NEXTINO_CORE_LOG(LogLevel::Debug, "Scheduler", "Scheduled recurring task with handle %u.", handle);
+    TaskHandle handle = allocateTask(intervalUs, callback, owner, true);
+    if (handle != 0)
+    {
+        NEXTINO_CORE_LOG(LogLevel::Debug, "Scheduler", "Scheduled recurring task with handle %u.", handle);
+    }
     return handle;
 }
 
+bool Scheduler::setMissedRunPolicy(TaskHandle handle, MissedRunPolicy policy)
+{
+    ScheduledTask *task = resolve(handle);
+    if (!task)
+    {
+        return false;
+    }
+    task->missedRunPolicy = policy;
+    return true;
+}
+
+bool Scheduler::setTaskPriority(TaskHandle handle, TaskPriority priority)
+{
+    ScheduledTask *task = resolve(handle);
+    if (!task)
+    {
+        return false;
+    }
+
+    if (task->state == TaskState::Ready)
+    {
+        // Already waiting its turn in this pass: reposition it.
+        uint16_t index = (uint16_t)(task - _slots);
+        heapRemove(_ready, task->heapIndex);
+        task->priority = priority;
+        heapInsert(_ready, index);
+    }
+    else
+    {
+        task->priority = priority;
+    }
+    return true;
+}
+
+bool Scheduler::getTaskPriority(TaskHandle handle, TaskPriority &priority)
+{
+    ScheduledTask *task = resolve(handle);
+    if (!task)
+    {
+        return false;
+    }
+    priority = task->priority;
+    return true;
+}
+
+bool Scheduler::setTaskBudget(TaskHandle handle, uint32_t budgetUs, OverrunPolicy policy)
+{
+    ScheduledTask *task = resolve(handle);
+    if (!task)
+    {
+        return false;
+    }
+    task->budget = budgetUs;
+    task->overrunPolicy = policy;
+    return true;
+}
+
+bool Scheduler::setTaskSlack(TaskHandle handle, unsigned long slackMs)
+{
+    uint64_t slackUs = (uint64_t)slackMs * 1000ULL;
+    return setTaskSlackMicros(handle, slackUs > UINT32_MAX ? UINT32_MAX : (uint32_t)slackUs);
+}
+
+bool Scheduler::setTaskSlackMicros(TaskHandle handle, uint32_t slackUs)
+{
+    ScheduledTask *task = resolve(handle);
+    if (!task)
+    {
+        return false;
+    }
+    if (slackUs > _maxSlack)
+    {
+        _maxSlack = slackUs;
+    }
+
+    if (task->state == TaskState::Scheduled)
+    {
+        // The slack is part of the timer heap key: reposition the task.
+        uint16_t index = (uint16_t)(task - _slots);
+        heapRemove(_timers, task->heapIndex);
+        task->slack = slackUs;
+        arm(index, true);
+    }
+    else
+    {
+        task->slack = slackUs;
+    }
+    return true;
+}
+
+bool Scheduler::setTaskAffinity(TaskHandle handle, TaskAffinity affinity)
+{
+    ScheduledTask *task = resolve(handle);
+    if (!task)
+    {
+        return false;
+    }
+    task->affinity = affinity;
+    return true;
+}
+
+bool Scheduler::getTaskTimingStats(TaskHandle handle, TaskTimingStats &stats)
+{
+    ScheduledTask *task = resolve(handle);
+    if (!task)
+    {
+        return false;
+    }
+
+    stats.runs = task->runs;
+    stats.missedPeriods = task->missedPeriods;
+    stats.overruns = task->overruns;
+#if NEXTINO_SCHEDULER_TIMING_STATS
+    stats.lateness = task->lateness.summary();
+    stats.jitter = task->jitter.summary();
+    stats.execution = task->execution.summary();
+#else
+    stats.lateness = {};
+    stats.jitter = {};
+    stats.execution = {};
+#endif
+    return true;
+}
+
+bool Scheduler::resetTaskTimingStats(TaskHandle handle)
+{
+    ScheduledTask *task = resolve(handle);
+    if (!task)
+    {
+        return false;
+    }
+
+    task->runs = 0;
+    task->missedPeriods = 0;
+    task->overruns = 0;
+#if NEXTINO_SCHEDULER_TIMING_STATS
+    task->lastLateness = 0;
+    task->lateness.reset();
+    task->jitter.reset();
+    task->execution.reset();
+#endif
+    return true;
+}
+
 bool Scheduler::cancel(TaskHandle handle)
 {
-    auto it = std::remove_if(_tasks.begin(), _tasks.end(), [handle](const ScheduledTask &task)
-                             { return task.handle == handle; });
+    ScheduledTask *task = resolve(handle);
+    if (!task)
+    {
+        NEXTINO_CORE_LOG(LogLevel::Warn, "Scheduler", "Could not cancel task: handle %u not found.", handle);
+        return false;
+    }
 
-    if (it != _tasks.end())
+    if (task->state == TaskState::Running)
     {
-        _tasks.erase(it, _tasks.end());
-        NEXTINO_CORE_LOG(LogLevel::Debug, "Scheduler", "Cancelled task with handle %u.", handle);
-        return true;
+        // The task is cancelling itself (or is cancelled by another callback it
+        // triggered). loop() frees the slot once the callback returns.
+        task->state = TaskState::Cancelled;
+    }
+    else
+    {
+        heapRemove(heapOf(*task), task->heapIndex);
+        freeTask((uint16_t)(task - _slots));
     }
 
-    NEXTINO_CORE_LOG(LogLevel::Warn, "Scheduler", "Could not cancel task: handle %u not found.", handle);
-    return false;
+    NEXTINO_CORE_LOG(LogLevel::Debug, "Scheduler", "Cancelled task with handle %u.", handle);
+    return true;
 }
 
-void Scheduler::loop()
+size_t Scheduler::cancelAllOwnedBy(const BaseModule *owner)
 {
-    unsigned long now = millis();
-    for (auto it = _tasks.begin(); it != _tasks.end(); /* no increment here */)
+    if (!owner)
+    {
+        return 0;
+    }
+
+    size_t cancelled = 0;
+    for (uint16_t i = 0; i < NEXTINO_SCHEDULER_MAX_TASKS; ++i)
     {
-        if (now - it->lastRun >= it->interval)
+        ScheduledTask &task = _slots[i];
+        if (task.owner != owner)
+        {
+            continue;
+        }
+        if (task.state == TaskState::Scheduled || task.state == TaskState::Ready)
+        {
+            heapRemove(heapOf(task), task.heapIndex);
+            freeTask(i);
+            cancelled++;
+        }
+        else if (task.state == TaskState::Running)
         {
-            NEXTINO_CORE_LOG(LogLevel::Debug, "Scheduler", "Executing task with handle %u.", it->handle);
-            it->callback();
+            task.state = TaskState::Cancelled;
+            cancelled++;
+        }
+    }
 
-            if (it->recurring)
-            {
-                it->lastRun = now;
-                ++it;
-            }
-            else
+    NEXTINO_CORE_LOG(LogLevel::Debug, "Scheduler", "Cancelled %u task(s) owned by a module.", (unsigned)cancelled);
+    return cancelled;
+}
+
+size_t Scheduler::getTaskCount() const
+{
+    return _activeTasks;
+}
+
+SchedulerStats Scheduler::getStats() const
+{
+    return {NEXTINO_SCHEDULER_MAX_TASKS, _activeTasks, _peakTasks, _scheduleFailures, _budgetOverruns};
+}
+
+unsigned long Scheduler::getTimeUntilNextDeadline() const
+{
+    Timestamp remainingUs = getTimeUntilNextDeadlineMicros();
+    if (remainingUs == NO_DEADLINE_MICROS)
+    {
+        return NO_DEADLINE;
+    }
+
+    Timestamp remainingMs = remainingUs / 1000ULL;
+    return remainingMs < (Timestamp)NO_DEADLINE ? (unsigned long)remainingMs : NO_DEADLINE - 1;
+}
+
+Scheduler::Timestamp Scheduler::getTimeUntilNextDeadlineMicros() const
+{
+    if (_ready.size > 0)
+    {
+        return 0;
+    }
+    if (_timers.size == 0)
+    {
+        return NO_DEADLINE_MICROS;
+    }
+
+    Timestamp now = _timeSource();
+    const ScheduledTask &first = _slots[_timers.entries[0]];
+    Timestamp deadline = first.nextRun + first.slack;
+    return deadline > now ? deadline - now : 0;
+}
+
+void Scheduler::setTimeSource(TimeSource source)
+{
+    _timeSource = source ? source : &nextinoMicros64;
+}
+
+Scheduler::TimeSource Scheduler::getTimeSource() const
+{
+    return _timeSource;
+}
+
+Scheduler::Timestamp Scheduler::nowMicros() const
+{
+    return _timeSource();
+}
+
+void Scheduler::loop()
+{
+    Timestamp now = _timeSource();
+
+    // Tasks armed from inside a callback get a sequence number >= passStart and
+    // wait for the next pass, so a zero-interval task runs once per loop().
+    uint64_t passStart = _nextSequence;
+
+    _passStartedAt = now;
+
+    // Move everything that is due into the ready heap, so the pass runs it by
+    // priority rather than by deadline alone.
+    promoteDueTasks(now, passStart);
+
+    while (_ready.size > 0)
+    {
+        uint16_t index = _ready.entries[0];
+        ScheduledTask &task = _slots[index];
+        heapRemove(_ready, 0);
+        task.state = TaskState::Running;
+
+        // Earlier callbacks in this pass may have taken a while; measure the
+        // real start time for lateness and for the missed-period decision.
+        Timestamp startedAt = _timeSource();
+        Timestamp finishedAt = startedAt;
+        if (task.affinity == TaskAffinity::Parallel && task.inFlight.load() > 0)
+        {
+            // The previous run is still executing on a worker; skip this period.
+            task.missedPeriods++;
+        }
+        else
+        {
+            recordStart(task, startedAt);
+            NEXTINO_CORE_LOG(LogLevel::Debug, "Scheduler", "Executing task with handle %u.",
+                             ((TaskHandle)task.generation << 16) | index);
+            if (task.affinity != TaskAffinity::Parallel || !dispatchToExecutor(task))
             {
-                // Erase the one-shot task and get the iterator to the next element
-                it = _tasks.erase(it);
+                task.callback();
+                finishedAt = _timeSource();
+                recordFinish(index, finishedAt - startedAt);
             }
         }
+
+        if (task.recurring && task.state == TaskState::Running)
+        {
+            rearmRecurring(index, startedAt);
+        }
         else
         {
-            ++it;
+            freeTask(index);
         }
+
+        // Tasks that fell due while the callback ran compete for the next turn,
+        // so a critical task waits for at most one callback, not the whole pass.
+        promoteDueTasks(finishedAt, passStart);
+    }
+}
+
+bool Scheduler::dispatchToExecutor(ScheduledTask &task)
+{
+    Executor &executor = Executor::getInstance();
+    if (!executor.isRunning())
+    {
+        return false;
+    }
+
+    // The worker runs its own copy of the callback, so cancelling or reusing
+    // the slot never races with it. inFlight is dropped when the copy returns.
+    task.inFlight++;
+    if (!executor.submit(task.callback, &task.inFlight))
+    {
+        task.inFlight--;
+        return false;
     }
-}
\ No newline at end of file
+    return true;
+}
+
+void Scheduler::promoteDueTasks(Timestamp now, uint64_t passStart)
+{
+    // The timer heap front holds the earliest latest-start (deadline plus
+    // slack). Without slack this is plain earliest-deadline order, and the
+    // due tasks are exactly the front ones.
+    while (_timers.size > 0)
+    {
+        uint16_t index = _timers.entries[0];
+        ScheduledTask &task = _slots[index];
+        if (task.nextRun > now || task.sequence >= passStart)
+        {
+            break;
+        }
+
+        heapRemove(_timers, 0);
+        task.state = TaskState::Ready;
+        heapInsert(_ready, index);
+    }
+
+    // With slack, a due task can sit behind a front whose deadline is still
+    // ahead. It rides along with a pass that has other work to do; a pass
+    // with none leaves it for later, within its window. Its key is at most
+    // now + _maxSlack, which bounds the search.
+    if (_maxSlack == 0 || _ready.size == 0)
+    {
+        return;
+    }
+    uint16_t position;
+    while ((position = findDueTimer(now, passStart)) != NO_INDEX)
+    {
+        uint16_t index = _timers.entries[position];
+        heapRemove(_timers, position);
+        _slots[index].state = TaskState::Ready;
+        heapInsert(_ready, index);
+    }
+}
+
+uint16_t Scheduler::findDueTimer(Timestamp now, uint64_t passStart) const
+{
+    // Depth-first over the timer heap, skipping every subtree whose root key
+    // is past the bound: its whole subtree is later still. A pre-order walk
+    // keeps at most one pending sibling per level on the stack.
+    Timestamp bound = now + _maxSlack;
+    uint16_t stack[17];
+    uint8_t depth = 0;
+    if (_timers.size > 0)
+    {
+        stack[depth++] = 0;
+    }
+    while (depth > 0)
+    {
+        uint16_t position = stack[--depth];
+        const ScheduledTask &task = _slots[_timers.entries[position]];
+        if (task.nextRun + task.slack > bound)
+        {
+            continue;
+        }
+        if (task.nextRun <= now && task.sequence < passStart)
+        {
+            return position;
+        }
+        uint32_t child = 2u * position + 1;
+        if (child + 1 < _timers.size)
+        {
+            stack[depth++] = (uint16_t)(child + 1);
+        }
+        if (child < _timers.size)
+        {
+            stack[depth++] = (uint16_t)child;
+        }
+    }
+    return NO_INDEX;
+}
+
+Scheduler::TaskHandle Scheduler::allocateTask(Timestamp delayUs, TaskCallback &callback, const BaseModule *owner, bool recurring)
+{
+    if (_freeHead == NO_INDEX)
+    {
+        _scheduleFailures++;
+        NEXTINO_CORE_LOG(LogLevel::Error, "Scheduler", "Task pool exhausted (%u slots). Raise NEXTINO_SCHEDULER_MAX_TASKS.",
+                         (unsigned)NEXTINO_SCHEDULER_MAX_TASKS);
+        return 0;
+    }
+
+    uint16_t index = _freeHead;
+    ScheduledTask &task = _slots[index];
+    _freeHead = task.heapIndex;
+
+    task.callback = std::move(callback);
+    task.owner = owner;
+    task.interval = delayUs;
+    task.nextRun = _timeSource() + delayUs;
+    task.recurring = recurring;
+    task.missedRunPolicy = MissedRunPolicy::Skip;
+    task.priority = TaskPriority::Normal;
+    task.overrunPolicy = OverrunPolicy::Report;
+    task.budget = 0;
+    task.slack = 0;
+    task.affinity = TaskAffinity::MainLoop;
+    task.runs = 0;
+    task.missedPeriods = 0;
+    task.overruns = 0;
+#if NEXTINO_SCHEDULER_TIMING_STATS
+    task.lastLateness = 0;
+    task.lateness.reset();
+    task.jitter.reset();
+    task.execution.reset();
+#endif
+    arm(index);
+
+    _activeTasks++;
+    if (_activeTasks > _peakTasks)
+    {
+        _peakTasks = _activeTasks;
+    }
+    return ((TaskHandle)task.generation << 16) | index;
+}
+
+Scheduler::ScheduledTask *Scheduler::resolve(TaskHandle handle)
+{
+    uint16_t index = (uint16_t)(handle & 0xFFFF);
+    uint16_t generation = (uint16_t)(handle >> 16);
+    if (index >= NEXTINO_SCHEDULER_MAX_TASKS)
+    {
+        return nullptr;
+    }
+
+    ScheduledTask &task = _slots[index];
+    if (task.generation != generation || task.state == TaskState::Free || task.state == TaskState::Cancelled)
+    {
+        return nullptr;
+    }
+    return &task;
+}
+
+void Scheduler::freeTask(uint16_t index)
+{
+    ScheduledTask &task = _slots[index];
+    task.callback.reset();
+    task.owner = nullptr;
+    task.state = TaskState::Free;
+
+    // Invalidate every outstanding handle to this slot. Skip 0 on wrap-around.
+    task.generation++;
+    if (task.generation == 0)
+    {
+        task.generation = 1;
+    }
+
+    task.heapIndex = _freeHead;
+    _freeHead = index;
+    _activeTasks--;
+}
+
+void Scheduler::arm(uint16_t index, bool keepSequence)
+{
+    ScheduledTask &task = _slots[index];
+    if (!keepSequence)
+    {
+        task.sequence = _nextSequence++;
+    }
+    task.state = TaskState::Scheduled;
+    heapInsert(_timers, index);
+}
+
+void Scheduler::rearmRecurring(uint16_t index, Timestamp startedAt)
+{
+    ScheduledTask &task = _slots[index];
+
+    // Anchor to the ideal timeline so loop latency never accumulates as drift.
+    task.nextRun += task.interval;
+
+    if (startedAt < task.nextRun || task.interval == 0)
+    {
+        arm(index);
+        return;
+    }
+
+    // At least one whole period was missed.
+    Timestamp missed = (startedAt - task.nextRun) / task.interval + 1;
+    switch (task.missedRunPolicy)
+    {
+    case MissedRunPolicy::CatchUp:
+        // Keep the old sequence number: the task stays eligible in this pass
+        // and runs once per missed period, back to back. Periods that only
+        // fell due during the pass wait for the next one, which bounds the pass.
+        arm(index, task.nextRun <= _passStartedAt);
+        return;
+    case MissedRunPolicy::Coalesce:
+        task.nextRun = startedAt + task.interval;
+        break;
+    case MissedRunPolicy::Skip:
+    default:
+        task.nextRun += missed * task.interval;
+        break;
+    }
+    task.missedPeriods += (uint32_t)missed;
+    arm(index);
+}
+
+void Scheduler::recordStart(ScheduledTask &task, Timestamp startedAt)
+{
+    task.runs++;
+#if NEXTINO_SCHEDULER_TIMING_STATS
+    // Saturate rather than wrap for pathological (> 71 minute) lateness.
+    Timestamp late = startedAt - task.nextRun;
+    uint32_t lateness = late > UINT32_MAX ? UINT32_MAX : (uint32_t)late;
+    task.lateness.record(lateness);
+    if (task.runs > 1)
+    {
+        task.jitter.record(lateness > task.lastLateness ? lateness - task.lastLateness : task.lastLateness - lateness);
+    }
+    task.lastLateness = lateness;
+#else
+    (void)startedAt;
+#endif
+}
+
+void Scheduler::recordFinish(uint16_t index, Timestamp executionUs)
+{
+    ScheduledTask &task = _slots[index];
+#if NEXTINO_SCHEDULER_TIMING_STATS
+    task.execution.record(executionUs > UINT32_MAX ? UINT32_MAX : (uint32_t)executionUs);
+#endif
+    if (task.budget == 0 || executionUs <= task.budget)
+    {
+        return;
+    }
+
+    task.overruns++;
+    _budgetOverruns++;
+    TaskHandle handle = ((TaskHandle)task.generation << 16) | index;
+    if (task.overrunPolicy == OverrunPolicy::Demote && task.priority != TaskPriority::Low)
+    {
+        task.priority = (TaskPriority)((uint8_t)task.priority + 1);
+        NEXTINO_CORE_LOG(LogLevel::Warn, "Scheduler", "Task %u ran %lu us (budget %lu us); demoted to priority %u.",
+                         handle, (unsigned long)executionUs, (unsigned long)task.budget, (unsigned)task.priority);
+    }
+    else if (task.overruns == 1)
+    {
+        // Report the first overrun only; the rest are visible in the task's stats.
+        NEXTINO_CORE_LOG(LogLevel::Warn, "Scheduler", "Task %u ran %lu us (budget %lu us).",
+                         handle, (unsigned long)executionUs, (unsigned long)task.budget);
+    }
+}
+
+Scheduler::TaskHeap &Scheduler::heapOf(const ScheduledTask &task)
+{
+    return task.state == TaskState::Ready ? _ready : _timers;
+}
+
+bool Scheduler::isEarlier(const TaskHeap &heap, uint16_t a, uint16_t b) const
+{
+    if (&heap == &_ready && _slots[a].priority != _slots[b].priority)
+    {
+        return _slots[a].priority < _slots[b].priority;
+    }
+    // 64-bit microsecond deadlines do not wrap (~584,000 years).
+    Timestamp keyA = _slots[a].nextRun;
+    Timestamp keyB = _slots[b].nextRun;
+    if (&heap == &_timers)
+    {
+        keyA += _slots[a].slack;
+        keyB += _slots[b].slack;
+    }
+    if (keyA != keyB)
+    {
+        return keyA < keyB;
+    }
+    return _slots[a].sequence < _slots[b].sequence;
+}
+
+void Scheduler::heapPlace(TaskHeap &heap, uint16_t position, uint16_t index)
+{
+    heap.entries[position] = index;
+    _slots[index].heapIndex = position;
+}
+
+void Scheduler::heapSiftUp(TaskHeap &heap, uint16_t position)
+{
+    uint16_t index = heap.entries[position];
+    while (position > 0)
+    {
+        uint16_t parent = (position - 1) / 2;
+        if (!isEarlier(heap, index, heap.entries[parent]))
+        {
+            break;
+        }
+        heapPlace(heap, position, heap.entries[parent]);
+        position = parent;
+    }
+    heapPlace(heap, position, index);
+}
+
+void Scheduler::heapSiftDown(TaskHeap &heap, uint16_t position)
+{
+    uint16_t index = heap.entries[position];
+    while (true)
+    {
+        uint32_t child = 2u * position + 1;
+        if (child >= heap.size)
+        {
+            break;
+        }
+        if (child + 1 < heap.size && isEarlier(heap, heap.entries[child + 1], heap.entries[child]))
+        {
+            child++;
+        }
+        if (!isEarlier(heap, heap.entries[child], index))
+        {
+            break;
+        }
+        heapPlace(heap, position, heap.entries[child]);
+        position = (uint16_t)child;
+    }
+    heapPlace(heap, position, index);
+}
+
+void Scheduler::heapInsert(TaskHeap &heap, uint16_t index)
+{
+    heapPlace(heap, heap.size, index);
+    heap.size++;
+    heapSiftUp(heap, heap.size - 1);
+}
+
+void Scheduler::heapRemove(TaskHeap &heap, uint16_t position)
+{
+    heap.size--;
+    if (position == heap.size)
+    {
+        return;
+    }
+
+    // Move the last entry into the hole and restore the heap property. It can
+    // only need to travel in one direction.
+    uint16_t moved = heap.entries[heap.size];
+    heapPlace(heap, position, moved);
+    heapSiftUp(heap, position);
+    if (_slots[moved].heapIndex == position)
+    {
+        heapSiftDown(heap, position);
+    }
+}
@@ -1,8 +1,18 @@
 /**
  * @file        Scheduler.h
  * @title       Non-Blocking Task Scheduler
- * @description Defines the `Scheduler` singleton class, providing a non-blocking,
- *              millis-based task scheduler for periodic and one-shot operations.
+ * @description Defines the `Scheduler` singleton class, providing a non-blocking
+ *              task scheduler for periodic and one-shot operations. Deadlines
+ *              use a 64-bit microsecond time base, so millisecond tasks and
+ *              kHz-rate control loops share the same queue without rollover.
+ *              Tasks live in a fixed-capacity slot pool and are kept in a min-heap
+ *              ordered by their next deadline, so a loop pass with nothing due
+ *              costs O(1) and scheduling never allocates. Tasks that are due run
+ *              by priority class, then earliest deadline first, and may declare a
+ *              CPU budget whose overruns are counted and can demote the task.
+ *              Tasks marked parallel-safe can be handed to the `Executor`.
+ *              Tasks that declare a slack window are coalesced with their
+ *              neighbours, so an idle loop wakes up once per batch.
  *
  * @author      Giorgi Magradze
  * @date        2025-08-21
@@ -13,9 +23,110 @@
  */
 
 #pragma once
-#include <vector>
-#include <functional>
+#include <atomic>
 #include <cstdint> // For uint32_t
+#include <cstddef> // For size_t
+#include "InlineFunction.h"
+#include "TimingStats.h"
+
+/**
+ * @def NEXTINO_SCHEDULER_MAX_TASKS
+ * @brief The number of task slots reserved at compile time (max 65535).
+ * @details Override with a build flag, e.g. `-DNEXTINO_SCHEDULER_MAX_TASKS=256`.
+ */
+#ifndef NEXTINO_SCHEDULER_MAX_TASKS
+#define NEXTINO_SCHEDULER_MAX_TASKS 64
+#endif
+
+/**
+ * @def NEXTINO_SCHEDULER_CALLBACK_SIZE
+ * @brief The inline storage, in bytes, available to each task callback.
+ * @details Enough for a lambda capturing `this` and a few references or pointers.
+ */
+#ifndef NEXTINO_SCHEDULER_CALLBACK_SIZE
+#define NEXTINO_SCHEDULER_CALLBACK_SIZE (4 * sizeof(void *))
+#endif
+
+/**
+ * @def NEXTINO_SCHEDULER_TIMING_STATS
+ * @brief Set to 0 to drop per-task lateness/jitter/execution histograms (~220 bytes per slot).
+ */
+#ifndef NEXTINO_SCHEDULER_TIMING_STATS
+#define NEXTINO_SCHEDULER_TIMING_STATS 1
+#endif
+
+// Forward declaration; modules may own tasks.
+class BaseModule;
+
+/**
+ * @struct SchedulerStats
+ * @brief A snapshot of the Scheduler's slot pool usage.
+ */
+struct SchedulerStats {
+    size_t capacity;           /**< Total number of task slots (NEXTINO_SCHEDULER_MAX_TASKS). */
+    size_t activeTasks;        /**< Slots currently in use. */
+    size_t peakTasks;          /**< Highest number of slots ever in use at once. */
+    uint32_t scheduleFailures; /**< Schedule calls rejected because the pool was full. */
+    uint32_t budgetOverruns;   /**< Task runs that exceeded their CPU budget, across all tasks. */
+};
+
+/**
+ * @enum TaskPriority
+ * @brief The priority class of a task.
+ * @details When several tasks are due in the same loop pass, higher classes run
+ *          first; within a class, the earliest deadline runs first. Priorities
+ *          never pre-empt a running callback.
+ */
+enum class TaskPriority : uint8_t {
+    Critical, /**< Safety or timing critical work, e.g. a relay interlock. */
+    High,     /**< Latency sensitive work, e.g. control loops. */
+    Normal,   /**< The default. */
+    Low       /**< Background work, e.g. log flushing or statistics. */
+};
+
+/**
+ * @enum OverrunPolicy
+ * @brief What happens when a task runs longer than its CPU budget.
+ */
+enum class OverrunPolicy : uint8_t {
+    Report, /**< Count the overrun and log it (default). */
+    Demote  /**< Count and log it, then lower the task by one priority class. */
+};
+
+/**
+ * @enum MissedRunPolicy
+ * @brief What a recurring task does when the loop was late by one or more whole periods.
+ * @details Recurring tasks are anchored to their ideal timeline (`nextRun += interval`),
+ *          so small delays never accumulate. The policy only matters when at
+ *          least one full period was missed.
+ */
+enum class MissedRunPolicy : uint8_t {
+    Skip,     /**< Run once, drop the missed periods, stay phase-locked to the timeline (default). */
+    CatchUp,  /**< Run once for every missed period, back to back in the same pass. */
+    Coalesce  /**< Run once for all missed periods and restart the timeline from that run. */
+};
+
+/**
+ * @enum TaskAffinity
+ * @brief Where a task's callback runs.
+ */
+enum class TaskAffinity : uint8_t {
+    MainLoop, /**< On the main loop, inside `Scheduler::loop()` (default). */
+    Parallel  /**< On an Executor worker when the Executor is running, else on the main loop. */
+};
+
+/**
+ * @struct TaskTimingStats
+ * @brief Per-task timing statistics, in microseconds.
+ */
+struct TaskTimingStats {
+    uint32_t runs;           /**< Number of executions started. */
+    uint32_t missedPeriods;  /**< Periods skipped or coalesced by the MissedRunPolicy. */
+    uint32_t overruns;       /**< Runs that exceeded the task's CPU budget. */
+    TimingSummary lateness;  /**< Actual start time minus ideal deadline. */
+    TimingSummary jitter;    /**< Change in lateness between consecutive runs. */
+    TimingSummary execution; /**< Time spent inside the callback. */
+};
 
 /**
  * @class Scheduler
@@ -26,14 +137,44 @@ public:
     /**
      * @typedef TaskHandle
      * @brief A unique identifier for a scheduled task.
+     * @details Encodes the slot index (low 16 bits) and the slot's generation
+     *          (high 16 bits). A handle is never 0, so 0 can be used as "no task".
+     *          Once a task finishes or is cancelled its handle becomes stale and
+     *          is safely rejected, even if the slot is reused.
      */
     using TaskHandle = uint32_t;
 
     /**
      * @typedef TaskCallback
      * @brief A function type for scheduled tasks.
+     * @details The callable is stored inline in the task slot; callables larger
+     *          than `NEXTINO_SCHEDULER_CALLBACK_SIZE` fail to compile.
      */
-    using TaskCallback = std::function<void()>;
+    using TaskCallback = InlineFunction<void(), NEXTINO_SCHEDULER_CALLBACK_SIZE>;
+
+    /**
+     * @typedef Timestamp
+     * @brief A point in time or a duration, in microseconds. Never wraps in practice.
+     */
+    using Timestamp = uint64_t;
+
+    /**
+     * @typedef TimeSource
+     * @brief A function returning the current time in microseconds.
+     * @details The default is `nextinoMicros64()`: `esp_timer_get_time()` on
+     *          ESP32, `std::chrono::steady_clock` on host builds.
+     */
+    using TimeSource = Timestamp (*)();
+
+    /**
+     * @brief Returned by getTimeUntilNextDeadline() when no task is scheduled.
+     */
+    static const unsigned long NO_DEADLINE = (unsigned long)-1;
+
+    /**
+     * @brief Returned by getTimeUntilNextDeadlineMicros() when no task is scheduled.
+     */
+    static const Timestamp NO_DEADLINE_MICROS = (Timestamp)-1;
 
     static Scheduler &getInstance();
 
@@ -41,42 +182,305 @@ public:
      * @brief Schedules a task to be executed only once after a specified delay.
      * @param delayMs The delay in milliseconds before the task is executed.
      * @param callback The function to be executed.
-     * @return A unique handle for the scheduled task.
+     * @param owner (Optional) The module owning the task, see cancelAllOwnedBy().
+     * @return A unique handle for the scheduled task, or 0 if the pool is full.
      */
-    TaskHandle scheduleOnce(unsigned long delayMs, TaskCallback callback);
+    TaskHandle scheduleOnce(unsigned long delayMs, TaskCallback callback, const BaseModule *owner = nullptr);
 
     /**
      * @brief Schedules a task to be executed periodically.
      * @param intervalMs The interval in milliseconds between executions.
      * @param callback The function to be executed.
-     * @return A unique handle for the scheduled task.
+     * @param owner (Optional) The module owning the task, see cancelAllOwnedBy().
+     * @return A unique handle for the scheduled task, or 0 if the pool is full.
+     */
+    TaskHandle scheduleRecurring(unsigned long intervalMs, TaskCallback callback, const BaseModule *owner = nullptr);
+
+    /**
+     * @brief Schedules a task to be executed once after a delay in microseconds.
+     * @param delayUs The delay in microseconds before the task is executed.
+     * @param callback The function to be executed.
+     * @param owner (Optional) The module owning the task, see cancelAllOwnedBy().
+     * @return A unique handle for the scheduled task, or 0 if the pool is full.
+     */
+    TaskHandle scheduleOnceMicros(Timestamp delayUs, TaskCallback callback, const BaseModule *owner = nullptr);
+
+    /**
+     * @brief Schedules a high-rate task with a period in microseconds.
+     * @details Intended for 1-5 kHz control loops (motor, PWM feedback). The
+     *          period is only honoured while `loop()` is called often enough, so
+     *          keep other modules' `loop()` and callbacks short.
+     * @param intervalUs The interval in microseconds between executions.
+     * @param callback The function to be executed.
+     * @param owner (Optional) The module owning the task, see cancelAllOwnedBy().
+     * @return A unique handle for the scheduled task, or 0 if the pool is full.
+     */
+    TaskHandle scheduleRecurringMicros(Timestamp intervalUs, TaskCallback callback, const BaseModule *owner = nullptr);
+
+    /**
+     * @brief Chooses how a recurring task handles missed periods.
+     * @param handle The handle of a recurring task.
+     * @param policy The policy to apply from the next run on.
+     * @return True if the handle is valid, false otherwise.
+     */
+    bool setMissedRunPolicy(TaskHandle handle, MissedRunPolicy policy);
+
+    /**
+     * @brief Sets the priority class of a task.
+     * @param handle The handle of the task.
+     * @param priority The new priority class. Tasks start as TaskPriority::Normal.
+     * @return True if the handle is valid, false otherwise.
+     */
+    bool setTaskPriority(TaskHandle handle, TaskPriority priority);
+
+    /**
+     * @brief Gets the current priority class of a task.
+     * @details May differ from the value set if the task was demoted for overrunning.
+     * @param handle The handle of the task.
+     * @param priority Receives the priority class.
+     * @return True if the handle is valid, false otherwise.
      */
-    TaskHandle scheduleRecurring(unsigned long intervalMs, TaskCallback callback);
+    bool getTaskPriority(TaskHandle handle, TaskPriority &priority);
+
+    /**
+     * @brief Declares how much CPU time a single run of a task may take.
+     * @details Each run is timed; a run longer than the budget counts as an
+     *          overrun and is handled according to `policy`. The callback is
+     *          never interrupted.
+     * @param handle The handle of the task.
+     * @param budgetUs The budget in microseconds, or 0 to disable the check.
+     * @param policy What to do on an overrun.
+     * @return True if the handle is valid, false otherwise.
+     */
+    bool setTaskBudget(TaskHandle handle, uint32_t budgetUs, OverrunPolicy policy = OverrunPolicy::Report);
+
+    /**
+     * @brief Lets a task run up to `slackMs` after its deadline.
+     * @details The timer heap is ordered by each task's latest acceptable start
+     *          (deadline plus slack), and the idle loop sleeps until the earliest
+     *          of those. Whenever the loop runs, every task whose deadline has
+     *          passed runs with it, so tasks with overlapping windows share one
+     *          wake-up. A recurring task stays anchored to its ideal timeline;
+     *          the delay shows up in its lateness statistics.
+     * @param handle The handle of the task.
+     * @param slackMs The tolerated delay in milliseconds, or 0 for none (default).
+     * @return True if the handle is valid, false otherwise.
+     */
+    bool setTaskSlack(TaskHandle handle, unsigned long slackMs);
+
+    /**
+     * @brief Lets a task run up to `slackUs` microseconds after its deadline.
+     * @see setTaskSlack()
+     * @param handle The handle of the task.
+     * @param slackUs The tolerated delay in microseconds, or 0 for none.
+     * @return True if the handle is valid, false otherwise.
+     */
+    bool setTaskSlackMicros(TaskHandle handle, uint32_t slackUs);
+
+    /**
+     * @brief Chooses whether a task may run on an Executor worker.
+     * @details A parallel task's callback is copied to a worker and runs
+     *          concurrently with the main loop, so it must only touch state that
+     *          is safe to share. Its deadlines, priority and statistics are still
+     *          managed by the main loop. A period that falls due while the
+     *          previous run is still executing is skipped and counted as missed.
+     *          CPU budgets are not checked for runs that happen on a worker.
+     * @param handle The handle of the task.
+     * @param affinity TaskAffinity::Parallel to allow workers, MainLoop to forbid them.
+     * @return True if the handle is valid, false otherwise.
+     */
+    bool setTaskAffinity(TaskHandle handle, TaskAffinity affinity);
+
+    /**
+     * @brief Gets the lateness and jitter statistics of a task.
+     * @details Always returns run, missed-period and overrun counts; the
+     *          lateness, jitter and execution summaries are zero when
+     *          NEXTINO_SCHEDULER_TIMING_STATS is 0.
+     * @param handle The handle of the task.
+     * @param stats Receives the statistics.
+     * @return True if the handle is valid, false otherwise.
+     */
+    bool getTaskTimingStats(TaskHandle handle, TaskTimingStats &stats);
+
+    /**
+     * @brief Clears the timing statistics of a task.
+     * @param handle The handle of the task.
+     * @return True if the handle is valid, false otherwise.
+     */
+    bool resetTaskTimingStats(TaskHandle handle);
 
     /**
      * @brief Cancels a previously scheduled task.
+     * @details The handle is resolved in O(1); removing the task from the
+     *          deadline heap is O(log n). Stale handles are rejected.
      * @param handle The handle of the task to cancel, returned by a schedule* method.
      * @return True if the task was found and cancelled, false otherwise.
      */
     bool cancel(TaskHandle handle);
 
+    /**
+     * @brief Cancels every task scheduled with the given owner.
+     * @details Typically called by a module when it stops or is torn down.
+     * @param owner The module whose tasks should be cancelled. Must not be null.
+     * @return The number of tasks cancelled.
+     */
+    size_t cancelAllOwnedBy(const BaseModule *owner);
+
+    /**
+     * @brief Gets the number of tasks currently scheduled.
+     * @return The number of pending one-shot and recurring tasks.
+     */
+    size_t getTaskCount() const;
+
+    /**
+     * @brief Gets a snapshot of slot pool usage counters.
+     * @return The current SchedulerStats.
+     */
+    SchedulerStats getStats() const;
+
+    /**
+     * @brief Gets the time remaining until the earliest task deadline.
+     * @details Used by the SystemManager idle mode to decide how long the main
+     *          loop may sleep. Includes task slack: this is the latest moment
+     *          the loop can wake up without running any task past its window.
+     *          Rounded down, so sleeping for it never overshoots. O(1).
+     * @return Milliseconds until the next task is due, 0 if a task is due within
+     *         the next millisecond, or NO_DEADLINE if no task is scheduled.
+     */
+    unsigned long getTimeUntilNextDeadline() const;
+
+    /**
+     * @brief Gets the time remaining until the earliest task deadline, in microseconds.
+     * @return Microseconds until the next task is due, 0 if a task is already
+     *         due, or NO_DEADLINE_MICROS if no task is scheduled.
+     */
+    Timestamp getTimeUntilNextDeadlineMicros() const;
+
+    /**
+     * @brief Replaces the clock used for all deadlines.
+     * @details Intended for tests and simulations that need a virtual clock.
+     *          Must be set before scheduling tasks; switching clocks with tasks
+     *          pending shifts their deadlines.
+     * @param source The new time source, or nullptr to restore `nextinoMicros64()`.
+     */
+    void setTimeSource(TimeSource source);
+
+    /**
+     * @brief Gets the active time source, e.g. to restore it after a simulation.
+     */
+    TimeSource getTimeSource() const;
+
+    /**
+     * @brief Gets the current time from the active time source.
+     * @return The current time in microseconds.
+     */
+    Timestamp nowMicros() const;
+
+    /**
+     * @brief Executes all tasks whose deadline has been reached.
+     * @details Due tasks run in priority order, earliest deadline first within a
+     *          class. Only the earliest deadline is inspected when nothing is due,
+     *          so an idle pass is O(1). Firing k tasks costs O(k log n).
+     *          A task with slack may be held back until another task falls
+     *          due, but never beyond its own window; once a pass has work, every
+     *          task whose deadline has passed joins it. Finding those visits
+     *          only the tasks within the largest slack of now.
+     */
     void loop();
 
 private:
-    Scheduler() : _nextTaskHandle(1) {} // Initialize handle counter
+    Scheduler();
+
+    // Delete copy constructor and assignment operator to prevent copies
+    Scheduler(const Scheduler &) = delete;
+    void operator=(const Scheduler &) = delete;
+
+    static const uint16_t NO_INDEX = 0xFFFF;
+
+    /**
+     * @enum TaskState
+     * @brief Lifecycle of a task slot.
+     */
+    enum class TaskState : uint8_t {
+        Free,      /**< On the free list. */
+        Scheduled, /**< Waiting in the timer heap for its deadline. */
+        Ready,     /**< Due; waiting in the ready heap for its turn in this pass. */
+        Running,   /**< Popped from the heap; its callback is executing. */
+        Cancelled  /**< Cancelled while its callback was executing. */
+    };
 
     /**
      * @struct ScheduledTask
      * @brief Internal structure to hold information about a scheduled task.
      */
     struct ScheduledTask {
-        TaskHandle handle; // Unique ID for this task
-        unsigned long interval;
-        unsigned long lastRun;
         TaskCallback callback;
+        const BaseModule *owner;
+        Timestamp interval;    // Period (or one-shot delay) in microseconds
+        Timestamp nextRun;     // Absolute ideal deadline in microseconds
+        uint64_t sequence;     // Arming order; breaks deadline ties FIFO. Never wraps
+        uint16_t generation;   // Bumped on every free; part of the handle
+        uint16_t heapIndex;    // Position in its heap, or the next free slot while Free
+        TaskState state;
         bool recurring;
+        MissedRunPolicy missedRunPolicy;
+        TaskPriority priority;
+        OverrunPolicy overrunPolicy;
+        TaskAffinity affinity;
+        std::atomic<uint16_t> inFlight; // Runs still executing on an Executor worker
+        uint32_t budget;       // CPU budget per run in microseconds, 0 = none
+        uint32_t slack;        // Tolerated start delay in microseconds, 0 = none
+        uint32_t runs;
+        uint32_t missedPeriods;
+        uint32_t overruns;
+#if NEXTINO_SCHEDULER_TIMING_STATS
+        uint32_t lastLateness;
+        TimingHistogram lateness;
+        TimingHistogram jitter;
+        TimingHistogram execution;
+#endif
     };
 
-    std::vector<ScheduledTask> _tasks;
-    TaskHandle _nextTaskHandle;
-};
\ No newline at end of file
+    /**
+     * @struct TaskHeap
+     * @brief An indexed binary min-heap of slot indices.
+     * @details The timer heap is ordered by (nextRun + slack, sequence); the
+     *          ready heap by (priority, nextRun, sequence).
+     */
+    struct TaskHeap {
+        uint16_t entries[NEXTINO_SCHEDULER_MAX_TASKS];
+        uint16_t size;
+    };
+
+    TaskHandle allocateTask(Timestamp delayUs, TaskCallback &callback, const BaseModule *owner, bool recurring);
+    ScheduledTask *resolve(TaskHandle handle);
+    void freeTask(uint16_t index);
+    void arm(uint16_t index, bool keepSequence = false);
+    void rearmRecurring(uint16_t index, Timestamp startedAt);
+    void recordStart(ScheduledTask &task, Timestamp startedAt);
+    void recordFinish(uint16_t index, Timestamp executionUs);
+    bool dispatchToExecutor(ScheduledTask &task);
+    void promoteDueTasks(Timestamp now, uint64_t passStart);
+    uint16_t findDueTimer(Timestamp now, uint64_t passStart) const;
+    TaskHeap &heapOf(const ScheduledTask &task);
+
+    bool isEarlier(const TaskHeap &heap, uint16_t a, uint16_t b) const;
+    void heapPlace(TaskHeap &heap, uint16_t position, uint16_t index);
+    void heapSiftUp(TaskHeap &heap, uint16_t position);
+    void heapSiftDown(TaskHeap &heap, uint16_t position);
+    void heapInsert(TaskHeap &heap, uint16_t index);
+    void heapRemove(TaskHeap &heap, uint16_t position);
+
+    ScheduledTask _slots[NEXTINO_SCHEDULER_MAX_TASKS];
+    TaskHeap _timers;       // Tasks waiting for their deadline
+    TaskHeap _ready;        // Due tasks of the current pass, by priority
+    uint16_t _freeHead;     // First free slot, or NO_INDEX
+    size_t _activeTasks;
+    size_t _peakTasks;
+    uint32_t _scheduleFailures;
+    uint32_t _budgetOverruns;
+    uint64_t _nextSequence;
+    uint32_t _maxSlack;       // The largest slack ever set; bounds the search for due tasks
+    Timestamp _passStartedAt; // Time at the start of the current loop() pass
+    TimeSource _timeSource;
+};
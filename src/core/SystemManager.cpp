@@ -13,12 +13,20 @@
  */
 
 #include "SystemManager.h"
+#include "DeferredQueue.h"
+#include "EventBus.h"
 #include "Scheduler.h"
 #include "ModuleFactory.h"
 #include "Logger.h"
 #include "ResourceManager.h"
 #include "modules/BaseModule.h"
 #include <ArduinoJson.h>
+#include <string.h> // For strcmp
+#include <stdlib.h> // For strtol
+
+#if defined(ESP32)
+#include "esp_sleep.h"
+#endif
 
 SystemManager &SystemManager::getInstance()
 {
@@ -27,6 +35,23 @@ SystemManager &SystemManager::getInstance()
     return instance;
 }
 
+SystemManager::SystemManager()
+    : _isInErrorState(false),
+      _idleMode(IdleMode::None),
+      _maxIdleMs(1000),
+      _sleepFunction(nullptr),
+      _statsStartUs(0),
+      _idleUs(0),
+      _idlePeriods(0),
+      _earlyWakeups(0)
+{
+    // Construct the queue now, so an ISR posting to it never runs its constructor,
+    // and hand it and the bus the wake signal, so posting never calls back into
+    // this singleton.
+    DeferredQueue::getInstance().setWakeSignal(&_wakeSignal);
+    EventBus::getInstance().setWakeSignal(&_wakeSignal);
+}
+
 void SystemManager::registerModule(BaseModule *module)
 {
     if (module)
@@ -201,9 +226,114 @@ void SystemManager::loop()
         return;
     }
 
+    // Work handed over by ISRs and other tasks runs first, in bounded batches.
+    DeferredQueue &deferred = DeferredQueue::getInstance();
+    if (deferred.drain() == NEXTINO_DEFERRED_BATCH_SIZE && !deferred.isEmpty())
+    {
+        wake(); // More is waiting: do not sleep at the end of this pass.
+    }
+
+    // Then events queued with postAsync(), highest priority first.
+    EventBus::getInstance().dispatchQueued();
+
     Scheduler::getInstance().loop();
     for (auto *module : _modules)
     {
         module->loop();
     }
+
+    if (_idleMode != IdleMode::None)
+    {
+        idle();
+    }
+}
+
+void SystemManager::setIdleMode(IdleMode mode, unsigned long maxIdleMs)
+{
+    _idleMode = mode;
+    _maxIdleMs = maxIdleMs;
+    resetIdleStats();
+    NEXTINO_CORE_LOG(LogLevel::Info, "SysManager", "Idle mode set to %d (max %lu ms per sleep).", (int)mode, maxIdleMs);
+}
+
+void SystemManager::setSleepFunction(SleepFunction sleepFunction)
+{
+    _sleepFunction = sleepFunction;
+}
+
+void NEXTINO_ISR_ATTR SystemManager::wake()
+{
+    _wakeSignal.notify();
+}
+
+IdleStats SystemManager::getIdleStats() const
+{
+    uint64_t elapsedUs = Scheduler::getInstance().nowMicros() - _statsStartUs;
+
+    IdleStats stats;
+    stats.elapsedMs = (unsigned long)(elapsedUs / 1000ULL);
+    stats.idleMs = (unsigned long)(_idleUs / 1000ULL);
+    stats.idlePeriods = _idlePeriods;
+    stats.earlyWakeups = _earlyWakeups;
+    stats.cpuUtilisation = elapsedUs > 0 ? 1.0f - (float)((double)_idleUs / (double)elapsedUs) : 1.0f;
+    return stats;
+}
+
+void SystemManager::resetIdleStats()
+{
+    _statsStartUs = Scheduler::getInstance().nowMicros();
+    _idleUs = 0;
+    _idlePeriods = 0;
+    _earlyWakeups = 0;
+}
+
+void SystemManager::idle()
+{
+    Scheduler &scheduler = Scheduler::getInstance();
+    unsigned long untilNext = scheduler.getTimeUntilNextDeadline();
+    unsigned long sleepMs = untilNext < _maxIdleMs ? untilNext : _maxIdleMs;
+    if (sleepMs == 0 || EventBus::getInstance().hasQueuedEvents())
+    {
+        return; // Work is already due.
+    }
+
+    if (_idleMode == IdleMode::Yield)
+    {
+        yield();
+        return;
+    }
+
+    uint64_t start = scheduler.nowMicros();
+    if (_sleepFunction)
+    {
+        // Honour a wake() that arrived while the loop was busy.
+        if (!_wakeSignal.consume())
+        {
+            _sleepFunction(sleepMs);
+        }
+    }
+#if defined(ESP32)
+    else if (_idleMode == IdleMode::LightSleep)
+    {
+        // Only the timer (and any wake sources the application configured,
+        // e.g. GPIO) can end light sleep; wake() from a task cannot.
+        if (!_wakeSignal.consume())
+        {
+            esp_sleep_enable_timer_wakeup((uint64_t)sleepMs * 1000ULL);
+            esp_light_sleep_start();
+        }
+    }
+#endif
+    else
+    {
+        _wakeSignal.wait(sleepMs);
+    }
+
+    uint64_t sleptUs = scheduler.nowMicros() - start;
+    _idleUs += sleptUs;
+    _idlePeriods++;
+    if (sleptUs < (uint64_t)sleepMs * 1000ULL)
+    {
+        _earlyWakeups++;
+    }
 }
\ No newline at end of file
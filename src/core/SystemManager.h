@@ -15,10 +15,35 @@
 
 #pragma once
 #include <vector>
+#include <cstdint>
+#include "WakeSignal.h"
 
 // Forward declaration of BaseModule to avoid circular dependencies.
 class BaseModule;
 
+/**
+ * @enum IdleMode
+ * @brief Defines what the main loop does when no scheduled task is due.
+ */
+enum class IdleMode {
+    None,      /**< Busy-spin: run every module's loop() back to back (default). */
+    Yield,     /**< Yield the CPU to other tasks/threads, then continue. */
+    Sleep,     /**< Block until the next deadline or a wake() (vTaskDelay-style on ESP32, condition variable on host). */
+    LightSleep /**< ESP32 only: enter light sleep until the next deadline. Falls back to Sleep elsewhere. */
+};
+
+/**
+ * @struct IdleStats
+ * @brief Idle-time and CPU-utilisation statistics of the main loop.
+ */
+struct IdleStats {
+    unsigned long elapsedMs;    /**< Time covered by these statistics. */
+    unsigned long idleMs;       /**< Time spent sleeping in the idle mode. */
+    uint32_t idlePeriods;       /**< Number of times the loop went to sleep. */
+    uint32_t earlyWakeups;      /**< Sleeps ended early by wake(). */
+    float cpuUtilisation;       /**< Busy fraction of elapsedMs, 0.0 to 1.0. */
+};
+
 /**
  * @class SystemManager
  * @brief The central orchestrator of the Nextino framework.
@@ -55,12 +80,70 @@ public:
      */
     void loop();
 
+    /**
+     * @typedef SleepFunction
+     * @brief A custom sleep primitive, e.g. a simulated clock in tests.
+     * @param timeoutMs The maximum time to sleep, in milliseconds.
+     */
+    using SleepFunction = void (*)(unsigned long timeoutMs);
+
+    /**
+     * @brief Selects what the main loop does when no task is due.
+     * @details In `Sleep` and `LightSleep` modes, `loop()` sleeps until the next
+     *          Scheduler deadline, capped at `maxIdleMs` so modules that poll in
+     *          their own `loop()` are still serviced regularly.
+     * @param mode The idle behaviour to use.
+     * @param maxIdleMs The longest single sleep, in milliseconds.
+     */
+    void setIdleMode(IdleMode mode, unsigned long maxIdleMs = 1000);
+
+    /**
+     * @brief Replaces the built-in sleep primitive.
+     * @details Used with `Scheduler::setTimeSource()` to run the idle mode under
+     *          a simulated clock. Pass nullptr to restore the default.
+     * @param sleepFunction The function to call instead of sleeping.
+     */
+    void setSleepFunction(SleepFunction sleepFunction);
+
+    /**
+     * @brief Ends the current (or next) idle sleep early.
+     * @details Call this after queuing work for the main loop from another
+     *          FreeRTOS task, a host thread or an ISR. Safe in all of them.
+     *          `DeferredQueue::post()` wakes the loop for you.
+     */
+    void wake();
+
+    /**
+     * @brief Gets idle-time and CPU-utilisation statistics.
+     * @return The statistics gathered since the last reset.
+     */
+    IdleStats getIdleStats() const;
+
+    /**
+     * @brief Restarts the idle statistics window.
+     */
+    void resetIdleStats();
+
 private:
     /**
      * @brief Private constructor to enforce the singleton pattern.
      */
-    SystemManager() : _isInErrorState(false) {}
+    SystemManager();
+
+    /**
+     * @brief Sleeps until the next deadline, according to the idle mode.
+     */
+    void idle();
 
     std::vector<BaseModule *> _modules;
     bool _isInErrorState; // Flag to indicate a critical startup failure.
+
+    IdleMode _idleMode;
+    unsigned long _maxIdleMs;
+    SleepFunction _sleepFunction;
+    WakeSignal _wakeSignal;
+    uint64_t _statsStartUs;
+    uint64_t _idleUs;
+    uint32_t _idlePeriods;
+    uint32_t _earlyWakeups;
 };
\ No newline at end of file
@@ -0,0 +1,126 @@
+/**
+ * @file        TimingStats.h
+ * @title       Compact Timing Statistics
+ * @description Defines `TimingHistogram`, a fixed-size accumulator for latency
+ *              style measurements (min/avg/max/p99) that never allocates.
+ *              Percentiles are estimated from power-of-two buckets.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-08-29
+ * @version     0.1.0
+ *
+ * @copyright   (c) 2025 Nextino. All rights reserved.
+ * @license     MIT License
+ */
+
+#pragma once
+#include <cstdint>
+
+/**
+ * @struct TimingSummary
+ * @brief A summary of a timing distribution, in the unit it was recorded in.
+ */
+struct TimingSummary {
+    uint32_t count; /**< Number of samples recorded. */
+    uint32_t min;   /**< Smallest sample (0 if no samples). */
+    uint32_t avg;   /**< Arithmetic mean, rounded down. */
+    uint32_t max;   /**< Largest sample. */
+    uint32_t p99;   /**< 99th percentile estimate (bucket upper bound, capped at max). */
+};
+
+/**
+ * @class TimingHistogram
+ * @brief Accumulates samples into 24 power-of-two buckets.
+ * @details Bucket 0 holds 0, bucket i holds [2^(i-1), 2^i), and the last bucket
+ *          holds everything larger. When a bucket count saturates, all buckets
+ *          are halved, which keeps the percentile estimate valid.
+ */
+class TimingHistogram {
+public:
+    static const uint8_t BUCKET_COUNT = 24;
+
+    TimingHistogram() { reset(); }
+
+    /**
+     * @brief Records one sample.
+     * @param value The sample value, e.g. a lateness in microseconds.
+     */
+    void record(uint32_t value) {
+        if (_count == 0 || value < _min) {
+            _min = value;
+        }
+        if (value > _max) {
+            _max = value;
+        }
+        _count++;
+        _sum += value;
+
+        uint8_t bucket = bucketFor(value);
+        if (_buckets[bucket] == UINT16_MAX) {
+            for (uint8_t i = 0; i < BUCKET_COUNT; ++i) {
+                _buckets[i] /= 2;
+            }
+        }
+        _buckets[bucket]++;
+    }
+
+    /**
+     * @brief Clears all samples.
+     */
+    void reset() {
+        _count = 0;
+        _min = 0;
+        _max = 0;
+        _sum = 0;
+        for (uint8_t i = 0; i < BUCKET_COUNT; ++i) {
+            _buckets[i] = 0;
+        }
+    }
+
+    /**
+     * @brief Computes a summary of the recorded samples.
+     */
+    TimingSummary summary() const {
+        TimingSummary result = {_count, _min, 0, _max, 0};
+        if (_count == 0) {
+            return result;
+        }
+        result.avg = (uint32_t)(_sum / _count);
+
+        uint32_t total = 0;
+        for (uint8_t i = 0; i < BUCKET_COUNT; ++i) {
+            total += _buckets[i];
+        }
+        // Smallest bucket whose cumulative count reaches 99% of the samples.
+        uint32_t threshold = total - total / 100;
+        uint32_t cumulative = 0;
+        for (uint8_t i = 0; i < BUCKET_COUNT; ++i) {
+            cumulative += _buckets[i];
+            if (cumulative >= threshold) {
+                uint32_t upperBound = (i == 0) ? 0 : ((i == BUCKET_COUNT - 1) ? _max : (1UL << i) - 1);
+                result.p99 = upperBound < _max ? upperBound : _max;
+                break;
+            }
+        }
+        if (result.p99 < _min) {
+            result.p99 = _min;
+        }
+        return result;
+    }
+
+private:
+    static uint8_t bucketFor(uint32_t value) {
+        uint8_t bucket = 0;
+        while (value != 0 && bucket < BUCKET_COUNT - 1) {
+            value >>= 1;
+            bucket++;
+        }
+        return bucket;
+    }
+
+    uint32_t _count;
+    uint32_t _min;
+    uint32_t _max;
+    uint64_t _sum;
+    uint16_t _buckets[BUCKET_COUNT];
+};
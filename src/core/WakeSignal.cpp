@@ -0,0 +1,87 @@
+/**
+ * @file        WakeSignal.cpp
+ * @title       Main Loop Wake Signal Implementation
+ * @description Implements the platform-specific sleep and notify logic for
+ *              the `WakeSignal` class.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-08-28
+ * @version     0.1.0
+ *
+ * @copyright   (c) 2025 Nextino. All rights reserved.
+ * @license     MIT License
+ */
+
+#include "WakeSignal.h"
+#include "Platform.h"
+
+WakeSignal::WakeSignal() : _pending(false), _isWaiting(false) {
+#if defined(ESP32)
+    _semaphore = xSemaphoreCreateBinary();
+#endif
+}
+
+void NEXTINO_ISR_ATTR WakeSignal::notify() {
+    _pending.store(true);
+
+    // The sleeper publishes _isWaiting before re-checking _pending, so either
+    // it sees our flag, or we see that it is waiting and must be woken.
+    if (!_isWaiting.load()) {
+        return;
+    }
+
+#if defined(ESP32)
+    if (_semaphore == NULL) {
+        return;
+    }
+    if (xPortInIsrContext()) {
+        BaseType_t higherPriorityTaskWoken = pdFALSE;
+        xSemaphoreGiveFromISR(_semaphore, &higherPriorityTaskWoken);
+        if (higherPriorityTaskWoken == pdTRUE) {
+            portYIELD_FROM_ISR();
+        }
+    } else {
+        xSemaphoreGive(_semaphore);
+    }
+#elif !defined(ARDUINO)
+    std::lock_guard<std::mutex> lock(_mutex);
+    _condition.notify_one();
+#endif
+}
+
+bool WakeSignal::wait(unsigned long timeoutMs) {
+    _isWaiting.store(true);
+    if (_pending.exchange(false)) {
+        _isWaiting.store(false);
+        return true;
+    }
+
+    bool woken = false;
+#if defined(ESP32)
+    if (_semaphore != NULL) {
+        // Blocking here lets FreeRTOS run the idle task, which enters automatic
+        // light sleep when power management is enabled.
+        woken = xSemaphoreTake(_semaphore, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+    } else {
+        delay(timeoutMs);
+    }
+#elif !defined(ARDUINO)
+    std::unique_lock<std::mutex> lock(_mutex);
+    woken = _condition.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() { return _pending.load(); });
+#else
+    // No blocking primitive: poll the flag in short naps.
+    unsigned long start = millis();
+    while (!_pending.load() && millis() - start < timeoutMs) {
+        delay(1);
+    }
+    woken = _pending.load();
+#endif
+
+    _isWaiting.store(false);
+    _pending.store(false);
+    return woken;
+}
+
+bool WakeSignal::consume() {
+    return _pending.exchange(false);
+}
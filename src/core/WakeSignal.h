@@ -0,0 +1,72 @@
+/**
+ * @file        WakeSignal.h
+ * @title       Main Loop Wake Signal
+ * @description Defines the `WakeSignal` class, a one-bit "work is pending" flag
+ *              the main loop can sleep on. Other FreeRTOS tasks, interrupts or
+ *              host threads call `notify()` to end the sleep early.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-08-28
+ * @version     0.1.0
+ *
+ * @copyright   (c) 2025 Nextino. All rights reserved.
+ * @license     MIT License
+ */
+
+#pragma once
+#include <atomic>
+
+#if defined(ESP32)
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#elif !defined(ARDUINO)
+#include <condition_variable>
+#include <mutex>
+#endif
+
+/**
+ * @class WakeSignal
+ * @brief A sleep/notify primitive for the main loop.
+ * @details Uses a FreeRTOS binary semaphore on ESP32, a condition variable on
+ *          host builds, and a polled flag on other Arduino targets.
+ */
+class WakeSignal {
+public:
+    WakeSignal();
+
+    // A wake signal is tied to the thread that sleeps on it; never copy it.
+    WakeSignal(const WakeSignal&) = delete;
+    void operator=(const WakeSignal&) = delete;
+
+    /**
+     * @brief Marks work as pending and wakes the sleeper, if any.
+     * @details Safe to call from any task, thread, or (on ESP32) an ISR.
+     */
+    void notify();
+
+    /**
+     * @brief Sleeps until notified or until the timeout expires.
+     * @details Returns immediately if a notification is already pending. The
+     *          pending flag is cleared on return.
+     * @param timeoutMs The maximum time to sleep, in milliseconds.
+     * @return True if woken by `notify()`, false if the timeout expired.
+     */
+    bool wait(unsigned long timeoutMs);
+
+    /**
+     * @brief Clears the pending flag without sleeping.
+     * @return True if a notification was pending.
+     */
+    bool consume();
+
+private:
+    std::atomic<bool> _pending;
+    std::atomic<bool> _isWaiting;
+
+#if defined(ESP32)
+    SemaphoreHandle_t _semaphore;
+#elif !defined(ARDUINO)
+    std::mutex _mutex;
+    std::condition_variable _condition;
+#endif
+};
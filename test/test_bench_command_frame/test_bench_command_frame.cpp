@@ -0,0 +1,172 @@
+/**
+ * @file        test_bench_command_frame.cpp
+ * @title       CommandRouter Benchmark: Text Commands vs. Binary Frames
+ * @description Measures the parse and dispatch cost of the same command, and
+ *              the bytes it takes on the wire, as a text line through
+ *              execute() and as a binary frame through executeFrame(), each on
+ *              its own and collected byte by byte, as from a serial port.
+ *              20 modules of 5 commands each are registered.
+ *              Intended for the host build: `pio test -e native -f test_bench_command_frame`.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-06
+ * @version     0.1.0
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include <string>
+#include "core/Platform.h"
+#include "core/CommandRouter.h"
+#include "core/CommandFrame.h"
+
+namespace {
+
+const int MODULE_COUNT = 20;
+const int COMMANDS = 500000;
+const char* const COMMAND_NAMES[] = {"on", "off", "set", "get_value", "status"};
+
+uint32_t g_checksum = 0;
+
+// Does as little as possible, so the parse and dispatch cost shows.
+CommandStatus handler(const CommandArgs& args, CommandOutput& out) {
+    g_checksum += (uint32_t)args.size();
+    out.print("OK");
+    return CommandStatus::Ok;
+}
+
+struct Row {
+    double commandsPerSecond;
+    size_t requestBytes;
+    size_t responseBytes;
+};
+
+template <typename Run>
+double measure(Run run, uint32_t argsPerCommand) {
+    g_checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < COMMANDS; ++i) {
+        run();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    TEST_ASSERT_EQUAL(COMMANDS * argsPerCommand, g_checksum);
+    return COMMANDS / seconds;
+}
+
+void printRow(const char* name, const Row& row, double baseline) {
+    printf("%-40s %14.0f %9.2fx %10u %10u\n", name, row.commandsPerSecond, row.commandsPerSecond / baseline,
+           (unsigned)row.requestBytes, (unsigned)row.responseBytes);
+}
+
+} // namespace
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_bench_text_vs_binary() {
+    CommandRouter& router = CommandRouter::getInstance();
+    char name[24];
+    for (int m = 0; m < MODULE_COUNT; ++m) {
+        snprintf(name, sizeof(name), "bench_module_%02d", m);
+        for (const char* command : COMMAND_NAMES) {
+            router.registerCommand(name, command, handler);
+        }
+    }
+
+    // The text line a controller would send, with its line break, and the same as a frame.
+    const std::string_view line = "bench_module_11 set 75 500 fast\n";
+    uint8_t request[CommandFrame::MAX_SIZE];
+    int id = router.commandId("bench_module_11", "set");
+    TEST_ASSERT_TRUE(id >= 0);
+    size_t requestSize = CommandFrameWriter(request, sizeof(request)).begin(1, (uint16_t)id).addInt(75).addInt(500).addText("fast").finish();
+
+    char buffer[64];
+    CommandOutput output(buffer, sizeof(buffer));
+    Row text = {measure([&]() {
+                    output.clear();
+                    router.execute(line, output);
+                }, 3),
+                line.size(), 0};
+    text.responseBytes = output.length() + 1;
+
+    // A serial console collects the line first.
+    char lineBuffer[64];
+    size_t lineLength = 0;
+    Row textStreamed = {measure([&]() {
+                            for (char c : line) {
+                                lineBuffer[lineLength++] = c;
+                                if (c == '\n') {
+                                    output.clear();
+                                    router.execute(std::string_view(lineBuffer, lineLength), output);
+                                    lineLength = 0;
+                                }
+                            }
+                        }, 3),
+                        line.size(), output.length() + 1};
+
+    uint8_t response[CommandFrame::MAX_SIZE];
+    size_t responseSize = 0;
+    Row binary = {measure([&]() { responseSize = router.executeFrame(request, requestSize, response, sizeof(response)); }, 3),
+                  requestSize, 0};
+    binary.responseBytes = responseSize;
+
+    CommandFrameReader reader;
+    Row streamed = {measure([&]() {
+                        for (size_t i = 0; i < requestSize; ++i) {
+                            if (reader.feed(request[i])) {
+                                responseSize = router.executeFrame(reader.data(), reader.size(), response, sizeof(response));
+                            }
+                        }
+                    }, 3),
+                    requestSize, responseSize};
+
+    // A command that does not exist: an error message against a status code.
+    const std::string_view missing = "bench_module_11 reboot\n";
+    Row textError = {measure([&]() {
+                         output.clear();
+                         router.execute(missing, output);
+                     }, 0),
+                     missing.size(), 0};
+    textError.responseBytes = output.length() + 1;
+    size_t missingSize = CommandFrameWriter(request, sizeof(request)).begin(2, 0x7FFF).finish();
+    Row binaryError = {measure([&]() { responseSize = router.executeFrame(request, missingSize, response, sizeof(response)); }, 0),
+                       missingSize, 0};
+    binaryError.responseBytes = responseSize;
+
+    printf("\n%d commands registered, %d executions each\n", MODULE_COUNT * 5, COMMANDS);
+    printf("%-40s %14s %10s %10s %10s\n", "path", "commands/s", "speedup", "req bytes", "resp bytes");
+    printRow("text: execute(\"bench_module_11 set ...\")", text, text.commandsPerSecond);
+    printRow("binary: executeFrame()", binary, text.commandsPerSecond);
+    printRow("text: line collected byte by byte", textStreamed, text.commandsPerSecond);
+    printRow("binary: CommandFrameReader + execute", streamed, textStreamed.commandsPerSecond);
+    printRow("text, unknown command", textError, textError.commandsPerSecond);
+    printRow("binary, unknown command ID", binaryError, textError.commandsPerSecond);
+
+    TEST_ASSERT_TRUE(binary.requestBytes < text.requestBytes);
+    TEST_ASSERT_TRUE(binaryError.responseBytes < textError.responseBytes);
+    TEST_ASSERT_TRUE(binary.commandsPerSecond > text.commandsPerSecond);
+    TEST_ASSERT_TRUE(streamed.commandsPerSecond > textStreamed.commandsPerSecond);
+}
+
+void runAllTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_text_vs_binary);
+}
+
+#if defined(ARDUINO)
+void setup() {
+    delay(2000);
+    runAllTests();
+}
+
+void loop() {
+    UNITY_END();
+}
+#else
+int main() {
+    runAllTests();
+    return UNITY_END();
+}
+#endif
@@ -0,0 +1,307 @@
+/**
+ * @file        test_bench_command_router.cpp
+ * @title       CommandRouter Benchmark: In-Place Parsing vs. String Copies
+ * @description Measures commands per second and heap allocations per command
+ *              with 20 modules of 5 commands each registered, through a copy
+ *              of the original `std::stringstream` and `std::map` router, the
+ *              `std::string` form of execute() with a string handler, and the
+ *              `std::string_view` form with a view handler and a caller buffer.
+ *              Also compares a string handler that parses its numbers with
+ *              strtol() against a typed handler, and batches of 30 commands
+ *              through executeBatch() against one execute() call per command.
+ *              Intended for the host build: `pio test -e native -f test_bench_command_router`.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-05
+ * @version     0.1.0
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "core/Platform.h"
+#include "core/CommandRouter.h"
+#include "core/Logger.h"
+
+static size_t g_allocations = 0;
+
+void* operator new(size_t size) {
+    g_allocations++;
+    void* block = malloc(size ? size : 1);
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void operator delete(void* block) noexcept {
+    free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    free(block);
+}
+
+namespace {
+
+const int MODULE_COUNT = 20;
+const int COMMANDS = 200000;
+const char* const COMMAND_NAMES[] = {"on", "off", "set", "get_value", "status"};
+
+uint32_t g_checksum = 0;
+
+/**
+ * @brief A copy of the original CommandRouter, used as the baseline.
+ * @details Every command goes through a stringstream, a vector of token
+ *          strings, a vector of argument strings and a key of two strings.
+ */
+class OriginalCommandRouter {
+public:
+    void registerCommand(const std::string& instanceName, const std::string& command, CommandHandler handler) {
+        _commandRegistry[{instanceName, command}] = handler;
+    }
+
+    std::string execute(const std::string& commandString) {
+        std::stringstream ss(commandString);
+        std::string segment;
+        std::vector<std::string> segments;
+        while (std::getline(ss, segment, ' ')) {
+            segments.push_back(segment);
+        }
+        if (segments.size() < 2) {
+            return "ERROR: Invalid command format. Expected '<instance_name> <command> [args...]'.";
+        }
+        std::string instanceName = segments[0];
+        std::string command = segments[1];
+        std::vector<std::string> args(segments.begin() + 2, segments.end());
+        RegisteredCommand cmdToFind = {instanceName, command};
+        auto it = _commandRegistry.find(cmdToFind);
+        if (it != _commandRegistry.end()) {
+            NEXTINO_CORE_LOG(LogLevel::Info, "CmdRouter", "Executing command '%s' for instance '%s'", command.c_str(), instanceName.c_str());
+            return it->second(args);
+        }
+        return "ERROR: Command not found.";
+    }
+
+private:
+    struct RegisteredCommand {
+        std::string instanceName;
+        std::string command;
+        bool operator<(const RegisteredCommand& other) const {
+            if (instanceName < other.instanceName) return true;
+            if (instanceName > other.instanceName) return false;
+            return command < other.command;
+        }
+    };
+    std::map<RegisteredCommand, CommandHandler> _commandRegistry;
+};
+
+std::string stringHandler(const std::vector<std::string>& args) {
+    g_checksum += (uint32_t)args.size();
+    return "OK: Level set to " + (args.empty() ? std::string("?") : args[0]) + ".";
+}
+
+// What a module wrote by hand before typed handlers: parse, check, format, return a string.
+std::string parsingStringHandler(const std::vector<std::string>& args) {
+    if (args.size() != 3) {
+        return "ERROR: Expected 3 arguments.";
+    }
+    char* end;
+    long level = strtol(args[0].c_str(), &end, 10);
+    if (*end != '\0') {
+        return "ERROR: Level must be an integer.";
+    }
+    long fadeMs = strtol(args[1].c_str(), &end, 10);
+    if (*end != '\0') {
+        return "ERROR: Fade must be an integer.";
+    }
+    g_checksum += (uint32_t)args.size();
+    char result[48];
+    snprintf(result, sizeof(result), "OK: Level set to %ld in %ld ms.", level, fadeMs);
+    return result;
+}
+
+CommandStatus typedHandler(int level, int fadeMs, std::string_view, CommandOutput& out) {
+    g_checksum += 3;
+    out.print("OK: Level set to ").print(level).print(" in ").print(fadeMs).print(" ms.");
+    return CommandStatus::Ok;
+}
+
+CommandStatus viewHandler(const CommandArgs& args, CommandOutput& out) {
+    g_checksum += (uint32_t)args.size();
+    out.print("OK: Level set to ").print(args.empty() ? std::string_view("?") : args[0]).print(".");
+    return CommandStatus::Ok;
+}
+
+struct Row {
+    double commandsPerSecond;
+    double allocationsPerCommand;
+};
+
+template <typename Run>
+Row measure(Run run) {
+    g_checksum = 0;
+    size_t allocations = g_allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < COMMANDS; ++i) {
+        run();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    TEST_ASSERT_EQUAL(COMMANDS * 3, g_checksum);
+    return {COMMANDS / seconds, (double)(g_allocations - allocations) / COMMANDS};
+}
+
+} // namespace
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_bench_commands_per_second() {
+    OriginalCommandRouter original;
+    CommandRouter& router = CommandRouter::getInstance();
+    char name[24];
+    for (int m = 0; m < MODULE_COUNT; ++m) {
+        snprintf(name, sizeof(name), "bench_module_%02d", m);
+        for (const char* command : COMMAND_NAMES) {
+            original.registerCommand(name, command, stringHandler);
+            // The router holds both forms: string handlers under a "legacy_" prefix.
+            router.registerCommand(std::string("legacy_") + name, command, stringHandler);
+            router.registerCommand(name, command, viewHandler);
+            router.registerCommand(std::string("parsing_") + name, command, parsingStringHandler);
+            router.registerCommand<int, int, std::string_view>(std::string("typed_") + name, command, typedHandler);
+        }
+    }
+
+    // A typical control command on a module in the middle of the table.
+    const std::string line = "bench_module_11 set 75 500 fast";
+    const std::string legacyLine = "legacy_bench_module_11 set 75 500 fast";
+    std::string result;
+    Row baseline = measure([&]() { result = original.execute(line); });
+    TEST_ASSERT_EQUAL_STRING("OK: Level set to 75.", result.c_str());
+    Row legacy = measure([&]() { result = router.execute(legacyLine); });
+    TEST_ASSERT_EQUAL_STRING("OK: Level set to 75.", result.c_str());
+
+    char buffer[64];
+    CommandOutput output(buffer, sizeof(buffer));
+    const std::string_view view(line);
+    Row inPlace = measure([&]() {
+        output.clear();
+        router.execute(view, output);
+    });
+    TEST_ASSERT_EQUAL_STRING("OK: Level set to 75.", buffer);
+
+    // Handlers that decode and check numbers: by hand from strings, and typed.
+    const std::string parsingLine = "parsing_bench_module_11 set 75 500 fast";
+    Row parsing = measure([&]() { result = router.execute(parsingLine); });
+    TEST_ASSERT_EQUAL_STRING("OK: Level set to 75 in 500 ms.", result.c_str());
+    const std::string typedLine = "typed_bench_module_11 set 75 500 fast";
+    const std::string_view typedView(typedLine);
+    Row typed = measure([&]() {
+        output.clear();
+        router.execute(typedView, output);
+    });
+    TEST_ASSERT_EQUAL_STRING("OK: Level set to 75 in 500 ms.", buffer);
+
+    printf("\n%d commands registered, %d executions of \"%s\"\n", MODULE_COUNT * 5, COMMANDS, line.c_str());
+    printf("%-44s %14s %10s %14s\n", "execute path", "commands/s", "speedup", "allocs/command");
+    printf("%-44s %14.0f %9.2fx %14.1f\n", "stringstream + std::map (original)", baseline.commandsPerSecond, 1.0,
+           baseline.allocationsPerCommand);
+    printf("%-44s %14.0f %9.2fx %14.1f\n", "execute(std::string), string handler", legacy.commandsPerSecond,
+           legacy.commandsPerSecond / baseline.commandsPerSecond, legacy.allocationsPerCommand);
+    printf("%-44s %14.0f %9.2fx %14.1f\n", "execute(string_view, output), view handler", inPlace.commandsPerSecond,
+           inPlace.commandsPerSecond / baseline.commandsPerSecond, inPlace.allocationsPerCommand);
+    printf("%-44s %14.0f %9.2fx %14.1f\n", "execute(std::string), strtol + snprintf", parsing.commandsPerSecond,
+           parsing.commandsPerSecond / baseline.commandsPerSecond, parsing.allocationsPerCommand);
+    printf("%-44s %14.0f %9.2fx %14.1f\n", "execute(string_view, output), typed handler", typed.commandsPerSecond,
+           typed.commandsPerSecond / baseline.commandsPerSecond, typed.allocationsPerCommand);
+
+    TEST_ASSERT_EQUAL(0, (int)(inPlace.allocationsPerCommand * COMMANDS));
+    TEST_ASSERT_EQUAL(0, (int)(typed.allocationsPerCommand * COMMANDS));
+    TEST_ASSERT_TRUE(typed.commandsPerSecond > parsing.commandsPerSecond);
+    TEST_ASSERT_TRUE(inPlace.commandsPerSecond > baseline.commandsPerSecond);
+}
+
+void test_bench_batch_vs_single_commands() {
+    // Runs after test_bench_commands_per_second, which registered the modules.
+    CommandRouter& router = CommandRouter::getInstance();
+    const int BATCH = 30;
+    const int ROUNDS = COMMANDS / BATCH;
+    std::vector<std::string> lines;
+    std::string batch;
+    char line[48];
+    for (int i = 0; i < BATCH; ++i) {
+        snprintf(line, sizeof(line), "legacy_bench_module_%02d set %d 500 fast", i % MODULE_COUNT, i);
+        lines.push_back(line);
+        batch += line + 7; // The view handlers, without the "legacy_" prefix
+        batch += ';';
+    }
+
+    // One execute(std::string) call and one result string per command.
+    g_checksum = 0;
+    size_t allocations = g_allocations;
+    auto start = std::chrono::steady_clock::now();
+    std::string result;
+    for (int round = 0; round < ROUNDS; ++round) {
+        for (const std::string& single : lines) {
+            result = router.execute(single);
+        }
+    }
+    double singleSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double singleAllocations = (double)(g_allocations - allocations) / (ROUNDS * BATCH);
+    TEST_ASSERT_EQUAL(ROUNDS * BATCH * 3, g_checksum);
+
+    // One executeBatch() call and one response buffer per batch.
+    char response[1024];
+    CommandOutput output(response, sizeof(response));
+    g_checksum = 0;
+    allocations = g_allocations;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        output.clear();
+        router.executeBatch(batch, output, BatchMode::StopOnError);
+    }
+    double batchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double batchAllocations = (double)(g_allocations - allocations) / (ROUNDS * BATCH);
+    TEST_ASSERT_EQUAL(ROUNDS * BATCH * 3, g_checksum);
+    TEST_ASSERT_FALSE(output.truncated());
+
+    double singleRate = ROUNDS * BATCH / singleSeconds;
+    double batchRate = ROUNDS * BATCH / batchSeconds;
+    printf("\n%d batches of %d commands\n", ROUNDS, BATCH);
+    printf("%-44s %14s %10s %14s\n", "execute path", "commands/s", "speedup", "allocs/command");
+    printf("%-44s %14.0f %9.2fx %14.1f\n", "execute(std::string), one call per command", singleRate, 1.0, singleAllocations);
+    printf("%-44s %14.0f %9.2fx %14.1f\n", "executeBatch(), one call per batch", batchRate, batchRate / singleRate,
+           batchAllocations);
+
+    TEST_ASSERT_EQUAL(0, (int)(batchAllocations * ROUNDS * BATCH));
+    TEST_ASSERT_TRUE(batchRate > singleRate);
+}
+
+void runAllTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_commands_per_second);
+    RUN_TEST(test_bench_batch_vs_single_commands);
+}
+
+#if defined(ARDUINO)
+void setup() {
+    delay(2000);
+    runAllTests();
+}
+
+void loop() {
+    UNITY_END();
+}
+#else
+int main() {
+    runAllTests();
+    return UNITY_END();
+}
+#endif
@@ -0,0 +1,526 @@
+/**
+ * @file        generated_commands.h
+ * @title       Command Table Fixture for the Benchmark
+ * @description The output of `code_generator.generate_command_table()` for
+ *              100 instances, `bench_module_000` to `bench_module_099`, each
+ *              declaring the commands on, off, set, get_value and status.
+ *              Regenerate it after changing the hash or the table layout.
+ */
+#pragma once
+#include "core/CommandRouter.h"
+
+// Perfect-hash table of the commands declared in config.json (see CommandTable)
+static const CommandTable::Entry nextinoCommandEntries[] = {
+    {"bench_module_027", "off"}, // ID 0
+    {"bench_module_066", "get_value"}, // ID 1
+    {"bench_module_072", "set"}, // ID 2
+    {"bench_module_089", "status"}, // ID 3
+    {"bench_module_055", "set"}, // ID 4
+    {"bench_module_000", "set"}, // ID 5
+    {"bench_module_095", "status"}, // ID 6
+    {"bench_module_017", "get_value"}, // ID 7
+    {"bench_module_036", "get_value"}, // ID 8
+    {"bench_module_053", "on"}, // ID 9
+    {"bench_module_018", "off"}, // ID 10
+    {"bench_module_065", "on"}, // ID 11
+    {"bench_module_099", "off"}, // ID 12
+    {"bench_module_023", "status"}, // ID 13
+    {"bench_module_012", "get_value"}, // ID 14
+    {"bench_module_094", "status"}, // ID 15
+    {"bench_module_010", "status"}, // ID 16
+    {"bench_module_045", "off"}, // ID 17
+    {"bench_module_097", "on"}, // ID 18
+    {"bench_module_045", "status"}, // ID 19
+    {"bench_module_082", "status"}, // ID 20
+    {"bench_module_028", "off"}, // ID 21
+    {"bench_module_095", "set"}, // ID 22
+    {"bench_module_082", "set"}, // ID 23
+    {"bench_module_038", "get_value"}, // ID 24
+    {"bench_module_044", "status"}, // ID 25
+    {"bench_module_076", "on"}, // ID 26
+    {"bench_module_084", "on"}, // ID 27
+    {"bench_module_026", "on"}, // ID 28
+    {"bench_module_050", "set"}, // ID 29
+    {"bench_module_054", "set"}, // ID 30
+    {"bench_module_037", "off"}, // ID 31
+    {"bench_module_037", "status"}, // ID 32
+    {"bench_module_083", "off"}, // ID 33
+    {"bench_module_019", "off"}, // ID 34
+    {"bench_module_068", "on"}, // ID 35
+    {"bench_module_053", "get_value"}, // ID 36
+    {"bench_module_034", "off"}, // ID 37
+    {"bench_module_079", "get_value"}, // ID 38
+    {"bench_module_059", "on"}, // ID 39
+    {"bench_module_095", "on"}, // ID 40
+    {"bench_module_029", "get_value"}, // ID 41
+    {"bench_module_057", "set"}, // ID 42
+    {"bench_module_038", "status"}, // ID 43
+    {"bench_module_026", "off"}, // ID 44
+    {"bench_module_008", "on"}, // ID 45
+    {"bench_module_007", "on"}, // ID 46
+    {"bench_module_016", "on"}, // ID 47
+    {"bench_module_084", "status"}, // ID 48
+    {"bench_module_068", "set"}, // ID 49
+    {"bench_module_090", "off"}, // ID 50
+    {"bench_module_079", "on"}, // ID 51
+    {"bench_module_085", "off"}, // ID 52
+    {"bench_module_004", "set"}, // ID 53
+    {"bench_module_039", "get_value"}, // ID 54
+    {"bench_module_001", "on"}, // ID 55
+    {"bench_module_049", "status"}, // ID 56
+    {"bench_module_024", "on"}, // ID 57
+    {"bench_module_041", "status"}, // ID 58
+    {"bench_module_001", "status"}, // ID 59
+    {"bench_module_077", "off"}, // ID 60
+    {"bench_module_017", "status"}, // ID 61
+    {"bench_module_029", "set"}, // ID 62
+    {"bench_module_099", "set"}, // ID 63
+    {"bench_module_057", "on"}, // ID 64
+    {"bench_module_094", "get_value"}, // ID 65
+    {"bench_module_021", "off"}, // ID 66
+    {"bench_module_034", "on"}, // ID 67
+    {"bench_module_001", "off"}, // ID 68
+    {"bench_module_079", "off"}, // ID 69
+    {"bench_module_045", "set"}, // ID 70
+    {"bench_module_036", "set"}, // ID 71
+    {"bench_module_002", "set"}, // ID 72
+    {"bench_module_091", "on"}, // ID 73
+    {"bench_module_063", "status"}, // ID 74
+    {"bench_module_081", "get_value"}, // ID 75
+    {"bench_module_077", "get_value"}, // ID 76
+    {"bench_module_017", "set"}, // ID 77
+    {"bench_module_069", "off"}, // ID 78
+    {"bench_module_064", "get_value"}, // ID 79
+    {"bench_module_070", "status"}, // ID 80
+    {"bench_module_000", "off"}, // ID 81
+    {"bench_module_006", "off"}, // ID 82
+    {"bench_module_093", "status"}, // ID 83
+    {"bench_module_066", "status"}, // ID 84
+    {"bench_module_088", "on"}, // ID 85
+    {"bench_module_023", "get_value"}, // ID 86
+    {"bench_module_033", "off"}, // ID 87
+    {"bench_module_050", "status"}, // ID 88
+    {"bench_module_040", "get_value"}, // ID 89
+    {"bench_module_053", "status"}, // ID 90
+    {"bench_module_020", "status"}, // ID 91
+    {"bench_module_073", "status"}, // ID 92
+    {"bench_module_033", "on"}, // ID 93
+    {"bench_module_059", "get_value"}, // ID 94
+    {"bench_module_005", "get_value"}, // ID 95
+    {"bench_module_042", "status"}, // ID 96
+    {"bench_module_011", "set"}, // ID 97
+    {"bench_module_035", "off"}, // ID 98
+    {"bench_module_034", "set"}, // ID 99
+    {"bench_module_027", "get_value"}, // ID 100
+    {"bench_module_013", "get_value"}, // ID 101
+    {"bench_module_028", "status"}, // ID 102
+    {"bench_module_083", "set"}, // ID 103
+    {"bench_module_062", "set"}, // ID 104
+    {"bench_module_009", "off"}, // ID 105
+    {"bench_module_003", "on"}, // ID 106
+    {"bench_module_073", "on"}, // ID 107
+    {"bench_module_008", "status"}, // ID 108
+    {"bench_module_076", "status"}, // ID 109
+    {"bench_module_061", "off"}, // ID 110
+    {"bench_module_099", "status"}, // ID 111
+    {"bench_module_023", "on"}, // ID 112
+    {"bench_module_098", "get_value"}, // ID 113
+    {"bench_module_035", "status"}, // ID 114
+    {"bench_module_036", "on"}, // ID 115
+    {"bench_module_027", "on"}, // ID 116
+    {"bench_module_021", "on"}, // ID 117
+    {"bench_module_042", "set"}, // ID 118
+    {"bench_module_085", "set"}, // ID 119
+    {"bench_module_025", "set"}, // ID 120
+    {"bench_module_063", "get_value"}, // ID 121
+    {"bench_module_074", "off"}, // ID 122
+    {"bench_module_033", "set"}, // ID 123
+    {"bench_module_052", "on"}, // ID 124
+    {"bench_module_043", "status"}, // ID 125
+    {"bench_module_073", "get_value"}, // ID 126
+    {"bench_module_060", "status"}, // ID 127
+    {"bench_module_001", "get_value"}, // ID 128
+    {"bench_module_078", "status"}, // ID 129
+    {"bench_module_041", "on"}, // ID 130
+    {"bench_module_069", "get_value"}, // ID 131
+    {"bench_module_092", "get_value"}, // ID 132
+    {"bench_module_005", "set"}, // ID 133
+    {"bench_module_052", "set"}, // ID 134
+    {"bench_module_067", "set"}, // ID 135
+    {"bench_module_041", "off"}, // ID 136
+    {"bench_module_031", "off"}, // ID 137
+    {"bench_module_096", "on"}, // ID 138
+    {"bench_module_019", "set"}, // ID 139
+    {"bench_module_061", "on"}, // ID 140
+    {"bench_module_086", "on"}, // ID 141
+    {"bench_module_060", "on"}, // ID 142
+    {"bench_module_000", "status"}, // ID 143
+    {"bench_module_081", "off"}, // ID 144
+    {"bench_module_034", "status"}, // ID 145
+    {"bench_module_050", "get_value"}, // ID 146
+    {"bench_module_012", "status"}, // ID 147
+    {"bench_module_068", "get_value"}, // ID 148
+    {"bench_module_050", "on"}, // ID 149
+    {"bench_module_014", "status"}, // ID 150
+    {"bench_module_064", "set"}, // ID 151
+    {"bench_module_035", "set"}, // ID 152
+    {"bench_module_007", "status"}, // ID 153
+    {"bench_module_090", "on"}, // ID 154
+    {"bench_module_059", "status"}, // ID 155
+    {"bench_module_071", "off"}, // ID 156
+    {"bench_module_066", "on"}, // ID 157
+    {"bench_module_046", "set"}, // ID 158
+    {"bench_module_046", "on"}, // ID 159
+    {"bench_module_043", "get_value"}, // ID 160
+    {"bench_module_012", "on"}, // ID 161
+    {"bench_module_044", "on"}, // ID 162
+    {"bench_module_064", "off"}, // ID 163
+    {"bench_module_097", "set"}, // ID 164
+    {"bench_module_016", "status"}, // ID 165
+    {"bench_module_018", "on"}, // ID 166
+    {"bench_module_019", "get_value"}, // ID 167
+    {"bench_module_079", "set"}, // ID 168
+    {"bench_module_074", "status"}, // ID 169
+    {"bench_module_005", "off"}, // ID 170
+    {"bench_module_088", "get_value"}, // ID 171
+    {"bench_module_028", "get_value"}, // ID 172
+    {"bench_module_078", "off"}, // ID 173
+    {"bench_module_057", "status"}, // ID 174
+    {"bench_module_046", "off"}, // ID 175
+    {"bench_module_081", "on"}, // ID 176
+    {"bench_module_018", "status"}, // ID 177
+    {"bench_module_007", "get_value"}, // ID 178
+    {"bench_module_006", "get_value"}, // ID 179
+    {"bench_module_025", "on"}, // ID 180
+    {"bench_module_022", "get_value"}, // ID 181
+    {"bench_module_097", "off"}, // ID 182
+    {"bench_module_089", "on"}, // ID 183
+    {"bench_module_015", "set"}, // ID 184
+    {"bench_module_063", "on"}, // ID 185
+    {"bench_module_033", "status"}, // ID 186
+    {"bench_module_077", "set"}, // ID 187
+    {"bench_module_043", "off"}, // ID 188
+    {"bench_module_060", "set"}, // ID 189
+    {"bench_module_006", "set"}, // ID 190
+    {"bench_module_082", "get_value"}, // ID 191
+    {"bench_module_056", "on"}, // ID 192
+    {"bench_module_061", "get_value"}, // ID 193
+    {"bench_module_093", "off"}, // ID 194
+    {"bench_module_087", "get_value"}, // ID 195
+    {"bench_module_086", "get_value"}, // ID 196
+    {"bench_module_022", "set"}, // ID 197
+    {"bench_module_064", "status"}, // ID 198
+    {"bench_module_045", "on"}, // ID 199
+    {"bench_module_006", "on"}, // ID 200
+    {"bench_module_062", "on"}, // ID 201
+    {"bench_module_039", "status"}, // ID 202
+    {"bench_module_056", "set"}, // ID 203
+    {"bench_module_080", "status"}, // ID 204
+    {"bench_module_008", "set"}, // ID 205
+    {"bench_module_016", "off"}, // ID 206
+    {"bench_module_048", "get_value"}, // ID 207
+    {"bench_module_056", "status"}, // ID 208
+    {"bench_module_014", "get_value"}, // ID 209
+    {"bench_module_001", "set"}, // ID 210
+    {"bench_module_067", "get_value"}, // ID 211
+    {"bench_module_075", "set"}, // ID 212
+    {"bench_module_091", "status"}, // ID 213
+    {"bench_module_098", "off"}, // ID 214
+    {"bench_module_042", "off"}, // ID 215
+    {"bench_module_009", "status"}, // ID 216
+    {"bench_module_015", "off"}, // ID 217
+    {"bench_module_051", "get_value"}, // ID 218
+    {"bench_module_025", "get_value"}, // ID 219
+    {"bench_module_068", "off"}, // ID 220
+    {"bench_module_073", "set"}, // ID 221
+    {"bench_module_096", "status"}, // ID 222
+    {"bench_module_016", "get_value"}, // ID 223
+    {"bench_module_039", "on"}, // ID 224
+    {"bench_module_021", "set"}, // ID 225
+    {"bench_module_080", "get_value"}, // ID 226
+    {"bench_module_075", "on"}, // ID 227
+    {"bench_module_039", "off"}, // ID 228
+    {"bench_module_052", "get_value"}, // ID 229
+    {"bench_module_048", "on"}, // ID 230
+    {"bench_module_067", "on"}, // ID 231
+    {"bench_module_024", "off"}, // ID 232
+    {"bench_module_049", "get_value"}, // ID 233
+    {"bench_module_020", "on"}, // ID 234
+    {"bench_module_029", "off"}, // ID 235
+    {"bench_module_051", "on"}, // ID 236
+    {"bench_module_052", "off"}, // ID 237
+    {"bench_module_099", "get_value"}, // ID 238
+    {"bench_module_018", "get_value"}, // ID 239
+    {"bench_module_044", "get_value"}, // ID 240
+    {"bench_module_090", "set"}, // ID 241
+    {"bench_module_092", "on"}, // ID 242
+    {"bench_module_015", "on"}, // ID 243
+    {"bench_module_030", "status"}, // ID 244
+    {"bench_module_077", "on"}, // ID 245
+    {"bench_module_096", "off"}, // ID 246
+    {"bench_module_085", "get_value"}, // ID 247
+    {"bench_module_091", "set"}, // ID 248
+    {"bench_module_009", "get_value"}, // ID 249
+    {"bench_module_086", "set"}, // ID 250
+    {"bench_module_075", "status"}, // ID 251
+    {"bench_module_013", "off"}, // ID 252
+    {"bench_module_056", "off"}, // ID 253
+    {"bench_module_080", "on"}, // ID 254
+    {"bench_module_088", "off"}, // ID 255
+    {"bench_module_071", "set"}, // ID 256
+    {"bench_module_072", "on"}, // ID 257
+    {"bench_module_076", "set"}, // ID 258
+    {"bench_module_037", "on"}, // ID 259
+    {"bench_module_058", "on"}, // ID 260
+    {"bench_module_098", "set"}, // ID 261
+    {"bench_module_043", "on"}, // ID 262
+    {"bench_module_090", "status"}, // ID 263
+    {"bench_module_053", "set"}, // ID 264
+    {"bench_module_071", "status"}, // ID 265
+    {"bench_module_064", "on"}, // ID 266
+    {"bench_module_027", "status"}, // ID 267
+    {"bench_module_088", "status"}, // ID 268
+    {"bench_module_072", "get_value"}, // ID 269
+    {"bench_module_046", "get_value"}, // ID 270
+    {"bench_module_094", "set"}, // ID 271
+    {"bench_module_092", "status"}, // ID 272
+    {"bench_module_095", "off"}, // ID 273
+    {"bench_module_093", "get_value"}, // ID 274
+    {"bench_module_074", "set"}, // ID 275
+    {"bench_module_051", "set"}, // ID 276
+    {"bench_module_083", "get_value"}, // ID 277
+    {"bench_module_054", "status"}, // ID 278
+    {"bench_module_015", "status"}, // ID 279
+    {"bench_module_030", "get_value"}, // ID 280
+    {"bench_module_048", "set"}, // ID 281
+    {"bench_module_091", "off"}, // ID 282
+    {"bench_module_042", "on"}, // ID 283
+    {"bench_module_097", "status"}, // ID 284
+    {"bench_module_022", "off"}, // ID 285
+    {"bench_module_047", "off"}, // ID 286
+    {"bench_module_079", "status"}, // ID 287
+    {"bench_module_092", "off"}, // ID 288
+    {"bench_module_099", "on"}, // ID 289
+    {"bench_module_093", "on"}, // ID 290
+    {"bench_module_030", "off"}, // ID 291
+    {"bench_module_062", "status"}, // ID 292
+    {"bench_module_004", "get_value"}, // ID 293
+    {"bench_module_035", "get_value"}, // ID 294
+    {"bench_module_065", "get_value"}, // ID 295
+    {"bench_module_041", "get_value"}, // ID 296
+    {"bench_module_084", "get_value"}, // ID 297
+    {"bench_module_018", "set"}, // ID 298
+    {"bench_module_004", "on"}, // ID 299
+    {"bench_module_047", "on"}, // ID 300
+    {"bench_module_019", "status"}, // ID 301
+    {"bench_module_094", "on"}, // ID 302
+    {"bench_module_009", "set"}, // ID 303
+    {"bench_module_028", "on"}, // ID 304
+    {"bench_module_097", "get_value"}, // ID 305
+    {"bench_module_065", "status"}, // ID 306
+    {"bench_module_085", "status"}, // ID 307
+    {"bench_module_053", "off"}, // ID 308
+    {"bench_module_048", "off"}, // ID 309
+    {"bench_module_078", "set"}, // ID 310
+    {"bench_module_039", "set"}, // ID 311
+    {"bench_module_024", "get_value"}, // ID 312
+    {"bench_module_031", "on"}, // ID 313
+    {"bench_module_063", "off"}, // ID 314
+    {"bench_module_040", "status"}, // ID 315
+    {"bench_module_021", "get_value"}, // ID 316
+    {"bench_module_073", "off"}, // ID 317
+    {"bench_module_025", "status"}, // ID 318
+    {"bench_module_032", "off"}, // ID 319
+    {"bench_module_076", "get_value"}, // ID 320
+    {"bench_module_000", "get_value"}, // ID 321
+    {"bench_module_009", "on"}, // ID 322
+    {"bench_module_008", "get_value"}, // ID 323
+    {"bench_module_049", "set"}, // ID 324
+    {"bench_module_011", "on"}, // ID 325
+    {"bench_module_093", "set"}, // ID 326
+    {"bench_module_036", "status"}, // ID 327
+    {"bench_module_000", "on"}, // ID 328
+    {"bench_module_010", "set"}, // ID 329
+    {"bench_module_087", "set"}, // ID 330
+    {"bench_module_074", "on"}, // ID 331
+    {"bench_module_030", "on"}, // ID 332
+    {"bench_module_088", "set"}, // ID 333
+    {"bench_module_067", "off"}, // ID 334
+    {"bench_module_003", "get_value"}, // ID 335
+    {"bench_module_092", "set"}, // ID 336
+    {"bench_module_058", "status"}, // ID 337
+    {"bench_module_011", "off"}, // ID 338
+    {"bench_module_094", "off"}, // ID 339
+    {"bench_module_031", "status"}, // ID 340
+    {"bench_module_031", "set"}, // ID 341
+    {"bench_module_089", "set"}, // ID 342
+    {"bench_module_038", "set"}, // ID 343
+    {"bench_module_054", "get_value"}, // ID 344
+    {"bench_module_061", "set"}, // ID 345
+    {"bench_module_055", "off"}, // ID 346
+    {"bench_module_086", "off"}, // ID 347
+    {"bench_module_038", "off"}, // ID 348
+    {"bench_module_070", "off"}, // ID 349
+    {"bench_module_025", "off"}, // ID 350
+    {"bench_module_082", "off"}, // ID 351
+    {"bench_module_062", "off"}, // ID 352
+    {"bench_module_033", "get_value"}, // ID 353
+    {"bench_module_036", "off"}, // ID 354
+    {"bench_module_015", "get_value"}, // ID 355
+    {"bench_module_002", "on"}, // ID 356
+    {"bench_module_032", "set"}, // ID 357
+    {"bench_module_014", "set"}, // ID 358
+    {"bench_module_003", "set"}, // ID 359
+    {"bench_module_049", "on"}, // ID 360
+    {"bench_module_016", "set"}, // ID 361
+    {"bench_module_087", "on"}, // ID 362
+    {"bench_module_041", "set"}, // ID 363
+    {"bench_module_007", "off"}, // ID 364
+    {"bench_module_087", "status"}, // ID 365
+    {"bench_module_096", "get_value"}, // ID 366
+    {"bench_module_057", "off"}, // ID 367
+    {"bench_module_051", "off"}, // ID 368
+    {"bench_module_020", "set"}, // ID 369
+    {"bench_module_022", "status"}, // ID 370
+    {"bench_module_024", "set"}, // ID 371
+    {"bench_module_005", "status"}, // ID 372
+    {"bench_module_071", "get_value"}, // ID 373
+    {"bench_module_026", "status"}, // ID 374
+    {"bench_module_023", "set"}, // ID 375
+    {"bench_module_013", "set"}, // ID 376
+    {"bench_module_057", "get_value"}, // ID 377
+    {"bench_module_087", "off"}, // ID 378
+    {"bench_module_061", "status"}, // ID 379
+    {"bench_module_086", "status"}, // ID 380
+    {"bench_module_075", "off"}, // ID 381
+    {"bench_module_040", "on"}, // ID 382
+    {"bench_module_043", "set"}, // ID 383
+    {"bench_module_078", "on"}, // ID 384
+    {"bench_module_017", "on"}, // ID 385
+    {"bench_module_014", "on"}, // ID 386
+    {"bench_module_070", "set"}, // ID 387
+    {"bench_module_004", "status"}, // ID 388
+    {"bench_module_075", "get_value"}, // ID 389
+    {"bench_module_012", "off"}, // ID 390
+    {"bench_module_081", "status"}, // ID 391
+    {"bench_module_034", "get_value"}, // ID 392
+    {"bench_module_060", "get_value"}, // ID 393
+    {"bench_module_084", "set"}, // ID 394
+    {"bench_module_096", "set"}, // ID 395
+    {"bench_module_028", "set"}, // ID 396
+    {"bench_module_074", "get_value"}, // ID 397
+    {"bench_module_066", "set"}, // ID 398
+    {"bench_module_029", "on"}, // ID 399
+    {"bench_module_098", "status"}, // ID 400
+    {"bench_module_058", "get_value"}, // ID 401
+    {"bench_module_095", "get_value"}, // ID 402
+    {"bench_module_011", "status"}, // ID 403
+    {"bench_module_044", "off"}, // ID 404
+    {"bench_module_002", "off"}, // ID 405
+    {"bench_module_083", "on"}, // ID 406
+    {"bench_module_021", "status"}, // ID 407
+    {"bench_module_027", "set"}, // ID 408
+    {"bench_module_002", "get_value"}, // ID 409
+    {"bench_module_002", "status"}, // ID 410
+    {"bench_module_031", "get_value"}, // ID 411
+    {"bench_module_055", "get_value"}, // ID 412
+    {"bench_module_022", "on"}, // ID 413
+    {"bench_module_069", "set"}, // ID 414
+    {"bench_module_030", "set"}, // ID 415
+    {"bench_module_003", "status"}, // ID 416
+    {"bench_module_003", "off"}, // ID 417
+    {"bench_module_080", "off"}, // ID 418
+    {"bench_module_010", "off"}, // ID 419
+    {"bench_module_024", "status"}, // ID 420
+    {"bench_module_070", "on"}, // ID 421
+    {"bench_module_067", "status"}, // ID 422
+    {"bench_module_063", "set"}, // ID 423
+    {"bench_module_058", "off"}, // ID 424
+    {"bench_module_013", "on"}, // ID 425
+    {"bench_module_048", "status"}, // ID 426
+    {"bench_module_008", "off"}, // ID 427
+    {"bench_module_082", "on"}, // ID 428
+    {"bench_module_060", "off"}, // ID 429
+    {"bench_module_071", "on"}, // ID 430
+    {"bench_module_017", "off"}, // ID 431
+    {"bench_module_091", "get_value"}, // ID 432
+    {"bench_module_089", "off"}, // ID 433
+    {"bench_module_037", "set"}, // ID 434
+    {"bench_module_012", "set"}, // ID 435
+    {"bench_module_070", "get_value"}, // ID 436
+    {"bench_module_035", "on"}, // ID 437
+    {"bench_module_077", "status"}, // ID 438
+    {"bench_module_032", "get_value"}, // ID 439
+    {"bench_module_085", "on"}, // ID 440
+    {"bench_module_010", "get_value"}, // ID 441
+    {"bench_module_050", "off"}, // ID 442
+    {"bench_module_068", "status"}, // ID 443
+    {"bench_module_047", "get_value"}, // ID 444
+    {"bench_module_029", "status"}, // ID 445
+    {"bench_module_065", "set"}, // ID 446
+    {"bench_module_044", "set"}, // ID 447
+    {"bench_module_032", "status"}, // ID 448
+    {"bench_module_023", "off"}, // ID 449
+    {"bench_module_014", "off"}, // ID 450
+    {"bench_module_058", "set"}, // ID 451
+    {"bench_module_059", "set"}, // ID 452
+    {"bench_module_005", "on"}, // ID 453
+    {"bench_module_011", "get_value"}, // ID 454
+    {"bench_module_026", "set"}, // ID 455
+    {"bench_module_007", "set"}, // ID 456
+    {"bench_module_047", "status"}, // ID 457
+    {"bench_module_062", "get_value"}, // ID 458
+    {"bench_module_072", "off"}, // ID 459
+    {"bench_module_054", "off"}, // ID 460
+    {"bench_module_026", "get_value"}, // ID 461
+    {"bench_module_020", "off"}, // ID 462
+    {"bench_module_045", "get_value"}, // ID 463
+    {"bench_module_042", "get_value"}, // ID 464
+    {"bench_module_066", "off"}, // ID 465
+    {"bench_module_089", "get_value"}, // ID 466
+    {"bench_module_059", "off"}, // ID 467
+    {"bench_module_049", "off"}, // ID 468
+    {"bench_module_072", "status"}, // ID 469
+    {"bench_module_046", "status"}, // ID 470
+    {"bench_module_047", "set"}, // ID 471
+    {"bench_module_055", "status"}, // ID 472
+    {"bench_module_090", "get_value"}, // ID 473
+    {"bench_module_051", "status"}, // ID 474
+    {"bench_module_038", "on"}, // ID 475
+    {"bench_module_069", "status"}, // ID 476
+    {"bench_module_006", "status"}, // ID 477
+    {"bench_module_055", "on"}, // ID 478
+    {"bench_module_084", "off"}, // ID 479
+    {"bench_module_078", "get_value"}, // ID 480
+    {"bench_module_013", "status"}, // ID 481
+    {"bench_module_040", "set"}, // ID 482
+    {"bench_module_054", "on"}, // ID 483
+    {"bench_module_032", "on"}, // ID 484
+    {"bench_module_081", "set"}, // ID 485
+    {"bench_module_010", "on"}, // ID 486
+    {"bench_module_040", "off"}, // ID 487
+    {"bench_module_052", "status"}, // ID 488
+    {"bench_module_080", "set"}, // ID 489
+    {"bench_module_037", "get_value"}, // ID 490
+    {"bench_module_076", "off"}, // ID 491
+    {"bench_module_065", "off"}, // ID 492
+    {"bench_module_004", "off"}, // ID 493
+    {"bench_module_098", "on"}, // ID 494
+    {"bench_module_020", "get_value"}, // ID 495
+    {"bench_module_069", "on"}, // ID 496
+    {"bench_module_019", "on"}, // ID 497
+    {"bench_module_083", "status"}, // ID 498
+    {"bench_module_056", "get_value"}, // ID 499
+};
+static const uint16_t nextinoCommandDisplacements[] = {
+    119, 18, 2, 4, 67, 265, 14, 1, 6, 243, 7, 11, 30, 1, 1, 1,
+    116, 20, 4, 2, 12, 1, 6, 4, 27, 12, 16, 6, 309, 3, 8, 47,
+    258, 1, 70, 1, 15, 41, 1, 74, 14, 1, 10, 24, 7, 127, 3, 1,
+    71, 18, 16, 7, 80, 28, 8, 82, 20, 79, 65, 147, 293, 19, 21, 13,
+    7, 303, 213, 1, 1, 512, 5, 30, 51, 1, 54, 10, 1, 1, 11, 50,
+    2, 463, 46, 19, 63, 37, 191, 243, 7, 23, 1590, 152, 1, 5, 58, 198,
+    167, 1688, 371, 4, 28, 347, 163, 750, 225, 106, 11, 2, 10, 134, 6, 63,
+    1, 4, 1207, 376, 8, 1260, 9, 129, 11, 8, 320, 4, 35,
+};
+static const CommandTable nextinoCommandTable = {nextinoCommandEntries, nextinoCommandDisplacements, 500, 125};
+
@@ -0,0 +1,167 @@
+/**
+ * @file        test_bench_command_table.cpp
+ * @title       CommandRouter Benchmark: Registry Map vs. Generated Table
+ * @description Registers 500 commands (100 instances of 5) into the registry
+ *              map, then again into a build-time perfect-hash table (the
+ *              fixture in `generated_commands.h`), and compares the time and
+ *              heap each registration takes and the commands per second of
+ *              executing all 500 in turn.
+ *              Intended for the host build: `pio test -e native -f test_bench_command_table`.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-05
+ * @version     0.1.0
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+#include "core/Platform.h"
+#include "core/CommandRouter.h"
+#include "generated_commands.h"
+
+static size_t g_allocations = 0;
+static size_t g_allocatedBytes = 0;
+
+void* operator new(size_t size) {
+    g_allocations++;
+    g_allocatedBytes += size;
+    void* block = malloc(size ? size : 1);
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void operator delete(void* block) noexcept {
+    free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    free(block);
+}
+
+namespace {
+
+const int INSTANCES = 100;
+const char* const COMMAND_NAMES[] = {"on", "off", "set", "get_value", "status"};
+const int ROUNDS = 400;
+
+uint32_t g_calls = 0;
+
+CommandStatus handler(const CommandArgs&, CommandOutput& out) {
+    g_calls++;
+    out.print("OK");
+    return CommandStatus::Ok;
+}
+
+struct Registration {
+    double microseconds;
+    size_t allocations;
+    size_t bytes;
+};
+
+Registration registerAll() {
+    CommandRouter& router = CommandRouter::getInstance();
+    size_t allocations = g_allocations;
+    size_t bytes = g_allocatedBytes;
+    auto start = std::chrono::steady_clock::now();
+    char name[24];
+    for (int i = 0; i < INSTANCES; ++i) {
+        snprintf(name, sizeof(name), "bench_module_%03d", i);
+        for (const char* command : COMMAND_NAMES) {
+            router.registerCommand(name, command, handler);
+        }
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    return {us, g_allocations - allocations, g_allocatedBytes - bytes};
+}
+
+double executeAll(const std::vector<std::string>& lines) {
+    CommandRouter& router = CommandRouter::getInstance();
+    char buffer[16];
+    CommandOutput output(buffer, sizeof(buffer));
+    double best = 0;
+    // The best of a few runs, so one noisy run cannot decide the comparison.
+    for (int run = 0; run < 3; ++run) {
+        g_calls = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < ROUNDS; ++round) {
+            for (const std::string& line : lines) {
+                output.clear();
+                router.execute(std::string_view(line), output);
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        TEST_ASSERT_EQUAL(ROUNDS * lines.size(), g_calls);
+        best = std::max(best, ROUNDS * lines.size() / seconds);
+    }
+    return best;
+}
+
+} // namespace
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_bench_registry_map_vs_generated_table() {
+    TEST_ASSERT_EQUAL(INSTANCES * 5, nextinoCommandTable.size);
+    std::vector<std::string> lines;
+    char line[40];
+    for (int i = 0; i < INSTANCES; ++i) {
+        for (const char* command : COMMAND_NAMES) {
+            snprintf(line, sizeof(line), "bench_module_%03d %s", i, command);
+            lines.push_back(line);
+        }
+    }
+
+    // Without a table, every command is a map node with two key strings.
+    Registration mapRegistration = registerAll();
+    double mapRate = executeAll(lines);
+
+    // With the table, the same registrations fill its slots and lookups hash instead.
+    size_t bytes = g_allocatedBytes;
+    TEST_ASSERT_TRUE(CommandRouter::getInstance().useCommandTable(nextinoCommandTable));
+    size_t slotBytes = g_allocatedBytes - bytes;
+    Registration tableRegistration = registerAll();
+    double tableRate = executeAll(lines);
+
+    printf("\n%d commands, executed %d times each in turn\n", INSTANCES * 5, ROUNDS);
+    printf("%-34s %16s %14s %14s %14s\n", "lookup", "register (us)", "allocations", "heap bytes", "commands/s");
+    printf("%-34s %16.0f %14u %14u %14.0f\n", "registry map (std::map, strings)", mapRegistration.microseconds,
+           (unsigned)mapRegistration.allocations, (unsigned)mapRegistration.bytes, mapRate);
+    printf("%-34s %16.0f %14u %14u %14.0f\n", "generated perfect-hash table", tableRegistration.microseconds,
+           (unsigned)(tableRegistration.allocations + 1), (unsigned)(tableRegistration.bytes + slotBytes), tableRate);
+    printf("Table in flash: %u bytes of entries and displacements, plus the name strings\n",
+           (unsigned)(sizeof(nextinoCommandEntries) + sizeof(nextinoCommandDisplacements)));
+
+    TEST_ASSERT_TRUE(tableRegistration.bytes + slotBytes < mapRegistration.bytes);
+    TEST_ASSERT_TRUE(tableRate > mapRate);
+}
+
+void runAllTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_registry_map_vs_generated_table);
+}
+
+#if defined(ARDUINO)
+void setup() {
+    delay(2000);
+    runAllTests();
+}
+
+void loop() {
+    UNITY_END();
+}
+#else
+int main() {
+    runAllTests();
+    return UNITY_END();
+}
+#endif
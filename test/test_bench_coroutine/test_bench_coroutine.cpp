@@ -0,0 +1,208 @@
+/**
+ * @file        test_bench_coroutine.cpp
+ * @title       Coroutine Benchmark: Coroutines vs. std::function State Machines
+ * @description Compares the cost of a coroutine context switch (suspend plus
+ *              resume) against calling an equivalent `std::function` state
+ *              machine, both raw and when driven by the Scheduler, and reports
+ *              the memory each approach needs per task.
+ *              Intended for the host build: `pio test -e native -f test_bench_coroutine`.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-08-31
+ * @version     0.1.0
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include <functional>
+#include <vector>
+#include "core/Platform.h"
+#include "core/Coroutine.h"
+#include "core/Scheduler.h"
+
+#if NEXTINO_HAS_COROUTINES
+
+namespace {
+
+const int TASK_COUNT = 16; // NEXTINO_COROUTINE_MAX_TASKS by default
+const int RAW_SWITCHES = 2000000;
+const unsigned long DRIVEN_MS = 20000;
+volatile uint32_t g_pinWrites = 0;
+
+double nsSince(std::chrono::steady_clock::time_point start) {
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// --- Raw switch: a coroutine that parks its handle, resumed in a tight loop ---
+
+std::coroutine_handle<> g_parked;
+
+struct Park {
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) noexcept { g_parked = handle; }
+    void await_resume() const noexcept {}
+};
+
+NextinoTask blinkRaw(int pin) {
+    bool on = false;
+    while (true) {
+        on = !on;
+        g_pinWrites = g_pinWrites + pin + on;
+        co_await Park();
+    }
+}
+
+// --- The same blink logic as a hand-written state machine ---
+
+struct BlinkStateMachine {
+    int pin;
+    bool on;
+    void step() {
+        on = !on;
+        g_pinWrites = g_pinWrites + pin + on;
+    }
+};
+
+// --- Scheduler driven: blink every 1 ms on a simulated clock ---
+
+unsigned long g_simulatedMs = 0;
+bool g_stopScheduled = false;
+
+uint64_t simulatedClock() {
+    return (uint64_t)g_simulatedMs * 1000ULL;
+}
+
+NextinoTask blinkScheduled(int pin) {
+    bool on = false;
+    while (!g_stopScheduled) {
+        on = !on;
+        g_pinWrites = g_pinWrites + pin + on;
+        co_await nextino::sleep(1);
+    }
+}
+
+double runSimulatedNsPerStep() {
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < DRIVEN_MS; ++i) {
+        g_simulatedMs++;
+        Scheduler::getInstance().loop();
+    }
+    return nsSince(start) / ((double)DRIVEN_MS * TASK_COUNT);
+}
+
+} // namespace
+
+void setUp(void) {}
+
+void tearDown(void) {
+    Scheduler::getInstance().setTimeSource(nullptr);
+}
+
+void test_bench_raw_context_switch() {
+    blinkRaw(13);
+    std::coroutine_handle<> handle = g_parked;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < RAW_SWITCHES; ++i) {
+        handle.resume();
+    }
+    double coroutineNs = nsSince(start) / RAW_SWITCHES;
+
+    BlinkStateMachine machine = {13, false};
+    std::function<void()> step = [&machine]() { machine.step(); };
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < RAW_SWITCHES; ++i) {
+        step();
+    }
+    double functionNs = nsSince(start) / RAW_SWITCHES;
+
+    printf("\n%-34s %12s\n", "raw switch", "ns/step");
+    printf("%-34s %12.2f\n", "coroutine resume + suspend", coroutineNs);
+    printf("%-34s %12.2f\n", "std::function state machine", functionNs);
+
+    // The parked coroutine never finishes; destroying it returns its frame.
+    handle.destroy();
+    TEST_ASSERT_TRUE(g_pinWrites > 0);
+}
+
+void test_bench_scheduler_driven_tasks() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    scheduler.setTimeSource(simulatedClock);
+    size_t framesBefore = CoroutinePool::getInstance().getStats().activeFrames;
+
+    // Coroutines: every step is a sleep(1), i.e. a one-shot Scheduler task.
+    for (int i = 0; i < TASK_COUNT; ++i) {
+        TEST_ASSERT_TRUE(blinkScheduled(i).isValid());
+    }
+    double coroutineNs = runSimulatedNsPerStep();
+    CoroutineStats stats = CoroutinePool::getInstance().getStats();
+    TEST_ASSERT_EQUAL(framesBefore + TASK_COUNT, stats.activeFrames);
+
+    // Let every coroutine leave its loop and give its frame back.
+    g_stopScheduled = true;
+    g_simulatedMs++;
+    scheduler.loop();
+    TEST_ASSERT_EQUAL(framesBefore, CoroutinePool::getInstance().getStats().activeFrames);
+    TEST_ASSERT_EQUAL(0, scheduler.getTaskCount());
+
+    // State machines: one recurring task each, stepping a std::function.
+    static BlinkStateMachine machines[TASK_COUNT];
+    static std::function<void()> steps[TASK_COUNT];
+    std::vector<Scheduler::TaskHandle> handles;
+    for (int i = 0; i < TASK_COUNT; ++i) {
+        machines[i] = {i, false};
+        BlinkStateMachine* machine = &machines[i];
+        steps[i] = [machine]() { machine->step(); };
+        std::function<void()>* step = &steps[i];
+        handles.push_back(scheduler.scheduleRecurring(1, [step]() { (*step)(); }));
+    }
+    double machineNs = runSimulatedNsPerStep();
+    for (auto handle : handles) {
+        scheduler.cancel(handle);
+    }
+
+    printf("\n%-34s %12s %16s\n", "scheduler driven (1 ms blink)", "ns/step", "bytes/task");
+    printf("%-34s %12.2f %16u\n", "coroutine + sleep(1)", coroutineNs, (unsigned)stats.largestFrame);
+    printf("%-34s %12.2f %16u\n", "recurring std::function machine", machineNs,
+           (unsigned)(sizeof(std::function<void()>) + sizeof(BlinkStateMachine)));
+    printf("(plus one Scheduler slot per task in both cases; coroutine frames come from a %u x %u byte pool)\n",
+           (unsigned)stats.capacity, (unsigned)stats.frameSize);
+}
+
+#else
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_bench_coroutines_unavailable() {
+    TEST_IGNORE_MESSAGE("Coroutines need a C++20 compiler (-std=gnu++20).");
+}
+
+#endif
+
+void runAllTests() {
+    UNITY_BEGIN();
+#if NEXTINO_HAS_COROUTINES
+    RUN_TEST(test_bench_raw_context_switch);
+    RUN_TEST(test_bench_scheduler_driven_tasks);
+#else
+    RUN_TEST(test_bench_coroutines_unavailable);
+#endif
+}
+
+#if defined(ARDUINO)
+void setup() {
+    delay(2000);
+    runAllTests();
+}
+
+void loop() {
+    UNITY_END();
+}
+#else
+int main() {
+    runAllTests();
+    return UNITY_END();
+}
+#endif
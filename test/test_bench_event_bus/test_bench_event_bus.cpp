@@ -0,0 +1,298 @@
+/**
+ * @file        test_bench_event_bus.cpp
+ * @title       EventBus Benchmark: Hashed IDs vs. String Map
+ * @description Measures posts per second through the EventBus with 32 events
+ *              registered, posting by compile-time EventId and by string name,
+ *              against a copy of the original `std::map<std::string, ...>`
+ *              implementation, the sustained throughput of queued dispatch, and
+ *              topic-filter matching through the trie against a linear scan.
+ *              Intended for the host build: `pio test -e native -f test_bench_event_bus`.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-02
+ * @version     0.1.0
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include "core/Platform.h"
+#include "core/EventBus.h"
+#include "core/Logger.h"
+
+namespace {
+
+/**
+ * @brief A copy of the original EventBus, used as the baseline.
+ * @details Every post builds a std::string and does two map lookups.
+ */
+class StringMapEventBus {
+public:
+    void on(const std::string& eventName, std::function<void(void*)> callback) {
+        _listeners[eventName].push_back(callback);
+    }
+
+    void post(const std::string& eventName, void* payload = nullptr) {
+        NEXTINO_CORE_LOG(LogLevel::Debug, "EventBus", "Posting event '%s'.", eventName.c_str());
+        if (_listeners.find(eventName) != _listeners.end()) {
+            for (auto const& callback : _listeners[eventName]) {
+                callback(payload);
+            }
+        }
+    }
+
+private:
+    std::map<std::string, std::vector<std::function<void(void*)>>> _listeners;
+};
+
+/**
+ * @brief MQTT topic matching by scanning every filter, used as the trie baseline.
+ */
+bool filterMatches(const char* filter, const char* topic) {
+    while (true) {
+        if (filter[0] == '#' && filter[1] == '\0') {
+            return true;
+        }
+        if (filter[0] == '+' && (filter[1] == '/' || filter[1] == '\0')) {
+            filter++;
+            while (*topic && *topic != '/') {
+                topic++;
+            }
+        } else {
+            while (*filter && *filter != '/' && *filter == *topic) {
+                filter++;
+                topic++;
+            }
+            if ((*filter && *filter != '/') || (*topic && *topic != '/')) {
+                return false;
+            }
+        }
+        if (*filter == '\0' || *topic == '\0') {
+            // `a/#` also matches `a`.
+            return *filter == *topic || (filter[0] == '/' && filter[1] == '#' && filter[2] == '\0');
+        }
+        filter++;
+        topic++;
+    }
+}
+
+const int EVENT_COUNT = 32;
+const int POSTS = 2000000;
+volatile uint32_t g_received = 0;
+
+double postsPerSecond(std::chrono::steady_clock::time_point start) {
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return POSTS / seconds;
+}
+
+} // namespace
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_bench_posts_per_second() {
+    StringMapEventBus baseline;
+    EventBus& bus = EventBus::getInstance();
+    char name[40];
+    for (int i = 0; i < EVENT_COUNT; ++i) {
+        snprintf(name, sizeof(name), "bench_sensor_reading_%02d", i);
+        baseline.on(name, [](void*) { g_received = g_received + 1; });
+        bus.on(name, [](void*) { g_received = g_received + 1; });
+    }
+
+    // The hot event sits in the middle of the map, as a typical event would.
+    constexpr EventId HOT("bench_sensor_reading_16");
+    const char* hotName = "bench_sensor_reading_16";
+
+    g_received = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < POSTS; ++i) {
+        baseline.post(hotName);
+    }
+    double baselineRate = postsPerSecond(start);
+    TEST_ASSERT_EQUAL(POSTS, g_received);
+
+    g_received = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < POSTS; ++i) {
+        bus.post(hotName);
+    }
+    double nameRate = postsPerSecond(start);
+    TEST_ASSERT_EQUAL(POSTS, g_received);
+
+    g_received = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < POSTS; ++i) {
+        bus.post(HOT);
+    }
+    double idRate = postsPerSecond(start);
+    TEST_ASSERT_EQUAL(POSTS, g_received);
+
+    printf("\n%d events registered, 1 listener each, %d posts\n", EVENT_COUNT, POSTS);
+    printf("%-36s %14s %10s\n", "post path", "posts/s", "speedup");
+    printf("%-36s %14.0f %9.2fx\n", "std::map<std::string> (original)", baselineRate, 1.0);
+    printf("%-36s %14.0f %9.2fx\n", "flat table, name hashed at runtime", nameRate, nameRate / baselineRate);
+    printf("%-36s %14.0f %9.2fx\n", "flat table, constexpr EventId", idRate, idRate / baselineRate);
+
+    TEST_ASSERT_TRUE(idRate > baselineRate);
+}
+
+void test_bench_queued_throughput() {
+    EventBus& bus = EventBus::getInstance();
+    constexpr EventId SAMPLE("bench_queued_sample");
+    bus.on(SAMPLE, [](void* payload) { g_received = g_received + *static_cast<uint32_t*>(payload); });
+    bus.setQueueFullPolicy(QueueFullPolicy::DropOldest);
+
+    printf("\nQueued dispatch: 4-byte payload, drained %u per loop pass, %d events per row\n",
+           (unsigned)NEXTINO_EVENTBUS_BATCH_SIZE, POSTS);
+    printf("%-28s %14s %10s %12s %12s\n", "producer burst per pass", "events/s", "dropped", "avg lat us", "p99 lat us");
+
+    // Synchronous delivery of the same event, for reference.
+    uint32_t one = 1;
+    g_received = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < POSTS; ++i) {
+        bus.post(SAMPLE, &one);
+    }
+    printf("%-28s %14.0f %10s %12s %12s\n", "synchronous post()", postsPerSecond(start), "-", "-", "-");
+
+    // Sustained: the producer never outpaces the consumer. Overload: it posts
+    // twice as many events per pass as are drained, so the queue stays full.
+    const unsigned bursts[] = {1, 4, NEXTINO_EVENTBUS_BATCH_SIZE, 2 * NEXTINO_EVENTBUS_BATCH_SIZE};
+    for (unsigned burst : bursts) {
+        bus.resetQueueStats();
+        g_received = 0;
+        start = std::chrono::steady_clock::now();
+        for (int posted = 0; posted < POSTS;) {
+            for (unsigned b = 0; b < burst; ++b, ++posted) {
+                bus.postAsync(SAMPLE, &one, sizeof(one));
+            }
+            bus.dispatchQueued();
+        }
+        while (bus.dispatchQueued() > 0) {
+        }
+        double rate = postsPerSecond(start);
+        EventQueueStats stats = bus.getQueueStats();
+
+        char label[40];
+        snprintf(label, sizeof(label), "%u%s", burst, burst > NEXTINO_EVENTBUS_BATCH_SIZE ? " (overload)" : "");
+        printf("%-28s %14.0f %10u %12u %12u\n", label, rate, (unsigned)stats.dropped, (unsigned)stats.latency.avg,
+               (unsigned)stats.latency.p99);
+
+        TEST_ASSERT_EQUAL(POSTS, stats.posted);
+        TEST_ASSERT_EQUAL(stats.posted, stats.dispatched + stats.dropped);
+        TEST_ASSERT_EQUAL(stats.dispatched, g_received);
+        if (burst <= NEXTINO_EVENTBUS_BATCH_SIZE) {
+            TEST_ASSERT_EQUAL(0, stats.dropped);
+        }
+    }
+}
+
+void test_bench_topic_matching() {
+    const int ROOMS = 128, SENSORS = 8, METRICS = 8;
+    const int TOPICS = ROOMS * SENSORS * METRICS;
+    const uint32_t MATCHES_PER_TOPIC = 6; // One filter of each shape below
+    EventBus& bus = EventBus::getInstance();
+
+    std::vector<std::string> topics;
+    std::vector<std::string> filters;
+    char name[48];
+    for (int r = 0; r < ROOMS; ++r) {
+        for (int s = 0; s < SENSORS; ++s) {
+            for (int m = 0; m < METRICS; ++m) {
+                snprintf(name, sizeof(name), "bench/room%d/sensor%d/metric%d", r, s, m);
+                topics.push_back(name);
+            }
+            snprintf(name, sizeof(name), "bench/room%d/sensor%d/#", r, s);
+            filters.push_back(name);
+            snprintf(name, sizeof(name), "bench/room%d/sensor%d/+", r, s);
+            filters.push_back(name);
+        }
+        for (int m = 0; m < METRICS; ++m) {
+            snprintf(name, sizeof(name), "bench/room%d/+/metric%d", r, m);
+            filters.push_back(name);
+        }
+        snprintf(name, sizeof(name), "bench/room%d/#", r);
+        filters.push_back(name);
+    }
+    for (int s = 0; s < SENSORS; ++s) {
+        for (int m = 0; m < METRICS; ++m) {
+            snprintf(name, sizeof(name), "bench/+/sensor%d/metric%d", s, m);
+            filters.push_back(name);
+        }
+    }
+    for (int m = 0; m < METRICS; ++m) {
+        snprintf(name, sizeof(name), "bench/+/+/metric%d", m);
+        filters.push_back(name);
+    }
+
+    std::vector<EventBus::Subscription> subscriptions;
+    for (const std::string& filter : filters) {
+        subscriptions.push_back(bus.on(filter, [](void*) { g_received = g_received + 1; }));
+        TEST_ASSERT_TRUE(subscriptions.back() != 0);
+    }
+
+    // Baseline: every post tests every filter.
+    std::vector<std::function<void(void*)>> callbacks(filters.size(), [](void*) { g_received = g_received + 1; });
+    g_received = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string& topic : topics) {
+        for (size_t f = 0; f < filters.size(); ++f) {
+            if (filterMatches(filters[f].c_str(), topic.c_str())) {
+                callbacks[f](nullptr);
+            }
+        }
+    }
+    double scanSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    TEST_ASSERT_EQUAL(MATCHES_PER_TOPIC * TOPICS, g_received);
+
+    const int ROUNDS = 50;
+    g_received = 0;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        for (const std::string& topic : topics) {
+            bus.post(topic.c_str());
+        }
+    }
+    double trieSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / ROUNDS;
+    TEST_ASSERT_EQUAL(MATCHES_PER_TOPIC * TOPICS * ROUNDS, g_received);
+
+    printf("\nTopic filters: %d topics, %d wildcard subscriptions, %u matches per post\n", TOPICS, (int)filters.size(),
+           (unsigned)MATCHES_PER_TOPIC);
+    printf("%-36s %14s %10s\n", "matching", "posts/s", "speedup");
+    printf("%-36s %14.0f %9.2fx\n", "linear scan of every filter", TOPICS / scanSeconds, 1.0);
+    printf("%-36s %14.0f %9.2fx\n", "topic trie", TOPICS / trieSeconds, scanSeconds / trieSeconds);
+
+    for (EventBus::Subscription subscription : subscriptions) {
+        TEST_ASSERT_TRUE(bus.off(subscription));
+    }
+    TEST_ASSERT_TRUE(trieSeconds < scanSeconds);
+}
+
+void runAllTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_posts_per_second);
+    RUN_TEST(test_bench_queued_throughput);
+    RUN_TEST(test_bench_topic_matching);
+}
+
+#if defined(ARDUINO)
+void setup() {
+    delay(2000);
+    runAllTests();
+}
+
+void loop() {
+    UNITY_END();
+}
+#else
+int main() {
+    runAllTests();
+    return UNITY_END();
+}
+#endif
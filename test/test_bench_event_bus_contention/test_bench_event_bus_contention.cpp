@@ -0,0 +1,199 @@
+/**
+ * @file        test_bench_event_bus_contention.cpp
+ * @title       EventBus Benchmark: Posting From Several Threads
+ * @description Measures postAsync() from 1 to 8 producer threads while the main
+ *              thread dispatches, in multi-producer mode (lock-free inbox,
+ *              listeners on the owner thread) against the same single-task bus
+ *              guarded by one mutex, as the Logger is. Reports the throughput
+ *              of delivered events and the time producers spend per post.
+ *              Intended for the host build: `pio test -e native -f test_bench_event_bus_contention`.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-04
+ * @version     0.1.0
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "core/Platform.h"
+#include "core/EventBus.h"
+#include "core/TimingStats.h"
+
+namespace {
+
+const uint32_t POSTS_PER_PRODUCER = 100000;
+const unsigned MAX_PRODUCERS = 8;
+constexpr EventId SAMPLE("bench_contention_sample");
+
+uint64_t g_checksum = 0;
+uint32_t g_delivered = 0;
+
+struct Sample {
+    uint32_t producer;
+    uint32_t value;
+};
+
+uint32_t nsBetween(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+// --- Baseline: the single-task bus behind one mutex ---
+
+std::mutex g_busMutex;
+
+bool postLocked(const Sample& sample) {
+    std::lock_guard<std::mutex> lock(g_busMutex);
+    return EventBus::getInstance().postAsync(SAMPLE, &sample, sizeof(sample));
+}
+
+size_t dispatchLocked() {
+    // Listeners run under the lock too: they may not overlap a post.
+    std::lock_guard<std::mutex> lock(g_busMutex);
+    return EventBus::getInstance().dispatchQueued(NEXTINO_EVENTBUS_QUEUE_SIZE);
+}
+
+bool postLockFree(const Sample& sample) {
+    return EventBus::getInstance().postAsync(SAMPLE, &sample, sizeof(sample));
+}
+
+size_t dispatchLockFree() {
+    return EventBus::getInstance().dispatchQueued(NEXTINO_EVENTBUS_QUEUE_SIZE);
+}
+
+struct Result {
+    TimingSummary latency;
+    double eventsPerSecond;
+    uint32_t retries;
+};
+
+// Runs `producers` threads that each post POSTS_PER_PRODUCER samples, timing
+// every accepted post, while this thread dispatches until all have arrived.
+// Full-queue retries are counted, not timed.
+Result measure(unsigned producers, bool (*post)(const Sample&), size_t (*dispatch)()) {
+    std::vector<TimingHistogram> histograms(producers);
+    std::vector<uint32_t> retryCounts(producers, 0);
+    std::vector<std::thread> threads;
+    g_delivered = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            for (uint32_t i = 0; i < POSTS_PER_PRODUCER; ++i) {
+                Sample sample = {p, i};
+                while (true) {
+                    auto before = std::chrono::steady_clock::now();
+                    bool accepted = post(sample);
+                    auto after = std::chrono::steady_clock::now();
+                    if (accepted) {
+                        histograms[p].record(nsBetween(before, after));
+                        break;
+                    }
+                    retryCounts[p]++;
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    const uint32_t total = producers * POSTS_PER_PRODUCER;
+    while (g_delivered < total) {
+        if (dispatch() == 0) {
+            std::this_thread::yield();
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Merge: count-weighted average, overall min/max, worst per-producer p99.
+    Result result;
+    result.latency = {0, UINT32_MAX, 0, 0, 0};
+    result.retries = 0;
+    uint64_t weighted = 0;
+    for (unsigned p = 0; p < producers; ++p) {
+        TimingSummary s = histograms[p].summary();
+        result.latency.count += s.count;
+        result.latency.min = s.min < result.latency.min ? s.min : result.latency.min;
+        result.latency.max = s.max > result.latency.max ? s.max : result.latency.max;
+        result.latency.p99 = s.p99 > result.latency.p99 ? s.p99 : result.latency.p99;
+        weighted += (uint64_t)s.avg * s.count;
+        result.retries += retryCounts[p];
+    }
+    result.latency.avg = result.latency.count ? (uint32_t)(weighted / result.latency.count) : 0;
+    result.eventsPerSecond = total / std::chrono::duration<double>(end - start).count();
+    return result;
+}
+
+void printRow(const char* name, unsigned producers, const Result& r) {
+    printf("%-20s %9u %12.0f %9u %9u %11u %9u\n", name, producers, r.eventsPerSecond, r.latency.avg, r.latency.p99,
+           r.latency.max, r.retries);
+}
+
+} // namespace
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_bench_multi_producer_contention() {
+    EventBus& bus = EventBus::getInstance();
+    bus.setQueueFullPolicy(QueueFullPolicy::DropNewest); // Producers retry instead of losing samples
+    EventBus::Subscription subscription = bus.on(SAMPLE, [](void* payload) {
+        g_checksum += static_cast<Sample*>(payload)->value;
+        g_delivered++;
+    });
+
+    printf("\n%u posts per producer, %u hardware thread(s), post time in ns (includes ~20-40 ns of clock reads)\n",
+           (unsigned)POSTS_PER_PRODUCER, std::thread::hardware_concurrency());
+    printf("%-20s %9s %12s %9s %9s %11s %9s\n", "bus", "producers", "events/s", "avg", "p99", "max", "retries");
+
+    for (unsigned producers = 1; producers <= MAX_PRODUCERS; producers *= 2) {
+        bus.setMultiProducer(false);
+        bus.resetQueueStats();
+        Result locked = measure(producers, postLocked, dispatchLocked);
+        printRow("mutex + EventBus", producers, locked);
+        TEST_ASSERT_EQUAL(producers * POSTS_PER_PRODUCER, locked.latency.count);
+
+        bus.setMultiProducer(true);
+        bus.resetQueueStats();
+        Result lockFree = measure(producers, postLockFree, dispatchLockFree);
+        printRow("multi-producer inbox", producers, lockFree);
+        TEST_ASSERT_EQUAL(producers * POSTS_PER_PRODUCER, lockFree.latency.count);
+
+        EventQueueStats stats = bus.getQueueStats();
+        TEST_ASSERT_EQUAL(producers * POSTS_PER_PRODUCER, stats.forwarded);
+        TEST_ASSERT_EQUAL(stats.forwarded, stats.dispatched);
+        TEST_ASSERT_EQUAL(lockFree.retries, stats.dropped);
+    }
+
+    bus.setMultiProducer(false);
+    bus.off(subscription);
+    bus.setQueueFullPolicy(QueueFullPolicy::DropOldest);
+}
+
+void runAllTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_multi_producer_contention);
+}
+
+#if defined(ARDUINO)
+void setup() {
+    delay(2000);
+    runAllTests();
+}
+
+void loop() {
+    UNITY_END();
+}
+#else
+int main() {
+    runAllTests();
+    return UNITY_END();
+}
+#endif
@@ -0,0 +1,113 @@
+/**
+ * @file        test_bench_executor.cpp
+ * @title       Executor Benchmark: Throughput Scaling
+ * @description Runs a fixed batch of CPU-heavy jobs on the main thread and on
+ *              1 to N Executor workers, and reports jobs per second and the
+ *              speedup over the single-threaded baseline.
+ *              Intended for the host build: `pio test -e native -f test_bench_executor`.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-08-30
+ * @version     0.1.0
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "core/Platform.h"
+#include "core/Executor.h"
+
+namespace {
+
+const int JOB_COUNT = 2000;
+const int JOB_ITERATIONS = 20000;
+std::atomic<uint32_t> g_checksum(0);
+
+// About 50-100 us of integer work on a desktop core; no memory traffic.
+void cpuHeavyJob() {
+    uint32_t x = 2463534242u;
+    for (int i = 0; i < JOB_ITERATIONS; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+    }
+    g_checksum.fetch_add(x & 1, std::memory_order_relaxed);
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+void setUp(void) {}
+
+void tearDown(void) {
+    Executor::getInstance().stop();
+}
+
+void test_bench_throughput_scaling() {
+    Executor& executor = Executor::getInstance();
+    unsigned cores = std::thread::hardware_concurrency();
+    uint8_t maxWorkers = (uint8_t)(cores > 1 ? (cores < NEXTINO_EXECUTOR_MAX_WORKERS ? cores : NEXTINO_EXECUTOR_MAX_WORKERS) : 2);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < JOB_COUNT; ++i) {
+        cpuHeavyJob();
+    }
+    double baselineSeconds = secondsSince(start);
+
+    printf("\n%d jobs, %u hardware thread(s)\n", JOB_COUNT, cores);
+    printf("%-12s %14s %10s %10s\n", "workers", "jobs/s", "speedup", "stolen");
+    printf("%-12s %14.0f %9.2fx %10s\n", "main loop", JOB_COUNT / baselineSeconds, 1.0, "-");
+
+    for (uint8_t workers = 1; workers <= maxWorkers; workers *= 2) {
+        TEST_ASSERT_TRUE(executor.start(workers));
+        ExecutorStats before = executor.getStats();
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < JOB_COUNT; ++i) {
+            while (!executor.submit(cpuHeavyJob)) {
+                yield(); // Every deque is full: let the workers catch up.
+            }
+        }
+        executor.waitIdle();
+        double seconds = secondsSince(start);
+
+        ExecutorStats stats = executor.getStats();
+        printf("%-12u %14.0f %9.2fx %10u\n", (unsigned)workers, JOB_COUNT / seconds, baselineSeconds / seconds,
+               (unsigned)(stats.stolen - before.stolen));
+        TEST_ASSERT_EQUAL(JOB_COUNT, stats.executed - before.executed);
+        executor.stop();
+
+        if (workers == maxWorkers) {
+            break;
+        }
+        if (workers * 2 > maxWorkers) {
+            workers = maxWorkers / 2; // Always finish with the full pool
+        }
+    }
+}
+
+void runAllTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_throughput_scaling);
+}
+
+#if defined(ARDUINO)
+void setup() {
+    delay(2000);
+    runAllTests();
+}
+
+void loop() {
+    UNITY_END();
+}
+#else
+int main() {
+    runAllTests();
+    return UNITY_END();
+}
+#endif
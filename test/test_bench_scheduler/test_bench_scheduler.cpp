@@ -0,0 +1,350 @@
+/**
+ * @file        test_bench_scheduler.cpp
+ * @title       Scheduler Benchmark: Deadline Heap vs. Vector Scan
+ * @description Compares the cost of `Scheduler::loop()` against the original
+ *              vector-scan implementation for 10, 100, 1,000 and 10,000 tasks,
+ *              measures the latency of a critical task under load with and
+ *              without priority classes and CPU budgets, and counts idle
+ *              wake-ups of a large task set with and without timer slack.
+ *              Intended for the host build: `pio test -e native -f test_bench_scheduler`.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-08-26
+ * @version     0.1.0
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include <functional>
+#include <vector>
+#include "core/Platform.h"
+#include "core/Scheduler.h"
+
+namespace {
+
+/**
+ * @brief A copy of the original Scheduler algorithm, used as the baseline.
+ * @details Every pass walks all tasks and checks `now - lastRun >= interval`.
+ */
+class VectorScanScheduler {
+public:
+    void scheduleRecurring(unsigned long intervalMs, std::function<void()> callback) {
+        _tasks.push_back({intervalMs, millis(), callback});
+    }
+
+    void loop() {
+        unsigned long now = millis();
+        for (auto& task : _tasks) {
+            if (now - task.lastRun >= task.interval) {
+                task.callback();
+                task.lastRun = now;
+            }
+        }
+    }
+
+private:
+    struct Task {
+        unsigned long interval;
+        unsigned long lastRun;
+        std::function<void()> callback;
+    };
+    std::vector<Task> _tasks;
+};
+
+const size_t TASK_COUNTS[] = {10, 100, 1000, 10000};
+const unsigned long IDLE_INTERVAL_MS = 3600000UL; // Never due during the benchmark
+const unsigned long MIXED_RUN_MS = 300;
+volatile unsigned long g_fired = 0;
+
+double nsSince(std::chrono::steady_clock::time_point start) {
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Idle passes: no task is due, which is the common case on a busy gateway.
+template <typename LoopFn>
+double measureIdlePassNs(LoopFn loopFn, size_t taskCount) {
+    size_t passes = taskCount >= 1000 ? 2000 : 100000;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < passes; ++i) {
+        loopFn();
+    }
+    return nsSince(start) / passes;
+}
+
+// Mixed load: intervals spread over 1..250 ms, loop runs flat out for a fixed time.
+template <typename LoopFn>
+double measureMixedPassNs(LoopFn loopFn, unsigned long& passesOut) {
+    unsigned long passes = 0;
+    auto start = std::chrono::steady_clock::now();
+    unsigned long startMs = millis();
+    while (millis() - startMs < MIXED_RUN_MS) {
+        loopFn();
+        passes++;
+    }
+    passesOut = passes;
+    return nsSince(start) / passes;
+}
+
+// Stress scenario on a simulated microsecond clock: callbacks "cost" time by
+// advancing it, so the results are deterministic and independent of the host.
+uint64_t g_simulatedUs = 0;
+
+uint64_t simulatedClock() {
+    return g_simulatedUs;
+}
+
+const int LOGGER_COUNT = 8;
+const uint32_t LOGGER_COST_US = 60;
+const uint32_t ROGUE_COST_US = 300;
+const uint32_t RELAY_COST_US = 10;
+const uint64_t STRESS_DURATION_US = 2000000ULL;
+
+enum class StressMode { Fifo, Priority, PriorityWithRogue, PriorityWithBudget };
+
+TimingSummary runRelayStress(StressMode mode) {
+    Scheduler& scheduler = Scheduler::getInstance();
+    scheduler.setTimeSource(simulatedClock);
+    g_simulatedUs = 0;
+    std::vector<Scheduler::TaskHandle> handles;
+
+    // Background loggers with slightly different periods, so their phases drift
+    // across the relay's deadline. Scheduled first: in FIFO they win every tie.
+    for (int i = 0; i < LOGGER_COUNT; ++i) {
+        handles.push_back(scheduler.scheduleRecurringMicros(1000 + i * 13, []() { g_simulatedUs += LOGGER_COST_US; }));
+        if (mode != StressMode::Fifo) {
+            scheduler.setTaskPriority(handles.back(), TaskPriority::Low);
+        }
+    }
+
+    // A task mistakenly marked Critical that hogs the CPU on every run.
+    if (mode == StressMode::PriorityWithRogue || mode == StressMode::PriorityWithBudget) {
+        handles.push_back(scheduler.scheduleRecurringMicros(1000, []() { g_simulatedUs += ROGUE_COST_US; }));
+        scheduler.setTaskPriority(handles.back(), TaskPriority::Critical);
+        if (mode == StressMode::PriorityWithBudget) {
+            scheduler.setTaskBudget(handles.back(), 100, OverrunPolicy::Demote);
+        }
+    }
+
+    Scheduler::TaskHandle relay = scheduler.scheduleRecurringMicros(1000, []() { g_simulatedUs += RELAY_COST_US; });
+    if (mode != StressMode::Fifo) {
+        scheduler.setTaskPriority(relay, TaskPriority::Critical);
+    }
+
+    while (g_simulatedUs < STRESS_DURATION_US) {
+        scheduler.loop();
+        g_simulatedUs += 5; // The rest of the main loop
+    }
+
+    TaskTimingStats stats;
+    scheduler.getTaskTimingStats(relay, stats);
+    scheduler.cancel(relay);
+    for (auto handle : handles) {
+        scheduler.cancel(handle);
+    }
+    scheduler.setTimeSource(nullptr);
+    return stats.lateness;
+}
+
+// Coalescing scenario: a tickless loop on a simulated clock that sleeps until
+// Scheduler::getTimeUntilNextDeadlineMicros(), like IdleMode::Sleep. Every
+// wake-up costs WAKE_COST_US of busy time (e.g. leaving light sleep).
+const int COALESCE_TASK_COUNT = 500;
+const uint64_t COALESCE_DURATION_US = 600000000ULL; // 10 simulated minutes
+const uint32_t WAKE_COST_US = 1000;
+const uint32_t COALESCE_TASK_COST_US = 100;
+const unsigned long NOMINAL_PERIODS_MS[] = {100, 250, 500, 1000, 2000, 5000, 10000};
+
+struct CoalesceResult {
+    double wakeupsPerMinute;
+    double busyMsPerMinute;
+    uint32_t runs;
+    uint32_t avgLatenessUs;
+    uint32_t maxLatenessUs;
+};
+
+CoalesceResult runCoalescing(unsigned slackPercent) {
+    Scheduler& scheduler = Scheduler::getInstance();
+    scheduler.setTimeSource(simulatedClock);
+    g_simulatedUs = 0;
+    std::vector<Scheduler::TaskHandle> handles;
+
+    // Periods within +/-3% of a few common values, e.g. 997 ms next to 1000 ms.
+    uint32_t seed = 12345;
+    for (int i = 0; i < COALESCE_TASK_COUNT; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        unsigned long nominal = NOMINAL_PERIODS_MS[(seed >> 16) % 7];
+        seed = seed * 1103515245u + 12345u;
+        long skew = (long)((seed >> 16) % 61) - 30; // -3.0% .. +3.0%
+        unsigned long period = (unsigned long)((long)nominal + (long)nominal * skew / 1000);
+        handles.push_back(scheduler.scheduleRecurring(period, []() { g_simulatedUs += COALESCE_TASK_COST_US; }));
+        scheduler.setTaskSlack(handles.back(), period * slackPercent / 100);
+    }
+
+    uint64_t idleUs = 0;
+    uint32_t wakeups = 0;
+    while (g_simulatedUs < COALESCE_DURATION_US) {
+        scheduler.loop();
+        Scheduler::Timestamp untilNext = scheduler.getTimeUntilNextDeadlineMicros();
+        if (untilNext == 0) {
+            continue;
+        }
+        g_simulatedUs += untilNext;
+        idleUs += untilNext;
+        g_simulatedUs += WAKE_COST_US;
+        wakeups++;
+    }
+
+    CoalesceResult result = {};
+    double minutes = (double)g_simulatedUs / 60e6;
+    result.wakeupsPerMinute = wakeups / minutes;
+    result.busyMsPerMinute = (double)(g_simulatedUs - idleUs) / 1000.0 / minutes;
+    uint64_t latenessSum = 0;
+    for (auto handle : handles) {
+        TaskTimingStats stats;
+        scheduler.getTaskTimingStats(handle, stats);
+        result.runs += stats.runs;
+        latenessSum += (uint64_t)stats.lateness.avg * stats.lateness.count;
+        result.maxLatenessUs = stats.lateness.max > result.maxLatenessUs ? stats.lateness.max : result.maxLatenessUs;
+        scheduler.cancel(handle);
+    }
+    result.avgLatenessUs = result.runs ? (uint32_t)(latenessSum / result.runs) : 0;
+    scheduler.setTimeSource(nullptr);
+    return result;
+}
+
+} // namespace
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_bench_idle_pass() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    printf("\n%-8s %18s %18s %10s\n", "tasks", "vector scan ns", "deadline heap ns", "speedup");
+
+    for (size_t count : TASK_COUNTS) {
+        VectorScanScheduler baseline;
+        std::vector<Scheduler::TaskHandle> handles;
+        for (size_t i = 0; i < count; ++i) {
+            baseline.scheduleRecurring(IDLE_INTERVAL_MS, []() { g_fired = g_fired + 1; });
+            handles.push_back(scheduler.scheduleRecurring(IDLE_INTERVAL_MS, []() { g_fired = g_fired + 1; }));
+        }
+
+        double scanNs = measureIdlePassNs([&]() { baseline.loop(); }, count);
+        double heapNs = measureIdlePassNs([&]() { scheduler.loop(); }, count);
+        printf("%-8zu %18.1f %18.1f %9.1fx\n", count, scanNs, heapNs, scanNs / heapNs);
+
+        for (auto handle : handles) {
+            scheduler.cancel(handle);
+        }
+        if (count >= 1000) {
+            TEST_ASSERT_TRUE(heapNs < scanNs);
+        }
+    }
+}
+
+void test_bench_mixed_load() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    printf("\n%-8s %18s %18s %14s %14s\n", "tasks", "vector scan ns", "deadline heap ns", "scan fired", "heap fired");
+
+    for (size_t count : TASK_COUNTS) {
+        VectorScanScheduler baseline;
+        std::vector<Scheduler::TaskHandle> handles;
+        for (size_t i = 0; i < count; ++i) {
+            unsigned long interval = 1 + (i * 7919) % 250;
+            baseline.scheduleRecurring(interval, []() { g_fired = g_fired + 1; });
+            handles.push_back(scheduler.scheduleRecurring(interval, []() { g_fired = g_fired + 1; }));
+        }
+
+        unsigned long passes = 0;
+        g_fired = 0;
+        double scanNs = measureMixedPassNs([&]() { baseline.loop(); }, passes);
+        unsigned long scanFired = g_fired;
+        g_fired = 0;
+        double heapNs = measureMixedPassNs([&]() { scheduler.loop(); }, passes);
+        unsigned long heapFired = g_fired;
+        printf("%-8zu %18.1f %18.1f %14lu %14lu\n", count, scanNs, heapNs, scanFired, heapFired);
+
+        for (auto handle : handles) {
+            scheduler.cancel(handle);
+        }
+    }
+    TEST_ASSERT_EQUAL(0, scheduler.getTaskCount());
+}
+
+void test_bench_critical_task_latency_under_load() {
+#if !NEXTINO_SCHEDULER_TIMING_STATS
+    TEST_IGNORE_MESSAGE("NEXTINO_SCHEDULER_TIMING_STATS is disabled.");
+#endif
+    const char* names[] = {"fifo (no policy)", "priority", "priority + rogue", "priority + budget"};
+    const StressMode modes[] = {StressMode::Fifo, StressMode::Priority, StressMode::PriorityWithRogue, StressMode::PriorityWithBudget};
+    TimingSummary results[4];
+
+    printf("\nRelay task lateness (us), %d loggers x %u us + rogue %u us, 1 ms periods:\n", LOGGER_COUNT,
+           (unsigned)LOGGER_COST_US, (unsigned)ROGUE_COST_US);
+    printf("%-20s %10s %10s %10s %10s\n", "policy", "runs", "avg", "p99", "max");
+    for (int i = 0; i < 4; ++i) {
+        results[i] = runRelayStress(modes[i]);
+        printf("%-20s %10u %10u %10u %10u\n", names[i], (unsigned)results[i].count, (unsigned)results[i].avg,
+               (unsigned)results[i].p99, (unsigned)results[i].max);
+    }
+
+    // Priority bounds the relay's lateness by one callback, not by the whole backlog.
+    TEST_ASSERT_TRUE(results[1].max < results[0].max);
+    TEST_ASSERT_TRUE(results[1].max <= LOGGER_COST_US + 5);
+    // A budget demotes the rogue task and restores the relay's latency.
+    TEST_ASSERT_TRUE(results[3].p99 < results[2].p99);
+}
+
+void test_bench_timer_slack_coalescing() {
+#if !NEXTINO_SCHEDULER_TIMING_STATS
+    TEST_IGNORE_MESSAGE("NEXTINO_SCHEDULER_TIMING_STATS is disabled.");
+#endif
+    const unsigned slackPercents[] = {0, 1, 5, 10};
+    CoalesceResult results[4];
+
+    printf("\n%d tasks, periods 100 ms - 10 s (+/-3%%), %u us per run, %u us per wake-up, 10 simulated minutes:\n",
+           COALESCE_TASK_COUNT, (unsigned)COALESCE_TASK_COST_US, (unsigned)WAKE_COST_US);
+    printf("%-14s %14s %16s %12s %14s %14s\n", "slack", "wakeups/min", "busy ms/min", "runs", "avg late us",
+           "max late us");
+    for (int i = 0; i < 4; ++i) {
+        results[i] = runCoalescing(slackPercents[i]);
+        printf("%3u%% of period %14.0f %16.1f %12u %14u %14u\n", slackPercents[i], results[i].wakeupsPerMinute,
+               results[i].busyMsPerMinute, (unsigned)results[i].runs, (unsigned)results[i].avgLatenessUs,
+               (unsigned)results[i].maxLatenessUs);
+    }
+
+    // Every slack setting runs the same work; only the grouping changes.
+    for (int i = 1; i < 4; ++i) {
+        TEST_ASSERT_TRUE(results[i].wakeupsPerMinute < results[i - 1].wakeupsPerMinute);
+        TEST_ASSERT_TRUE(results[i].busyMsPerMinute < results[0].busyMsPerMinute);
+    }
+    // Lateness stays within the largest window (10% of 10.3 s), plus one run's cost per task ahead in the batch.
+    TEST_ASSERT_TRUE(results[3].maxLatenessUs <= 1030000 + COALESCE_TASK_COUNT * COALESCE_TASK_COST_US + WAKE_COST_US);
+    TEST_ASSERT_EQUAL(0, Scheduler::getInstance().getTaskCount());
+}
+
+void runAllTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_idle_pass);
+    RUN_TEST(test_bench_mixed_load);
+    RUN_TEST(test_bench_critical_task_latency_under_load);
+    RUN_TEST(test_bench_timer_slack_coalescing);
+}
+
+#if defined(ARDUINO)
+void setup() {
+    delay(2000);
+    runAllTests();
+}
+
+void loop() {
+    UNITY_END();
+}
+#else
+int main() {
+    runAllTests();
+    return UNITY_END();
+}
+#endif
@@ -0,0 +1,257 @@
+/**
+ * @file        test_command_frame.cpp
+ * @title       Unit Tests for Binary Command Frames
+ * @description Verifies command IDs, typed arguments reaching the same text
+ *              and typed handlers as text commands, status codes in
+ *              responses, rejection of malformed frames, and frame
+ *              reassembly from a noisy stream.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-06
+ * @version     0.1.0
+ */
+
+#include <unity.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "core/Platform.h"
+#include "core/CommandRouter.h"
+#include "core/CommandFrame.h"
+
+static std::vector<std::string> g_seen;
+
+// Generated by code_generator.generate_command_table() for these five commands.
+static const CommandTable::Entry tableEntries[] = {
+    {"relay", "on"},
+    {"pump", "stop"},
+    {"pump", "start"},
+    {"valve", "open"},
+    {"valve", "close"},
+};
+static const uint16_t tableDisplacements[] = {
+    0, 13,
+};
+static const CommandTable table = {tableEntries, tableDisplacements, 5, 2};
+
+static CommandStatus recordArgs(const CommandArgs& args, CommandOutput& out) {
+    for (std::string_view arg : args) {
+        g_seen.emplace_back(arg);
+    }
+    out.printf("OK: %u args.", (unsigned)args.size());
+    return CommandStatus::Ok;
+}
+
+void setUp(void) {
+    g_seen.clear();
+}
+
+void tearDown(void) {}
+
+void test_commands_have_stable_ids(void) {
+    CommandRouter& router = CommandRouter::getInstance();
+    TEST_ASSERT_TRUE(router.useCommandTable(table));
+    router.registerCommand("pump", "start", recordArgs);
+    router.registerCommand("mixer", "set", recordArgs);
+    router.registerCommand("mixer", "get", [](const std::vector<std::string>&) { return std::string("OK: 7"); });
+
+    // Declared commands are their slot; others are numbered in order of registration.
+    TEST_ASSERT_EQUAL(2, router.commandId("pump", "start"));
+    TEST_ASSERT_EQUAL(CommandRouter::FIRST_REGISTERED_ID, router.commandId("mixer", "set"));
+    TEST_ASSERT_EQUAL(CommandRouter::FIRST_REGISTERED_ID + 1, router.commandId("mixer", "get"));
+    TEST_ASSERT_EQUAL(-1, router.commandId("pump", "stop")); // Declared, never registered
+    TEST_ASSERT_EQUAL(-1, router.commandId("mixer", "reset"));
+
+    // Registering again replaces the handler but keeps the ID.
+    router.registerCommand("mixer", "set", recordArgs);
+    TEST_ASSERT_EQUAL(CommandRouter::FIRST_REGISTERED_ID, router.commandId("mixer", "set"));
+}
+
+void test_typed_arguments_reach_the_text_handler(void) {
+    CommandRouter& router = CommandRouter::getInstance();
+    uint8_t request[CommandFrame::MAX_SIZE];
+    size_t size = CommandFrameWriter(request, sizeof(request))
+                      .begin(42, (uint16_t)router.commandId("mixer", "set"))
+                      .addInt(-2147483647 - 1)
+                      .addFloat(0.1f)
+                      .addBool(true)
+                      .addText("fast")
+                      .addText("")
+                      .finish();
+    TEST_ASSERT_EQUAL(6 + 5 + 5 + 2 + 6 + 2 + 1, size);
+
+    uint8_t response[CommandFrame::MAX_SIZE];
+    size_t responseSize = router.executeFrame(request, size, response, sizeof(response));
+    CommandResponse decoded;
+    TEST_ASSERT_TRUE(CommandFrame::decodeResponse(response, responseSize, decoded));
+    TEST_ASSERT_EQUAL(42, decoded.sequence);
+    TEST_ASSERT_EQUAL((int)CommandStatus::Ok, (int)decoded.status);
+    TEST_ASSERT_EQUAL_STRING("OK: 5 args.", std::string(decoded.output).c_str());
+
+    TEST_ASSERT_EQUAL(5, g_seen.size());
+    if (g_seen.size() == 5) {
+        TEST_ASSERT_EQUAL_STRING("-2147483648", g_seen[0].c_str());
+        TEST_ASSERT_EQUAL_FLOAT(0.1f, strtof(g_seen[1].c_str(), nullptr));
+        TEST_ASSERT_TRUE(strtof(g_seen[1].c_str(), nullptr) == 0.1f); // Reads back exactly
+        TEST_ASSERT_EQUAL_STRING("1", g_seen[2].c_str());
+        TEST_ASSERT_EQUAL_STRING("fast", g_seen[3].c_str());
+        TEST_ASSERT_EQUAL_STRING("", g_seen[4].c_str());
+    }
+
+    // A string handler works too, and a table slot by its ID.
+    size = CommandFrameWriter(request, sizeof(request)).begin(1, (uint16_t)router.commandId("mixer", "get")).finish();
+    responseSize = router.executeFrame(request, size, response, sizeof(response));
+    TEST_ASSERT_TRUE(CommandFrame::decodeResponse(response, responseSize, decoded));
+    TEST_ASSERT_EQUAL_STRING("OK: 7", std::string(decoded.output).c_str());
+    size = CommandFrameWriter(request, sizeof(request)).begin(2, 2).addInt(5).finish();
+    responseSize = router.executeFrame(request, size, response, sizeof(response));
+    TEST_ASSERT_TRUE(CommandFrame::decodeResponse(response, responseSize, decoded));
+    TEST_ASSERT_EQUAL_STRING("OK: 1 args.", std::string(decoded.output).c_str());
+}
+
+void test_typed_handlers_take_frames(void) {
+    CommandRouter& router = CommandRouter::getInstance();
+    router.registerCommand<int32_t, float, bool>("mixer", "gain", [](int32_t channel, float gain, bool mute, CommandOutput& out) {
+        out.print(channel).print(':').print(gain, 3).print(':').print(mute);
+        return CommandStatus::Ok;
+    });
+    uint8_t request[CommandFrame::MAX_SIZE];
+    size_t size = CommandFrameWriter(request, sizeof(request))
+                      .begin(5, (uint16_t)router.commandId("mixer", "gain"))
+                      .addInt(-3)
+                      .addFloat(0.125f)
+                      .addBool(false)
+                      .finish();
+    uint8_t response[CommandFrame::MAX_SIZE];
+    CommandResponse decoded;
+    TEST_ASSERT_TRUE(CommandFrame::decodeResponse(response, router.executeFrame(request, size, response, sizeof(response)), decoded));
+    TEST_ASSERT_EQUAL((int)CommandStatus::Ok, (int)decoded.status);
+    TEST_ASSERT_EQUAL_STRING("-3:0.125:false", std::string(decoded.output).c_str());
+}
+
+void test_errors_are_status_codes(void) {
+    CommandRouter& router = CommandRouter::getInstance();
+    uint8_t request[CommandFrame::MAX_SIZE];
+    uint8_t response[CommandFrame::MAX_SIZE];
+    CommandResponse decoded;
+
+    // Unknown IDs, in and out of the table, answer with a status and no text.
+    const uint16_t unknown[] = {1, 99, CommandRouter::FIRST_REGISTERED_ID + 500};
+    for (uint16_t id : unknown) {
+        size_t size = CommandFrameWriter(request, sizeof(request)).begin(7, id).finish();
+        size_t responseSize = router.executeFrame(request, size, response, sizeof(response));
+        TEST_ASSERT_EQUAL(CommandFrame::OVERHEAD + 2, responseSize);
+        TEST_ASSERT_TRUE(CommandFrame::decodeResponse(response, responseSize, decoded));
+        TEST_ASSERT_EQUAL((int)CommandStatus::NotFound, (int)decoded.status);
+        TEST_ASSERT_EQUAL(0, decoded.output.size());
+    }
+
+    // Too many arguments.
+    CommandFrameWriter writer(request, sizeof(request));
+    writer.begin(8, (uint16_t)router.commandId("mixer", "set"));
+    for (int i = 0; i <= NEXTINO_COMMAND_MAX_ARGS; ++i) {
+        writer.addBool(false);
+    }
+    size_t size = writer.finish();
+    TEST_ASSERT_TRUE(CommandFrame::decodeResponse(response, router.executeFrame(request, size, response, sizeof(response)), decoded));
+    TEST_ASSERT_EQUAL((int)CommandStatus::BadArguments, (int)decoded.status);
+    TEST_ASSERT_EQUAL(0, g_seen.size());
+
+    // An unknown argument type, with a valid CRC.
+    size = CommandFrameWriter(request, sizeof(request)).begin(9, (uint16_t)router.commandId("mixer", "set")).addBool(true).finish();
+    request[6] = 0x7F;
+    request[size - 1] = CommandFrame::crc8(request + 1, size - 2);
+    TEST_ASSERT_TRUE(CommandFrame::decodeResponse(response, router.executeFrame(request, size, response, sizeof(response)), decoded));
+    TEST_ASSERT_EQUAL((int)CommandStatus::InvalidFormat, (int)decoded.status);
+
+    // Frames that are not frames get no response at all.
+    size = CommandFrameWriter(request, sizeof(request)).begin(10, 2).addInt(1).finish();
+    request[7] ^= 0x01;
+    TEST_ASSERT_EQUAL(0, router.executeFrame(request, size, response, sizeof(response))); // Bad CRC
+    request[7] ^= 0x01;
+    TEST_ASSERT_EQUAL(0, router.executeFrame(request, size - 1, response, sizeof(response))); // Short
+    TEST_ASSERT_EQUAL(0, router.executeFrame(request, size, response, 4));                   // No room
+    TEST_ASSERT_TRUE(router.executeFrame(request, size, response, sizeof(response)) > 0);
+}
+
+void test_output_is_cut_to_the_response(void) {
+    CommandRouter& router = CommandRouter::getInstance();
+    router.registerCommand("mixer", "dump", [](const CommandArgs&, CommandOutput& out) {
+        for (int i = 0; i < 40; ++i) {
+            out.print("0123456789");
+        }
+        return CommandStatus::Ok;
+    });
+    uint8_t request[16];
+    size_t size = CommandFrameWriter(request, sizeof(request)).begin(3, (uint16_t)router.commandId("mixer", "dump")).finish();
+
+    uint8_t response[CommandFrame::MAX_SIZE];
+    CommandResponse decoded;
+    size_t responseSize = router.executeFrame(request, size, response, sizeof(response));
+    TEST_ASSERT_EQUAL(CommandFrame::MAX_SIZE, responseSize);
+    TEST_ASSERT_TRUE(CommandFrame::decodeResponse(response, responseSize, decoded));
+    TEST_ASSERT_EQUAL(CommandFrame::MAX_OUTPUT, decoded.output.size());
+
+    uint8_t small[12];
+    responseSize = router.executeFrame(request, size, small, sizeof(small));
+    TEST_ASSERT_EQUAL(sizeof(small), responseSize);
+    TEST_ASSERT_TRUE(CommandFrame::decodeResponse(small, responseSize, decoded));
+    TEST_ASSERT_EQUAL_STRING("0123456", std::string(decoded.output).c_str());
+
+    // The writer refuses what does not fit.
+    TEST_ASSERT_EQUAL(0, CommandFrameWriter(request, sizeof(request)).begin(4, 1).addText("too long for this").finish());
+}
+
+void test_reader_finds_frames_in_a_noisy_stream(void) {
+    uint8_t first[32];
+    uint8_t second[32];
+    size_t firstSize = CommandFrameWriter(first, sizeof(first)).begin(1, 0x1234).addText("a").finish();
+    size_t secondSize = CommandFrameWriter(second, sizeof(second)).begin(2, 0x4321).addInt(9).finish();
+
+    std::vector<uint8_t> stream = {0x00, 0xFF, CommandFrame::REQUEST, 0x02, 0x99, 0x99, 0x00}; // Noise, a false start
+    stream.insert(stream.end(), first, first + firstSize);
+    stream.push_back(0x55);
+    stream.insert(stream.end(), second, second + secondSize);
+
+    CommandFrameReader reader;
+    std::vector<std::vector<uint8_t>> frames;
+    for (uint8_t byte : stream) {
+        if (reader.feed(byte)) {
+            frames.emplace_back(reader.data(), reader.data() + reader.size());
+        }
+    }
+    TEST_ASSERT_EQUAL(2, frames.size());
+    TEST_ASSERT_EQUAL(1, reader.dropped());
+    if (frames.size() == 2) {
+        TEST_ASSERT_EQUAL(firstSize, frames[0].size());
+        TEST_ASSERT_EQUAL_MEMORY(first, frames[0].data(), firstSize);
+        TEST_ASSERT_EQUAL(secondSize, frames[1].size());
+        TEST_ASSERT_EQUAL_MEMORY(second, frames[1].data(), secondSize);
+    }
+}
+
+void runAllTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_commands_have_stable_ids);
+    RUN_TEST(test_typed_arguments_reach_the_text_handler);
+    RUN_TEST(test_typed_handlers_take_frames);
+    RUN_TEST(test_errors_are_status_codes);
+    RUN_TEST(test_output_is_cut_to_the_response);
+    RUN_TEST(test_reader_finds_frames_in_a_noisy_stream);
+}
+
+#if defined(ARDUINO)
+void setup() {
+    delay(2000);
+    runAllTests();
+}
+
+void loop() {
+    UNITY_END();
+}
+#else
+int main() {
+    runAllTests();
+    return UNITY_END();
+}
+#endif
@@ -0,0 +1,578 @@
+/**
+ * @file        test_command_router.cpp
+ * @title       Unit Tests for the CommandRouter
+ * @description Verifies in-place tokenizing, handler lookup, error statuses,
+ *              bounded output, compatibility with string handlers, lookups
+ *              through a generated command table, batches, typed handlers
+ *              and typed output, asynchronous handlers with timeouts and
+ *              cancellation, and that executing commands with view, typed or
+ *              asynchronous handlers does not allocate.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-05
+ * @version     0.1.0
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <new>
+#include <string>
+#include <vector>
+#include "core/Platform.h"
+#include "core/CommandRouter.h"
+
+#if !defined(ARDUINO)
+// Counts heap allocations made by this test program.
+static size_t g_allocations = 0;
+
+void* operator new(size_t size) {
+    g_allocations++;
+    void* block = malloc(size ? size : 1);
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void operator delete(void* block) noexcept {
+    free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    free(block);
+}
+#endif
+
+static std::vector<std::string> g_seen;
+
+void setUp(void) {
+    g_seen.clear();
+}
+
+void tearDown(void) {}
+
+void test_arguments_are_views_into_the_command_line(void) {
+    CommandRouter& router = CommandRouter::getInstance();
+    static const char* line = "  mixer\tset_levels 10 -20  30\r\n";
+    router.registerCommand("mixer", "set_levels", [](const CommandArgs& args, CommandOutput& out) {
+        TEST_ASSERT_EQUAL(3, args.size());
+        for (std::string_view arg : args) {
+            TEST_ASSERT_TRUE(arg.data() >= line && arg.data() < line + strlen(line)); // Not a copy
+            g_seen.emplace_back(arg);
+        }
+        out.printf("OK: %u levels.", (unsigned)args.size());
+        return CommandStatus::Ok;
+    });
+
+    char buffer[64];
+    CommandOutput output(buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL((int)CommandStatus::Ok, (int)router.execute(std::string_view(line), output));
+    TEST_ASSERT_EQUAL_STRING("OK: 3 levels.", buffer);
+    TEST_ASSERT_EQUAL(3, g_seen.size());
+    TEST_ASSERT_EQUAL_STRING("10", g_seen[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("-20", g_seen[1].c_str());
+    TEST_ASSERT_EQUAL_STRING("30", g_seen[2].c_str());
+}
+
+void test_errors_report_a_status_and_a_message(void) {
+    CommandRouter& router = CommandRouter::getInstance();
+    router.registerCommand("relay", "on", [](const CommandArgs& args, CommandOutput& out) {
+        if (!args.empty()) {
+            out.print("ERROR: No arguments expected.");
+            return CommandStatus::BadArguments;
+        }
+        out.print("OK");
+        return CommandStatus::Ok;
+    });
+
+    char buffer[128];
+    CommandOutput output(buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL((int)CommandStatus::InvalidFormat, (int)router.execute("relay", output));
+    output.clear();
+    TEST_ASSERT_EQUAL((int)CommandStatus::NotFound, (int)router.execute("relay off", output));
+    TEST_ASSERT_EQUAL_STRING("ERROR: Command not found.", buffer);
+    output.clear();
+    TEST_ASSERT_EQUAL((int)CommandStatus::NotFound, (int)router.execute("relays on", output));
+    output.clear();
+    TEST_ASSERT_EQUAL((int)CommandStatus::BadArguments, (int)router.execute("relay on now", output));
+    TEST_ASSERT_EQUAL_STRING("ERROR: No arguments expected.", buffer);
+    output.clear();
+    TEST_ASSERT_EQUAL((int)CommandStatus::BadArguments, (int)router.execute("relay on 1 2 3 4 5 6 7 8 9", output));
+    TEST_ASSERT_EQUAL_STRING("ERROR: Too many arguments (at most 8).", buffer);
+    output.clear();
+    TEST_ASSERT_EQUAL((int)CommandStatus::Ok, (int)router.execute("relay on", output));
+    TEST_ASSERT_EQUAL_STRING("OK", buffer);
+}
+
+void test_output_is_cut_at_the_buffer_size(void) {
+    char buffer[8];
+    CommandOutput output(buffer, sizeof(buffer));
+    output.print("abc").printf("%d", 1234);
+    TEST_ASSERT_EQUAL_STRING("abc1234", buffer);
+    TEST_ASSERT_FALSE(output.truncated());
+    output.print("5");
+    TEST_ASSERT_EQUAL_STRING("abc1234", buffer);
+    TEST_ASSERT_TRUE(output.truncated());
+
+    output.clear();
+    output.printf("%s", "longer than eight");
+    TEST_ASSERT_EQUAL_STRING("longer ", buffer);
+    TEST_ASSERT_EQUAL(7, output.length());
+    TEST_ASSERT_TRUE(output.truncated());
+
+    CommandOutput none(nullptr, 0);
+    none.print("x");
+    TEST_ASSERT_TRUE(none.truncated());
+    TEST_ASSERT_EQUAL_STRING("", none.c_str());
+}
+
+void test_string_handlers_and_execute_still_work(void) {
+    CommandRouter& router = CommandRouter::getInstance();
+    router.registerCommand("legacy", "echo", [](const std::vector<std::string>& args) -> std::string {
+        std::string result = "OK:";
+        for (const std::string& arg : args) {
+            result += " " + arg;
+        }
+        return result;
+    });
+    router.registerCommand("legacy", "fail", [](auto) { return "ERROR: Nope."; });
+
+    TEST_ASSERT_EQUAL_STRING("OK: a b", router.execute(std::string("legacy echo a b")).c_str());
+    TEST_ASSERT_EQUAL_STRING("OK", router.execute(std::string("relay on")).c_str()); // A view handler
+    TEST_ASSERT_EQUAL_STRING("ERROR: Command not found.", router.execute(std::string("legacy nothing")).c_str());
+    // Past NEXTINO_COMMAND_MAX_ARGS, only string handlers still get every argument.
+    TEST_ASSERT_EQUAL_STRING("OK: 1 2 3 4 5 6 7 8 9 10", router.execute(std::string("legacy echo 1 2 3 4 5 6 7 8 9 10")).c_str());
+    TEST_ASSERT_EQUAL_STRING("ERROR: Too many arguments (at most 8).", router.execute(std::string("relay on 1 2 3 4 5 6 7 8 9")).c_str());
+
+    char buffer[32];
+    CommandOutput output(buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL((int)CommandStatus::Ok, (int)router.execute("legacy echo x", output));
+    TEST_ASSERT_EQUAL_STRING("OK: x", buffer);
+    output.clear();
+    TEST_ASSERT_EQUAL((int)CommandStatus::Failed, (int)router.execute("legacy fail", output));
+    TEST_ASSERT_EQUAL_STRING("ERROR: Nope.", buffer);
+}
+
+// Generated by code_generator.generate_command_table() for these five commands.
+static const CommandTable::Entry tableEntries[] = {
+    {"relay", "on"},
+    {"pump", "stop"},
+    {"pump", "start"},
+    {"valve", "open"},
+    {"valve", "close"},
+};
+static const uint16_t tableDisplacements[] = {
+    0, 13,
+};
+static const CommandTable table = {tableEntries, tableDisplacements, 5, 2};
+
+void test_declared_commands_use_the_generated_table(void) {
+    // Every declared command hashes to its own slot; anything else is not in the table.
+    for (uint16_t slot = 0; slot < table.size; ++slot) {
+        TEST_ASSERT_EQUAL(slot, table.find(tableEntries[slot].instanceName, tableEntries[slot].command));
+    }
+    TEST_ASSERT_EQUAL(-1, table.find("pump", "stat"));
+    TEST_ASSERT_EQUAL(-1, table.find("valve", "on"));
+    TEST_ASSERT_EQUAL(-1, table.find("", ""));
+
+    CommandRouter& router = CommandRouter::getInstance();
+    TEST_ASSERT_TRUE(router.useCommandTable(table));
+    TEST_ASSERT_FALSE(router.useCommandTable(table));
+    router.registerCommand("pump", "start", [](const CommandArgs&, CommandOutput& out) {
+        out.print("OK: Pumping.");
+        return CommandStatus::Ok;
+    });
+    router.registerCommand("pump", "flush", [](const CommandArgs&, CommandOutput& out) {
+        out.print("OK: Flushed."); // Not declared: goes to the registry map
+        return CommandStatus::Ok;
+    });
+
+    char buffer[32];
+    CommandOutput output(buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL((int)CommandStatus::Ok, (int)router.execute("pump start", output));
+    TEST_ASSERT_EQUAL_STRING("OK: Pumping.", buffer);
+    output.clear();
+    TEST_ASSERT_EQUAL((int)CommandStatus::Ok, (int)router.execute("pump flush", output));
+    TEST_ASSERT_EQUAL_STRING("OK: Flushed.", buffer);
+    output.clear();
+    TEST_ASSERT_EQUAL((int)CommandStatus::Ok, (int)router.execute("relay on", output)); // Registered before the table
+    output.clear();
+    TEST_ASSERT_EQUAL((int)CommandStatus::NotFound, (int)router.execute("pump stop", output)); // Declared, never registered
+}
+
+void test_batches_run_in_order_with_one_line_per_command(void) {
+    CommandRouter& router = CommandRouter::getInstance();
+    char buffer[128];
+    CommandOutput output(buffer, sizeof(buffer));
+    BatchResult result = router.executeBatch("relay on; legacy echo a b\n\n  ;relay on\r\n", output);
+    TEST_ASSERT_EQUAL(3, result.executed);
+    TEST_ASSERT_EQUAL(0, result.failed);
+    TEST_ASSERT_EQUAL((int)CommandStatus::Ok, (int)result.firstError);
+    TEST_ASSERT_EQUAL_STRING("OK\nOK: a b\nOK", buffer);
+
+    // Keep going: every command runs and answers on its line.
+    output.clear();
+    result = router.executeBatch("relay on;relay off;relay on 1;relay on", output, BatchMode::ContinueOnError);
+    TEST_ASSERT_EQUAL(4, result.executed);
+    TEST_ASSERT_EQUAL(2, result.failed);
+    TEST_ASSERT_EQUAL(0, result.skipped);
+    TEST_ASSERT_EQUAL((int)CommandStatus::NotFound, (int)result.firstError);
+    TEST_ASSERT_EQUAL_STRING("OK\nERROR: Command not found.\nERROR: No arguments expected.\nOK", buffer);
+
+    // Stop: the commands after the first failure are skipped.
+    output.clear();
+    result = router.executeBatch("relay on;relay on 1;relay on;legacy echo", output, BatchMode::StopOnError);
+    TEST_ASSERT_EQUAL(2, result.executed);
+    TEST_ASSERT_EQUAL(1, result.failed);
+    TEST_ASSERT_EQUAL(2, result.skipped);
+    TEST_ASSERT_EQUAL((int)CommandStatus::BadArguments, (int)result.firstError);
+    TEST_ASSERT_EQUAL_STRING("OK\nERROR: No arguments expected.", buffer);
+
+    // An overlong command ends at its separator like any other.
+    output.clear();
+    result = router.executeBatch("relay on 1 2 3 4 5 6 7 8 9\nrelay on", output);
+    TEST_ASSERT_EQUAL(2, result.executed);
+    TEST_ASSERT_EQUAL(1, result.failed);
+    TEST_ASSERT_EQUAL_STRING("ERROR: Too many arguments (at most 8).\nOK", buffer);
+
+    output.clear();
+    result = router.executeBatch(" ;\n", output);
+    TEST_ASSERT_EQUAL(0, result.executed);
+    TEST_ASSERT_EQUAL(0, output.length());
+}
+
+void test_typed_handlers_get_decoded_arguments(void) {
+    CommandRouter& router = CommandRouter::getInstance();
+    static int calls = 0;
+    router.registerCommand<int, float, bool, std::string_view>(
+        "dimmer", "set", [](int level, float rate, bool fade, std::string_view curve, CommandOutput& out) {
+            calls++;
+            out.print("OK: ").print(level).print(' ').print(rate, 1).print(' ').print(fade).print(' ').print(curve);
+            return CommandStatus::Ok;
+        });
+    router.registerCommand<uint8_t>("dimmer", "channel", [](uint8_t channel, CommandOutput& out) {
+        calls++;
+        out.print(channel);
+        return CommandStatus::Ok;
+    });
+    // No arguments: the handler takes only the output.
+    router.registerCommand("dimmer", "status", [](CommandOutput& out) {
+        out.print("OK: ").print(42u);
+        return CommandStatus::Ok;
+    });
+
+    char buffer[64];
+    CommandOutput output(buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL((int)CommandStatus::Ok, (int)router.execute("dimmer set -5 2.25 on log", output));
+    TEST_ASSERT_EQUAL_STRING("OK: -5 2.3 true log", buffer);
+    output.clear();
+    TEST_ASSERT_EQUAL((int)CommandStatus::Ok, (int)router.execute("dimmer channel 255", output));
+    TEST_ASSERT_EQUAL_STRING("255", buffer);
+    output.clear();
+    TEST_ASSERT_EQUAL((int)CommandStatus::Ok, (int)router.execute("dimmer status", output));
+    TEST_ASSERT_EQUAL_STRING("OK: 42", buffer);
+    TEST_ASSERT_EQUAL(2, calls);
+
+    // Rejected centrally: the handler never runs.
+    const char* const rejected[][2] = {
+        {"dimmer set 5", "ERROR: Expected 4 argument(s), got 1."},
+        {"dimmer set 5x 1 on log", "ERROR: Argument 1 must be an integer."},
+        {"dimmer set 5 fast on log", "ERROR: Argument 2 must be a number."},
+        {"dimmer set 5 1 maybe log", "ERROR: Argument 3 must be true or false."},
+        {"dimmer set 99999999999 1 on log", "ERROR: Argument 1 must be an integer."},
+        {"dimmer channel 256", "ERROR: Argument 1 must be a non-negative integer."},
+        {"dimmer channel -1", "ERROR: Argument 1 must be a non-negative integer."},
+        {"dimmer status now", "ERROR: Expected 0 argument(s), got 1."},
+    };
+    for (const auto& line : rejected) {
+        output.clear();
+        TEST_ASSERT_EQUAL((int)CommandStatus::BadArguments, (int)router.execute(line[0], output));
+        TEST_ASSERT_EQUAL_STRING(line[1], buffer);
+    }
+    TEST_ASSERT_EQUAL(2, calls);
+}
+
+void test_output_prints_typed_values(void) {
+    char buffer[128];
+    CommandOutput output(buffer, sizeof(buffer));
+    output.print(0).print(',').print(-7).print(',').print((int64_t)INT64_MIN).print(',').print((uint64_t)UINT64_MAX);
+    TEST_ASSERT_EQUAL_STRING("0,-7,-9223372036854775808,18446744073709551615", buffer);
+
+    output.clear();
+    output.print(3.14159).print(' ').print(-0.004).print(' ').print(2.5f, 0).print(' ').print(-1.05, 3).print(' ').print(7.0, 12);
+    TEST_ASSERT_EQUAL_STRING("3.14 0.00 3 -1.050 7.000000000", buffer);
+
+    output.clear();
+    output.print(1e12, 1).print(' ').print(false);
+    TEST_ASSERT_EQUAL_STRING("1000000000000.0 false", buffer);
+
+    long long wide;
+    unsigned long long unsignedWide;
+    TEST_ASSERT_TRUE(nextino::parseCommandArg("-9223372036854775808", wide));
+    TEST_ASSERT_TRUE(wide == INT64_MIN);
+    TEST_ASSERT_FALSE(nextino::parseCommandArg("9223372036854775808", wide));
+    TEST_ASSERT_TRUE(nextino::parseCommandArg("18446744073709551615", unsignedWide));
+    TEST_ASSERT_FALSE(nextino::parseCommandArg("18446744073709551616", unsignedWide));
+    TEST_ASSERT_FALSE(nextino::parseCommandArg("", wide));
+    TEST_ASSERT_FALSE(nextino::parseCommandArg("-", wide));
+    double number;
+    TEST_ASSERT_FALSE(nextino::parseCommandArg(" 1", number));
+    TEST_ASSERT_FALSE(nextino::parseCommandArg("1.5.", number));
+}
+
+// --- Asynchronous commands, on a simulated clock ---
+
+static uint64_t g_nowUs = 0;
+
+static uint64_t simulatedClock() {
+    return g_nowUs;
+}
+
+// Advances the clock and runs the Scheduler, as the main loop would.
+static void runFor(unsigned long ms) {
+    for (unsigned long i = 0; i <= ms; ++i) {
+        Scheduler::getInstance().loop();
+        g_nowUs += 1000;
+    }
+}
+
+struct AsyncResult {
+    int calls;
+    CommandStatus status;
+    char text[64];
+};
+
+static AsyncResult g_result;
+static PendingCommand g_pending;
+
+static void recordResult(CommandStatus status, std::string_view output) {
+    g_result.calls++;
+    g_result.status = status;
+    snprintf(g_result.text, sizeof(g_result.text), "%.*s", (int)output.size(), output.data());
+}
+
+static void registerAsyncCommands() {
+    Scheduler::getInstance().setTimeSource(simulatedClock);
+    g_result = AsyncResult{0, CommandStatus::Ok, ""};
+    CommandRouter& router = CommandRouter::getInstance();
+    router.registerCommand("sensor", "read", [](const CommandArgs&, PendingCommand pending) { g_pending = pending; });
+    router.registerCommand("sensor", "now", [](const CommandArgs& args, PendingCommand pending) {
+        pending.complete(CommandStatus::Ok, args.empty() ? "OK" : args[0]);
+    });
+    router.registerCommand("sensor", "sync", [](const CommandArgs&, CommandOutput& out) {
+        out.print("OK: sync");
+        return CommandStatus::Ok;
+    });
+}
+
+void test_async_commands_complete_from_the_scheduler(void) {
+    registerAsyncCommands();
+    CommandRouter& router = CommandRouter::getInstance();
+
+    CommandToken token = router.executeAsync("sensor read", recordResult);
+    TEST_ASSERT_TRUE(token != 0);
+    TEST_ASSERT_TRUE(g_pending.isActive());
+    TEST_ASSERT_EQUAL(1, router.getPendingCount());
+    runFor(10);
+    TEST_ASSERT_EQUAL(0, g_result.calls);
+
+    // The result reaches the caller from the next Scheduler pass, not from complete().
+    TEST_ASSERT_TRUE(g_pending.complete(CommandStatus::Ok, [](CommandOutput& out) { out.print("OK: ").print(21.5, 1); }));
+    TEST_ASSERT_EQUAL(0, g_result.calls);
+    runFor(1);
+    TEST_ASSERT_EQUAL(1, g_result.calls);
+    TEST_ASSERT_EQUAL((int)CommandStatus::Ok, (int)g_result.status);
+    TEST_ASSERT_EQUAL_STRING("OK: 21.5", g_result.text);
+    TEST_ASSERT_EQUAL(0, router.getPendingCount());
+    TEST_ASSERT_FALSE(g_pending.isActive());
+    TEST_ASSERT_FALSE(g_pending.complete(CommandStatus::Ok, "late"));
+
+    // Handlers that finish at once, synchronous handlers and errors arrive the same way.
+    const char* const lines[] = {"sensor now ready", "sensor sync", "sensor reboot"};
+    const char* const texts[] = {"ready", "OK: sync", "ERROR: Command not found."};
+    const CommandStatus statuses[] = {CommandStatus::Ok, CommandStatus::Ok, CommandStatus::NotFound};
+    for (int i = 0; i < 3; ++i) {
+        g_result.calls = 0;
+        TEST_ASSERT_TRUE(router.executeAsync(lines[i], recordResult) != 0);
+        TEST_ASSERT_EQUAL(0, g_result.calls);
+        runFor(1);
+        TEST_ASSERT_EQUAL(1, g_result.calls);
+        TEST_ASSERT_EQUAL((int)statuses[i], (int)g_result.status);
+        TEST_ASSERT_EQUAL_STRING(texts[i], g_result.text);
+    }
+
+    // execute() answers at once if it can, and reports Pending otherwise.
+    char buffer[64];
+    CommandOutput output(buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL((int)CommandStatus::Ok, (int)router.execute("sensor now done", output));
+    TEST_ASSERT_EQUAL_STRING("done", buffer);
+    output.clear();
+    TEST_ASSERT_EQUAL((int)CommandStatus::Pending, (int)router.execute("sensor read", output));
+    TEST_ASSERT_EQUAL(0, strncmp(buffer, "PENDING: Command ", 17));
+    TEST_ASSERT_TRUE(g_pending.complete(CommandStatus::Ok, "OK"));
+    runFor(1);
+    TEST_ASSERT_EQUAL(0, router.getPendingCount());
+    Scheduler::getInstance().setTimeSource(nullptr);
+}
+
+void test_async_commands_time_out_and_cancel(void) {
+    registerAsyncCommands();
+    CommandRouter& router = CommandRouter::getInstance();
+
+    router.executeAsync("sensor read", recordResult, 100);
+    runFor(90);
+    TEST_ASSERT_EQUAL(0, g_result.calls);
+    runFor(20);
+    TEST_ASSERT_EQUAL(1, g_result.calls);
+    TEST_ASSERT_EQUAL((int)CommandStatus::TimedOut, (int)g_result.status);
+    TEST_ASSERT_EQUAL_STRING("ERROR: Command timed out.", g_result.text);
+    TEST_ASSERT_FALSE(g_pending.isActive());
+    TEST_ASSERT_FALSE(g_pending.complete(CommandStatus::Ok, "late"));
+
+    // A cancelled command never calls its completion, even once its handler finishes.
+    g_result.calls = 0;
+    CommandToken token = router.executeAsync("sensor read", recordResult, 100);
+    TEST_ASSERT_TRUE(router.cancel(token));
+    TEST_ASSERT_FALSE(router.cancel(token));
+    TEST_ASSERT_FALSE(g_pending.complete(CommandStatus::Ok, "late"));
+    runFor(200);
+    TEST_ASSERT_EQUAL(0, g_result.calls);
+
+    // The same goes for one whose result is ready but not yet delivered.
+    token = router.executeAsync("sensor now", recordResult);
+    TEST_ASSERT_TRUE(router.cancel(token));
+    runFor(1);
+    TEST_ASSERT_EQUAL(0, g_result.calls);
+
+    // The pool is fixed: past NEXTINO_COMMAND_MAX_PENDING, commands are refused.
+    CommandToken tokens[NEXTINO_COMMAND_MAX_PENDING];
+    for (int i = 0; i < NEXTINO_COMMAND_MAX_PENDING; ++i) {
+        tokens[i] = router.executeAsync("sensor read", recordResult, 0);
+        TEST_ASSERT_TRUE(tokens[i] != 0);
+    }
+    TEST_ASSERT_EQUAL(0, router.executeAsync("sensor read", recordResult));
+    TEST_ASSERT_EQUAL(NEXTINO_COMMAND_MAX_PENDING, router.getPendingCount());
+    for (CommandToken pending : tokens) {
+        TEST_ASSERT_TRUE(router.cancel(pending));
+    }
+    TEST_ASSERT_EQUAL(0, router.getPendingCount());
+    Scheduler::getInstance().setTimeSource(nullptr);
+}
+
+void test_batches_count_running_commands_as_pending(void) {
+    registerAsyncCommands();
+    CommandRouter& router = CommandRouter::getInstance();
+    char buffer[128];
+    CommandOutput output(buffer, sizeof(buffer));
+
+    // A command still running neither fails the batch nor stops it.
+    BatchResult result = router.executeBatch("sensor read; sensor now done; sensor sync", output, BatchMode::StopOnError);
+    TEST_ASSERT_EQUAL(3, result.executed);
+    TEST_ASSERT_EQUAL(0, result.failed);
+    TEST_ASSERT_EQUAL(0, result.skipped);
+    TEST_ASSERT_EQUAL(1, result.pending);
+    TEST_ASSERT_EQUAL((int)CommandStatus::Ok, (int)result.firstError);
+    TEST_ASSERT_EQUAL(0, strncmp(buffer, "PENDING: Command ", 17));
+    const char* rest = strchr(buffer, '\n');
+    TEST_ASSERT_EQUAL_STRING("\ndone\nOK: sync", rest ? rest : "");
+    TEST_ASSERT_TRUE(g_pending.complete(CommandStatus::Ok, "OK"));
+    runFor(1);
+    TEST_ASSERT_EQUAL(0, router.getPendingCount());
+
+    // The first real failure still stops the batch.
+    output.clear();
+    result = router.executeBatch("sensor read; sensor reboot; sensor sync", output, BatchMode::StopOnError);
+    TEST_ASSERT_EQUAL(2, result.executed);
+    TEST_ASSERT_EQUAL(1, result.failed);
+    TEST_ASSERT_EQUAL(1, result.skipped);
+    TEST_ASSERT_EQUAL(1, result.pending);
+    TEST_ASSERT_EQUAL((int)CommandStatus::NotFound, (int)result.firstError);
+    TEST_ASSERT_TRUE(g_pending.complete(CommandStatus::Ok, "OK"));
+    runFor(1);
+    TEST_ASSERT_EQUAL(0, router.getPendingCount());
+    Scheduler::getInstance().setTimeSource(nullptr);
+}
+
+#if !defined(ARDUINO)
+void test_execute_does_not_allocate(void) {
+    CommandRouter& router = CommandRouter::getInstance();
+    for (int i = 0; i < 20; ++i) {
+        char name[16];
+        snprintf(name, sizeof(name), "module_%d", i);
+        router.registerCommand(name, "set", [](const CommandArgs& args, CommandOutput& out) {
+            out.printf("OK: %.*s", (int)args[0].size(), args[0].data());
+            return CommandStatus::Ok;
+        });
+    }
+
+    char buffer[64];
+    CommandOutput output(buffer, sizeof(buffer));
+    size_t before = g_allocations;
+    for (int i = 0; i < 1000; ++i) {
+        output.clear();
+        router.execute("module_17 set 42", output);
+    }
+    TEST_ASSERT_EQUAL(before, g_allocations);
+    TEST_ASSERT_EQUAL_STRING("OK: 42", buffer);
+
+    output.clear();
+    BatchResult result = router.executeBatch("module_1 set 1;module_2 set 2;module_3 set 3", output);
+    TEST_ASSERT_EQUAL(before, g_allocations);
+    TEST_ASSERT_EQUAL(3, result.executed);
+
+    for (int i = 0; i < 1000; ++i) {
+        output.clear();
+        router.execute("dimmer set 70 0.5 off linear", output);
+    }
+    TEST_ASSERT_EQUAL(before, g_allocations);
+    TEST_ASSERT_EQUAL_STRING("OK: 70 0.5 false linear", buffer);
+
+    registerAsyncCommands();
+    before = g_allocations;
+    for (int i = 0; i < 100; ++i) {
+        router.executeAsync("sensor read", recordResult);
+        g_pending.complete(CommandStatus::Ok, "OK");
+        runFor(0);
+    }
+    TEST_ASSERT_EQUAL(before, g_allocations);
+    TEST_ASSERT_EQUAL(100, g_result.calls);
+    Scheduler::getInstance().setTimeSource(nullptr);
+}
+#endif
+
+void runAllTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_arguments_are_views_into_the_command_line);
+    RUN_TEST(test_errors_report_a_status_and_a_message);
+    RUN_TEST(test_output_is_cut_at_the_buffer_size);
+    RUN_TEST(test_string_handlers_and_execute_still_work);
+    RUN_TEST(test_declared_commands_use_the_generated_table);
+    RUN_TEST(test_batches_run_in_order_with_one_line_per_command);
+    RUN_TEST(test_typed_handlers_get_decoded_arguments);
+    RUN_TEST(test_output_prints_typed_values);
+    RUN_TEST(test_async_commands_complete_from_the_scheduler);
+    RUN_TEST(test_async_commands_time_out_and_cancel);
+    RUN_TEST(test_batches_count_running_commands_as_pending);
+#if !defined(ARDUINO)
+    RUN_TEST(test_execute_does_not_allocate);
+#endif
+}
+
+#if defined(ARDUINO)
+void setup() {
+    delay(2000);
+    runAllTests();
+}
+
+void loop() {
+    UNITY_END();
+}
+#else
+int main() {
+    runAllTests();
+    return UNITY_END();
+}
+#endif
@@ -9,9 +9,11 @@
  * @version     0.1.0
  */
 
-#include <Arduino.h>
 #include <unity.h>
+#include <vector>
+#include "core/Platform.h"
 #include "core/Scheduler.h"
+#include "modules/BaseModule.h"
 
 bool callbackWasCalled = false;
 
@@ -27,7 +29,7 @@ void tearDown(void) {}
 
 void test_scheduler_runs_a_task() {
     Scheduler& scheduler = Scheduler::getInstance();
-    scheduler.scheduleRecurring(10, test_callback_function);
+    Scheduler::TaskHandle handle = scheduler.scheduleRecurring(10, test_callback_function);
     
     unsigned long startTime = millis();
     while (millis() - startTime < 50) {
@@ -36,14 +38,447 @@ void test_scheduler_runs_a_task() {
     }
 
     TEST_ASSERT_TRUE(callbackWasCalled);
+    scheduler.cancel(handle);
 }
 
-void setup() {
-    delay(2000);
+void test_scheduler_fires_in_deadline_order() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    std::vector<int> order;
+    scheduler.scheduleOnce(30, [&order]() { order.push_back(30); });
+    scheduler.scheduleOnce(10, [&order]() { order.push_back(10); });
+    scheduler.scheduleOnce(20, [&order]() { order.push_back(20); });
+
+    unsigned long startTime = millis();
+    while (millis() - startTime < 60) {
+        scheduler.loop();
+        delay(1);
+    }
+
+    TEST_ASSERT_EQUAL(3, order.size());
+    TEST_ASSERT_EQUAL(10, order[0]);
+    TEST_ASSERT_EQUAL(20, order[1]);
+    TEST_ASSERT_EQUAL(30, order[2]);
+}
+
+void test_scheduler_cancel_from_own_callback() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    int runs = 0;
+    Scheduler::TaskHandle handle = 0;
+    handle = scheduler.scheduleRecurring(5, [&]() {
+        runs++;
+        scheduler.cancel(handle);
+    });
+    size_t countWithTask = scheduler.getTaskCount();
+
+    unsigned long startTime = millis();
+    while (millis() - startTime < 40) {
+        scheduler.loop();
+        delay(1);
+    }
+
+    TEST_ASSERT_EQUAL(1, runs);
+    TEST_ASSERT_EQUAL(countWithTask - 1, scheduler.getTaskCount());
+}
+
+class TestOwnerModule : public BaseModule {
+public:
+    TestOwnerModule() : BaseModule("test_owner") {}
+    const char* getName() const override { return "TestOwnerModule"; }
+};
+
+void test_scheduler_rejects_stale_handle_after_slot_reuse() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    Scheduler::TaskHandle first = scheduler.scheduleOnce(1000, []() {});
+    TEST_ASSERT_NOT_EQUAL(0, first);
+    TEST_ASSERT_TRUE(scheduler.cancel(first));
+
+    // The freed slot is reused first, but with a new generation.
+    Scheduler::TaskHandle second = scheduler.scheduleOnce(1000, []() {});
+    TEST_ASSERT_EQUAL(first & 0xFFFF, second & 0xFFFF);
+    TEST_ASSERT_NOT_EQUAL(first, second);
+
+    TEST_ASSERT_FALSE(scheduler.cancel(first));
+    TEST_ASSERT_TRUE(scheduler.cancel(second));
+    TEST_ASSERT_FALSE(scheduler.cancel(0));
+}
+
+void test_scheduler_cancel_all_owned_by_module() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    TestOwnerModule owner;
+    size_t before = scheduler.getTaskCount();
+
+    scheduler.scheduleRecurring(1000, []() {}, &owner);
+    scheduler.scheduleRecurring(2000, []() {}, &owner);
+    Scheduler::TaskHandle unowned = scheduler.scheduleOnce(1000, []() {});
+    scheduler.scheduleOnce(500, []() {}, &owner);
+    TEST_ASSERT_EQUAL(before + 4, scheduler.getTaskCount());
+
+    TEST_ASSERT_EQUAL(3, scheduler.cancelAllOwnedBy(&owner));
+    TEST_ASSERT_EQUAL(before + 1, scheduler.getTaskCount());
+    TEST_ASSERT_TRUE(scheduler.cancel(unowned));
+}
+
+void test_scheduler_pool_exhaustion_is_reported() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    SchedulerStats stats = scheduler.getStats();
+    std::vector<Scheduler::TaskHandle> handles;
+    for (size_t i = stats.activeTasks; i < stats.capacity; ++i) {
+        handles.push_back(scheduler.scheduleOnce(1000, []() {}));
+    }
+
+    TEST_ASSERT_EQUAL(0, scheduler.scheduleOnce(1000, []() {}));
+    stats = scheduler.getStats();
+    TEST_ASSERT_EQUAL(stats.capacity, stats.peakTasks);
+    TEST_ASSERT_EQUAL(1, stats.scheduleFailures);
+
+    for (auto handle : handles) {
+        TEST_ASSERT_TRUE(scheduler.cancel(handle));
+    }
+}
+
+unsigned long simulatedNowMs = 0;
+
+uint64_t simulatedClock() {
+    return (uint64_t)simulatedNowMs * 1000ULL;
+}
+
+// Advances the simulated clock in `stepMs` increments, running the loop each time.
+void runSimulated(unsigned long durationMs, unsigned long stepMs) {
+    unsigned long end = simulatedNowMs + durationMs;
+    while (simulatedNowMs < end) {
+        simulatedNowMs += stepMs;
+        Scheduler::getInstance().loop();
+    }
+}
+
+void test_recurring_task_does_not_drift() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    scheduler.setTimeSource(simulatedClock);
+    simulatedNowMs = 0;
+    int runs = 0;
+    Scheduler::TaskHandle handle = scheduler.scheduleRecurring(1000, [&runs]() { runs++; });
+
+    // The loop only comes around every 7 ms, so each run starts up to 6 ms late.
+    // Re-anchoring on the actual run time would lose a whole run over 100 s.
+    runSimulated(100000, 7);
+
+    TaskTimingStats stats;
+    TEST_ASSERT_TRUE(scheduler.getTaskTimingStats(handle, stats));
+    TEST_ASSERT_EQUAL(100, runs);
+    TEST_ASSERT_EQUAL(0, stats.missedPeriods);
+#if NEXTINO_SCHEDULER_TIMING_STATS
+    TEST_ASSERT_LESS_THAN(7000, stats.lateness.max);
+#endif
+    TEST_ASSERT_TRUE(scheduler.cancel(handle));
+    scheduler.setTimeSource(nullptr);
+}
+
+void test_missed_run_policies() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    scheduler.setTimeSource(simulatedClock);
+    const MissedRunPolicy policies[] = {MissedRunPolicy::Skip, MissedRunPolicy::CatchUp, MissedRunPolicy::Coalesce};
+    const int expectedStallRuns[] = {1, 4, 1};
+    const unsigned long expectedNextDeadline[] = {500, 500, 1000};
+
+    for (int p = 0; p < 3; ++p) {
+        simulatedNowMs = 0;
+        int runs = 0;
+        Scheduler::TaskHandle handle = scheduler.scheduleRecurring(1000, [&runs]() { runs++; });
+        scheduler.setMissedRunPolicy(handle, policies[p]);
+
+        // Stall the loop for 4.5 periods, then run a single pass.
+        simulatedNowMs = 4500;
+        scheduler.loop();
+        TEST_ASSERT_EQUAL(expectedStallRuns[p], runs);
+        TEST_ASSERT_EQUAL(expectedNextDeadline[p], scheduler.getTimeUntilNextDeadline());
+
+        TaskTimingStats stats;
+        scheduler.getTaskTimingStats(handle, stats);
+        TEST_ASSERT_EQUAL(policies[p] == MissedRunPolicy::CatchUp ? 0 : 3, stats.missedPeriods);
+        TEST_ASSERT_TRUE(scheduler.cancel(handle));
+    }
+    scheduler.setTimeSource(nullptr);
+}
+
+void test_lateness_and_jitter_statistics() {
+#if !NEXTINO_SCHEDULER_TIMING_STATS
+    TEST_IGNORE_MESSAGE("NEXTINO_SCHEDULER_TIMING_STATS is disabled.");
+#endif
+    Scheduler& scheduler = Scheduler::getInstance();
+    scheduler.setTimeSource(simulatedClock);
+    simulatedNowMs = 0;
+    Scheduler::TaskHandle handle = scheduler.scheduleRecurring(100, []() {});
+
+    // 200 runs: every run starts 2 ms late, except each 50th, which is 40 ms late.
+    for (int i = 1; i <= 200; ++i) {
+        simulatedNowMs = i * 100 + ((i % 50 == 0) ? 40 : 2);
+        scheduler.loop();
+    }
+
+    TaskTimingStats stats;
+    TEST_ASSERT_TRUE(scheduler.getTaskTimingStats(handle, stats));
+    TEST_ASSERT_EQUAL(200, stats.runs);
+    TEST_ASSERT_EQUAL(2000, stats.lateness.min);
+    TEST_ASSERT_EQUAL(40000, stats.lateness.max);
+    TEST_ASSERT_EQUAL(2760, stats.lateness.avg); // (196*2 + 4*40) / 200 ms
+    TEST_ASSERT_EQUAL(40000, stats.lateness.p99);
+    TEST_ASSERT_EQUAL(0, stats.jitter.min);
+    TEST_ASSERT_EQUAL(38000, stats.jitter.max);
+
+    TEST_ASSERT_TRUE(scheduler.resetTaskTimingStats(handle));
+    scheduler.getTaskTimingStats(handle, stats);
+    TEST_ASSERT_EQUAL(0, stats.runs);
+    TEST_ASSERT_TRUE(scheduler.cancel(handle));
+    scheduler.setTimeSource(nullptr);
+}
+
+void test_due_tasks_run_by_priority_then_deadline() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    scheduler.setTimeSource(simulatedClock);
+    simulatedNowMs = 0;
+    std::vector<int> order;
+    Scheduler::TaskHandle flush = scheduler.scheduleOnce(10, [&order]() { order.push_back(1); });
+    scheduler.scheduleOnce(40, [&order]() { order.push_back(2); });
+    scheduler.scheduleOnce(20, [&order]() { order.push_back(3); });
+    Scheduler::TaskHandle relay = scheduler.scheduleOnce(30, [&order]() { order.push_back(4); });
+    TEST_ASSERT_TRUE(scheduler.setTaskPriority(flush, TaskPriority::Low));
+    TEST_ASSERT_TRUE(scheduler.setTaskPriority(relay, TaskPriority::Critical));
+
+    // All four are due in the same pass.
+    simulatedNowMs = 50;
+    scheduler.loop();
+
+    TEST_ASSERT_EQUAL(4, order.size());
+    TEST_ASSERT_EQUAL(4, order[0]); // Critical
+    TEST_ASSERT_EQUAL(3, order[1]); // Normal, earlier deadline
+    TEST_ASSERT_EQUAL(2, order[2]); // Normal, later deadline
+    TEST_ASSERT_EQUAL(1, order[3]); // Low, despite the earliest deadline
+    scheduler.setTimeSource(nullptr);
+}
+
+void test_budget_overrun_is_counted_and_demotes() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    scheduler.setTimeSource(simulatedClock);
+    simulatedNowMs = 0;
+    uint32_t overrunsBefore = scheduler.getStats().budgetOverruns;
+    int runs = 0;
+    // Every other run "takes" 5 ms of simulated CPU time.
+    Scheduler::TaskHandle handle = scheduler.scheduleRecurring(100, [&runs]() {
+        runs++;
+        if (runs % 2 == 0) {
+            simulatedNowMs += 5;
+        }
+    });
+    scheduler.setTaskPriority(handle, TaskPriority::High);
+    TEST_ASSERT_TRUE(scheduler.setTaskBudget(handle, 2000, OverrunPolicy::Demote));
+
+    runSimulated(1000, 10);
+
+    TaskTimingStats stats;
+    TEST_ASSERT_TRUE(scheduler.getTaskTimingStats(handle, stats));
+    TEST_ASSERT_EQUAL(10, stats.runs);
+    TEST_ASSERT_EQUAL(5, stats.overruns);
+    TEST_ASSERT_EQUAL(overrunsBefore + 5, scheduler.getStats().budgetOverruns);
+#if NEXTINO_SCHEDULER_TIMING_STATS
+    TEST_ASSERT_EQUAL(0, stats.execution.min);
+    TEST_ASSERT_EQUAL(5000, stats.execution.max);
+#endif
+
+    // Demoted one class per overrun, stopping at Low.
+    TaskPriority priority;
+    TEST_ASSERT_TRUE(scheduler.getTaskPriority(handle, priority));
+    TEST_ASSERT_EQUAL((int)TaskPriority::Low, (int)priority);
+    TEST_ASSERT_TRUE(scheduler.cancel(handle));
+    scheduler.setTimeSource(nullptr);
+}
+
+// Sleeps like the SystemManager idle mode, straight to the next wake-up, for
+// `durationMs`. Returns the number of wake-ups.
+int runSleeping(unsigned long durationMs) {
+    Scheduler& scheduler = Scheduler::getInstance();
+    unsigned long end = simulatedNowMs + durationMs;
+    int wakeups = 0;
+    while (simulatedNowMs < end) {
+        unsigned long untilNext = scheduler.getTimeUntilNextDeadline();
+        simulatedNowMs += untilNext > 0 ? untilNext : 1;
+        scheduler.loop();
+        wakeups++;
+    }
+    return wakeups;
+}
+
+void test_slack_coalesces_nearby_deadlines() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    scheduler.setTimeSource(simulatedClock);
+    const unsigned long periods[] = {1000, 1000, 997}; // LED, sensor, heartbeat
+    int runs[3] = {0, 0, 0};
+    int wakeups[2];
+
+    for (int withSlack = 0; withSlack < 2; ++withSlack) {
+        simulatedNowMs = 0;
+        Scheduler::TaskHandle handles[3];
+        for (int t = 0; t < 3; ++t) {
+            runs[t] = 0;
+            int* counter = &runs[t];
+            handles[t] = scheduler.scheduleRecurring(periods[t], [counter]() { (*counter)++; });
+            if (withSlack) {
+                TEST_ASSERT_TRUE(scheduler.setTaskSlack(handles[t], 50));
+            }
+        }
+
+        wakeups[withSlack] = runSleeping(10000);
+
+        for (int t = 0; t < 3; ++t) {
+            TaskTimingStats stats;
+            TEST_ASSERT_TRUE(scheduler.getTaskTimingStats(handles[t], stats));
+            TEST_ASSERT_EQUAL(0, stats.missedPeriods);
+#if NEXTINO_SCHEDULER_TIMING_STATS
+            // Never started past its window.
+            TEST_ASSERT_TRUE(stats.lateness.max <= (withSlack ? 50000u : 0u));
+#endif
+            TEST_ASSERT_TRUE(scheduler.cancel(handles[t]));
+        }
+        TEST_ASSERT_EQUAL(10, runs[0]);
+        TEST_ASSERT_EQUAL(10, runs[2]); // No drift: 10 runs by 9970 ms
+    }
+
+    // Without slack the heartbeat wakes the loop 3 ms before the others every
+    // period; with 50 ms of slack all three share one wake-up.
+    TEST_ASSERT_EQUAL(20, wakeups[0]);
+    TEST_ASSERT_EQUAL(10, wakeups[1]);
+    scheduler.setTimeSource(nullptr);
+}
+
+void test_task_without_slack_is_never_held_back() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    scheduler.setTimeSource(simulatedClock);
+    simulatedNowMs = 0;
+    std::vector<int> order;
+    Scheduler::TaskHandle lazy = scheduler.scheduleOnce(10, [&order]() { order.push_back(1); });
+    scheduler.scheduleOnce(30, [&order]() { order.push_back(2); });
+    TEST_ASSERT_TRUE(scheduler.setTaskSlack(lazy, 100));
+
+    // The strict task decides the wake-up; the lazy one rides along with it.
+    TEST_ASSERT_EQUAL(30, scheduler.getTimeUntilNextDeadline());
+    simulatedNowMs = 29;
+    scheduler.loop();
+    TEST_ASSERT_EQUAL(0, order.size());
+    simulatedNowMs = 30;
+    scheduler.loop();
+    TEST_ASSERT_EQUAL(2, order.size());
+    TEST_ASSERT_EQUAL(1, order[0]); // Earlier deadline first within the batch
+    TEST_ASSERT_EQUAL(0, scheduler.getTaskCount());
+    scheduler.setTimeSource(nullptr);
+}
+
+void test_due_tasks_with_slack_join_the_pass() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    scheduler.setTimeSource(simulatedClock);
+    simulatedNowMs = 0;
+    std::vector<int> order;
+    Scheduler::TaskHandle lazy = scheduler.scheduleOnce(10, [&order]() { order.push_back(1); });
+    scheduler.scheduleOnce(15, [&order]() { order.push_back(2); });
+    scheduler.scheduleOnce(20, [&order]() { order.push_back(3); });
+    TEST_ASSERT_TRUE(scheduler.setTaskSlack(lazy, 50));
+
+    // The lazy task's key (60 ms) sits behind the 20 ms one, which is not due
+    // at 15 ms; it still joins the 15 ms pass, as its deadline has passed.
+    simulatedNowMs = 15;
+    scheduler.loop();
+    TEST_ASSERT_EQUAL(2, order.size());
+    if (order.size() == 2) {
+        TEST_ASSERT_EQUAL(1, order[0]);
+        TEST_ASSERT_EQUAL(2, order[1]);
+    }
+    simulatedNowMs = 20;
+    scheduler.loop();
+    TEST_ASSERT_EQUAL(3, order.size());
+    TEST_ASSERT_EQUAL(0, scheduler.getTaskCount());
+    scheduler.setTimeSource(nullptr);
+}
+
+uint64_t simulatedNowUs = 0;
+
+uint64_t simulatedMicrosClock() {
+    return simulatedNowUs;
+}
+
+void test_microsecond_recurring_task_runs_at_4khz() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    scheduler.setTimeSource(simulatedMicrosClock);
+    simulatedNowUs = 0;
+    int runs = 0;
+    Scheduler::TaskHandle handle = scheduler.scheduleRecurringMicros(250, [&runs]() { runs++; });
+    TEST_ASSERT_EQUAL(250, scheduler.getTimeUntilNextDeadlineMicros());
+    TEST_ASSERT_EQUAL(0, scheduler.getTimeUntilNextDeadline());
+
+    // One simulated second, with the loop coming around every 50 us.
+    while (simulatedNowUs < 1000000ULL) {
+        simulatedNowUs += 50;
+        scheduler.loop();
+    }
+
+    TaskTimingStats stats;
+    TEST_ASSERT_TRUE(scheduler.getTaskTimingStats(handle, stats));
+    TEST_ASSERT_EQUAL(4000, runs);
+    TEST_ASSERT_EQUAL(0, stats.missedPeriods);
+#if NEXTINO_SCHEDULER_TIMING_STATS
+    TEST_ASSERT_EQUAL(0, stats.lateness.max);
+#endif
+    TEST_ASSERT_TRUE(scheduler.cancel(handle));
+    scheduler.setTimeSource(nullptr);
+}
+
+void test_time_base_does_not_wrap_at_32_bits() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    scheduler.setTimeSource(simulatedMicrosClock);
+    // Just below the point where a 32-bit microsecond counter would wrap (~71.6 min).
+    simulatedNowUs = 0xFFFFFF00ULL;
+    int runs = 0;
+    Scheduler::TaskHandle handle = scheduler.scheduleOnceMicros(1000, [&runs]() { runs++; });
+
+    simulatedNowUs += 999;
+    scheduler.loop();
+    TEST_ASSERT_EQUAL(0, runs);
+    simulatedNowUs += 1;
+    scheduler.loop();
+    TEST_ASSERT_EQUAL(1, runs);
+    TEST_ASSERT_FALSE(scheduler.cancel(handle));
+    scheduler.setTimeSource(nullptr);
+}
+
+void runAllTests() {
     UNITY_BEGIN();
     RUN_TEST(test_scheduler_runs_a_task);
+    RUN_TEST(test_scheduler_fires_in_deadline_order);
+    RUN_TEST(test_scheduler_cancel_from_own_callback);
+    RUN_TEST(test_scheduler_rejects_stale_handle_after_slot_reuse);
+    RUN_TEST(test_scheduler_cancel_all_owned_by_module);
+    RUN_TEST(test_scheduler_pool_exhaustion_is_reported);
+    RUN_TEST(test_recurring_task_does_not_drift);
+    RUN_TEST(test_missed_run_policies);
+    RUN_TEST(test_lateness_and_jitter_statistics);
+    RUN_TEST(test_due_tasks_run_by_priority_then_deadline);
+    RUN_TEST(test_budget_overrun_is_counted_and_demotes);
+    RUN_TEST(test_slack_coalesces_nearby_deadlines);
+    RUN_TEST(test_task_without_slack_is_never_held_back);
+    RUN_TEST(test_due_tasks_with_slack_join_the_pass);
+    RUN_TEST(test_microsecond_recurring_task_runs_at_4khz);
+    RUN_TEST(test_time_base_does_not_wrap_at_32_bits);
+}
+
+#if defined(ARDUINO)
+void setup() {
+    delay(2000);
+    runAllTests();
 }
 
 void loop() {
     UNITY_END();
-}
\ No newline at end of file
+}
+#else
+int main() {
+    runAllTests();
+    return UNITY_END();
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,185 @@
+/**
+ * @file        test_coroutine.cpp
+ * @title       Unit Tests for Coroutine Tasks
+ * @description Verifies `NextinoTask` coroutines driven by the Scheduler and the
+ *              EventBus under a simulated clock, and the fixed frame pool.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-08-31
+ * @version     0.1.0
+ */
+
+#include <unity.h>
+#include <vector>
+#include "core/Platform.h"
+#include "core/Coroutine.h"
+#include "core/EventBus.h"
+#include "core/Scheduler.h"
+
+#if NEXTINO_HAS_COROUTINES
+
+unsigned long simulatedNowMs = 0;
+
+uint64_t simulatedClock() {
+    return (uint64_t)simulatedNowMs * 1000ULL;
+}
+
+// Advances the simulated clock in 1 ms steps, running the loop each time.
+void runFor(unsigned long durationMs) {
+    unsigned long end = simulatedNowMs + durationMs;
+    while (simulatedNowMs < end) {
+        simulatedNowMs++;
+        Scheduler::getInstance().loop();
+    }
+}
+
+std::vector<int> trace;
+
+NextinoTask blinkThreeTimes() {
+    for (int i = 0; i < 3; ++i) {
+        trace.push_back(1);
+        co_await nextino::sleep(100);
+        trace.push_back(0);
+        co_await nextino::sleep(100);
+    }
+}
+
+NextinoTask waitForPress() {
+    void* payload = co_await nextino::event("button_short_press");
+    trace.push_back(*static_cast<int*>(payload));
+    payload = co_await nextino::event("button_short_press");
+    trace.push_back(*static_cast<int*>(payload));
+}
+
+bool dataReady = false;
+
+NextinoTask readWithTimeout(unsigned long timeoutMs) {
+    bool ready = co_await nextino::until([]() { return dataReady; }, timeoutMs);
+    trace.push_back(ready ? 1 : 0);
+}
+
+NextinoTask waitForever() {
+    co_await nextino::event("never_posted");
+}
+
+void setUp(void) {
+    simulatedNowMs = 0;
+    dataReady = false;
+    trace.clear();
+    Scheduler::getInstance().setTimeSource(simulatedClock);
+}
+
+void tearDown(void) {
+    Scheduler::getInstance().setTimeSource(nullptr);
+}
+
+void test_sleep_resumes_on_schedule() {
+    size_t framesBefore = CoroutinePool::getInstance().getStats().activeFrames;
+    NextinoTask task = blinkThreeTimes();
+    TEST_ASSERT_TRUE(task.isValid());
+    TEST_ASSERT_EQUAL(1, trace.size()); // Runs eagerly up to the first co_await
+
+    runFor(99);
+    TEST_ASSERT_EQUAL(1, trace.size());
+    runFor(1);
+    TEST_ASSERT_EQUAL(2, trace.size());
+    runFor(500);
+
+    TEST_ASSERT_EQUAL(6, trace.size());
+    // The coroutine finished and gave its frame back.
+    TEST_ASSERT_EQUAL(framesBefore, CoroutinePool::getInstance().getStats().activeFrames);
+}
+
+void test_event_resumes_with_payload() {
+    waitForPress();
+    waitForPress();
+    TEST_ASSERT_EQUAL(0, trace.size());
+
+    int first = 7;
+    EventBus::getInstance().post("button_short_press", &first);
+    TEST_ASSERT_EQUAL(2, trace.size()); // Both waiters, once each
+    TEST_ASSERT_EQUAL(7, trace[0]);
+    TEST_ASSERT_EQUAL(7, trace[1]);
+
+    int second = 9;
+    EventBus::getInstance().post("button_short_press", &second);
+    TEST_ASSERT_EQUAL(4, trace.size());
+    TEST_ASSERT_EQUAL(9, trace[3]);
+}
+
+void test_until_returns_true_when_condition_holds() {
+    readWithTimeout(50);
+    runFor(10);
+    TEST_ASSERT_EQUAL(0, trace.size());
+
+    dataReady = true;
+    runFor(1);
+    TEST_ASSERT_EQUAL(1, trace.size());
+    TEST_ASSERT_EQUAL(1, trace[0]);
+}
+
+void test_until_times_out() {
+    readWithTimeout(50);
+    runFor(49);
+    TEST_ASSERT_EQUAL(0, trace.size());
+    runFor(1);
+    TEST_ASSERT_EQUAL(1, trace.size());
+    TEST_ASSERT_EQUAL(0, trace[0]);
+    TEST_ASSERT_EQUAL(0, Scheduler::getInstance().getTaskCount());
+}
+
+void test_frames_come_from_the_fixed_pool() {
+    CoroutineStats stats = CoroutinePool::getInstance().getStats();
+    size_t freeFrames = stats.capacity - stats.activeFrames;
+    for (size_t i = 0; i < freeFrames; ++i) {
+        TEST_ASSERT_TRUE(waitForever().isValid());
+    }
+
+    // The pool is full: the coroutine does not start, and nothing is allocated.
+    TEST_ASSERT_FALSE(waitForever().isValid());
+    stats = CoroutinePool::getInstance().getStats();
+    TEST_ASSERT_EQUAL(stats.capacity, stats.activeFrames);
+    TEST_ASSERT_EQUAL(1, stats.allocationFailures);
+    TEST_ASSERT_TRUE(stats.largestFrame <= stats.frameSize);
+}
+
+#else
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_coroutines_unavailable() {
+    TEST_IGNORE_MESSAGE("Coroutines need a C++20 compiler (-std=gnu++20).");
+}
+
+#endif
+
+void runAllTests() {
+    UNITY_BEGIN();
+#if NEXTINO_HAS_COROUTINES
+    RUN_TEST(test_sleep_resumes_on_schedule);
+    RUN_TEST(test_event_resumes_with_payload);
+    RUN_TEST(test_until_returns_true_when_condition_holds);
+    RUN_TEST(test_until_times_out);
+    RUN_TEST(test_frames_come_from_the_fixed_pool);
+#else
+    RUN_TEST(test_coroutines_unavailable);
+#endif
+}
+
+#if defined(ARDUINO)
+void setup() {
+    delay(2000);
+    runAllTests();
+}
+
+void loop() {
+    UNITY_END();
+}
+#else
+int main() {
+    runAllTests();
+    return UNITY_END();
+}
+#endif
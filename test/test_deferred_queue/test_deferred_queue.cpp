@@ -0,0 +1,205 @@
+/**
+ * @file        test_deferred_queue.cpp
+ * @title       Unit Tests for the Deferred Work Queue
+ * @description Verifies ordering, payload copies and the overflow counters of
+ *              the `DeferredQueue`, draining by the SystemManager, and, on the
+ *              host build, concurrent producers on several threads.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-01
+ * @version     0.1.0
+ */
+
+#include <unity.h>
+#include <vector>
+#include "core/Platform.h"
+#include "core/DeferredQueue.h"
+#include "core/SystemManager.h"
+
+#if !defined(ARDUINO)
+#include <thread>
+#endif
+
+struct Sample {
+    uint16_t producer;
+    uint16_t pin;
+    uint32_t sequence;
+};
+
+std::vector<Sample> received;
+int rawCalls = 0;
+size_t rawSize = 0;
+
+void onSample(const Sample& sample) {
+    received.push_back(sample);
+}
+
+void onRaw(const void*, size_t size) {
+    rawCalls++;
+    rawSize = size;
+}
+
+void drainAll() {
+    while (DeferredQueue::getInstance().drain() > 0) {
+    }
+}
+
+void setUp(void) {
+    drainAll();
+    received.clear();
+    rawCalls = 0;
+    rawSize = 0;
+    DeferredQueue::getInstance().resetStats();
+}
+
+void tearDown(void) {}
+
+void test_entries_run_in_order_with_their_payload() {
+    DeferredQueue& queue = DeferredQueue::getInstance();
+    for (uint32_t i = 0; i < 5; ++i) {
+        TEST_ASSERT_TRUE(queue.post(onSample, Sample{0, 13, i}));
+    }
+    uint8_t bytes[3] = {1, 2, 3};
+    TEST_ASSERT_TRUE(queue.post(onRaw, bytes, sizeof(bytes)));
+    TEST_ASSERT_FALSE(queue.isEmpty());
+    TEST_ASSERT_EQUAL(0, received.size()); // Nothing runs until drained
+
+    TEST_ASSERT_EQUAL(6, queue.drain());
+    TEST_ASSERT_TRUE(queue.isEmpty());
+    TEST_ASSERT_EQUAL(5, received.size());
+    for (uint32_t i = 0; i < 5; ++i) {
+        TEST_ASSERT_EQUAL(i, received[i].sequence);
+        TEST_ASSERT_EQUAL(13, received[i].pin);
+    }
+    TEST_ASSERT_EQUAL(1, rawCalls);
+    TEST_ASSERT_EQUAL(3, rawSize);
+}
+
+void test_drain_is_bounded_by_the_batch_size() {
+    DeferredQueue& queue = DeferredQueue::getInstance();
+    for (uint32_t i = 0; i < 10; ++i) {
+        queue.post(onSample, Sample{0, 0, i});
+    }
+    TEST_ASSERT_EQUAL(4, queue.drain(4));
+    TEST_ASSERT_EQUAL(6, queue.getStats().pending);
+    TEST_ASSERT_EQUAL(6, queue.drain());
+    TEST_ASSERT_EQUAL(10, received.size());
+}
+
+void test_full_queue_counts_drops_and_overflows() {
+    DeferredQueue& queue = DeferredQueue::getInstance();
+    for (uint32_t i = 0; i < NEXTINO_DEFERRED_QUEUE_SIZE; ++i) {
+        TEST_ASSERT_TRUE(queue.post(onSample, Sample{0, 0, i}));
+    }
+    // Three drops in one burst are one overflow.
+    TEST_ASSERT_FALSE(queue.post(onSample, Sample{0, 0, 100}));
+    TEST_ASSERT_FALSE(queue.post(onSample, Sample{0, 0, 101}));
+    TEST_ASSERT_FALSE(queue.post(onSample, Sample{0, 0, 102}));
+
+    DeferredQueueStats stats = queue.getStats();
+    TEST_ASSERT_EQUAL(NEXTINO_DEFERRED_QUEUE_SIZE, stats.posted);
+    TEST_ASSERT_EQUAL(3, stats.dropped);
+    TEST_ASSERT_EQUAL(1, stats.overflows);
+    TEST_ASSERT_EQUAL(NEXTINO_DEFERRED_QUEUE_SIZE, stats.peakDepth);
+
+    drainAll();
+    TEST_ASSERT_EQUAL(NEXTINO_DEFERRED_QUEUE_SIZE, received.size());
+    TEST_ASSERT_EQUAL(NEXTINO_DEFERRED_QUEUE_SIZE - 1, received.back().sequence);
+
+    // A new burst after draining is a second overflow.
+    for (uint32_t i = 0; i <= NEXTINO_DEFERRED_QUEUE_SIZE; ++i) {
+        queue.post(onSample, Sample{0, 0, i});
+    }
+    stats = queue.getStats();
+    TEST_ASSERT_EQUAL(4, stats.dropped);
+    TEST_ASSERT_EQUAL(2, stats.overflows);
+
+    // An oversized payload is dropped without counting as an overflow.
+    uint8_t tooLarge[NEXTINO_DEFERRED_PAYLOAD_SIZE + 1] = {0};
+    drainAll();
+    TEST_ASSERT_FALSE(queue.post(onRaw, tooLarge, sizeof(tooLarge)));
+    stats = queue.getStats();
+    TEST_ASSERT_EQUAL(5, stats.dropped);
+    TEST_ASSERT_EQUAL(2, stats.overflows);
+}
+
+void test_system_manager_loop_drains_the_queue() {
+    DeferredQueue& queue = DeferredQueue::getInstance();
+    for (uint32_t i = 0; i < NEXTINO_DEFERRED_BATCH_SIZE + 2; ++i) {
+        queue.post(onSample, Sample{0, 0, i});
+    }
+    SystemManager::getInstance().loop();
+    TEST_ASSERT_EQUAL(NEXTINO_DEFERRED_BATCH_SIZE, received.size());
+    SystemManager::getInstance().loop();
+    TEST_ASSERT_EQUAL(NEXTINO_DEFERRED_BATCH_SIZE + 2, received.size());
+    TEST_ASSERT_EQUAL(NEXTINO_DEFERRED_BATCH_SIZE + 2, queue.getStats().executed);
+}
+
+#if !defined(ARDUINO)
+void test_concurrent_producers_keep_per_producer_order() {
+    DeferredQueue& queue = DeferredQueue::getInstance();
+    const uint16_t PRODUCERS = 4;
+    const uint32_t PER_PRODUCER = 20000;
+
+    std::vector<std::thread> producers;
+    for (uint16_t p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (uint32_t i = 0; i < PER_PRODUCER; ++i) {
+                // Retry on full, like a task that can afford to wait.
+                while (!queue.post(onSample, Sample{p, 0, i})) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    const size_t total = (size_t)PRODUCERS * PER_PRODUCER;
+    while (received.size() < total) {
+        if (queue.drain() == 0) {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    std::vector<uint32_t> next(PRODUCERS, 0);
+    for (const Sample& sample : received) {
+        TEST_ASSERT_TRUE(sample.producer < PRODUCERS);
+        TEST_ASSERT_EQUAL(next[sample.producer], sample.sequence);
+        next[sample.producer]++;
+    }
+    DeferredQueueStats stats = queue.getStats();
+    TEST_ASSERT_EQUAL(total, stats.posted);
+    TEST_ASSERT_EQUAL(total, stats.executed);
+    TEST_ASSERT_TRUE(queue.isEmpty());
+    TEST_ASSERT_TRUE(stats.peakDepth <= NEXTINO_DEFERRED_QUEUE_SIZE);
+}
+#endif
+
+void runAllTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_entries_run_in_order_with_their_payload);
+    RUN_TEST(test_drain_is_bounded_by_the_batch_size);
+    RUN_TEST(test_full_queue_counts_drops_and_overflows);
+    RUN_TEST(test_system_manager_loop_drains_the_queue);
+#if !defined(ARDUINO)
+    RUN_TEST(test_concurrent_producers_keep_per_producer_order);
+#endif
+}
+
+#if defined(ARDUINO)
+void setup() {
+    delay(2000);
+    runAllTests();
+}
+
+void loop() {
+    UNITY_END();
+}
+#else
+int main() {
+    runAllTests();
+    return UNITY_END();
+}
+#endif
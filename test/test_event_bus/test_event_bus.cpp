@@ -0,0 +1,750 @@
+/**
+ * @file        test_event_bus.cpp
+ * @title       Unit Tests for the EventBus
+ * @description Verifies compile-time event IDs, delivery through the flat event
+ *              table, compatibility with string event names, typed channels,
+ *              queued dispatch with priorities and full-queue policies,
+ *              unsubscribing, including from within a dispatch, MQTT-style
+ *              topic filters, per-event rate controls, and posting from other
+ *              threads in multi-producer mode.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-02
+ * @version     0.1.0
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "core/Platform.h"
+#include "core/EventBus.h"
+#include "core/EventChannel.h"
+#include "core/Scheduler.h"
+
+#if !defined(ARDUINO)
+#include <atomic>
+#include <thread>
+#endif
+
+// Computed by the compiler; a non-constant hash would fail to build here.
+constexpr EventId TEMPERATURE("test_temperature");
+static_assert(TEMPERATURE.value == EventId::hash("test_temperature"), "EventId must be constexpr");
+static_assert(EventId("").value == 2166136261u, "FNV-1a offset basis");
+static_assert(EventId("a").value == 0xe40c292cu, "FNV-1a of \"a\"");
+static_assert(NEXTINO_EVENT("x") != NEXTINO_EVENT("y"), "distinct names, distinct IDs");
+
+void setUp(void) {
+    EventBus& bus = EventBus::getInstance();
+    while (bus.dispatchQueued() > 0) {
+    }
+    bus.setQueueFullPolicy(QueueFullPolicy::DropOldest);
+    bus.resetQueueStats();
+}
+
+void tearDown(void) {}
+
+std::vector<int> received;
+
+void test_names_and_ids_reach_the_same_listeners() {
+    EventBus& bus = EventBus::getInstance();
+    bus.on("test_temperature", [](void* payload) { received.push_back(*static_cast<int*>(payload)); });
+    bus.on(TEMPERATURE, [](void* payload) { received.push_back(-*static_cast<int*>(payload)); });
+
+    int value = 21;
+    bus.post(TEMPERATURE, &value);
+    bus.post("test_temperature", &value);
+    bus.post(std::string("test_temperature"), &value);
+    bus.post(NEXTINO_EVENT("test_temperature"), &value);
+
+    TEST_ASSERT_EQUAL(8, received.size());
+    for (size_t i = 0; i < received.size(); i += 2) {
+        TEST_ASSERT_EQUAL(21, received[i]); // Listeners run in subscription order
+        TEST_ASSERT_EQUAL(-21, received[i + 1]);
+    }
+}
+
+void test_post_without_listeners_is_a_no_op() {
+    EventBus& bus = EventBus::getInstance();
+    int calls = 0;
+    EventBus::Subscription subscription = bus.on("test_somebody_listens", [&calls](void*) { calls++; });
+    bus.post("test_nobody_listens");
+    bus.post(EventId::fromValue(0xdeadbeef));
+    TEST_ASSERT_EQUAL(0, calls);
+    TEST_ASSERT_TRUE(bus.off(subscription)); // `calls` goes out of scope
+}
+
+void test_many_events_are_kept_apart() {
+    EventBus& bus = EventBus::getInstance();
+    const int COUNT = NEXTINO_EVENTBUS_MAX_EVENTS / 2;
+    std::vector<int> hits(COUNT, 0);
+    char name[32];
+    for (int i = 0; i < COUNT; ++i) {
+        snprintf(name, sizeof(name), "test_sensor_%d", i);
+        int* hit = &hits[i];
+        bus.on(name, [hit](void*) { (*hit)++; });
+    }
+
+    for (int i = 0; i < COUNT; ++i) {
+        snprintf(name, sizeof(name), "test_sensor_%d", i);
+        for (int n = 0; n <= i % 3; ++n) {
+            bus.post(name);
+        }
+    }
+    for (int i = 0; i < COUNT; ++i) {
+        TEST_ASSERT_EQUAL(i % 3 + 1, hits[i]);
+    }
+}
+
+#if NEXTINO_EVENTBUS_CHECK_NAMES
+void test_names_with_the_same_hash_are_rejected() {
+    // "evt/149599" and "evt/312382" both hash to 0x42602b42.
+    TEST_ASSERT_EQUAL(EventId("evt/149599").value, EventId("evt/312382").value);
+    EventBus& bus = EventBus::getInstance();
+    static int hits = 0;
+    EventBus::Subscription first = bus.on("evt/149599", [](void*) { hits++; });
+    TEST_ASSERT_TRUE(first != 0);
+    TEST_ASSERT_EQUAL(0, bus.on("evt/312382", [](void*) { hits++; }));
+
+    bus.post(std::string("evt/149599"));
+    bus.post("evt/312382");
+    TEST_ASSERT_FALSE(bus.postAsync("evt/312382"));
+    bus.post(EventId::fromValue(EventId("evt/149599").value)); // Only the hash: not checked
+    TEST_ASSERT_EQUAL(2, hits);
+    TEST_ASSERT_TRUE(bus.off(first));
+}
+#endif
+
+// Counts copies, to prove typed delivery passes the publisher's object by reference.
+struct TempReading {
+    float celsius;
+    static int copies;
+    explicit TempReading(float c) : celsius(c) {}
+    TempReading(const TempReading& other) : celsius(other.celsius) { copies++; }
+};
+int TempReading::copies = 0;
+
+constexpr EventChannel<TempReading> TEMPERATURE_CHANNEL("test_typed_temperature");
+
+// Listeners stay subscribed for the rest of the run, so their state lives here.
+std::vector<const TempReading*> seen;
+float sum = 0;
+void* legacy = nullptr;
+
+void test_typed_channel_delivers_by_reference() {
+    TEST_ASSERT_TRUE(TEMPERATURE_CHANNEL.on([](const TempReading& reading) {
+        seen.push_back(&reading);
+        sum += reading.celsius;
+    }));
+    // A legacy listener of the same event still gets a void* to the same object.
+    EventBus::getInstance().on("test_typed_temperature", [](void* payload) { legacy = payload; });
+
+    TempReading::copies = 0;
+    TempReading reading(21.5f);
+    TEST_ASSERT_TRUE(TEMPERATURE_CHANNEL.post(reading));
+
+    TEST_ASSERT_EQUAL(0, TempReading::copies);
+    TEST_ASSERT_EQUAL(1, seen.size());
+    TEST_ASSERT_TRUE(seen[0] == &reading);
+    TEST_ASSERT_TRUE(legacy == &reading);
+    TEST_ASSERT_EQUAL_FLOAT(21.5f, sum);
+}
+
+void test_typed_channel_rejects_another_type() {
+    constexpr EventChannel<int> WRONG("test_typed_temperature");
+    TEST_ASSERT_FALSE(WRONG.on([](const int&) { TEST_FAIL_MESSAGE("wrong type delivered"); }));
+    TEST_ASSERT_FALSE(WRONG.post(5));
+    TEST_ASSERT_EQUAL(1, seen.size());
+
+    // The same name with the right type is the same channel.
+    constexpr EventChannel<TempReading> SAME(EventId("test_typed_temperature"));
+    TEST_ASSERT_TRUE(SAME.id() == TEMPERATURE_CHANNEL.id());
+    TEST_ASSERT_TRUE(SAME.post(TempReading(1.0f)));
+    TEST_ASSERT_EQUAL(2, seen.size());
+}
+
+void test_untyped_posts_cannot_reach_typed_listeners() {
+    EventBus& bus = EventBus::getInstance();
+    int value = 5;
+    legacy = &value;
+
+    // Without a payload, only the plain listener runs.
+    bus.post("test_typed_temperature");
+    TEST_ASSERT_NULL(legacy);
+    TEST_ASSERT_EQUAL(2, seen.size());
+
+    // A payload of unknown type is rejected outright.
+    legacy = &value;
+    bus.post("test_typed_temperature", &value);
+    TEST_ASSERT_TRUE(legacy == &value);
+    TEST_ASSERT_FALSE(bus.postAsync("test_typed_temperature", &value, sizeof(value)));
+    TEST_ASSERT_FALSE(bus.postAsync("test_typed_temperature", EventPayload<int>::make(5)));
+
+    TEST_ASSERT_TRUE(bus.postAsync("test_typed_temperature"));
+    TEST_ASSERT_EQUAL(1, bus.dispatchQueued());
+    TEST_ASSERT_NULL(legacy);
+    TEST_ASSERT_EQUAL(2, seen.size());
+}
+
+std::vector<int> queuedTrace;
+
+void traceInt(void* payload) {
+    queuedTrace.push_back(*static_cast<int*>(payload));
+}
+
+void test_queued_events_wait_and_run_by_priority() {
+    EventBus& bus = EventBus::getInstance();
+    bus.on("test_queued", traceInt);
+    queuedTrace.clear();
+
+    int value = 1;
+    TEST_ASSERT_TRUE(bus.postAsync("test_queued", &value, sizeof(value), EventPriority::Low));
+    value = 2;
+    bus.postAsync("test_queued", &value, sizeof(value));
+    value = 3;
+    bus.postAsync("test_queued", &value, sizeof(value), EventPriority::High);
+    value = 4;
+    bus.postAsync("test_queued", &value, sizeof(value));
+    value = 99; // The payloads were copied
+
+    TEST_ASSERT_TRUE(bus.hasQueuedEvents());
+    TEST_ASSERT_EQUAL(0, queuedTrace.size());
+    TEST_ASSERT_EQUAL(4, bus.dispatchQueued());
+    TEST_ASSERT_FALSE(bus.hasQueuedEvents());
+
+    const int expected[] = {3, 2, 4, 1}; // High, then Normal FIFO, then Low
+    TEST_ASSERT_EQUAL(4, queuedTrace.size());
+    for (int i = 0; i < 4; ++i) {
+        TEST_ASSERT_EQUAL(expected[i], queuedTrace[i]);
+    }
+
+    EventQueueStats stats = bus.getQueueStats();
+    TEST_ASSERT_EQUAL(4, stats.posted);
+    TEST_ASSERT_EQUAL(4, stats.dispatched);
+    TEST_ASSERT_EQUAL(4, stats.peakDepth);
+    TEST_ASSERT_EQUAL(4, stats.latency.count);
+}
+
+int chainRuns = 0;
+const int CHAIN_LENGTH = 100;
+
+void test_listener_posting_again_does_not_recurse() {
+    EventBus& bus = EventBus::getInstance();
+    chainRuns = 0;
+    // Each delivery queues the next one; synchronously this would recurse 100 deep.
+    bus.on("test_chain", [](void*) {
+        if (++chainRuns < CHAIN_LENGTH) {
+            EventBus::getInstance().postAsync("test_chain");
+        }
+    });
+
+    bus.postAsync("test_chain");
+    TEST_ASSERT_EQUAL(1, bus.dispatchQueued(1));
+    TEST_ASSERT_EQUAL(1, chainRuns);
+    TEST_ASSERT_EQUAL(NEXTINO_EVENTBUS_BATCH_SIZE, bus.dispatchQueued()); // Bounded by the batch size
+    TEST_ASSERT_EQUAL(1 + NEXTINO_EVENTBUS_BATCH_SIZE, chainRuns);
+    while (bus.dispatchQueued() > 0) {
+    }
+    TEST_ASSERT_EQUAL(CHAIN_LENGTH, chainRuns);
+    TEST_ASSERT_EQUAL(1, bus.getQueueStats().peakDepth);
+}
+
+void test_queue_full_policies() {
+    EventBus& bus = EventBus::getInstance();
+    bus.on("test_full", traceInt);
+
+    const QueueFullPolicy policies[] = {QueueFullPolicy::DropOldest, QueueFullPolicy::DropNewest, QueueFullPolicy::Block};
+    for (int p = 0; p < 3; ++p) {
+        bus.setQueueFullPolicy(policies[p]);
+        bus.resetQueueStats();
+        queuedTrace.clear();
+        for (int i = 0; i < NEXTINO_EVENTBUS_QUEUE_SIZE; ++i) {
+            TEST_ASSERT_TRUE(bus.postAsync("test_full", &i, sizeof(i)));
+        }
+        int extra = 100;
+        bool accepted = bus.postAsync("test_full", &extra, sizeof(extra));
+        while (bus.dispatchQueued() > 0) {
+        }
+
+        EventQueueStats stats = bus.getQueueStats();
+        if (policies[p] == QueueFullPolicy::DropOldest) {
+            TEST_ASSERT_TRUE(accepted);
+            TEST_ASSERT_EQUAL(NEXTINO_EVENTBUS_QUEUE_SIZE, queuedTrace.size());
+            TEST_ASSERT_EQUAL(1, queuedTrace.front()); // Event 0 was discarded
+            TEST_ASSERT_EQUAL(1, stats.dropped);
+        } else if (policies[p] == QueueFullPolicy::DropNewest) {
+            TEST_ASSERT_FALSE(accepted);
+            TEST_ASSERT_EQUAL(NEXTINO_EVENTBUS_QUEUE_SIZE, queuedTrace.size());
+            TEST_ASSERT_EQUAL(NEXTINO_EVENTBUS_QUEUE_SIZE - 1, queuedTrace.back());
+            TEST_ASSERT_EQUAL(1, stats.dropped);
+        } else {
+            TEST_ASSERT_TRUE(accepted);
+            TEST_ASSERT_EQUAL(NEXTINO_EVENTBUS_QUEUE_SIZE + 1, queuedTrace.size()); // Nothing lost
+            TEST_ASSERT_EQUAL(0, queuedTrace.front()); // Delivered during the post
+            TEST_ASSERT_EQUAL(0, stats.dropped);
+            TEST_ASSERT_EQUAL(1, stats.blocked);
+        }
+    }
+
+    // Under Block, a listener that posts again can refill the slot it freed;
+    // the new event is then dropped rather than written over a queued one.
+    bus.on("test_full_echo", [](void*) {
+        int echo = -1;
+        EventBus::getInstance().postAsync("test_full", &echo, sizeof(echo));
+    });
+    bus.resetQueueStats();
+    for (int i = 0; i < NEXTINO_EVENTBUS_QUEUE_SIZE; ++i) {
+        TEST_ASSERT_TRUE(bus.postAsync("test_full_echo"));
+    }
+    TEST_ASSERT_FALSE(bus.postAsync("test_full_echo"));
+    EventQueueStats stats = bus.getQueueStats();
+    TEST_ASSERT_EQUAL(NEXTINO_EVENTBUS_QUEUE_SIZE, stats.depth);
+    TEST_ASSERT_EQUAL(1, stats.dropped);
+    while (bus.dispatchQueued() > 0) {
+    }
+    TEST_ASSERT_EQUAL(NEXTINO_EVENTBUS_QUEUE_SIZE, bus.getQueueStats().peakDepth);
+    bus.setQueueFullPolicy(QueueFullPolicy::DropOldest);
+}
+
+void test_typed_channel_can_queue_a_copy() {
+    struct Sample { uint16_t pin; uint32_t at; };
+    static constexpr EventChannel<Sample> SAMPLES("test_typed_samples");
+    static Sample last = {0, 0};
+    SAMPLES.on([](const Sample& sample) { last = sample; });
+
+    Sample sample = {4, 1234};
+    TEST_ASSERT_TRUE(SAMPLES.postAsync(sample, EventPriority::High));
+    sample.at = 0;
+    TEST_ASSERT_EQUAL(0, last.at);
+    EventBus::getInstance().dispatchQueued();
+    TEST_ASSERT_EQUAL(4, last.pin);
+    TEST_ASSERT_EQUAL(1234, last.at);
+
+    constexpr EventChannel<int> WRONG("test_typed_samples");
+    TEST_ASSERT_FALSE(WRONG.postAsync(1));
+}
+
+std::vector<char> trace;
+
+void test_off_removes_only_that_listener() {
+    EventBus& bus = EventBus::getInstance();
+    EventBus::Subscription a = bus.on("test_off", [](void*) { trace.push_back('a'); });
+    EventBus::Subscription b = bus.on("test_off", [](void*) { trace.push_back('b'); });
+    EventBus::Subscription c = bus.on("test_off", [](void*) { trace.push_back('c'); });
+    TEST_ASSERT_TRUE(a != 0 && b != 0 && c != 0);
+    TEST_ASSERT_TRUE(a != b && b != c);
+
+    TEST_ASSERT_TRUE(bus.off(b));
+    TEST_ASSERT_FALSE(bus.off(b)); // Stale
+    TEST_ASSERT_FALSE(bus.off(0));
+    trace.clear();
+    bus.post("test_off");
+    TEST_ASSERT_EQUAL(2, trace.size());
+    TEST_ASSERT_EQUAL('a', trace[0]);
+    TEST_ASSERT_EQUAL('c', trace[1]);
+
+    // The freed slot is reused under a new generation; the old handle stays stale.
+    EventBus::Subscription d = bus.on("test_off", [](void*) { trace.push_back('d'); });
+    TEST_ASSERT_TRUE(d != b);
+    TEST_ASSERT_FALSE(bus.off(b));
+    trace.clear();
+    bus.post("test_off");
+    TEST_ASSERT_EQUAL(3, trace.size());
+    TEST_ASSERT_EQUAL('d', trace[2]); // Appended in subscription order
+
+    TEST_ASSERT_TRUE(bus.off(a));
+    TEST_ASSERT_TRUE(bus.off(c));
+    TEST_ASSERT_TRUE(bus.off(d));
+    trace.clear();
+    bus.post("test_off");
+    TEST_ASSERT_EQUAL(0, trace.size());
+}
+
+EventBus::Subscription self = 0;
+EventBus::Subscription victim = 0;
+EventBus::Subscription late = 0;
+int selfRuns = 0;
+
+void test_subscribing_and_unsubscribing_during_dispatch() {
+    EventBus& bus = EventBus::getInstance();
+    self = bus.on("test_reentrant", [](void*) {
+        EventBus& bus = EventBus::getInstance();
+        selfRuns++;
+        trace.push_back('s');
+        TEST_ASSERT_TRUE(bus.off(self));   // Removes the running listener
+        TEST_ASSERT_TRUE(bus.off(victim)); // Removes one that has not run yet
+        late = bus.on("test_reentrant", [](void*) { trace.push_back('l'); });
+        bus.post("test_reentrant"); // Nested: sees neither the removed nor the new listener
+    });
+    victim = bus.on("test_reentrant", [](void*) { trace.push_back('v'); });
+    bus.on("test_reentrant", [](void*) { trace.push_back('k'); });
+
+    trace.clear();
+    bus.post("test_reentrant");
+    TEST_ASSERT_EQUAL(1, selfRuns);
+    const char first[] = {'s', 'k', 'k'}; // Nested post delivers 'k' first
+    TEST_ASSERT_EQUAL(3, trace.size());
+    for (int i = 0; i < 3; ++i) {
+        TEST_ASSERT_EQUAL(first[i], trace[i]);
+    }
+
+    // Compacted after the outer post: the new listener now runs, last.
+    trace.clear();
+    bus.post("test_reentrant");
+    TEST_ASSERT_EQUAL(1, selfRuns);
+    TEST_ASSERT_EQUAL(2, trace.size());
+    TEST_ASSERT_EQUAL('k', trace[0]);
+    TEST_ASSERT_EQUAL('l', trace[1]);
+    TEST_ASSERT_TRUE(bus.off(late));
+}
+
+std::string delivered(const char* topic) {
+    trace.clear();
+    EventBus::getInstance().post(topic);
+    return std::string(trace.begin(), trace.end());
+}
+
+void test_topic_filters_match_like_mqtt() {
+    EventBus& bus = EventBus::getInstance();
+    EventBus::Subscription subscriptions[] = {
+        bus.on("t/sensor/kitchen/temperature", [](void*) { trace.push_back('e'); }), // Exact
+        bus.on("t/sensor/+/temperature", [](void*) { trace.push_back('p'); }),
+        bus.on("t/sensor/#", [](void*) { trace.push_back('h'); }),
+        bus.on("t/+/kitchen/#", [](void*) { trace.push_back('k'); }),
+    };
+    for (EventBus::Subscription subscription : subscriptions) {
+        TEST_ASSERT_TRUE(subscription != 0);
+    }
+
+    TEST_ASSERT_EQUAL_STRING("ehpk", delivered("t/sensor/kitchen/temperature").c_str()); // Exact listeners first
+    TEST_ASSERT_EQUAL_STRING("hk", delivered("t/sensor/kitchen/humidity").c_str());
+    TEST_ASSERT_EQUAL_STRING("hk", delivered("t/sensor/kitchen/temperature/raw").c_str());
+    TEST_ASSERT_EQUAL_STRING("hp", delivered("t/sensor//temperature").c_str()); // `+` matches an empty level
+    TEST_ASSERT_EQUAL_STRING("h", delivered("t/sensor").c_str());               // `#` matches the parent too
+    TEST_ASSERT_EQUAL_STRING("k", delivered("t/sensors/kitchen").c_str());
+    TEST_ASSERT_EQUAL_STRING("", delivered("t/sensors/hall").c_str());
+    TEST_ASSERT_EQUAL_STRING("", delivered("t").c_str());
+
+    // Constant IDs and std::string names carry the name; bare hashes reach exact listeners only.
+    constexpr EventId KITCHEN("t/sensor/kitchen/temperature");
+    trace.clear();
+    bus.post(KITCHEN);
+    bus.post(std::string("t/sensor/hall/temperature"));
+    bus.post(EventId::fromValue(KITCHEN.value));
+    TEST_ASSERT_EQUAL_STRING("ehpkhpe", std::string(trace.begin(), trace.end()).c_str());
+
+    for (EventBus::Subscription subscription : subscriptions) {
+        TEST_ASSERT_TRUE(bus.off(subscription));
+    }
+    TEST_ASSERT_EQUAL_STRING("", delivered("t/sensor/kitchen/temperature").c_str());
+}
+
+void test_topic_filter_subscriptions_are_handles_too() {
+    EventBus& bus = EventBus::getInstance();
+    TEST_ASSERT_EQUAL(0, bus.on("t/#/temperature", [](void*) {})); // `#` must come last
+    TEST_ASSERT_TRUE(bus.on("t/c#/+x", [](void*) {}) != 0);         // Exact: no level is a wildcard
+
+    EventBus::Subscription first = bus.on("t/+", [](void*) { trace.push_back('1'); });
+    EventBus::Subscription second = bus.on("t/+", [](void*) { trace.push_back('2'); });
+    TEST_ASSERT_EQUAL_STRING("12", delivered("t/x").c_str());
+    TEST_ASSERT_TRUE(bus.off(first));
+    TEST_ASSERT_FALSE(bus.off(first));
+    TEST_ASSERT_EQUAL_STRING("2", delivered("t/x").c_str());
+
+    // Typed channels need an exact event: wildcard payloads may differ in type.
+    constexpr EventChannel<int> ANY("t/+");
+    TEST_ASSERT_EQUAL(0, ANY.on([](const int&) {}));
+    TEST_ASSERT_TRUE(bus.off(second));
+}
+
+unsigned long simulatedNowMs = 0;
+
+uint64_t simulatedClock() {
+    return (uint64_t)simulatedNowMs * 1000ULL;
+}
+
+void test_min_interval_and_rate_limit_drop_excess_posts() {
+    EventBus& bus = EventBus::getInstance();
+    Scheduler::getInstance().setTimeSource(simulatedClock);
+    simulatedNowMs = 0;
+    bus.on("test_spaced", traceInt);
+    bus.on("test_limited", traceInt);
+    TEST_ASSERT_TRUE(bus.setEventRate("test_spaced", EventRateMode::MinInterval, 100));
+    TEST_ASSERT_TRUE(bus.setEventRate("test_limited", EventRateMode::RateLimit, 10, 3));
+
+    // A post every 10 ms for 300 ms: one per 100 ms gets through.
+    queuedTrace.clear();
+    for (int i = 0; i < 30; ++i, simulatedNowMs += 10) {
+        bus.post("test_spaced", &i);
+    }
+    TEST_ASSERT_EQUAL(3, queuedTrace.size());
+    TEST_ASSERT_EQUAL(10, queuedTrace[1]);
+    EventRateStats stats;
+    TEST_ASSERT_TRUE(bus.getEventRateStats("test_spaced", stats));
+    TEST_ASSERT_EQUAL(30, stats.posted);
+    TEST_ASSERT_EQUAL(3, stats.delivered);
+    TEST_ASSERT_EQUAL(27, stats.dropped);
+
+    // A burst of 5 spends the 3 tokens; 25 ms later 2 more have been refilled.
+    queuedTrace.clear();
+    for (int i = 0; i < 5; ++i) {
+        bus.post("test_limited", &i);
+    }
+    simulatedNowMs += 25;
+    for (int i = 5; i < 8; ++i) {
+        bus.postAsync("test_limited", &i, sizeof(i)); // Rejected before taking queue space
+    }
+    bus.dispatchQueued();
+    TEST_ASSERT_TRUE(bus.getEventRateStats("test_limited", stats));
+    TEST_ASSERT_EQUAL(8, stats.posted);
+    TEST_ASSERT_EQUAL(5, stats.delivered);
+    TEST_ASSERT_EQUAL(3, stats.dropped);
+    TEST_ASSERT_EQUAL(2, bus.getQueueStats().posted);
+    const int expected[] = {0, 1, 2, 5, 6};
+    TEST_ASSERT_EQUAL(5, queuedTrace.size());
+    for (int i = 0; i < 5; ++i) {
+        TEST_ASSERT_EQUAL(expected[i], queuedTrace[i]);
+    }
+
+    TEST_ASSERT_TRUE(bus.setEventRate("test_spaced", EventRateMode::Unlimited, 0));
+    TEST_ASSERT_TRUE(bus.setEventRate("test_limited", EventRateMode::Unlimited, 0));
+    TEST_ASSERT_FALSE(bus.getEventRateStats("test_spaced", stats));
+    Scheduler::getInstance().setTimeSource(nullptr);
+}
+
+void test_coalescing_delivers_only_the_newest_payload() {
+    EventBus& bus = EventBus::getInstance();
+    Scheduler& scheduler = Scheduler::getInstance();
+    scheduler.setTimeSource(simulatedClock);
+    simulatedNowMs = 0;
+    bus.on("test_coalesced", traceInt);
+    TEST_ASSERT_TRUE(bus.setEventRate("test_coalesced", EventRateMode::Coalesce, 100));
+    TEST_ASSERT_FALSE(bus.setEventRate("test/+", EventRateMode::Coalesce, 100));
+
+    // A value every 10 ms, as a sensor read every loop would post.
+    queuedTrace.clear();
+    for (int i = 1; i <= 10; ++i, simulatedNowMs += 10) {
+        bus.postAsync("test_coalesced", &i, sizeof(i));
+        bus.dispatchQueued();
+        scheduler.loop();
+    }
+    TEST_ASSERT_EQUAL(1, queuedTrace.size()); // The first value went straight through
+    TEST_ASSERT_EQUAL(1, queuedTrace[0]);
+
+    // The window ends at 100 ms: only the newest of the other nine is delivered.
+    scheduler.loop();
+    TEST_ASSERT_EQUAL(2, queuedTrace.size());
+    TEST_ASSERT_EQUAL(10, queuedTrace[1]);
+
+    EventRateStats stats;
+    TEST_ASSERT_TRUE(bus.getEventRateStats("test_coalesced", stats));
+    TEST_ASSERT_EQUAL(10, stats.posted);
+    TEST_ASSERT_EQUAL(2, stats.delivered);
+    TEST_ASSERT_EQUAL(8, stats.coalesced);
+    TEST_ASSERT_EQUAL(0, stats.dropped);
+    TEST_ASSERT_EQUAL(1, bus.getQueueStats().posted); // The coalesced ones never took queue space
+
+    TEST_ASSERT_TRUE(bus.setEventRate("test_coalesced", EventRateMode::Unlimited, 0));
+    scheduler.setTimeSource(nullptr);
+}
+
+void test_topic_filters_see_queued_events() {
+    EventBus& bus = EventBus::getInstance();
+    Scheduler& scheduler = Scheduler::getInstance();
+    scheduler.setTimeSource(simulatedClock);
+    simulatedNowMs = 0;
+    EventBus::Subscription filter = bus.on("q/sensor/+/temperature", traceInt);
+    TEST_ASSERT_TRUE(bus.setEventRate("q/sensor/attic/temperature", EventRateMode::Coalesce, 100));
+
+    // The name is copied when queued, so a temporary std::string is fine.
+    queuedTrace.clear();
+    int values[] = {1, 2, 3, 4};
+    TEST_ASSERT_TRUE(bus.postAsync(std::string("q/sensor/hall/temperature"), &values[0], sizeof(int)));
+    TEST_ASSERT_TRUE(bus.postAsync("q/sensor/kitchen/temperature", &values[1], sizeof(int), EventPriority::High));
+    TEST_ASSERT_TRUE(bus.postAsync("q/sensor/kitchen/humidity", &values[2], sizeof(int)));
+    TEST_ASSERT_EQUAL(3, bus.dispatchQueued());
+    TEST_ASSERT_EQUAL(2, queuedTrace.size());
+    TEST_ASSERT_EQUAL(2, queuedTrace[0]);
+    TEST_ASSERT_EQUAL(1, queuedTrace[1]);
+
+    // Coalesced payloads are delivered by a Scheduler task, with the name too.
+    bus.postAsync("q/sensor/attic/temperature", &values[0], sizeof(int));
+    bus.dispatchQueued();
+    bus.postAsync("q/sensor/attic/temperature", &values[3], sizeof(int));
+    simulatedNowMs += 100;
+    scheduler.loop();
+    TEST_ASSERT_EQUAL(4, queuedTrace.size());
+    TEST_ASSERT_EQUAL(4, queuedTrace[3]);
+
+#if !defined(ARDUINO)
+    // From another task, the name travels in the inbox cell.
+    bus.setMultiProducer(true);
+    std::thread other([&]() { bus.postAsync(std::string("q/sensor/cellar/temperature"), &values[2], sizeof(int)); });
+    other.join();
+    TEST_ASSERT_EQUAL(1, bus.dispatchQueued());
+    TEST_ASSERT_EQUAL(5, queuedTrace.size());
+    TEST_ASSERT_EQUAL(3, queuedTrace[4]);
+    bus.setMultiProducer(false);
+#endif
+
+    // Names no filter matches are not kept, so they cannot fill the event table.
+    for (int i = 0; i < 2 * NEXTINO_EVENTBUS_MAX_EVENTS; ++i) {
+        bus.postAsync(std::string("q/unheard/") + std::to_string(i));
+    }
+    while (bus.dispatchQueued() > 0) {
+    }
+    EventBus::Subscription late = bus.on("q/sensor/late", traceInt);
+    TEST_ASSERT_TRUE(late != 0);
+    TEST_ASSERT_TRUE(bus.off(late));
+
+    TEST_ASSERT_TRUE(bus.setEventRate("q/sensor/attic/temperature", EventRateMode::Unlimited, 0));
+    TEST_ASSERT_TRUE(bus.off(filter));
+    scheduler.setTimeSource(nullptr);
+}
+
+#if !defined(ARDUINO)
+struct ProducerPost {
+    uint16_t producer;
+    uint16_t sequence;
+};
+
+void test_posts_from_other_threads_run_on_the_owner() {
+    const uint16_t PRODUCERS = 4;
+    const uint16_t POSTS = 2000;
+    EventBus& bus = EventBus::getInstance();
+    bus.setMultiProducer(true);
+    TEST_ASSERT_TRUE(bus.isMultiProducer());
+
+    static std::vector<ProducerPost> received;
+    static bool allOnOwner;
+    received.clear();
+    allOnOwner = true;
+    static std::thread::id owner;
+    owner = std::this_thread::get_id();
+    EventBus::Subscription subscription = bus.on("test_multi_producer", [](void* payload) {
+        allOnOwner = allOnOwner && std::this_thread::get_id() == owner;
+        received.push_back(*static_cast<ProducerPost*>(payload));
+    });
+
+    // Producers retry when the inbox is full, so every post arrives.
+    std::atomic<uint32_t> retries(0);
+    std::vector<std::thread> producers;
+    for (uint16_t p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&, p]() {
+            for (uint16_t i = 0; i < POSTS; ++i) {
+                ProducerPost post = {p, i};
+                while (!bus.postAsync("test_multi_producer", &post, sizeof(post), (EventPriority)(p % 3))) {
+                    retries.fetch_add(1);
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    while (received.size() < (size_t)PRODUCERS * POSTS) {
+        if (bus.dispatchQueued() == 0) {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& thread : producers) {
+        thread.join();
+    }
+
+    TEST_ASSERT_TRUE(allOnOwner);
+    uint16_t next[PRODUCERS] = {0};
+    for (const ProducerPost& post : received) {
+        TEST_ASSERT_EQUAL(next[post.producer], post.sequence); // FIFO per producer
+        next[post.producer]++;
+    }
+    EventQueueStats stats = bus.getQueueStats();
+    TEST_ASSERT_EQUAL(PRODUCERS * POSTS, stats.forwarded);
+    TEST_ASSERT_EQUAL(PRODUCERS * POSTS, stats.dispatched);
+    TEST_ASSERT_EQUAL(retries.load(), stats.dropped); // Only full-inbox retries
+    TEST_ASSERT_FALSE(bus.hasQueuedEvents());
+
+    bus.off(subscription);
+    bus.setMultiProducer(false);
+}
+
+void test_other_threads_cannot_change_subscriptions() {
+    EventBus& bus = EventBus::getInstance();
+    bus.setMultiProducer(true);
+    static int calls;
+    calls = 0;
+    EventBus::Subscription subscription = bus.on("test_owner_only", [](void*) { calls++; });
+
+    // Unity cannot assert from another thread: collect the results first.
+    int value = 1;
+    bool rejected[4];
+    std::thread other([&]() {
+        rejected[0] = bus.on("test_owner_only", [](void*) { calls += 100; }) == 0;
+        rejected[1] = !bus.off(subscription);
+        rejected[2] = !bus.setEventRate("test_owner_only", EventRateMode::MinInterval, 100);
+        rejected[3] = bus.dispatchQueued() == 0;
+
+        bus.post("test_owner_only");         // Queued for the owner
+        bus.post("test_owner_only", &value); // Would dangle: dropped
+        char large[NEXTINO_EVENTBUS_PAYLOAD_SIZE + 1] = {};
+        bus.postAsync("test_owner_only", large, sizeof(large)); // Too large: dropped
+        EventPayload<int> shared = EventPayload<int>::make(5);
+        bus.post("test_owner_only", shared); // Queued with a reference
+    });
+    other.join();
+    for (bool wasRejected : rejected) {
+        TEST_ASSERT_TRUE(wasRejected);
+    }
+    TEST_ASSERT_EQUAL(0, calls); // Nothing ran on the other thread
+
+    // Both drops were counted at once; the owner logs them as it dispatches.
+    TEST_ASSERT_EQUAL(2, bus.getQueueStats().dropped);
+    TEST_ASSERT_EQUAL(2, bus.dispatchQueued());
+    TEST_ASSERT_EQUAL(2, calls);
+    TEST_ASSERT_EQUAL(2, bus.getQueueStats().dropped);
+
+    bus.off(subscription);
+    bus.setMultiProducer(false);
+}
+#endif
+
+void runAllTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_names_and_ids_reach_the_same_listeners);
+    RUN_TEST(test_post_without_listeners_is_a_no_op);
+    RUN_TEST(test_many_events_are_kept_apart);
+#if NEXTINO_EVENTBUS_CHECK_NAMES
+    RUN_TEST(test_names_with_the_same_hash_are_rejected);
+#endif
+    RUN_TEST(test_typed_channel_delivers_by_reference);
+    RUN_TEST(test_typed_channel_rejects_another_type);
+    RUN_TEST(test_untyped_posts_cannot_reach_typed_listeners);
+    RUN_TEST(test_queued_events_wait_and_run_by_priority);
+    RUN_TEST(test_listener_posting_again_does_not_recurse);
+    RUN_TEST(test_queue_full_policies);
+    RUN_TEST(test_typed_channel_can_queue_a_copy);
+    RUN_TEST(test_off_removes_only_that_listener);
+    RUN_TEST(test_subscribing_and_unsubscribing_during_dispatch);
+    RUN_TEST(test_topic_filters_match_like_mqtt);
+    RUN_TEST(test_topic_filter_subscriptions_are_handles_too);
+    RUN_TEST(test_min_interval_and_rate_limit_drop_excess_posts);
+    RUN_TEST(test_coalescing_delivers_only_the_newest_payload);
+    RUN_TEST(test_topic_filters_see_queued_events);
+#if !defined(ARDUINO)
+    RUN_TEST(test_posts_from_other_threads_run_on_the_owner);
+    RUN_TEST(test_other_threads_cannot_change_subscriptions);
+#endif
+}
+
+#if defined(ARDUINO)
+void setup() {
+    delay(2000);
+    runAllTests();
+}
+
+void loop() {
+    UNITY_END();
+}
+#else
+int main() {
+    runAllTests();
+    return UNITY_END();
+}
+#endif
@@ -0,0 +1,389 @@
+/**
+ * @file        test_event_payload.cpp
+ * @title       Unit and Soak Tests for Pooled Event Payloads
+ * @description Verifies the reference counting and size classes of the
+ *              EventPayloadPool, that queued, dropped and coalesced events
+ *              release their payloads, and soaks the pool with millions of
+ *              events of random size, priority and lifetime to show it neither
+ *              leaks nor fragments.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-03
+ * @version     0.1.0
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "core/Platform.h"
+#include "core/EventBus.h"
+#include "core/EventChannel.h"
+#include "core/EventPayload.h"
+
+#if defined(ARDUINO)
+static const uint32_t SOAK_EVENTS = 20000;
+#else
+static const uint32_t SOAK_EVENTS = 3000000;
+#endif
+
+static const size_t BLOCK_SIZES[EventPayloadPool::CLASS_COUNT] = {16, 32, 64, 128};
+
+struct Tracked {
+    static int alive;
+    int value;
+    explicit Tracked(int v) : value(v) { alive++; }
+    ~Tracked() { alive--; }
+};
+int Tracked::alive = 0;
+
+static size_t blocksInUse() {
+    size_t total = 0;
+    for (size_t c = 0; c < EventPayloadPool::CLASS_COUNT; ++c) {
+        total += EventPayloadPool::getInstance().getStats(c).inUse;
+    }
+    return total;
+}
+
+void setUp(void) {
+    EventBus& bus = EventBus::getInstance();
+    while (bus.dispatchQueued() > 0) {
+    }
+    bus.setQueueFullPolicy(QueueFullPolicy::DropOldest);
+    bus.resetQueueStats();
+    EventPayloadPool::getInstance().resetStats();
+}
+
+void tearDown(void) {}
+
+void test_last_reference_returns_the_block(void) {
+    EventPayloadPool& pool = EventPayloadPool::getInstance();
+    {
+        EventPayload<Tracked> first = EventPayload<Tracked>::make(7);
+        TEST_ASSERT_TRUE((bool)first);
+        TEST_ASSERT_TRUE(pool.owns(first.get()));
+        TEST_ASSERT_EQUAL(1, first.useCount());
+        TEST_ASSERT_EQUAL(1, Tracked::alive);
+
+        EventPayload<Tracked> second = first;
+        TEST_ASSERT_EQUAL(2, first.useCount());
+        TEST_ASSERT_EQUAL(7, second->value);
+
+        first.reset();
+        TEST_ASSERT_FALSE((bool)first);
+        TEST_ASSERT_EQUAL(1, second.useCount());
+        TEST_ASSERT_EQUAL(1, Tracked::alive); // Still referenced
+
+        EventPayload<Tracked> moved = std::move(second);
+        TEST_ASSERT_FALSE((bool)second);
+        TEST_ASSERT_EQUAL(1, moved.useCount());
+    }
+    TEST_ASSERT_EQUAL(0, Tracked::alive); // Destroyed exactly once
+    TEST_ASSERT_EQUAL(0, blocksInUse());
+
+    PayloadPoolStats stats = pool.getStats(0);
+    TEST_ASSERT_EQUAL(1, stats.allocations);
+    TEST_ASSERT_EQUAL(1, stats.releases);
+    TEST_ASSERT_EQUAL(1, stats.peakInUse);
+
+    int local = 0;
+    TEST_ASSERT_FALSE(pool.owns(&local));
+}
+
+void test_exhausted_class_falls_back_then_fails(void) {
+    EventPayloadPool& pool = EventPayloadPool::getInstance();
+    std::vector<void*> taken;
+    for (int i = 0; i < NEXTINO_PAYLOAD_POOL_BLOCKS_16; ++i) {
+        taken.push_back(pool.allocate(10));
+        TEST_ASSERT_NOT_NULL(taken.back());
+    }
+    TEST_ASSERT_EQUAL(NEXTINO_PAYLOAD_POOL_BLOCKS_16, pool.getStats(0).inUse);
+    TEST_ASSERT_EQUAL(NEXTINO_PAYLOAD_POOL_BLOCKS_16 * 10, pool.getStats(0).requestedBytes);
+
+    // The 16-byte class is exhausted, so the next small payload takes a 32-byte block.
+    void* spilled = pool.allocate(10);
+    TEST_ASSERT_NOT_NULL(spilled);
+    TEST_ASSERT_EQUAL(1, pool.getStats(1).inUse);
+    TEST_ASSERT_EQUAL(1, pool.getStats(1).fallbacks);
+    pool.release(spilled);
+
+    TEST_ASSERT_NULL(pool.allocate(129)); // Larger than any class
+    TEST_ASSERT_EQUAL(1, pool.getStats(3).failures);
+
+    for (int i = 0; i < NEXTINO_PAYLOAD_POOL_BLOCKS_128; ++i) {
+        taken.push_back(pool.allocate(100));
+        TEST_ASSERT_NOT_NULL(taken.back());
+    }
+    TEST_ASSERT_NULL(pool.allocate(100)); // Nothing larger to fall back to
+    TEST_ASSERT_EQUAL(2, pool.getStats(3).failures);
+
+    for (void* payload : taken) {
+        pool.release(payload);
+    }
+    TEST_ASSERT_EQUAL(0, blocksInUse());
+    TEST_ASSERT_EQUAL(0, pool.getStats(0).requestedBytes);
+}
+
+void test_queued_payload_fans_out_and_outlives_the_dispatch(void) {
+    EventBus& bus = EventBus::getInstance();
+    std::vector<const Tracked*> seen;
+    EventPayload<Tracked> kept;
+    EventBus::Subscription a = bus.on("test_payload_fan_out", [&](void* payload) { seen.push_back(static_cast<Tracked*>(payload)); });
+    EventBus::Subscription b = bus.on("test_payload_fan_out", [&](void* payload) { seen.push_back(static_cast<Tracked*>(payload)); });
+    EventBus::Subscription c = bus.on("test_payload_fan_out", [&](void* payload) { kept = EventPayload<Tracked>::retain(payload); });
+
+    {
+        EventPayload<Tracked> reading = EventPayload<Tracked>::make(42);
+        TEST_ASSERT_TRUE(bus.postAsync("test_payload_fan_out", reading));
+        TEST_ASSERT_EQUAL(2, reading.useCount()); // The publisher and the queue
+    } // The publisher lets go before the event is dispatched
+
+    TEST_ASSERT_EQUAL(1, Tracked::alive);
+    TEST_ASSERT_EQUAL(1, bus.dispatchQueued());
+    TEST_ASSERT_EQUAL(2, (int)seen.size());
+    TEST_ASSERT_TRUE(seen[0] == seen[1]); // Every listener gets the same object
+    TEST_ASSERT_TRUE(seen[0] == kept.get());
+    TEST_ASSERT_EQUAL(1, kept.useCount()); // Only the listener's reference is left
+    TEST_ASSERT_EQUAL(42, kept->value);
+
+    kept.reset();
+    TEST_ASSERT_EQUAL(0, Tracked::alive);
+    TEST_ASSERT_EQUAL(0, blocksInUse());
+
+    TEST_ASSERT_FALSE(bus.postAsync("test_payload_fan_out", EventPayload<Tracked>())); // Empty handles are rejected
+
+    bus.off(a);
+    bus.off(b);
+    bus.off(c);
+}
+
+void test_dropped_and_coalesced_payloads_are_released(void) {
+    EventBus& bus = EventBus::getInstance();
+    int delivered = 0;
+    EventBus::Subscription subscription = bus.on("test_payload_dropped", [&](void*) { delivered++; });
+
+    // DropOldest: overwritten events release their payloads.
+    for (int i = 0; i < NEXTINO_EVENTBUS_QUEUE_SIZE + 5; ++i) {
+        bus.postAsync("test_payload_dropped", EventPayload<Tracked>::make(i), EventPriority::Low);
+    }
+    TEST_ASSERT_EQUAL(NEXTINO_EVENTBUS_QUEUE_SIZE, Tracked::alive);
+
+    // DropNewest: the rejected event's reference is given back at once.
+    bus.setQueueFullPolicy(QueueFullPolicy::DropNewest);
+    EventPayload<Tracked> rejected = EventPayload<Tracked>::make(-1);
+    TEST_ASSERT_FALSE(bus.postAsync("test_payload_dropped", rejected, EventPriority::Low));
+    TEST_ASSERT_EQUAL(1, rejected.useCount());
+    rejected.reset();
+
+    while (bus.dispatchQueued() > 0) {
+    }
+    TEST_ASSERT_EQUAL(NEXTINO_EVENTBUS_QUEUE_SIZE, delivered);
+    TEST_ASSERT_EQUAL(0, Tracked::alive);
+
+    // Coalescing keeps only the newest payload; the others return to the pool.
+    TEST_ASSERT_TRUE(bus.setEventRate("test_payload_dropped", EventRateMode::Coalesce, 1000));
+    for (int i = 0; i < 5; ++i) {
+        bus.postAsync("test_payload_dropped", EventPayload<Tracked>::make(i));
+    }
+    TEST_ASSERT_EQUAL(2, Tracked::alive); // The first one, queued, and the newest, pending
+    TEST_ASSERT_TRUE(bus.setEventRate("test_payload_dropped", EventRateMode::Unlimited, 0)); // Discards the pending one
+    TEST_ASSERT_EQUAL(1, Tracked::alive);
+    TEST_ASSERT_EQUAL(1, bus.dispatchQueued());
+    TEST_ASSERT_EQUAL(0, Tracked::alive);
+    TEST_ASSERT_EQUAL(0, blocksInUse());
+
+    bus.off(subscription);
+}
+
+void test_typed_channel_can_queue_a_pooled_payload(void) {
+    struct Frame {
+        uint32_t id;
+        uint8_t data[64];
+    };
+    static const EventChannel<Frame> FRAMES("test_payload_frames");
+
+    uint32_t received = 0;
+    EventBus::Subscription subscription = FRAMES.on([&](const Frame& frame) { received = frame.id + frame.data[63]; });
+    EventPayload<Frame> frame = EventPayload<Frame>::make();
+    frame->id = 0x100;
+    memset(frame->data, 1, sizeof(frame->data));
+    TEST_ASSERT_EQUAL(1, EventPayloadPool::getInstance().getStats(3).inUse); // 68 bytes need a 128-byte block
+    TEST_ASSERT_TRUE(FRAMES.postAsync(frame));
+    frame.reset();
+
+    TEST_ASSERT_EQUAL(1, EventBus::getInstance().dispatchQueued());
+    TEST_ASSERT_EQUAL(0x101, received);
+    TEST_ASSERT_EQUAL(0, blocksInUse());
+
+    EventBus::getInstance().off(subscription);
+}
+
+/**
+ * @brief A payload whose every byte is derived from its sequence number, so a
+ *        block freed too early or handed out twice is caught when it is read.
+ */
+template <size_t N>
+struct Blob {
+    uint32_t seq;
+    uint16_t size;
+    uint8_t fill[N - 6];
+
+    explicit Blob(uint32_t s) : seq(s), size(N) { memset(fill, (uint8_t)s, sizeof(fill)); }
+};
+
+static bool intact(const void* payload) {
+    uint32_t seq;
+    uint16_t size;
+    memcpy(&seq, payload, sizeof(seq));
+    memcpy(&size, static_cast<const uint8_t*>(payload) + 4, sizeof(size));
+    const uint8_t* fill = static_cast<const uint8_t*>(payload) + 6;
+    for (size_t i = 0; i + 6 < size; ++i) {
+        if (fill[i] != (uint8_t)seq) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint32_t lcgState = 12345;
+static uint32_t nextRandom() {
+    lcgState = lcgState * 1664525u + 1013904223u;
+    return lcgState >> 8;
+}
+
+template <size_t N>
+static bool postBlob(uint32_t seq, EventPriority priority) {
+    EventPayload<Blob<N>> blob = EventPayload<Blob<N>>::make(seq);
+    return blob && EventBus::getInstance().postAsync("test_payload_soak", blob, priority);
+}
+
+void test_soak_random_sizes_and_lifetimes_leave_no_fragmentation(void) {
+    struct Held {
+        void* payload;
+        uint32_t until;
+    };
+    EventBus& bus = EventBus::getInstance();
+    EventPayloadPool& pool = EventPayloadPool::getInstance();
+    std::vector<Held> held;
+    uint32_t now = 0;
+    uint32_t delivered = 0;
+    uint32_t corrupted = 0;
+    uint32_t posted = 0;
+    uint32_t exhausted = 0;
+
+    // A quarter of the deliveries are kept by the listener for a random while.
+    EventBus::Subscription subscription = bus.on("test_payload_soak", [&](void* payload) {
+        delivered++;
+        if (!intact(payload)) {
+            corrupted++;
+        }
+        if (nextRandom() % 4 == 0 && held.size() < 12) {
+            pool.retain(payload);
+            held.push_back({payload, now + 1 + nextRandom() % 64});
+        }
+    });
+
+    for (uint32_t seq = 0; seq < SOAK_EVENTS; ++seq) {
+        now = seq;
+        EventPriority priority = (EventPriority)(nextRandom() % 3);
+        bool queued;
+        switch (nextRandom() % 8) {
+            case 0: queued = postBlob<8>(seq, priority); break;
+            case 1: queued = postBlob<16>(seq, priority); break;
+            case 2: queued = postBlob<24>(seq, priority); break;
+            case 3: queued = postBlob<32>(seq, priority); break;
+            case 4: queued = postBlob<48>(seq, priority); break;
+            case 5: queued = postBlob<64>(seq, priority); break;
+            case 6: queued = postBlob<100>(seq, priority); break;
+            default: queued = postBlob<128>(seq, priority); break;
+        }
+        posted += queued ? 1 : 0;
+        exhausted += queued ? 0 : 1;
+
+        if (nextRandom() % 3 == 0) {
+            bus.dispatchQueued(1 + nextRandom() % 8);
+        }
+        for (size_t i = 0; i < held.size();) {
+            if (held[i].until <= now) {
+                if (!intact(held[i].payload)) {
+                    corrupted++;
+                }
+                pool.release(held[i].payload);
+                held[i] = held.back();
+                held.pop_back();
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    while (bus.dispatchQueued() > 0) {
+    }
+    for (const Held& h : held) {
+        pool.release(h.payload);
+    }
+    bus.off(subscription);
+
+    TEST_ASSERT_EQUAL(0, corrupted);
+    TEST_ASSERT_TRUE(delivered > 0 && delivered <= posted);
+    TEST_ASSERT_TRUE(exhausted < SOAK_EVENTS / 10); // Pressure, but mostly served
+
+    printf("\n  %lu events: %lu queued, %lu delivered, %lu found the pool exhausted\n", (unsigned long)SOAK_EVENTS,
+           (unsigned long)posted, (unsigned long)delivered, (unsigned long)exhausted);
+    printf("  %-6s %8s %6s %10s %10s %9s %8s\n", "class", "capacity", "peak", "allocs", "releases", "fallbacks", "failures");
+    for (size_t c = 0; c < EventPayloadPool::CLASS_COUNT; ++c) {
+        PayloadPoolStats stats = pool.getStats(c);
+        printf("  %-6lu %8lu %6lu %10lu %10lu %9lu %8lu\n", (unsigned long)stats.blockSize, (unsigned long)stats.capacity,
+               (unsigned long)stats.peakInUse, (unsigned long)stats.allocations, (unsigned long)stats.releases,
+               (unsigned long)stats.fallbacks, (unsigned long)stats.failures);
+
+        // Nothing leaked and nothing was released twice.
+        TEST_ASSERT_EQUAL(0, stats.inUse);
+        TEST_ASSERT_EQUAL(0, stats.requestedBytes);
+        TEST_ASSERT_EQUAL(stats.allocations, stats.releases);
+    }
+
+    // No fragmentation: every block of every class can still be taken at once.
+    pool.resetStats();
+    std::vector<void*> all;
+    for (size_t c = 0; c < EventPayloadPool::CLASS_COUNT; ++c) {
+        size_t capacity = pool.getStats(c).capacity;
+        for (size_t i = 0; i < capacity; ++i) {
+            void* payload = pool.allocate(BLOCK_SIZES[c]);
+            TEST_ASSERT_NOT_NULL(payload);
+            all.push_back(payload);
+        }
+        TEST_ASSERT_EQUAL(capacity, pool.getStats(c).inUse);
+        TEST_ASSERT_EQUAL(0, pool.getStats(c).fallbacks);
+    }
+    for (void* payload : all) {
+        pool.release(payload);
+    }
+    TEST_ASSERT_EQUAL(0, blocksInUse());
+}
+
+void runAllTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_last_reference_returns_the_block);
+    RUN_TEST(test_exhausted_class_falls_back_then_fails);
+    RUN_TEST(test_queued_payload_fans_out_and_outlives_the_dispatch);
+    RUN_TEST(test_dropped_and_coalesced_payloads_are_released);
+    RUN_TEST(test_typed_channel_can_queue_a_pooled_payload);
+    RUN_TEST(test_soak_random_sizes_and_lifetimes_leave_no_fragmentation);
+}
+
+#if defined(ARDUINO)
+void setup() {
+    delay(2000);
+    runAllTests();
+}
+
+void loop() {
+    UNITY_END();
+}
+#else
+int main() {
+    runAllTests();
+    return UNITY_END();
+}
+#endif
@@ -0,0 +1,331 @@
+/**
+ * @file        test_event_recorder.cpp
+ * @title       Unit Tests for Event Recording and Replay
+ * @description Records posts of every kind under a simulated clock, then
+ *              verifies that a replay delivers the same events, payloads,
+ *              priorities and timestamps, that a full ring keeps the newest
+ *              records, that replays are deterministic (rate controls and
+ *              timers included), that paced replays follow the recorded time
+ *              and that malformed streams are rejected.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-09-04
+ * @version     0.1.0
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "core/Platform.h"
+#include "core/EventBus.h"
+#include "core/EventChannel.h"
+#include "core/EventPayload.h"
+#include "core/EventRecorder.h"
+#include "core/Scheduler.h"
+
+struct Reading {
+    float celsius;
+    uint32_t sensor;
+};
+
+struct Frame {
+    uint8_t bytes[40];
+};
+
+constexpr EventChannel<Reading> TEMPERATURE("rec/temperature");
+constexpr EventId BUTTON("rec_button");
+constexpr EventId SAMPLE("rec_sample");
+constexpr EventId FRAME("rec_frame");
+constexpr EventId START("rec_start");
+constexpr EventId ACK("rec_ack");
+
+static uint64_t simulatedNowUs = 0;
+
+static uint64_t simulatedClock() {
+    return simulatedNowUs;
+}
+
+static std::vector<std::string> trace;
+
+// Each delivery as "what@time:value", with the time the listener sees.
+static void note(const char* what, long value) {
+    char line[64];
+    snprintf(line, sizeof(line), "%s@%lu:%ld", what, (unsigned long)Scheduler::getInstance().nowMicros(), value);
+    trace.push_back(line);
+}
+
+static std::vector<uint8_t> exportRing(const EventRecorder& recorder) {
+    std::vector<uint8_t> stream;
+    size_t written = recorder.writeTo([&stream](const uint8_t* data, size_t size) { stream.insert(stream.end(), data, data + size); });
+    TEST_ASSERT_EQUAL(stream.size(), written);
+    return stream;
+}
+
+static void drain() {
+    EventBus& bus = EventBus::getInstance();
+    while (bus.dispatchQueued() > 0) {
+    }
+}
+
+void setUp(void) {
+    Scheduler::getInstance().setTimeSource(simulatedClock);
+    simulatedNowUs = 1000000;
+    trace.clear();
+}
+
+void tearDown(void) {
+    Scheduler::getInstance().setTimeSource(nullptr);
+}
+
+void test_replay_delivers_the_recorded_posts_at_their_times(void) {
+    EventBus& bus = EventBus::getInstance();
+    EventBus::Subscription subscriptions[] = {
+        TEMPERATURE.on([](const Reading& reading) { note("temperature", (long)(reading.celsius * 10) + reading.sensor * 1000); }),
+        bus.on(BUTTON, [](void* payload) { note("button", payload ? 1 : 0); }),
+        bus.on(SAMPLE, [](void* payload) { note("sample", *static_cast<int*>(payload)); }),
+        bus.on(FRAME, [](void* payload) {
+            const Frame* frame = static_cast<const Frame*>(payload);
+            note("frame", frame->bytes[0] + frame->bytes[39]);
+        }),
+        bus.on("rec/#", [](void*) { note("topic", 0); }),
+    };
+
+    static uint8_t ring[1024];
+    EventRecorder recorder(ring, sizeof(ring));
+    recorder.start();
+    TEST_ASSERT_TRUE(recorder.isRecording());
+
+    TEMPERATURE.post({21.5f, 2});
+    simulatedNowUs += 250;
+    bus.post(BUTTON);
+    simulatedNowUs += 100000;
+    int sample = -42;
+    bus.postAsync(SAMPLE, &sample, sizeof(sample), EventPriority::High);
+    drain();
+    simulatedNowUs += 5;
+    EventPayload<Frame> frame = EventPayload<Frame>::make();
+    frame->bytes[0] = 3;
+    frame->bytes[39] = 4;
+    bus.postAsync(FRAME, frame);
+    frame.reset();
+    drain();
+    simulatedNowUs += 3000000;
+    TEMPERATURE.post({-4.0f, 1});
+    recorder.stop();
+    TEST_ASSERT_FALSE(recorder.isRecording());
+
+    RecorderStats stats = recorder.getStats();
+    TEST_ASSERT_EQUAL(5, stats.recorded);
+    TEST_ASSERT_EQUAL(0, stats.overwritten);
+    std::vector<uint8_t> stream = exportRing(recorder);
+    TEST_ASSERT_EQUAL(EventRecorder::HEADER_SIZE + stats.bytes, stream.size());
+
+    // Replay at a different wall-clock time: the virtual clock restores the recorded one.
+    std::vector<std::string> original = trace;
+    trace.clear();
+    simulatedNowUs = 77;
+    EventReplay replay(stream.data(), stream.size());
+    TEST_ASSERT_TRUE(replay.isValid());
+    ReplayStats result = replay.run();
+    TEST_ASSERT_TRUE(result.complete);
+    TEST_ASSERT_EQUAL(5, result.posted);
+    TEST_ASSERT_EQUAL(0, result.failed);
+    TEST_ASSERT_EQUAL(3100255, result.recordedUs);
+    TEST_ASSERT_EQUAL(7, original.size());
+    TEST_ASSERT_EQUAL(original.size(), trace.size());
+    for (size_t i = 0; i < original.size(); ++i) {
+        TEST_ASSERT_EQUAL_STRING(original[i].c_str(), trace[i].c_str());
+    }
+    TEST_ASSERT_EQUAL_STRING("sample@1100250:-42", trace[3].c_str());
+    TEST_ASSERT_EQUAL(77, Scheduler::getInstance().nowMicros()); // The previous clock is back
+
+    for (EventBus::Subscription subscription : subscriptions) {
+        bus.off(subscription);
+    }
+}
+
+void test_full_ring_keeps_the_newest_records(void) {
+    EventBus& bus = EventBus::getInstance();
+    EventBus::Subscription subscription = bus.on(SAMPLE, [](void* payload) { note("sample", *static_cast<int*>(payload)); });
+
+    // Each record is 13 bytes: flags, a 2-byte delta, the ID, two 1-byte sizes and the payload.
+    static uint8_t ring[64];
+    EventRecorder recorder(ring, sizeof(ring));
+    recorder.start();
+    for (int i = 0; i < 50; ++i) {
+        simulatedNowUs += 1000;
+        bus.postAsync(SAMPLE, &i, sizeof(i));
+        drain();
+    }
+    recorder.stop();
+    RecorderStats stats = recorder.getStats();
+    TEST_ASSERT_EQUAL(50, stats.recorded);
+    TEST_ASSERT_EQUAL(46, stats.overwritten);
+    TEST_ASSERT_EQUAL(4 * 13 + 2, stats.bytes); // And the end record of stop()
+
+    trace.clear();
+    std::vector<uint8_t> stream = exportRing(recorder);
+    ReplayStats result = EventReplay(stream.data(), stream.size()).run();
+    TEST_ASSERT_TRUE(result.complete);
+    TEST_ASSERT_EQUAL(4, result.posted);
+    TEST_ASSERT_EQUAL(4, trace.size());
+    TEST_ASSERT_EQUAL_STRING("sample@1047000:46", trace[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("sample@1050000:49", trace[3].c_str());
+    bus.off(subscription);
+}
+
+void test_replay_is_deterministic(void) {
+    EventBus& bus = EventBus::getInstance();
+    Scheduler& scheduler = Scheduler::getInstance();
+    TEST_ASSERT_TRUE(bus.setEventRate(SAMPLE, EventRateMode::Coalesce, 10));
+    EventBus::Subscription subscriptions[] = {
+        bus.on(SAMPLE, [](void* payload) { note("sample", *static_cast<int*>(payload)); }),
+        bus.on(START, [](void*) {
+            note("start", 0);
+            EventBus::getInstance().post(ACK); // A derived post
+            Scheduler::getInstance().scheduleOnceMicros(15000, []() { note("timeout", 0); });
+        }),
+        bus.on(ACK, [](void*) { note("ack", 0); }),
+    };
+
+    // Bursts of samples are coalesced over 10 ms by a Scheduler task.
+    static uint8_t ring[512];
+    EventRecorder recorder(ring, sizeof(ring));
+    recorder.start();
+    bus.post(START);
+    for (int i = 0; i < 12; ++i) {
+        simulatedNowUs += 1700;
+        bus.postAsync(SAMPLE, &i, sizeof(i));
+        drain();
+        scheduler.loop();
+    }
+    for (int i = 0; i < 30; ++i) {
+        simulatedNowUs += 1000;
+        scheduler.loop();
+    }
+    recorder.stop();
+    std::vector<uint8_t> stream = exportRing(recorder);
+    EventRateStats recorded;
+    TEST_ASSERT_TRUE(bus.getEventRateStats(SAMPLE, recorded));
+
+    // Two replays, each recorded again: the same deliveries and the same bytes.
+    std::vector<std::string> traces[2];
+    std::vector<uint8_t> rerecorded[2];
+    for (int run = 0; run < 2; ++run) {
+        trace.clear();
+        std::vector<uint8_t>& copy = rerecorded[run];
+        EventRecorder again([&copy](const uint8_t* data, size_t size) { copy.insert(copy.end(), data, data + size); });
+        again.start();
+        ReplayStats result = EventReplay(stream.data(), stream.size()).run();
+        again.stop();
+        TEST_ASSERT_TRUE(result.complete);
+        TEST_ASSERT_EQUAL(13, result.posted);
+        TEST_ASSERT_EQUAL(1, result.skipped); // The ack, posted again by the start listener
+        traces[run] = trace;
+    }
+    TEST_ASSERT_EQUAL(traces[0].size(), traces[1].size());
+    for (size_t i = 0; i < traces[0].size(); ++i) {
+        TEST_ASSERT_EQUAL_STRING(traces[0][i].c_str(), traces[1][i].c_str());
+    }
+    TEST_ASSERT_EQUAL(rerecorded[0].size(), rerecorded[1].size());
+    TEST_ASSERT_EQUAL_MEMORY(rerecorded[0].data(), rerecorded[1].data(), rerecorded[0].size());
+
+    TEST_ASSERT_EQUAL(6, traces[0].size());
+    // Tasks run at their exact due times: the coalesced flushes every 10 ms, then the timeout.
+    TEST_ASSERT_EQUAL_STRING("start@1000000:0", traces[0][0].c_str());
+    TEST_ASSERT_EQUAL_STRING("ack@1000000:0", traces[0][1].c_str());
+    TEST_ASSERT_EQUAL_STRING("sample@1001700:0", traces[0][2].c_str());
+    TEST_ASSERT_EQUAL_STRING("sample@1011700:5", traces[0][3].c_str());
+    TEST_ASSERT_EQUAL_STRING("timeout@1015000:0", traces[0][4].c_str());
+    TEST_ASSERT_EQUAL_STRING("sample@1021700:11", traces[0][5].c_str()); // Pending when the last sample was posted
+    EventRateStats replayed;
+    TEST_ASSERT_TRUE(bus.getEventRateStats(SAMPLE, replayed));
+    TEST_ASSERT_EQUAL(3 * recorded.posted, replayed.posted);
+    TEST_ASSERT_EQUAL(3 * recorded.delivered, replayed.delivered);
+
+    TEST_ASSERT_TRUE(bus.setEventRate(SAMPLE, EventRateMode::Unlimited, 0));
+    for (EventBus::Subscription subscription : subscriptions) {
+        bus.off(subscription);
+    }
+}
+
+void test_paced_replay_follows_the_recorded_time(void) {
+    EventBus& bus = EventBus::getInstance();
+    EventBus::Subscription subscription = bus.on(BUTTON, [](void*) { note("button", 0); });
+    static uint8_t ring[128];
+    EventRecorder recorder(ring, sizeof(ring));
+    recorder.start();
+    for (int i = 0; i < 5; ++i) {
+        bus.post(BUTTON);
+        simulatedNowUs += 50000;
+    }
+    recorder.stop();
+    std::vector<uint8_t> stream = exportRing(recorder);
+
+    // 250 ms recorded, up to stop(), replayed 4 times faster.
+    Scheduler::getInstance().setTimeSource(nullptr);
+    ReplayStats result = EventReplay(stream.data(), stream.size()).run(4.0f);
+    TEST_ASSERT_TRUE(result.complete);
+    TEST_ASSERT_EQUAL(250000, result.recordedUs);
+    TEST_ASSERT_UINT64_WITHIN(20000, 62500, result.elapsedUs);
+    bus.off(subscription);
+}
+
+void test_malformed_streams_are_rejected(void) {
+    EventBus& bus = EventBus::getInstance();
+    EventBus::Subscription subscription = bus.on(SAMPLE, [](void* payload) { note("sample", *static_cast<int*>(payload)); });
+    static uint8_t ring[128];
+    EventRecorder recorder(ring, sizeof(ring));
+    recorder.start();
+    for (int i = 0; i < 3; ++i) {
+        bus.postAsync(SAMPLE, &i, sizeof(i));
+        drain();
+    }
+    recorder.stop();
+    std::vector<uint8_t> stream = exportRing(recorder);
+
+    // A stream cut inside the last post replays the whole ones.
+    trace.clear();
+    ReplayStats result = EventReplay(stream.data(), stream.size() - 4).run();
+    TEST_ASSERT_FALSE(result.complete);
+    TEST_ASSERT_EQUAL(2, result.posted);
+    TEST_ASSERT_EQUAL(2, trace.size());
+
+    // A stream without the header replays nothing.
+    std::vector<uint8_t> bad = stream;
+    bad[0] = 'X';
+    EventReplay replay(bad.data(), bad.size());
+    TEST_ASSERT_FALSE(replay.isValid());
+    result = replay.run();
+    TEST_ASSERT_FALSE(result.complete);
+    TEST_ASSERT_EQUAL(0, result.posted);
+    TEST_ASSERT_EQUAL(2, trace.size());
+    bus.off(subscription);
+}
+
+void runAllTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_replay_delivers_the_recorded_posts_at_their_times);
+    RUN_TEST(test_full_ring_keeps_the_newest_records);
+    RUN_TEST(test_replay_is_deterministic);
+    RUN_TEST(test_paced_replay_follows_the_recorded_time);
+    RUN_TEST(test_malformed_streams_are_rejected);
+}
+
+#if defined(ARDUINO)
+void setup() {
+    delay(2000);
+    runAllTests();
+}
+
+void loop() {
+    UNITY_END();
+}
+#else
+int main() {
+    runAllTests();
+    return UNITY_END();
+}
+#endif
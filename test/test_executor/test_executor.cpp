@@ -0,0 +1,206 @@
+/**
+ * @file        test_executor.cpp
+ * @title       Unit Tests for the Executor
+ * @description Verifies the work-stealing worker pool and how the Scheduler
+ *              hands parallel-safe tasks to it.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-08-30
+ * @version     0.1.0
+ */
+
+#include <unity.h>
+#include <atomic>
+#include "core/Platform.h"
+#include "core/Executor.h"
+#include "core/Scheduler.h"
+
+#if !defined(ARDUINO)
+#include <thread>
+#endif
+
+std::atomic<uint32_t> jobsRun(0);
+std::atomic<bool> gateOpen(false);
+
+unsigned long simulatedNowMs = 0;
+
+uint64_t simulatedClock() {
+    return (uint64_t)simulatedNowMs * 1000ULL;
+}
+
+// Submits a job, retrying while every deque is full.
+void submitBlocking(const Executor::Job& job) {
+    while (!Executor::getInstance().submit(job)) {
+        yield();
+    }
+}
+
+// Waits up to `timeoutMs` for `value` to reach `expected`.
+bool waitFor(std::atomic<uint32_t>& value, uint32_t expected, unsigned long timeoutMs) {
+    unsigned long start = millis();
+    while (value.load() < expected && millis() - start < timeoutMs) {
+        delay(1);
+    }
+    return value.load() >= expected;
+}
+
+void setUp(void) {
+    jobsRun = 0;
+    gateOpen = false;
+}
+
+void tearDown(void) {
+    gateOpen = true;
+    Executor::getInstance().stop();
+    Scheduler::getInstance().setTimeSource(nullptr);
+}
+
+void test_executor_runs_every_job() {
+    Executor& executor = Executor::getInstance();
+    TEST_ASSERT_TRUE(executor.start(4));
+    TEST_ASSERT_TRUE(executor.isRunning());
+    ExecutorStats before = executor.getStats();
+
+    for (int i = 0; i < 1000; ++i) {
+        submitBlocking([]() { jobsRun++; });
+    }
+    executor.waitIdle();
+
+    ExecutorStats stats = executor.getStats();
+    TEST_ASSERT_EQUAL(1000, jobsRun.load());
+    TEST_ASSERT_EQUAL(4, stats.workers);
+    TEST_ASSERT_EQUAL(1000, stats.executed - before.executed);
+}
+
+void test_idle_worker_steals_from_a_busy_one() {
+    Executor& executor = Executor::getInstance();
+    TEST_ASSERT_TRUE(executor.start(2));
+    uint32_t stolenBefore = executor.getStats().stolen;
+
+    // Park one worker on a job that waits for the gate.
+    executor.submit([]() {
+        while (!gateOpen.load()) {
+            yield();
+        }
+    });
+    delay(10);
+
+    // Half of these land on the parked worker's deque; the other worker
+    // has to steal them for all ten to finish while the gate is closed.
+    for (int i = 0; i < 10; ++i) {
+        executor.submit([]() { jobsRun++; });
+    }
+    TEST_ASSERT_TRUE(waitFor(jobsRun, 10, 2000));
+    TEST_ASSERT_TRUE(executor.getStats().stolen > stolenBefore);
+
+    gateOpen = true;
+    executor.waitIdle();
+}
+
+void test_submit_is_rejected_when_stopped() {
+    Executor& executor = Executor::getInstance();
+    executor.stop();
+    uint32_t rejectedBefore = executor.getStats().rejected;
+
+    TEST_ASSERT_FALSE(executor.submit([]() { jobsRun++; }));
+    TEST_ASSERT_EQUAL(rejectedBefore + 1, executor.getStats().rejected);
+    TEST_ASSERT_EQUAL(0, executor.getStats().workers);
+}
+
+void test_parallel_task_runs_inline_without_executor() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    scheduler.setTimeSource(simulatedClock);
+    simulatedNowMs = 0;
+    Scheduler::TaskHandle handle = scheduler.scheduleRecurring(10, []() { jobsRun++; });
+    TEST_ASSERT_TRUE(scheduler.setTaskAffinity(handle, TaskAffinity::Parallel));
+
+    simulatedNowMs = 10;
+    scheduler.loop();
+
+    TEST_ASSERT_EQUAL(1, jobsRun.load());
+    TEST_ASSERT_TRUE(scheduler.cancel(handle));
+}
+
+void test_overlapping_parallel_run_is_skipped() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    TEST_ASSERT_TRUE(Executor::getInstance().start(2));
+    scheduler.setTimeSource(simulatedClock);
+    simulatedNowMs = 0;
+    Scheduler::TaskHandle handle = scheduler.scheduleRecurring(10, []() {
+        jobsRun++;
+        while (!gateOpen.load()) {
+            yield();
+        }
+    });
+    scheduler.setTaskAffinity(handle, TaskAffinity::Parallel);
+
+    simulatedNowMs = 10;
+    scheduler.loop(); // Dispatched; the loop does not wait for it.
+    TEST_ASSERT_TRUE(waitFor(jobsRun, 1, 2000));
+    simulatedNowMs = 20;
+    scheduler.loop(); // Still running on the worker: this period is skipped.
+
+    TaskTimingStats stats;
+    scheduler.getTaskTimingStats(handle, stats);
+    TEST_ASSERT_EQUAL(1, stats.runs);
+    TEST_ASSERT_EQUAL(1, stats.missedPeriods);
+
+    gateOpen = true;
+    Executor::getInstance().waitIdle();
+    simulatedNowMs = 30;
+    scheduler.loop();
+    TEST_ASSERT_TRUE(waitFor(jobsRun, 2, 2000));
+    TEST_ASSERT_TRUE(scheduler.cancel(handle));
+}
+
+#if !defined(ARDUINO)
+void test_only_parallel_tasks_leave_the_main_thread() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    TEST_ASSERT_TRUE(Executor::getInstance().start(2));
+    scheduler.setTimeSource(simulatedClock);
+    simulatedNowMs = 0;
+    static std::thread::id mainLoopTaskThread;
+    static std::thread::id parallelTaskThread;
+    Scheduler::TaskHandle mainLoopTask = scheduler.scheduleOnce(10, []() { mainLoopTaskThread = std::this_thread::get_id(); });
+    Scheduler::TaskHandle parallelTask = scheduler.scheduleOnce(10, []() { parallelTaskThread = std::this_thread::get_id(); });
+    scheduler.setTaskAffinity(parallelTask, TaskAffinity::Parallel);
+
+    simulatedNowMs = 10;
+    scheduler.loop();
+    Executor::getInstance().waitIdle();
+
+    TEST_ASSERT_TRUE(mainLoopTaskThread == std::this_thread::get_id());
+    TEST_ASSERT_TRUE(parallelTaskThread != std::thread::id());
+    TEST_ASSERT_TRUE(parallelTaskThread != std::this_thread::get_id());
+    TEST_ASSERT_FALSE(scheduler.cancel(mainLoopTask));
+    TEST_ASSERT_FALSE(scheduler.cancel(parallelTask));
+}
+#endif
+
+void runAllTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_executor_runs_every_job);
+    RUN_TEST(test_idle_worker_steals_from_a_busy_one);
+    RUN_TEST(test_submit_is_rejected_when_stopped);
+    RUN_TEST(test_parallel_task_runs_inline_without_executor);
+    RUN_TEST(test_overlapping_parallel_run_is_skipped);
+#if !defined(ARDUINO)
+    RUN_TEST(test_only_parallel_tasks_leave_the_main_thread);
+#endif
+}
+
+#if defined(ARDUINO)
+void setup() {
+    delay(2000);
+    runAllTests();
+}
+
+void loop() {
+    UNITY_END();
+}
+#else
+int main() {
+    runAllTests();
+    return UNITY_END();
+}
+#endif
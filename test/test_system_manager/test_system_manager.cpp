@@ -0,0 +1,188 @@
+/**
+ * @file        test_system_manager.cpp
+ * @title       Unit Tests for the SystemManager Idle Mode
+ * @description Verifies tickless idle behaviour under a simulated clock, and
+ *              early wake-up from another thread on the host build.
+ *
+ * @author      Giorgi Magradze
+ * @date        2025-08-28
+ * @version     0.1.0
+ */
+
+#include <unity.h>
+#include "core/Platform.h"
+#include "core/DeferredQueue.h"
+#include "core/EventBus.h"
+#include "core/Scheduler.h"
+#include "core/SystemManager.h"
+
+#if !defined(ARDUINO)
+#include <thread>
+#endif
+
+unsigned long simulatedNowMs = 0;
+unsigned long sleepCalls = 0;
+
+uint64_t simulatedClock() {
+    return (uint64_t)simulatedNowMs * 1000ULL;
+}
+
+void simulatedSleep(unsigned long timeoutMs) {
+    sleepCalls++;
+    simulatedNowMs += timeoutMs;
+}
+
+void setUp(void) {
+    simulatedNowMs = 0;
+    sleepCalls = 0;
+    Scheduler::getInstance().setTimeSource(simulatedClock);
+    SystemManager::getInstance().setSleepFunction(simulatedSleep);
+}
+
+void tearDown(void) {
+    SystemManager::getInstance().setIdleMode(IdleMode::None);
+    SystemManager::getInstance().setSleepFunction(nullptr);
+    Scheduler::getInstance().setTimeSource(nullptr);
+}
+
+void test_idle_sleeps_until_next_deadline() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    SystemManager& system = SystemManager::getInstance();
+    int runs = 0;
+    // Each run "costs" 10 ms of CPU time on the simulated clock.
+    Scheduler::TaskHandle handle = scheduler.scheduleRecurring(100, [&runs]() {
+        runs++;
+        simulatedNowMs += 10;
+    });
+    system.setIdleMode(IdleMode::Sleep, 1000);
+
+    for (int i = 0; i < 50; ++i) {
+        system.loop();
+    }
+
+    IdleStats stats = system.getIdleStats();
+    TEST_ASSERT_EQUAL(50, stats.idlePeriods);
+    TEST_ASSERT_EQUAL(49, runs);
+    // 100 ms period, 10 ms busy: the loop is idle ~90% of the time.
+    TEST_ASSERT_UINT32_WITHIN(100, 4500, stats.idleMs);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 0.10f, stats.cpuUtilisation);
+    TEST_ASSERT_TRUE(scheduler.cancel(handle));
+}
+
+void test_idle_sleep_is_capped_by_max_idle() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    SystemManager& system = SystemManager::getInstance();
+    Scheduler::TaskHandle handle = scheduler.scheduleOnce(5000, []() {});
+    system.setIdleMode(IdleMode::Sleep, 200);
+
+    system.loop();
+
+    TEST_ASSERT_EQUAL(1, sleepCalls);
+    TEST_ASSERT_EQUAL(200, simulatedNowMs);
+    TEST_ASSERT_TRUE(scheduler.cancel(handle));
+}
+
+void test_pending_wake_skips_the_next_sleep() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    SystemManager& system = SystemManager::getInstance();
+    Scheduler::TaskHandle handle = scheduler.scheduleOnce(5000, []() {});
+    system.setIdleMode(IdleMode::Sleep, 1000);
+
+    system.wake(); // e.g. an ISR queued work while the loop was busy
+    system.loop();
+
+    TEST_ASSERT_EQUAL(0, sleepCalls);
+    TEST_ASSERT_EQUAL(1, system.getIdleStats().earlyWakeups);
+    TEST_ASSERT_TRUE(scheduler.cancel(handle));
+}
+
+int deferredRuns = 0;
+
+void test_deferred_post_skips_the_next_sleep() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    SystemManager& system = SystemManager::getInstance();
+    Scheduler::TaskHandle handle = scheduler.scheduleOnce(5000, []() {});
+    system.setIdleMode(IdleMode::Sleep, 1000);
+
+    // The queue wakes the loop through the cached signal, as an ISR would.
+    DeferredQueue::getInstance().post([](const void*, size_t) { deferredRuns++; });
+    system.loop();
+
+    TEST_ASSERT_EQUAL(1, deferredRuns);
+    TEST_ASSERT_EQUAL(0, sleepCalls);
+    TEST_ASSERT_EQUAL(1, system.getIdleStats().earlyWakeups);
+    TEST_ASSERT_TRUE(scheduler.cancel(handle));
+}
+
+int queuedDeliveries = 0;
+
+void test_queued_events_are_dispatched_before_sleeping() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    SystemManager& system = SystemManager::getInstance();
+    EventBus::getInstance().on("test_sm_queued", [](void*) { queuedDeliveries++; });
+    Scheduler::TaskHandle idleTask = scheduler.scheduleOnce(5000, []() {});
+    // A task queues an event in the middle of the pass.
+    scheduler.scheduleOnce(0, []() { EventBus::getInstance().postAsync("test_sm_queued"); });
+    system.setIdleMode(IdleMode::Sleep, 1000);
+
+    system.loop();
+    TEST_ASSERT_EQUAL(0, queuedDeliveries);
+    TEST_ASSERT_EQUAL(0, sleepCalls); // Did not sleep with an event pending
+
+    system.loop();
+    TEST_ASSERT_EQUAL(1, queuedDeliveries);
+    TEST_ASSERT_EQUAL(1, sleepCalls);
+    TEST_ASSERT_TRUE(scheduler.cancel(idleTask));
+}
+
+#if !defined(ARDUINO)
+void test_wake_from_another_thread_ends_sleep_early() {
+    Scheduler& scheduler = Scheduler::getInstance();
+    SystemManager& system = SystemManager::getInstance();
+    scheduler.setTimeSource(nullptr);
+    system.setSleepFunction(nullptr);
+    Scheduler::TaskHandle handle = scheduler.scheduleOnce(5000, []() {});
+    system.setIdleMode(IdleMode::Sleep, 5000);
+
+    std::thread producer([&system]() {
+        delay(20);
+        system.wake();
+    });
+    unsigned long start = millis();
+    system.loop();
+    unsigned long sleptMs = millis() - start;
+    producer.join();
+
+    TEST_ASSERT_LESS_THAN(1000, sleptMs);
+    TEST_ASSERT_EQUAL(1, system.getIdleStats().earlyWakeups);
+    TEST_ASSERT_TRUE(scheduler.cancel(handle));
+}
+#endif
+
+void runAllTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_idle_sleeps_until_next_deadline);
+    RUN_TEST(test_idle_sleep_is_capped_by_max_idle);
+    RUN_TEST(test_pending_wake_skips_the_next_sleep);
+    RUN_TEST(test_deferred_post_skips_the_next_sleep);
+    RUN_TEST(test_queued_events_are_dispatched_before_sleeping);
+#if !defined(ARDUINO)
+    RUN_TEST(test_wake_from_another_thread_ends_sleep_early);
+#endif
+}
+
+#if defined(ARDUINO)
+void setup() {
+    delay(2000);
+    runAllTests();
+}
+
+void loop() {
+    UNITY_END();
+}
+#else
+int main() {
+    runAllTests();
+    return UNITY_END();
+}
+#endif